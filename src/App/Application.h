@@ -120,6 +120,8 @@ public:
     boost::signal<void (const Document&)> signalUndoDocument;
     /// signal on redo in document
     boost::signal<void (const Document&)> signalRedoDocument;
+    /// signal before the objects of a document are recomputed in worker threads
+    boost::signal<void (const Document&)> signalParallelRecompute;
     //@}
 
 
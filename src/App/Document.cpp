@@ -53,8 +53,10 @@ recompute path. Also enables more complicated dependencies beyond trees.
 
 #ifndef _PreComp_
 # include <algorithm>
+# include <cstring>
 # include <sstream>
 # include <climits>
+# include <set>
 #endif
 
 #include <boost/graph/topological_sort.hpp>
@@ -65,9 +67,15 @@ recompute path. Also enables more complicated dependencies beyond trees.
 #include <boost/bind.hpp>
 #include <boost/regex.hpp>
 #include <boost/unordered_set.hpp>
+#include <boost/unordered_map.hpp>
 
 #include <QCoreApplication>
 #include <QCryptographicHash>
+#include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QtConcurrentRun>
 
 
 #include "Document.h"
@@ -117,7 +125,7 @@ using namespace zipios;
 typedef boost::adjacency_list <
 boost::vecS,           // class OutEdgeListS  : a Sequence or an AssociativeContainer
 boost::vecS,           // class VertexListS   : a Sequence or a RandomAccessContainer
-boost::directedS,      // class DirectedS     : This is a directed graph
+boost::bidirectionalS, // class DirectedS     : This is a directed graph with access to in-edges
 boost::no_property,    // class VertexProperty:
 boost::no_property,    // class EdgeProperty:
 boost::no_property,    // class GraphProperty:
@@ -129,6 +137,86 @@ typedef Traits::edge_descriptor Edge;
 
 namespace App {
 
+// Names split into their text and the number at their end. This gives the
+// highest number used after a text without going through all names.
+class NumberedNames
+{
+public:
+    void add(const std::string& name)
+    {
+        std::string text, number;
+        split(name, text, number);
+        names[text].insert(number);
+    }
+    void remove(const std::string& name)
+    {
+        std::string text, number;
+        split(name, text, number);
+        boost::unordered_map<std::string, Numbers>::iterator it = names.find(text);
+        if (it == names.end())
+            return;
+        Numbers::iterator jt = it->second.find(number);
+        if (jt != it->second.end())
+            it->second.erase(jt);
+        if (it->second.empty())
+            names.erase(it);
+    }
+    void clear()
+    {
+        names.clear();
+    }
+    /// Same as Base::Tools::getUniqueName() with all added names
+    std::string getUniqueName(const std::string& name, int d) const
+    {
+        std::string text, number, highest;
+        split(name, text, number);
+        boost::unordered_map<std::string, Numbers>::const_iterator it = names.find(text);
+        if (it != names.end() && number.empty()) {
+            // the numbers are sorted by their values
+            highest = *it->second.rbegin();
+        }
+        else if (it != names.end()) {
+            // the numbers of the names starting with 'name' and ending with digits
+            Numbers::const_iterator jt = it->second.lower_bound(std::string(number.size()+1, '0'));
+            for (; jt != it->second.end(); ++jt) {
+                if (jt->compare(0, number.size(), number) == 0) {
+                    std::string suffix = jt->substr(number.size());
+                    if (NumberLess()(highest, suffix))
+                        highest = suffix;
+                }
+            }
+        }
+
+        std::vector<std::string> used;
+        if (!highest.empty())
+            used.push_back(name + highest);
+        return Base::Tools::getUniqueName(name, used, d);
+    }
+
+private:
+    // compares numbers represented as strings
+    struct NumberLess
+    {
+        bool operator() (const std::string& s1, const std::string& s2) const
+        {
+            if (s1.size() != s2.size())
+                return s1.size() < s2.size();
+            return s1 < s2;
+        }
+    };
+    typedef std::multiset<std::string, NumberLess> Numbers;
+
+    static void split(const std::string& name, std::string& text, std::string& number)
+    {
+        std::string::size_type pos = name.find_last_not_of("0123456789");
+        pos = (pos == std::string::npos) ? 0 : pos + 1;
+        text = name.substr(0, pos);
+        number = name.substr(pos);
+    }
+
+    boost::unordered_map<std::string, Numbers> names;
+};
+
 // Pimpl class
 struct DocumentP
 {
@@ -141,14 +229,37 @@ struct DocumentP
     int iTransactionMode;
     int iTransactionCount;
     std::map<int,Transaction*> mTransactions;
-    std::map<Vertex,DocumentObject*> vertexMap;
+    // snapshot of vertexObjects while a recompute is running
+    std::vector<DocumentObject*> vertexMap;
+    // the vertices to be recomputed in topological order
+    std::vector<Vertex> recomputeOrder;
     bool rollback;
     bool closable;
     int iUndoMode;
     unsigned int UndoMemSize;
     unsigned int UndoMaxStackSize;
+    // the dependency graph which is kept up-to-date when objects are added or
+    // removed or when one of their link properties changes
     DependencyList DepList;
-    std::map<DocumentObject*,Vertex> VertexObjectList;
+    boost::unordered_map<DocumentObject*,Vertex> VertexObjectList;
+    std::vector<DocumentObject*> vertexObjects;
+    // vertices of removed objects which are reused for new objects
+    std::vector<Vertex> freeVertices;
+    // objects linking to an object which is not part of the graph (yet)
+    std::set<DocumentObject*> danglingLinks;
+    // vertices of the touched objects, recomputing the touched objects only
+    // thus doesn't need to look at every object of the document
+    std::set<Vertex> touchedVertices;
+    // the thread running a parallel recompute, 0 otherwise
+    QThread* recomputeThread;
+    QMutex recomputeMutex;
+    // property changes made in worker threads which are notified afterwards
+    std::vector<std::pair<const DocumentObject*, const Property*> > pendingChanges;
+    // the names and labels of the objects to create unique ones
+    NumberedNames objectNames;
+    NumberedNames objectLabels;
+    boost::unordered_multimap<std::string, DocumentObject*> labelMap;
+    boost::unordered_map<const DocumentObject*, std::string> labelOfObject;
 
     DocumentP() {
         activeObject = 0;
@@ -161,9 +272,203 @@ struct DocumentP
         iUndoMode = 0;
         UndoMemSize = 0;
         UndoMaxStackSize = 20;
+        recomputeThread = 0;
+    }
+
+    void addObjectName(DocumentObject* pcObject, const std::string& name)
+    {
+        objectNames.add(name);
+        std::string label = pcObject->Label.getValue();
+        objectLabels.add(label);
+        labelMap.insert(std::make_pair(label, pcObject));
+        labelOfObject[pcObject] = label;
+    }
+    void removeObjectName(DocumentObject* pcObject, const std::string& name)
+    {
+        objectNames.remove(name);
+        boost::unordered_map<const DocumentObject*, std::string>::iterator it = labelOfObject.find(pcObject);
+        if (it != labelOfObject.end()) {
+            objectLabels.remove(it->second);
+            std::pair<boost::unordered_multimap<std::string, DocumentObject*>::iterator,
+                      boost::unordered_multimap<std::string, DocumentObject*>::iterator>
+                range = labelMap.equal_range(it->second);
+            for (; range.first != range.second; ++range.first) {
+                if (range.first->second == pcObject) {
+                    labelMap.erase(range.first);
+                    break;
+                }
+            }
+            labelOfObject.erase(it);
+        }
+    }
+    void updateLabel(const DocumentObject* pcObject)
+    {
+        // only for objects of the document
+        if (labelOfObject.find(pcObject) == labelOfObject.end())
+            return;
+        DocumentObject* obj = const_cast<DocumentObject*>(pcObject);
+        std::string name = obj->getNameInDocument();
+        removeObjectName(obj, name);
+        addObjectName(obj, name);
+    }
+    void clearObjectNames()
+    {
+        objectNames.clear();
+        objectLabels.clear();
+        labelMap.clear();
+        labelOfObject.clear();
     }
 };
 
+// Checks whether the object of the vertex must be recomputed, i.e. either the object
+// itself requests it or one of the objects it depends on is touched.
+static bool mustRecompute(DocumentP* d, Vertex v)
+{
+    // objects added during the recompute are not part of the snapshot
+    DocumentObject* Cur = v < d->vertexMap.size() ? d->vertexMap[v] : 0;
+    if (!Cur)
+        return false;
+#ifdef FC_LOGFEATUREUPDATE
+    std::clog << Cur->getNameInDocument() << " dep on: " ;
+#endif
+
+    // ask the object if it should be recomputed
+    if (Cur->mustExecute() == 1)
+        return true;
+
+    // update if one of the dependencies is touched
+    DependencyList::out_edge_iterator j, jend;
+    for (boost::tie(j, jend) = out_edges(v, d->DepList); j != jend; ++j) {
+        Vertex t = target(*j, d->DepList);
+        DocumentObject* Test = t < d->vertexMap.size() ? d->vertexMap[t] : 0;
+        if (!Test) continue;
+#ifdef FC_LOGFEATUREUPDATE
+        std::clog << Test->getNameInDocument() << ", " ;
+#endif
+        if (Test->isTouched())
+            return true;
+    }
+#ifdef FC_LOGFEATUREUPDATE
+    std::clog << std::endl;
+#endif
+    return false;
+}
+
+// Collects the touched objects and all objects depending on them directly or
+// indirectly in topological order. Returns false if the graph has a cycle.
+// An object whose mustExecute() returns 1 has a touched property and thus is
+// touched itself, so the touched vertices are the starting points.
+static bool sortTouchedDependents(DocumentP* d, std::vector<Vertex>& order)
+{
+    std::size_t numVertices = boost::num_vertices(d->DepList);
+    std::vector<bool> inClosure(numVertices, false);
+    std::vector<Vertex> closure(d->touchedVertices.begin(), d->touchedVertices.end());
+    for (std::vector<Vertex>::iterator it = closure.begin(); it != closure.end(); ++it)
+        inClosure[*it] = true;
+
+    // go upstream along the reverse edges
+    DependencyList::in_edge_iterator ei, ei_end;
+    for (std::size_t i = 0; i < closure.size(); i++) {
+        for (boost::tie(ei, ei_end) = boost::in_edges(closure[i], d->DepList); ei != ei_end; ++ei) {
+            Vertex u = boost::source(*ei, d->DepList);
+            if (!inClosure[u]) {
+                inClosure[u] = true;
+                closure.push_back(u);
+            }
+        }
+    }
+
+    // sort the closure topologically, dependencies first
+    std::vector<std::size_t> pending(numVertices, 0);
+    DependencyList::out_edge_iterator oi, oi_end;
+    for (std::vector<Vertex>::iterator it = closure.begin(); it != closure.end(); ++it) {
+        for (boost::tie(oi, oi_end) = boost::out_edges(*it, d->DepList); oi != oi_end; ++oi) {
+            if (inClosure[boost::target(*oi, d->DepList)])
+                pending[*it]++;
+        }
+    }
+
+    order.clear();
+    order.reserve(closure.size());
+    for (std::vector<Vertex>::iterator it = closure.begin(); it != closure.end(); ++it) {
+        if (pending[*it] == 0)
+            order.push_back(*it);
+    }
+    for (std::size_t i = 0; i < order.size(); i++) {
+        for (boost::tie(ei, ei_end) = boost::in_edges(order[i], d->DepList); ei != ei_end; ++ei) {
+            Vertex u = boost::source(*ei, d->DepList);
+            if (--pending[u] == 0)
+                order.push_back(u);
+        }
+    }
+
+    return order.size() == closure.size();
+}
+
+// Helper structure to recompute an object in a worker thread. The exceptions
+// are caught in the worker and reported afterwards by the thread owning the
+// document because neither the console nor the recompute log are thread-safe.
+struct RecomputeJob
+{
+    enum Status { Success, BaseError, StdError, UserAbort, MemoryError, UnknownError };
+
+    RecomputeJob() : object(0), vertex(0), returnCode(0), status(Success) {}
+
+    DocumentObject* object;
+    Vertex vertex;
+    DocumentObjectExecReturn* returnCode;
+    Status status;
+    std::string what;
+};
+
+// Collects the jobs of a parallel recompute as soon as they are finished
+struct RecomputeQueue
+{
+    QMutex mutex;
+    QWaitCondition finished;
+    std::vector<RecomputeJob*> done;
+};
+
+static bool isLinkProperty(const Property* prop)
+{
+    Base::Type type = prop->getTypeId();
+    return type.isDerivedFrom(PropertyLink::getClassTypeId()) ||
+           type.isDerivedFrom(PropertyLinkSub::getClassTypeId()) ||
+           type.isDerivedFrom(PropertyLinkList::getClassTypeId()) ||
+           type.isDerivedFrom(PropertyLinkSubList::getClassTypeId());
+}
+
+static void runRecomputeJob(RecomputeJob* job, RecomputeQueue* queue)
+{
+    try {
+        job->returnCode = job->object->recompute();
+    }
+    catch (const Base::AbortException& e) {
+        job->status = RecomputeJob::UserAbort;
+        job->what = e.what();
+    }
+    catch (const Base::MemoryException& e) {
+        job->status = RecomputeJob::MemoryError;
+        job->what = e.what();
+    }
+    catch (const Base::Exception& e) {
+        job->status = RecomputeJob::BaseError;
+        job->what = e.what();
+    }
+    catch (const std::exception& e) {
+        job->status = RecomputeJob::StdError;
+        job->what = e.what();
+    }
+    catch (...) {
+        // an exception must never leave a worker thread
+        job->status = RecomputeJob::UnknownError;
+    }
+
+    QMutexLocker locker(&queue->mutex);
+    queue->done.push_back(job);
+    queue->finished.wakeOne();
+}
+
 } // namespace App
 
 PROPERTY_SOURCE(App::Document, App::PropertyContainer)
@@ -476,17 +781,54 @@ void Document::onChanged(const Property* prop)
 
 void Document::onBeforeChangeProperty(const DocumentObject *Who, const Property *What)
 {
+    // while recomputing in parallel this may be called from several threads
+    QMutexLocker locker(d->recomputeThread ? &d->recomputeMutex : 0);
     if (d->activeUndoTransaction && !d->rollback)
         d->activeUndoTransaction->addObjectChange(Who,What);
 }
 
 void Document::onChangedProperty(const DocumentObject *Who, const Property *What)
 {
+    QMutexLocker locker(d->recomputeThread ? &d->recomputeMutex : 0);
     if (d->activeTransaction && !d->rollback)
         d->activeTransaction->addObjectChange(Who,What);
+    // the observers must only be notified from the thread owning the document
+    if (d->recomputeThread && QThread::currentThread() != d->recomputeThread) {
+        d->pendingChanges.push_back(std::make_pair(Who, What));
+        return;
+    }
+    locker.unlock();
+    if (isLinkProperty(What))
+        _updateDependencies(const_cast<DocumentObject*>(Who));
+    else if (What == &Who->Label)
+        d->updateLabel(Who);
     signalChangedObject(*Who, *What);
 }
 
+void Document::onRemovedProperty(const DocumentObject *Who)
+{
+    // as for a changed link the out-edges are rebuilt from the remaining properties
+    _updateDependencies(const_cast<DocumentObject*>(Who));
+}
+
+void Document::_notifyPendingChanges()
+{
+    std::vector<std::pair<const DocumentObject*, const Property*> > changes;
+    {
+        QMutexLocker locker(&d->recomputeMutex);
+        changes.swap(d->pendingChanges);
+    }
+
+    for (std::vector<std::pair<const DocumentObject*, const Property*> >::iterator
+        it = changes.begin(); it != changes.end(); ++it) {
+        if (isLinkProperty(it->second))
+            _updateDependencies(const_cast<DocumentObject*>(it->first));
+        else if (it->second == &it->first->Label)
+            d->updateLabel(it->first);
+        signalChangedObject(*(it->first), *(it->second));
+    }
+}
+
 void Document::setTransactionMode(int iMode)
 {
     /*  if(_iTransactionMode == 0 && iMode == 1)
@@ -906,8 +1248,11 @@ bool Document::saveAs(const char* file)
 // Save the document under the name it has been opened
 bool Document::save (void)
 {
-    int compression = App::GetApplication().GetParameterGroupByPath
-        ("User parameter:BaseApp/Preferences/Document")->GetInt("CompressionLevel",3);
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Document");
+    int compression = hGrp->GetInt("CompressionLevel",3);
+    // the binary format is faster to write and read but cannot be loaded by older versions
+    bool binaryBrep = hGrp->GetBool("SaveBinaryBrep",false);
 
     if (*(FileName.getValue()) != '\0') {
         LastModifiedDate.setValue(Base::TimeInfo::currentDateTimeString());
@@ -927,6 +1272,8 @@ bool Document::save (void)
             writer.setComment("FreeCAD Document");
             writer.setLevel(compression);
             writer.putNextEntry("Document.xml");
+            if (binaryBrep)
+                writer.setMode("BinaryBrep");
 
             Document::Save(writer);
 
@@ -1014,7 +1361,9 @@ void Document::restore (void)
     }
     d->objectArray.clear();
     d->objectMap.clear();
+    d->clearObjectNames();
     d->activeObject = 0;
+    _rebuildDependencyList();
 
     Base::FileInfo fi(FileName.getValue());
     Base::ifstream file(fi, std::ios::in | std::ios::binary);
@@ -1120,11 +1469,35 @@ int Document::countObjects(void) const
    return static_cast<int>(d->objectArray.size());
 }
 
+// Sorts objects by their names like the map of the objects of a document
+struct ObjectNameLess
+{
+    bool operator() (const DocumentObject* a, const DocumentObject* b) const
+    {
+        return std::strcmp(a->getNameInDocument(), b->getNameInDocument()) < 0;
+    }
+};
+
 std::vector<App::DocumentObject*> Document::getInList(const DocumentObject* me) const
 {
     // result list
     std::vector<App::DocumentObject*> result;
-    // go through all objects
+    // the in-edges of an object of the dependency graph are the links to it,
+    // an object linking several times to it has several edges
+    boost::unordered_map<DocumentObject*,Vertex>::const_iterator pos =
+        d->VertexObjectList.find(const_cast<DocumentObject*>(me));
+    if (pos != d->VertexObjectList.end()) {
+        DependencyList::in_edge_iterator ei, ei_end;
+        for (boost::tie(ei, ei_end) = boost::in_edges(pos->second, d->DepList); ei != ei_end; ++ei) {
+            DocumentObject* parent = d->vertexObjects[boost::source(*ei, d->DepList)];
+            if (parent)
+                result.push_back(parent);
+        }
+        std::stable_sort(result.begin(), result.end(), ObjectNameLess());
+        return result;
+    }
+
+    // the object is not part of this document, go through all objects
     for (std::map<std::string,DocumentObject*>::const_iterator It = d->objectMap.begin(); It != d->objectMap.end();++It) {
         // get the outList and search if me is in that list
         std::vector<DocumentObject*> OutList = It->second->getOutList();
@@ -1139,32 +1512,12 @@ std::vector<App::DocumentObject*> Document::getInList(const DocumentObject* me)
 std::vector<App::DocumentObject*>
 Document::getDependencyList(const std::vector<App::DocumentObject*>& objs) const
 {
-    DependencyList DepList;
-    std::map<DocumentObject*,Vertex> ObjectMap;
-    std::map<Vertex,DocumentObject*> VertexMap;
-
-    // Filling up the adjacency List
-    for (std::map<std::string,DocumentObject*>::const_iterator It = d->objectMap.begin(); It != d->objectMap.end();++It) {
-        // add the object as Vertex and remember the index
-        Vertex v = add_vertex(DepList);
-        ObjectMap[It->second] = v;
-        VertexMap[v] = It->second;
-    }
-    // add the edges
-    for (std::map<std::string,DocumentObject*>::const_iterator It = d->objectMap.begin(); It != d->objectMap.end();++It) {
-        std::vector<DocumentObject*> OutList = It->second->getOutList();
-        for (std::vector<DocumentObject*>::const_iterator It2=OutList.begin();It2!=OutList.end();++It2) {
-            if (*It2)
-                add_edge(ObjectMap[It->second],ObjectMap[*It2],DepList);
-        }
-    }
-
     std::list<Vertex> make_order;
     DependencyList::out_edge_iterator j, jend;
 
     try {
         // this sort gives the execute
-        boost::topological_sort(DepList, std::front_inserter(make_order));
+        boost::topological_sort(d->DepList, std::front_inserter(make_order));
     }
     catch (const std::exception&) {
         return std::vector<App::DocumentObject*>();
@@ -1173,11 +1526,11 @@ Document::getDependencyList(const std::vector<App::DocumentObject*>& objs) const
     //std::vector<App::DocumentObject*> out;
     boost::unordered_set<App::DocumentObject*> out;
     for (std::vector<App::DocumentObject*>::const_iterator it = objs.begin(); it != objs.end(); ++it) {
-        std::map<DocumentObject*,Vertex>::iterator jt = ObjectMap.find(*it);
+        boost::unordered_map<DocumentObject*,Vertex>::const_iterator jt = d->VertexObjectList.find(*it);
         // ok, object is part of this graph
-        if (jt != ObjectMap.end()) {
-            for (boost::tie(j, jend) = boost::out_edges(jt->second, DepList); j != jend; ++j) {
-                out.insert(VertexMap[boost::target(*j, DepList)]);
+        if (jt != d->VertexObjectList.end()) {
+            for (boost::tie(j, jend) = boost::out_edges(jt->second, d->DepList); j != jend; ++j) {
+                out.insert(d->vertexObjects[boost::target(*j, d->DepList)]);
             }
             out.insert(*it);
         }
@@ -1188,104 +1541,374 @@ Document::getDependencyList(const std::vector<App::DocumentObject*>& objs) const
     return ary;
 }
 
+bool Document::checkDependencyGraph(void) const
+{
+    bool ok = true;
+    if (d->VertexObjectList.size() != d->objectArray.size()) {
+        Base::Console().Warning("Document '%s': %d objects but %d vertices in the dependency graph\n",
+            getName(), (int)d->objectArray.size(), (int)d->VertexObjectList.size());
+        ok = false;
+    }
+
+    for (std::vector<DocumentObject*>::const_iterator It = d->objectArray.begin(); It != d->objectArray.end(); ++It) {
+        boost::unordered_map<DocumentObject*,Vertex>::const_iterator pos = d->VertexObjectList.find(*It);
+        if (pos == d->VertexObjectList.end() || d->vertexObjects[pos->second] != *It) {
+            Base::Console().Warning("Document '%s': '%s' has no vertex in the dependency graph\n",
+                getName(), (*It)->getNameInDocument());
+            ok = false;
+            continue;
+        }
+
+        // the links to objects of the graph must be the out-edges
+        std::vector<DocumentObject*> links, edges;
+        bool dangling = false;
+        std::vector<DocumentObject*> OutList = (*It)->getOutList();
+        for (std::vector<DocumentObject*>::const_iterator jt = OutList.begin(); jt != OutList.end(); ++jt) {
+            if (d->VertexObjectList.find(*jt) != d->VertexObjectList.end())
+                links.push_back(*jt);
+            else
+                dangling = true;
+        }
+        DependencyList::out_edge_iterator ei, ei_end;
+        for (boost::tie(ei, ei_end) = boost::out_edges(pos->second, d->DepList); ei != ei_end; ++ei)
+            edges.push_back(d->vertexObjects[boost::target(*ei, d->DepList)]);
+
+        std::sort(links.begin(), links.end());
+        std::sort(edges.begin(), edges.end());
+        if (links != edges) {
+            Base::Console().Warning("Document '%s': the links of '%s' don't match the dependency graph\n",
+                getName(), (*It)->getNameInDocument());
+            ok = false;
+        }
+        // links to other objects must be restored when these objects are added
+        if (dangling && d->danglingLinks.find(*It) == d->danglingLinks.end()) {
+            Base::Console().Warning("Document '%s': the links of '%s' to objects outside the graph are not remembered\n",
+                getName(), (*It)->getNameInDocument());
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
 void Document::_rebuildDependencyList(void)
 {
     d->VertexObjectList.clear();
+    d->vertexObjects.clear();
+    d->freeVertices.clear();
+    d->danglingLinks.clear();
+    d->touchedVertices.clear();
     d->DepList.clear();
     // Filling up the adjacency List
-    for (std::map<std::string,DocumentObject*>::const_iterator It = d->objectMap.begin(); It != d->objectMap.end();++It) {
+    for (std::vector<DocumentObject*>::const_iterator It = d->objectArray.begin(); It != d->objectArray.end();++It) {
         // add the object as Vertex and remember the index
-        d->VertexObjectList[It->second] = add_vertex(d->DepList);
+        Vertex v = add_vertex(d->DepList);
+        d->VertexObjectList[*It] = v;
+        d->vertexObjects.push_back(*It);
+        if ((*It)->isTouched())
+            d->touchedVertices.insert(v);
     }
     // add the edges
-    for (std::map<std::string,DocumentObject*>::const_iterator It = d->objectMap.begin(); It != d->objectMap.end();++It) {
-        std::vector<DocumentObject*> OutList = It->second->getOutList();
-        for (std::vector<DocumentObject*>::const_iterator It2=OutList.begin();It2!=OutList.end();++It2) {
-            if (*It2)
-                add_edge(d->VertexObjectList[It->second],d->VertexObjectList[*It2],d->DepList);
-        }
+    for (std::vector<DocumentObject*>::const_iterator It = d->objectArray.begin(); It != d->objectArray.end();++It)
+        _updateDependencies(*It);
+}
+
+void Document::_addVertex(DocumentObject* pcObject)
+{
+    Vertex v;
+    if (d->freeVertices.empty()) {
+        v = add_vertex(d->DepList);
+        d->vertexObjects.push_back(pcObject);
+    }
+    else {
+        v = d->freeVertices.back();
+        d->freeVertices.pop_back();
+        d->vertexObjects[v] = pcObject;
+    }
+
+    d->VertexObjectList[pcObject] = v;
+    if (pcObject->isTouched())
+        d->touchedVertices.insert(v);
+    _updateDependencies(pcObject);
+
+    // objects may already link to the new object, e.g. on undo
+    if (!d->danglingLinks.empty()) {
+        std::vector<DocumentObject*> dangling(d->danglingLinks.begin(), d->danglingLinks.end());
+        for (std::vector<DocumentObject*>::iterator it = dangling.begin(); it != dangling.end(); ++it)
+            _updateDependencies(*it);
     }
 }
 
-void Document::recompute()
+void Document::_removeVertex(DocumentObject* pcObject)
+{
+    boost::unordered_map<DocumentObject*,Vertex>::iterator it = d->VertexObjectList.find(pcObject);
+    if (it == d->VertexObjectList.end())
+        return;
+    Vertex v = it->second;
+
+    // objects still linking to the removed object get their edge back if it is added again
+    DependencyList::in_edge_iterator ei, ei_end;
+    for (boost::tie(ei, ei_end) = boost::in_edges(v, d->DepList); ei != ei_end; ++ei)
+        d->danglingLinks.insert(d->vertexObjects[boost::source(*ei, d->DepList)]);
+    d->danglingLinks.erase(pcObject);
+
+    boost::clear_vertex(v, d->DepList);
+    d->vertexObjects[v] = 0;
+    d->freeVertices.push_back(v);
+    d->touchedVertices.erase(v);
+    d->VertexObjectList.erase(it);
+}
+
+void Document::_updateDependencies(DocumentObject* pcObject)
+{
+    boost::unordered_map<DocumentObject*,Vertex>::iterator it = d->VertexObjectList.find(pcObject);
+    if (it == d->VertexObjectList.end())
+        return;
+    Vertex v = it->second;
+
+    boost::clear_out_edges(v, d->DepList);
+    d->danglingLinks.erase(pcObject);
+    std::vector<DocumentObject*> OutList = pcObject->getOutList();
+    for (std::vector<DocumentObject*>::const_iterator It = OutList.begin(); It != OutList.end(); ++It) {
+        boost::unordered_map<DocumentObject*,Vertex>::iterator jt = d->VertexObjectList.find(*It);
+        if (jt != d->VertexObjectList.end())
+            add_edge(v, jt->second, d->DepList);
+        else
+            d->danglingLinks.insert(pcObject);
+    }
+}
+
+void Document::_setObjectTouched(DocumentObject* pcObject, bool touched)
+{
+    // objects which are removed but kept by the undo stack are not part of the graph
+    boost::unordered_map<DocumentObject*,Vertex>::iterator it = d->VertexObjectList.find(pcObject);
+    if (it == d->VertexObjectList.end())
+        return;
+    // while recomputing in parallel this may be called from several threads
+    QMutexLocker locker(d->recomputeThread ? &d->recomputeMutex : 0);
+    if (touched)
+        d->touchedVertices.insert(it->second);
+    else
+        d->touchedVertices.erase(it->second);
+}
+
+void Document::recompute(bool touchedOnly)
 {
     // delete recompute log
     for( std::vector<App::DocumentObjectExecReturn*>::iterator it=_RecomputeLog.begin();it!=_RecomputeLog.end();++it)
         delete *it;
     _RecomputeLog.clear();
 
-    // updates the dependency graph
-    _rebuildDependencyList();
+    d->recomputeOrder.clear();
+    if (touchedOnly) {
+        if (!sortTouchedDependents(d, d->recomputeOrder)) {
+            std::cerr << "Document::recompute: The graph must be a DAG." << std::endl;
+            return;
+        }
+        if (d->recomputeOrder.empty())
+            return;
+    }
+    else {
+        std::list<Vertex> make_order;
 
-    std::list<Vertex> make_order;
-    DependencyList::out_edge_iterator j, jend;
+        try {
+            // this sort gives the execute
+            boost::topological_sort(d->DepList, std::front_inserter(make_order));
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Document::recompute: " << e.what() << std::endl;
+            return;
+        }
 
-    try {
-        // this sort gives the execute
-        boost::topological_sort(d->DepList, std::front_inserter(make_order));
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Document::recompute: " << e.what() << std::endl;
-        return;
+        d->recomputeOrder.assign(make_order.rbegin(), make_order.rend());
     }
 
     // caching vertex to DocObject
-    for (std::map<DocumentObject*,Vertex>::const_iterator It1= d->VertexObjectList.begin();It1 != d->VertexObjectList.end(); ++It1)
-        d->vertexMap[It1->second] = It1->first;
-
+    d->vertexMap = d->vertexObjects;
+
+    bool parallel = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Document")->GetBool("ParallelRecompute",false);
+    if (parallel) {
+        if (!_recomputeParallel()) {
+            d->vertexMap.clear();
+            return;
+        }
+    }
+    else {
 #ifdef FC_LOGFEATUREUPDATE
-    std::clog << "make ordering: " << std::endl;
+        std::clog << "make ordering: " << std::endl;
 #endif
 
-    for (std::list<Vertex>::reverse_iterator i = make_order.rbegin();i != make_order.rend(); ++i) {
-        DocumentObject* Cur = d->vertexMap[*i];
-        if (!Cur) continue;
+        for (std::vector<Vertex>::iterator i = d->recomputeOrder.begin();i != d->recomputeOrder.end(); ++i) {
+            DocumentObject* Cur = d->vertexMap[*i];
+            // if one touched recompute
+            if (mustRecompute(d, *i)) {
 #ifdef FC_LOGFEATUREUPDATE
-        std::clog << Cur->getNameInDocument() << " dep on: " ;
+                std::clog << "Recompute" << std::endl;
 #endif
-        bool NeedUpdate = false;
-
-        // ask the object if it should be recomputed
-        if (Cur->mustExecute() == 1)
-            NeedUpdate = true;
-        else {// if (Cur->mustExecute() == -1)
-            // update if one of the dependencies is touched
-            for (boost::tie(j, jend) = out_edges(*i, d->DepList); j != jend; ++j) {
-                DocumentObject* Test = d->vertexMap[target(*j, d->DepList)];
-                if (!Test) continue;
-#ifdef FC_LOGFEATUREUPDATE
-                std::clog << Test->getNameInDocument() << ", " ;
-#endif
-                if (Test->isTouched()) {
-                    NeedUpdate = true;
-                    break;
+                if (_recomputeFeature(Cur)) {
+                    // if somthing happen break execution of recompute
+                    d->vertexMap.clear();
+                    return;
                 }
             }
-#ifdef FC_LOGFEATUREUPDATE
-            std::clog << std::endl;
-#endif
-        }
-        // if one touched recompute
-        if (NeedUpdate) {
-#ifdef FC_LOGFEATUREUPDATE
-            std::clog << "Recompute" << std::endl;
-#endif
-            if (_recomputeFeature(Cur)) {
-                // if somthing happen break execution of recompute
-                d->vertexMap.clear();
-                return;
-            }
         }
     }
 
     // reset all touched
-    for (std::map<Vertex,DocumentObject*>::iterator it = d->vertexMap.begin(); it != d->vertexMap.end(); ++it) {
-        if (it->second)
-            it->second->purgeTouched();
+    for (std::vector<Vertex>::iterator it = d->recomputeOrder.begin(); it != d->recomputeOrder.end(); ++it) {
+        if (d->vertexMap[*it])
+            d->vertexMap[*it]->purgeTouched();
     }
     d->vertexMap.clear();
 }
 
+/**
+ * Recomputes the objects of the recompute order on the global thread pool. An object
+ * is scheduled as soon as all objects it depends on are processed so that independent
+ * branches of the graph are recomputed concurrently. Objects that are not thread-safe
+ * are recomputed in the calling thread. Returns false if the recompute was aborted.
+ */
+bool Document::_recomputeParallel(void)
+{
+    std::size_t numVertices = boost::num_vertices(d->DepList);
+    std::vector<bool> scheduled(numVertices, false);
+    for (std::vector<Vertex>::iterator it = d->recomputeOrder.begin(); it != d->recomputeOrder.end(); ++it)
+        scheduled[*it] = true;
+
+    // count the dependencies of each vertex and collect the vertices depending on it
+    std::vector<std::size_t> pending(numVertices, 0);
+    std::vector< std::vector<Vertex> > dependents(numVertices);
+    DependencyList::in_edge_iterator ei, ei_end;
+    for (std::vector<Vertex>::iterator it = d->recomputeOrder.begin(); it != d->recomputeOrder.end(); ++it) {
+        for (boost::tie(ei, ei_end) = boost::in_edges(*it, d->DepList); ei != ei_end; ++ei) {
+            Vertex u = boost::source(*ei, d->DepList);
+            if (scheduled[u]) {
+                pending[u]++;
+                dependents[*it].push_back(u);
+            }
+        }
+    }
+
+    // process ready vertices in ascending order to keep the scheduling deterministic
+    std::set<Vertex> ready;
+    for (std::vector<Vertex>::iterator it = d->recomputeOrder.begin(); it != d->recomputeOrder.end(); ++it) {
+        if (pending[*it] == 0)
+            ready.insert(*it);
+    }
+
+    std::vector<RecomputeJob> jobs(numVertices);
+    std::vector<Vertex> finished;
+    RecomputeQueue queue;
+    int running = 0;
+    bool abort = false;
+    // modules prepare their libraries for the use from several threads
+    GetApplication().signalParallelRecompute(*this);
+    d->recomputeThread = QThread::currentThread();
+
+    for (;;) {
+        // release the dependents of the processed vertices
+        for (std::vector<Vertex>::iterator it = finished.begin(); it != finished.end(); ++it) {
+            for (std::vector<Vertex>::iterator jt = dependents[*it].begin(); jt != dependents[*it].end(); ++jt) {
+                if (--pending[*jt] == 0)
+                    ready.insert(*jt);
+            }
+        }
+        finished.clear();
+
+        // after an abort only wait for the already running jobs
+        if (abort)
+            ready.clear();
+        if (ready.empty() && running == 0)
+            break;
+
+        if (!ready.empty()) {
+            Vertex v = *ready.begin();
+            ready.erase(ready.begin());
+            DocumentObject* Cur = d->vertexMap[v];
+            if (!mustRecompute(d, v)) {
+                finished.push_back(v);
+            }
+            else if (!Cur->isThreadSafe()) {
+                if (_recomputeFeature(Cur))
+                    abort = true;
+                finished.push_back(v);
+            }
+            else {
+                jobs[v].object = Cur;
+                jobs[v].vertex = v;
+                QtConcurrent::run(runRecomputeJob, &jobs[v], &queue);
+                running++;
+            }
+            continue;
+        }
+
+        // wait until at least one job is finished
+        std::vector<RecomputeJob*> done;
+        {
+            QMutexLocker locker(&queue.mutex);
+            while (queue.done.empty())
+                queue.finished.wait(&queue.mutex);
+            done.swap(queue.done);
+        }
+
+        _notifyPendingChanges();
+
+        for (std::vector<RecomputeJob*>::iterator it = done.begin(); it != done.end(); ++it) {
+            RecomputeJob* job = *it;
+            DocumentObject* Feat = job->object;
+            running--;
+            finished.push_back(job->vertex);
+
+            switch (job->status) {
+            case RecomputeJob::Success:
+                if (job->returnCode == DocumentObject::StdReturn) {
+                    Feat->resetError();
+                }
+                else {
+                    job->returnCode->Which = Feat;
+                    _RecomputeLog.push_back(job->returnCode);
+                    Base::Console().Error("%s\n",job->returnCode->Why.c_str());
+                    Feat->setError();
+                }
+                break;
+            case RecomputeJob::UserAbort:
+                Base::Console().Error("%s\n",job->what.c_str());
+                _RecomputeLog.push_back(new DocumentObjectExecReturn("User abort",Feat));
+                Feat->setError();
+                abort = true;
+                break;
+            case RecomputeJob::MemoryError:
+                Base::Console().Error("Memory exception in feature '%s' thrown: %s\n",Feat->getNameInDocument(),job->what.c_str());
+                _RecomputeLog.push_back(new DocumentObjectExecReturn("Out of memory exception",Feat));
+                Feat->setError();
+                abort = true;
+                break;
+            case RecomputeJob::BaseError:
+                Base::Console().Error("%s\n",job->what.c_str());
+                _RecomputeLog.push_back(new DocumentObjectExecReturn(job->what,Feat));
+                Feat->setError();
+                break;
+            case RecomputeJob::StdError:
+                Base::Console().Warning("exception in Feature \"%s\" thrown: %s\n",Feat->getNameInDocument(),job->what.c_str());
+                _RecomputeLog.push_back(new DocumentObjectExecReturn(job->what,Feat));
+                Feat->setError();
+                break;
+            case RecomputeJob::UnknownError:
+                Base::Console().Error("App::Document::_recomputeParallel(): Unknown exception in Feature \"%s\" thrown\n",Feat->getNameInDocument());
+                _RecomputeLog.push_back(new DocumentObjectExecReturn("Unknown exeption!",Feat));
+                Feat->setError();
+                abort = true;
+                break;
+            }
+        }
+    }
+
+    d->recomputeThread = 0;
+    _notifyPendingChanges();
+    return !abort;
+}
+
 const char * Document::getErrorDescription(const App::DocumentObject*Obj) const
 {
     for (std::vector<App::DocumentObjectExecReturn*>::const_iterator it=_RecomputeLog.begin();it!=_RecomputeLog.end();++it)
@@ -1403,8 +2026,9 @@ DocumentObject * Document::addObject(const char* sType, const char* pObjectName)
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
     // insert in the vector
     d->objectArray.push_back(pcObject);
-    // insert in the adjacence list and referenc through the ConectionMap
-    //_DepConMap[pcObject] = add_vertex(_DepList);
+    // insert in the adjacence list
+    _addVertex(pcObject);
+    d->addObjectName(pcObject, ObjectName);
 
     pcObject->Label.setValue( ObjectName );
 
@@ -1423,6 +2047,8 @@ void Document::_addObject(DocumentObject* pcObject, const char* pObjectName)
     d->objectArray.push_back(pcObject);
     // cache the pointer to the name string in the Object (for performance of DocumentObject::getNameInDocument())
     pcObject->pcNameInDocument = &(d->objectMap.find(pObjectName)->first);
+    _addVertex(pcObject);
+    d->addObjectName(pcObject, pObjectName);
 
     // do no transactions if we do a rollback!
     if(!d->rollback){
@@ -1454,16 +2080,14 @@ void Document::remObject(const char* sName)
     signalDeletedObject(*(pos->second));
     if (!d->vertexMap.empty()) {
         // recompute of document is running
-        for (std::map<Vertex,DocumentObject*>::iterator it = d->vertexMap.begin(); it != d->vertexMap.end(); ++it) {
-            if (it->second == pos->second) {
-                it->second = 0; // just nullify the pointer
-                break;
-            }
-        }
+        std::vector<DocumentObject*>::iterator it = std::find(d->vertexMap.begin(), d->vertexMap.end(), pos->second);
+        if (it != d->vertexMap.end())
+            *it = 0; // just nullify the pointer
     }
 
     // Before deleting we must nullify all dependant objects
     breakDependency(pos->second, true);
+    _removeVertex(pos->second);
 
     // do no transactions if we do a rollback!
     if(!d->rollback){
@@ -1490,9 +2114,7 @@ void Document::remObject(const char* sName)
             break;
         }
     }
-    // remove from adjancy list
-    //remove_vertex(_DepConMap[pos->second],_DepList);
-    //_DepConMap.erase(pos->second);
+    d->removeObjectName(pos->second, pos->first);
     d->objectMap.erase(pos);
 }
 
@@ -1519,7 +2141,9 @@ void Document::_remObject(DocumentObject* pcObject)
             d->activeUndoTransaction->addObjectNew(pcObject);
     }
     // remove from map
+    d->removeObjectName(pcObject, pos->first);
     d->objectMap.erase(pos);
+    _removeVertex(pcObject);
     //// set name cache false
     //pcObject->pcNameInDocument = 0;
 
@@ -1533,10 +2157,15 @@ void Document::_remObject(DocumentObject* pcObject)
 
 void Document::breakDependency(DocumentObject* pcObject, bool clear)
 {
-    // Nullify all dependant objects
-    for (std::map<std::string,DocumentObject*>::iterator it = d->objectMap.begin(); it != d->objectMap.end(); ++it) {
+    // Nullify all dependant objects, only the objects linking to it and the
+    // object itself can have a link to be changed
+    std::vector<DocumentObject*> objs = getInList(pcObject);
+    objs.erase(std::unique(objs.begin(), objs.end()), objs.end());
+    if (clear && std::find(objs.begin(), objs.end(), pcObject) == objs.end())
+        objs.push_back(pcObject);
+    for (std::vector<DocumentObject*>::iterator it = objs.begin(); it != objs.end(); ++it) {
         std::map<std::string,App::Property*> Map;
-        it->second->getPropertyMap(Map);
+        (*it)->getPropertyMap(Map);
         // search for all properties that could have a link to the object
         for (std::map<std::string,App::Property*>::iterator pt = Map.begin(); pt != Map.end(); ++pt) {
             if (pt->second->getTypeId().isDerivedFrom(PropertyLink::getClassTypeId())) {
@@ -1773,26 +2402,24 @@ std::string Document::getUniqueObjectName(const char *Name) const
         return CleanName;
     }
     else {
-        std::vector<std::string> names;
-        names.reserve(d->objectMap.size());
-        for (pos = d->objectMap.begin();pos != d->objectMap.end();++pos) {
-            names.push_back(pos->first);
-        }
-        return Base::Tools::getUniqueName(CleanName, names, 3);
+        return d->objectNames.getUniqueName(CleanName, 3);
     }
 }
 
 std::string Document::getStandardObjectName(const char *Name, int d) const
 {
-    std::vector<App::DocumentObject*> mm = getObjects();
-    std::vector<std::string> labels;
-    labels.reserve(mm.size());
+    return this->d->objectLabels.getUniqueName(Name, d);
+}
 
-    for (std::vector<App::DocumentObject*>::const_iterator it = mm.begin(); it != mm.end(); ++it) {
-        std::string label = (*it)->Label.getValue();
-        labels.push_back(label);
-    }
-    return Base::Tools::getUniqueName(Name, labels, d);
+std::vector<DocumentObject*> Document::getObjectsByLabel(const std::string& label) const
+{
+    std::vector<DocumentObject*> objs;
+    std::pair<boost::unordered_multimap<std::string, DocumentObject*>::const_iterator,
+              boost::unordered_multimap<std::string, DocumentObject*>::const_iterator>
+        range = d->labelMap.equal_range(label);
+    for (; range.first != range.second; ++range.first)
+        objs.push_back(range.first->second);
+    return objs;
 }
 
 std::vector<DocumentObject*> Document::getObjects() const
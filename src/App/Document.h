@@ -182,6 +182,8 @@ public:
     std::string getUniqueObjectName(const char *Name) const;
     /// Returns a name of the form prefix_number. d specifies the number of digits.
     std::string getStandardObjectName(const char *Name, int d) const;
+    /// Returns the objects with the given label
+    std::vector<DocumentObject*> getObjectsByLabel(const std::string& label) const;
     /// Returns a list of all Objects
     std::vector<DocumentObject*> getObjects() const;
     std::vector<DocumentObject*> getObjectsOfType(const Base::Type& typeId) const;
@@ -206,8 +208,13 @@ public:
     void setClosable(bool);
     /// check whether the document can be closed
     bool isClosable() const;
-    /// Recompute all touched features
-    void recompute();
+    /** Recompute all touched features
+     * If \a touchedOnly is true then only the touched objects and the objects depending
+     * on them are visited instead of the whole dependency graph.
+     * If the parameter 'ParallelRecompute' of the document preferences is set then
+     * independent branches of the dependency graph are recomputed concurrently.
+     */
+    void recompute(bool touchedOnly=false);
     /// Recompute only one feature
     void recomputeFeature(DocumentObject* Feat);
     /// get the error log from the recompute run
@@ -265,6 +272,10 @@ public:
     bool checkOnCycle(void);
     /// get a list of all objects linking to the given object
     std::vector<App::DocumentObject*> getInList(const DocumentObject* me) const;
+    /** Checks if the dependency graph matches the links of all objects, the
+     * differences are reported as warnings. Returns true if both match.
+     */
+    bool checkDependencyGraph(void) const;
     /// Get a complete list of all objects the given objects depend on. The list
     /// also contains the given objects!
     std::vector<App::DocumentObject*> getDependencyList
@@ -303,11 +314,25 @@ protected:
     void onBeforeChangeProperty(const DocumentObject *Who, const Property *What);
     /// callback from the Document objects after property was changed
     void onChangedProperty(const DocumentObject *Who, const Property *What);
+    /// callback from the Document objects after a dynamic property was removed
+    void onRemovedProperty(const DocumentObject *Who);
     /// helper which Recompute only this feature
     bool _recomputeFeature(DocumentObject* Feat);
+    /// helper which recomputes the dependency graph using several threads
+    bool _recomputeParallel(void);
+    /// notify the property changes made by worker threads
+    void _notifyPendingChanges(void);
     void _clearRedos();
-    /// refresh the internal dependency graph
+    /// rebuild the internal dependency graph from scratch
     void _rebuildDependencyList(void);
+    /// add the object to the dependency graph
+    void _addVertex(DocumentObject* pcObject);
+    /// remove the object from the dependency graph
+    void _removeVertex(DocumentObject* pcObject);
+    /// refresh the edges of the object in the dependency graph after a link has changed
+    void _updateDependencies(DocumentObject* pcObject);
+    /// keep track of the touched objects of the dependency graph
+    void _setObjectTouched(DocumentObject* pcObject, bool touched);
     std::string getTransientDirectoryName(const std::string& uuid, const std::string& filename) const;
 
 
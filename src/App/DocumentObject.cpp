@@ -188,7 +188,13 @@ void DocumentObject::onChanged(const Property* prop)
     if (prop->getType() & Prop_Output)
         return;
     // set object touched
-    StatusBits.set(0);
+    touch();
+}
+
+void DocumentObject::onRemovedDynamicProperty(void)
+{
+    if (_pDoc)
+        _pDoc->onRemovedProperty(this);
 }
 
 PyObject *DocumentObject::getPyObject(void)
@@ -209,6 +215,23 @@ std::vector<PyObject *> DocumentObject::getPySubObjects(const std::vector<std::s
 void DocumentObject::touch(void)
 {
     StatusBits.set(0);
+    if (_pDoc)
+        _pDoc->_setObjectTouched(this, true);
+}
+
+void DocumentObject::purgeTouched(void)
+{
+    StatusBits.reset(0);
+    setPropertyStatus(0,false);
+    if (_pDoc)
+        _pDoc->_setObjectTouched(this, false);
+}
+
+void DocumentObject::setStatus(ObjectStatus pos, bool on)
+{
+    StatusBits.set((size_t)pos, on);
+    if (pos == Touch && _pDoc)
+        _pDoc->_setObjectTouched(this, on);
 }
 
 void DocumentObject::Save (Base::Writer &writer) const
@@ -100,7 +100,7 @@ public:
     /// test if this feature is touched
     bool isTouched(void) const {return StatusBits.test(0);}
     /// reset this feature touched
-    void purgeTouched(void){StatusBits.reset(0);setPropertyStatus(0,false);}
+    void purgeTouched(void);
     /// set this feature to error
     bool isError(void) const {return  StatusBits.test(1);}
     bool isValid(void) const {return !StatusBits.test(1);}
@@ -112,10 +112,16 @@ public:
     bool isRestoring() const {return StatusBits.test(4);}
     /// recompute only this object
     virtual App::DocumentObjectExecReturn *recompute(void);
+    /** Returns true if the object can be recomputed in a worker thread while other
+     * objects of the document are recomputed, too. Only sub-classes whose execute()
+     * has been checked to be reentrant may return true, all others are recomputed in
+     * the thread owning the document.
+     */
+    virtual bool isThreadSafe(void) const {return false;}
     /// return the status bits
     unsigned long getStatus() const {return StatusBits.to_ulong();}
     bool testStatus(ObjectStatus pos) const {return StatusBits.test((size_t)pos);}
-    void setStatus(ObjectStatus pos, bool on) {StatusBits.set((size_t)pos, on);}
+    void setStatus(ObjectStatus pos, bool on);
     //@}
 
     /// returns a list of objects this object is pointing to by Links
@@ -191,6 +197,8 @@ protected:
     virtual void onBeforeChange(const Property* prop);
     /// get called by the container when a property was changed
     virtual void onChanged(const Property* prop);
+    /// get called by the container after a dynamic property was removed
+    void onRemovedDynamicProperty(void);
     /// get called after a document has been fully restored
     virtual void onDocumentRestored() {}
     /// get called after duplicating an object
@@ -289,12 +289,20 @@ PyObject*  DocumentPy::clearUndos(PyObject * args)
 
 PyObject*  DocumentPy::recompute(PyObject * args)
 {
-    if (!PyArg_ParseTuple(args, ""))     // convert args: Python->C 
+    PyObject *touched=Py_False;
+    if (!PyArg_ParseTuple(args, "|O!",&PyBool_Type,&touched))     // convert args: Python->C 
         return NULL;                    // NULL triggers exception 
-    getDocumentPtr()->recompute();
+    getDocumentPtr()->recompute(PyObject_IsTrue(touched) ? true : false);
     Py_Return;
 }
 
+PyObject*  DocumentPy::checkDependencyGraph(PyObject * args)
+{
+    if (!PyArg_ParseTuple(args, ""))     // convert args: Python->C 
+        return NULL;                    // NULL triggers exception 
+    return PyBool_FromLong(getDocumentPtr()->checkDependencyGraph() ? 1 : 0);
+}
+
 PyObject*  DocumentPy::getObject(PyObject *args)
 {
     char *sName;
@@ -85,6 +85,10 @@ public:
     virtual DocumentObjectExecReturn *execute(void) {
         return imp->execute();
     }
+    /// the Python interpreter must only be used from the main thread
+    virtual bool isThreadSafe(void) const {
+        return false;
+    }
     /// returns the type name of the ViewProvider
     virtual const char* getViewProviderName(void) const {
         return FeatureT::getViewProviderName();
@@ -100,7 +104,11 @@ public:
         return props->addDynamicProperty(type, name, group, doc, attr, ro, hidden);
     }
     virtual bool removeDynamicProperty(const char* name) {
-        return props->removeDynamicProperty(name);
+        if (!props->removeDynamicProperty(name))
+            return false;
+        // the removed property may have been a link
+        this->onRemovedDynamicProperty();
+        return true;
     }
     std::vector<std::string> getDynamicPropertyNames() const {
         return props->getDynamicPropertyNames();
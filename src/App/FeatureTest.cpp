@@ -25,6 +25,7 @@
 #ifndef _PreComp_
 #endif
 
+#include <QThread>
 
 #include <Base/Console.h>
 #include <Base/Exception.h>
@@ -43,6 +44,7 @@ const PropertyFloatConstraint::Constraints floatPercent = {0.0,100.0,1.0};
 
 
 FeatureTest::FeatureTest()
+  : mainThread(QThread::currentThread())
 {
   ADD_PROPERTY(Integer,(4711)  );
   ADD_PROPERTY(Float  ,(47.11f) );
@@ -85,6 +87,8 @@ FeatureTest::FeatureTest()
   ADD_PROPERTY_TYPE(ExecResult    ,("empty"),group,Prop_None,"Result of the execution");
   ADD_PROPERTY_TYPE(ExceptionType ,(0),group,Prop_None,"The type of exception the execution method throws");
   ADD_PROPERTY_TYPE(ExecCount     ,(0),group,Prop_None,"Number of executions");
+  ADD_PROPERTY_TYPE(ThreadSafe    ,(false),group,Prop_None,"Whether the feature may be recomputed in a worker thread");
+  ADD_PROPERTY_TYPE(ExecInMainThread,(false),group,Prop_None,"Whether the last execution ran in the thread which created the feature");
   
   // properties with types
   ADD_PROPERTY_TYPE(TypeHidden  ,(4711),group,Prop_Hidden,"An example property which has the type 'Hidden'"  );
@@ -111,6 +115,7 @@ DocumentObjectExecReturn *FeatureTest::execute(void)
     case 2: throw Base::Exception("FeatureTestException::execute(): Testexception");
   }
   ExecCount.setValue(ExecCount.getValue() + 1);
+  ExecInMainThread.setValue(QThread::currentThread() == mainThread);
 
   ExecResult.setValue("Exec");
 
@@ -118,6 +123,12 @@ DocumentObjectExecReturn *FeatureTest::execute(void)
 }
 
 
+bool FeatureTest::isThreadSafe(void) const
+{
+  return ThreadSafe.getValue();
+}
+
+
 PROPERTY_SOURCE(App::FeatureTestException, App::FeatureTest)
 
 
@@ -31,6 +31,8 @@
 #include "PropertyGeo.h"
 #include "PropertyLinks.h"
 
+class QThread;
+
 namespace App
 {
 
@@ -86,6 +88,8 @@ public:
   App::PropertyString   ExecResult;
   App::PropertyInteger  ExceptionType;
   App::PropertyInteger  ExecCount;
+  App::PropertyBool     ThreadSafe;
+  App::PropertyBool     ExecInMainThread;
   
   App::PropertyInteger   TypeHidden;
   App::PropertyInteger   TypeReadOnly;
@@ -97,12 +101,18 @@ public:
   //@{
   /// recalculate the Feature
   virtual DocumentObjectExecReturn *execute(void);
+  /// the property 'ThreadSafe' decides whether the feature may run in a worker thread
+  virtual bool isThreadSafe(void) const;
   /// returns the type name of the ViewProvider
   //FIXME: Propably it makes sense to have a view provider for unittests (e.g. Gui::ViewProviderTest)
   virtual const char* getViewProviderName(void) const {
     return "Gui::ViewProviderFeature";
   }
   //@}
+
+private:
+  // the thread the feature was created in
+  QThread* mainThread;
 };
 
 /// The exception testing feature
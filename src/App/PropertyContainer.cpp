@@ -25,7 +25,11 @@
 
 #ifndef _PreComp_
 # include <cassert>
+# include <climits>
+# include <cstring>
 # include <algorithm>
+# include <boost/unordered_map.hpp>
+# include <boost/functional/hash.hpp>
 #endif
 
 /// Here the FreeCAD includes sorted by Base,App,Gui......
@@ -260,14 +264,64 @@ void PropertyContainer::Restore(Base::XMLReader &reader)
     reader.readEndElement("Properties");
 }
 
-void PropertyData::addProperty(const PropertyContainer *container,const char* PropName, Property *Prop, const char* PropertyGroup , PropertyType Type, const char* PropertyDocu)
+namespace App {
+struct PropertyDataIndex
+{
+  struct NameHash
+  {
+    std::size_t operator() (const char* s) const
+    { return boost::hash_range(s, s + std::strlen(s)); }
+  };
+  struct NameEqual
+  {
+    bool operator() (const char* a, const char* b) const
+    { return std::strcmp(a, b) == 0; }
+  };
+  // a name hashed once for the lookups in all parent classes
+  struct HashedName
+  {
+    std::size_t operator() (const char*) const
+    { return value; }
+    std::size_t value;
+  };
+  typedef boost::unordered_map<const char*, std::size_t, NameHash, NameEqual> NameMap;
+  typedef boost::unordered_map<short, std::size_t> OffsetMap;
+
+  NameMap nameIndex;
+  OffsetMap offsetIndex;
+};
+}
+
+PropertyData::PropertyData()
+  : parentPropertyData(0), index(new PropertyDataIndex)
+{
+}
+
+PropertyData::PropertyData(const PropertyData& that)
+  : propertyData(that.propertyData), parentPropertyData(that.parentPropertyData),
+    index(new PropertyDataIndex(*that.index))
+{
+}
+
+PropertyData::~PropertyData()
+{
+  delete index;
+}
+
+PropertyData& PropertyData::operator=(const PropertyData& that)
 {
-  bool IsIn = false;
-  for (vector<PropertySpec>::const_iterator It = propertyData.begin(); It != propertyData.end(); ++It)
-    if(strcmp(It->Name,PropName)==0)
-      IsIn = true;
+  if (this != &that) {
+    propertyData = that.propertyData;
+    parentPropertyData = that.parentPropertyData;
+    *index = *that.index;
+  }
+  return *this;
+}
 
-  if( !IsIn )
+void PropertyData::addProperty(const PropertyContainer *container,const char* PropName, Property *Prop, const char* PropertyGroup , PropertyType Type, const char* PropertyDocu)
+{
+  // the properties are added by each constructor call, keep only the first
+  if (index->nameIndex.find(PropName) == index->nameIndex.end())
   {
     PropertySpec temp;
     temp.Name   = PropName;
@@ -275,32 +329,39 @@ void PropertyData::addProperty(const PropertyContainer *container,const char* Pr
     temp.Group  = PropertyGroup;
     temp.Type   = Type;
     temp.Docu   = PropertyDocu;
+    index->nameIndex[temp.Name] = propertyData.size();
+    index->offsetIndex.insert(std::make_pair(temp.Offset, propertyData.size()));
     propertyData.push_back(temp);
   }
 }
 
 const PropertyData::PropertySpec *PropertyData::findProperty(const PropertyContainer *container,const char* PropName) const
 {
-  for (vector<PropertyData::PropertySpec>::const_iterator It = propertyData.begin(); It != propertyData.end(); ++It)
-    if(strcmp(It->Name,PropName)==0)
-      return &(*It);
+  PropertyDataIndex::HashedName hash;
+  hash.value = PropertyDataIndex::NameHash()(PropName);
+  for (const PropertyData* data = this; data; data = data->parentPropertyData) {
+    PropertyDataIndex::NameMap::const_iterator
+      It = data->index->nameIndex.find(PropName, hash, PropertyDataIndex::NameEqual());
+    if (It != data->index->nameIndex.end())
+      return &data->propertyData[It->second];
+  }
 
-  if(parentPropertyData)
-      return parentPropertyData->findProperty(container,PropName);
- 
   return 0;
 }
 
 const PropertyData::PropertySpec *PropertyData::findProperty(const PropertyContainer *container,const Property* prop) const
 {
   const int diff = (int) ((char*)prop - (char*)container);
+  // not a member of the container
+  if (diff < 0 || diff > SHRT_MAX)
+    return 0;
 
-  for (vector<PropertyData::PropertySpec>::const_iterator It = propertyData.begin(); It != propertyData.end(); ++It)
-    if(diff == It->Offset)
-      return &(*It);
-  
-  if(parentPropertyData)
-      return parentPropertyData->findProperty(container,prop);
+  for (const PropertyData* data = this; data; data = data->parentPropertyData) {
+    PropertyDataIndex::OffsetMap::const_iterator
+      It = data->index->offsetIndex.find((short)diff);
+    if (It != data->index->offsetIndex.end())
+      return &data->propertyData[It->second];
+  }
 
   return 0;
 }
@@ -37,6 +37,7 @@ namespace App
 class Property;
 class PropertyContainer;
 class DocumentObject;
+struct PropertyDataIndex;
 
 enum PropertyType 
 {
@@ -56,9 +57,16 @@ struct AppExport PropertyData
     const char * Docu;
     short Offset,Type;
   };
+  PropertyData();
+  PropertyData(const PropertyData&);
+  ~PropertyData();
+  PropertyData& operator=(const PropertyData&);
+
   // vector of all properties
   std::vector<PropertySpec> propertyData;
   const PropertyData *parentPropertyData;
+  // positions of the properties in propertyData by name and by offset
+  PropertyDataIndex *index;
 
   void addProperty(const PropertyContainer *container,const char* PropName, Property *Prop, const char* PropertyGroup= 0, PropertyType = Prop_None, const char* PropertyDocu= 0 );
 
@@ -0,0 +1,283 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent[at]local>                             *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef BASE_POINTHASH_H
+#define BASE_POINTHASH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "Vector3D.h"
+
+namespace Base
+{
+
+/**
+ * A spatial hash to find duplicated points. Two points are considered to be equal if
+ * each of their coordinates differs by less than the tolerance. This is the same criterion
+ * as the fuzzy operator < of e.g. MeshCore::MeshPoint that is used to weld points with a
+ * std::set, but searching and inserting a point takes constant time.
+ *
+ * The space is divided into cubic cells with an edge length of a multiple of the tolerance
+ * and the points are kept in an open addressing table over the hash values of their cells.
+ * To find a point its own cell is searched and its neighbour cells only if the point is
+ * closer to their border than the tolerance. With a tolerance of zero only points with
+ * identical coordinates are equal and each point has a cell of its own.
+ */
+template <class _Precision>
+class PointHash
+{
+public:
+    typedef Vector3<_Precision> Point;
+    /// A cell of the grid, the coordinates are integral numbers.
+    struct Cell
+    {
+        double c[3];
+    };
+    static const std::size_t npos = ~std::size_t(0);
+
+    PointHash(_Precision tolerance) : _tolerance(tolerance), _numSlots(0)
+    {
+        if (_tolerance > 0) {
+            _cellSize = 8.0 * double(_tolerance);
+            _border = 0.125;
+        }
+        else {
+            // only points with identical coordinates are equal
+            _tolerance = 0;
+            _cellSize = 0.0;
+            _border = 0.0;
+        }
+    }
+
+    /// Reserves memory for \a numPoints points.
+    void reserve(std::size_t numPoints)
+    {
+        _points.reserve(numPoints);
+        std::size_t size = 16;
+        while (size < 2 * numPoints)
+            size *= 2;
+        if (size > _table.size())
+            rehash(size);
+    }
+    /// Returns the number of points.
+    std::size_t size() const
+    {
+        return _points.size();
+    }
+    /// Returns the points in the order they were added.
+    const std::vector<Point>& getPoints() const
+    {
+        return _points;
+    }
+    const Point& operator[] (std::size_t index) const
+    {
+        return _points[index];
+    }
+
+    /** Returns the index of a point equal to \a p. If there is none \a p is added. */
+    std::size_t insert(const Point& p)
+    {
+        Cell cells[8];
+        int count = getCells(p, cells);
+        for (int i=0; i<count; i++) {
+            std::size_t index = find(p, cells[i]);
+            if (index != npos)
+                return index;
+        }
+        return add(p, hash(cells[0]));
+    }
+    /** Returns the index of a point equal to \a p or npos if there is none. */
+    std::size_t find(const Point& p) const
+    {
+        Cell cells[8];
+        int count = getCells(p, cells);
+        for (int i=0; i<count; i++) {
+            std::size_t index = find(p, cells[i]);
+            if (index != npos)
+                return index;
+        }
+        return npos;
+    }
+    /** Returns the index of a point equal to \a p stored in the cell \a c or npos
+     * if there is none.
+     */
+    std::size_t find(const Point& p, const Cell& c) const
+    {
+        if (_table.empty())
+            return npos;
+        std::size_t mask = _table.size() - 1;
+        for (std::size_t i = hash(c) & mask; _table[i].index != npos; i = (i + 1) & mask) {
+            if (isEqual(_table[i], p))
+                return _table[i].index;
+        }
+        return npos;
+    }
+    /** Adds \a p without checking for an equal point and returns its index. */
+    std::size_t append(const Point& p)
+    {
+        return add(p, hash(getCell(p)));
+    }
+
+    /// Returns the cell containing \a p.
+    Cell getCell(const Point& p) const
+    {
+        Cell c;
+        c.c[0] = toCell(p.x);
+        c.c[1] = toCell(p.y);
+        c.c[2] = toCell(p.z);
+        return c;
+    }
+    /** Gets the cells that may contain points equal to \a p, the first one is the cell
+     * of \a p. Returns the number of cells which is 1, 2, 4 or 8.
+     */
+    int getCells(const Point& p, Cell cells[8]) const
+    {
+        if (_cellSize == 0) {
+            cells[0] = getCell(p);
+            return 1;
+        }
+
+        const double v[3] = { double(p.x) / _cellSize, double(p.y) / _cellSize, double(p.z) / _cellSize };
+        for (int i=0; i<3; i++) {
+            // adding 0 turns -0 into +0
+            cells[0].c[i] = std::floor(v[i]) + 0.0;
+        }
+
+        int count = 1;
+        for (int i=0; i<3; i++) {
+            double c = cells[0].c[i];
+            double f = v[i] - c;
+            if (f < _border)
+                c -= 1.0;
+            else if (f > 1.0 - _border)
+                c += 1.0;
+            else
+                continue;
+            // duplicate the cells found so far with the neighbour coordinate
+            for (int j=0; j<count; j++) {
+                cells[count+j] = cells[j];
+                cells[count+j].c[i] = c;
+            }
+            count *= 2;
+        }
+        return count;
+    }
+    /// Returns the hash value of a cell.
+    static std::size_t hash(const Cell& c)
+    {
+        unsigned int h = 0;
+        for (int i=0; i<3; i++)
+            mix(h, c.c[i]);
+        return h;
+    }
+
+private:
+    /// The slots keep a copy of the coordinates to avoid an access to the point array.
+    struct Slot
+    {
+        _Precision x, y, z;
+        std::size_t index;
+    };
+
+    double toCell(_Precision v) const
+    {
+        // adding 0 turns -0 into +0
+        if (_cellSize == 0)
+            return double(v) + 0.0;
+        return std::floor(double(v) / _cellSize) + 0.0;
+    }
+    bool isEqual(const Slot& s, const Point& p) const
+    {
+        _Precision dx = std::fabs(s.x - p.x);
+        _Precision dy = std::fabs(s.y - p.y);
+        _Precision dz = std::fabs(s.z - p.z);
+        return (dx < _tolerance || dx == 0) &&
+               (dy < _tolerance || dy == 0) &&
+               (dz < _tolerance || dz == 0);
+    }
+    static void mix(unsigned int& h, double v)
+    {
+        unsigned int w[2];
+        std::memcpy(w, &v, sizeof(w));
+        for (int i=0; i<2; i++) {
+            // finalizer of MurmurHash3
+            h ^= w[i];
+            h ^= h >> 16;
+            h *= 0x85ebca6bu;
+            h ^= h >> 13;
+            h *= 0xc2b2ae35u;
+            h ^= h >> 16;
+        }
+    }
+    std::size_t add(const Point& p, std::size_t h)
+    {
+        // keep the load factor below 1/2
+        if (2 * (_numSlots + 1) > _table.size())
+            rehash(std::max<std::size_t>(16, 2 * _table.size()));
+        Slot slot;
+        slot.x = p.x;
+        slot.y = p.y;
+        slot.z = p.z;
+        slot.index = _points.size();
+        _points.push_back(p);
+        insertSlot(slot, h);
+        return slot.index;
+    }
+    void insertSlot(const Slot& slot, std::size_t h)
+    {
+        std::size_t mask = _table.size() - 1;
+        std::size_t i = h & mask;
+        while (_table[i].index != npos)
+            i = (i + 1) & mask;
+        _table[i] = slot;
+        _numSlots++;
+    }
+    void rehash(std::size_t size)
+    {
+        Slot empty;
+        empty.x = empty.y = empty.z = 0;
+        empty.index = npos;
+        std::vector<Slot> table(size, empty);
+        table.swap(_table);
+        _numSlots = 0;
+        for (typename std::vector<Slot>::iterator it = table.begin(); it != table.end(); ++it) {
+            if (it->index != npos)
+                insertSlot(*it, hash(getCell(_points[it->index])));
+        }
+    }
+
+private:
+    _Precision _tolerance;
+    double _cellSize; ///< 0 if only identical points are equal
+    double _border; ///< distance to the cell border in cell units
+    std::vector<Point> _points;
+    std::vector<Slot> _table;
+    std::size_t _numSlots;
+};
+
+} // namespace Base
+
+#endif // BASE_POINTHASH_H
@@ -42,6 +42,7 @@
 #endif // FC_OS_WIN32
 #include <cmath>
 #include <climits>
+#include <cstring>
 
 #ifdef FC_OS_WIN32
 #include <direct.h>
@@ -116,6 +117,10 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <QUuid>
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
 
 
 #endif //_PreComp_
@@ -28,6 +28,11 @@
 # include <xercesc/sax/SAXException.hpp>
 # include <xercesc/sax2/XMLReaderFactory.hpp>
 # include <xercesc/sax2/SAX2XMLReader.hpp>
+# include <algorithm>
+# include <list>
+# include <QFuture>
+# include <QThread>
+# include <QtConcurrentRun>
 #endif
 
 #include <locale>
@@ -39,6 +44,7 @@
 #include "Persistence.h"
 #include "InputSource.h"
 #include "Console.h"
+#include "FileInfo.h"
 #include "Sequencer.h"
 
 #include <zipios++/zipios-config.h>
@@ -273,6 +279,78 @@ void Base::XMLReader::readBinFile(const char* filename)
     to.close();
 }
 
+namespace {
+
+void restoreFile(Base::Persistence* object, std::istream& str, const std::string& name)
+{
+    try {
+        object->RestoreDocFile(str);
+    }
+    catch(...) {
+        // For any exception we just continue with the next file.
+        // It doesn't matter if the last reader has read more or
+        // less data than the file size would allow.
+        // All what we need to do is to notify the user about the
+        // failure.
+        Base::Console().Error("Reading failed from embedded file: %s\n", name.c_str());
+    }
+}
+
+#ifdef ZIPIOS_HAVE_RAW_ENTRIES
+/// Reads from memory that is owned by someone else
+class MemoryInputBuffer : public std::streambuf
+{
+public:
+    MemoryInputBuffer(std::vector<char>& data)
+    {
+        if (!data.empty())
+            setg(&data[0], &data[0], &data[0] + data.size());
+    }
+};
+
+/// A file read ahead from the zip stream whose data is inflated in a worker thread
+struct PendingFile
+{
+    Base::Persistence* Object;
+    std::string Name;
+    zipios::StorageMethod Method;
+    zipios::uint32 Size;
+    std::vector<char> Data;
+    bool Ok;
+    QFuture<void> Future;
+
+    ~PendingFile()
+    {
+        // the worker thread must not access the file any more
+        Future.waitForFinished();
+    }
+    void inflate()
+    {
+        Ok = zipios::ZipInputStreambuf::inflateEntryData(Data, Method, Size);
+    }
+};
+
+// The maximum size of the files kept in memory at the same time
+const std::size_t MaxPendingSize = 256 * 1024 * 1024;
+
+void restorePendingFile(PendingFile& file, const std::istream& zipstream)
+{
+    file.Future.waitForFinished();
+    if (file.Ok) {
+        MemoryInputBuffer buf(file.Data);
+        std::istream str(&buf);
+        str.imbue(zipstream.getloc());
+        str.flags(zipstream.flags());
+        restoreFile(file.Object, str, file.Name);
+    }
+    else {
+        Base::Console().Error("Reading failed from embedded file: %s\n", file.Name.c_str());
+    }
+}
+#endif
+
+}
+
 void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
 {
     // It's possible that not all objects inside the document could be created, e.g. if a module
@@ -294,6 +372,13 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
     }
     std::vector<FileEntry>::const_iterator it = FileList.begin();
     Base::SequencerLauncher seq("Importing project files...", FileList.size());
+#ifdef ZIPIOS_HAVE_RAW_ENTRIES
+    // The files are read ahead and inflated in parallel while the files read
+    // before are restored, still in the order of the zip file.
+    std::list<PendingFile> pending;
+    std::size_t pendingSize = 0;
+    std::size_t maxPending = 2 * std::max(QThread::idealThreadCount(), 1);
+#endif
     while (entry->isValid() && it != FileList.end()) {
         std::vector<FileEntry>::const_iterator jt = it; 
         // Check if the current entry is registered, otherwise check the next registered files as soon as
@@ -303,17 +388,39 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
         // If this condition is true both file names match and we can read-in the data, otherwise
         // no file name for the current entry in the zip was registered.
         if (jt != FileList.end()) {
-            try {
-                jt->Object->RestoreDocFile(zipstream);
+#ifdef ZIPIOS_HAVE_RAW_ENTRIES
+            // An XML file may register further files that are read from the zip stream when
+            // restoring it (e.g. GuiDocument.xml) and large files shouldn't be kept in memory.
+            // These files are restored directly from the zip stream after the pending files.
+            if (entry->getSize() < MaxPendingSize && !FileInfo(jt->FileName).hasExtension("xml")) {
+                pending.push_back(PendingFile());
+                PendingFile& file = pending.back();
+                file.Object = jt->Object;
+                file.Name = entry->toString();
+                file.Method = entry->getMethod();
+                file.Size = entry->getSize();
+                file.Ok = zipstream.readRawEntryData(file.Data);
+                if (file.Ok)
+                    file.Future = QtConcurrent::run(&file, &PendingFile::inflate);
+                pendingSize += file.Size;
+
+                while (pending.size() > maxPending || pendingSize > MaxPendingSize) {
+                    pendingSize -= pending.front().Size;
+                    restorePendingFile(pending.front(), zipstream);
+                    pending.pop_front();
+                }
             }
-            catch(...) {
-                // For any exception we just continue with the next file.
-                // It doesn't matter if the last reader has read more or
-                // less data than the file size would allow.
-                // All what we need to do is to notify the user about the
-                // failure.
-                Base::Console().Error("Reading failed from embedded file: %s\n", entry->toString().c_str());
+            else {
+                while (!pending.empty()) {
+                    restorePendingFile(pending.front(), zipstream);
+                    pending.pop_front();
+                }
+                pendingSize = 0;
+                restoreFile(jt->Object, zipstream, entry->toString());
             }
+#else
+            restoreFile(jt->Object, zipstream, entry->toString());
+#endif
             // Go to the next registered file name
             it = jt + 1;
         }
@@ -329,6 +436,12 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
             break;
         }
     }
+#ifdef ZIPIOS_HAVE_RAW_ENTRIES
+    while (!pending.empty()) {
+        restorePendingFile(pending.front(), zipstream);
+        pending.pop_front();
+    }
+#endif
 }
 
 const char *Base::XMLReader::addFile(const char* Name, Base::Persistence *Object)
@@ -0,0 +1,193 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent[at]local>                             *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef BASE_TOKENIZER_H
+#define BASE_TOKENIZER_H
+
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+namespace Base
+{
+
+/**
+ * Hand-written tokenizer for ASCII file formats. It is locale independent and much faster
+ * than std::istream or regular expressions.
+ * The functions work on a single line [p, end) without the line feed. They skip leading
+ * blanks, move p behind the token and return false if there is no valid token.
+ */
+namespace Tokenizer
+{
+
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline const char* skipBlanks(const char* p, const char* end)
+{
+    while (p < end && isBlank(*p))
+        ++p;
+    return p;
+}
+
+// true if only blanks are left in the line
+inline bool isLineEnd(const char* p, const char* end)
+{
+    return skipBlanks(p, end) == end;
+}
+
+// true if the token ends at p, i.e. it is followed by a blank or the end of the line
+inline bool isTokenEnd(const char* p, const char* end)
+{
+    return p == end || isBlank(*p);
+}
+
+// case-insensitive match of the keyword kw that must be followed by a blank or the line end
+inline bool parseKeyword(const char*& p, const char* end, const char* kw)
+{
+    const char* s = skipBlanks(p, end);
+    for (; *kw; ++kw, ++s) {
+        if (s == end || toupper(static_cast<unsigned char>(*s)) != *kw)
+            return false;
+    }
+    if (!isTokenEnd(s, end))
+        return false;
+    p = s;
+    return true;
+}
+
+// parses a decimal number into a float or double
+template <class T>
+inline bool parseFloat(const char*& p, const char* end, T& value)
+{
+    static const double pow10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char* s = skipBlanks(p, end);
+    const char* start = s;
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+')) {
+        negative = (*s == '-');
+        ++s;
+    }
+
+    // A double holds 15 to 16 significant decimal digits. Integers of up to 15 digits
+    // are exact, further digits are rounded away and only the first 18 are collected.
+    double mantissa = 0.0;
+    int digits = 0, exponent = 0;
+    bool valid = false;
+    for (; s < end && *s >= '0' && *s <= '9'; ++s) {
+        valid = true;
+        if (digits < 18) {
+            mantissa = 10.0 * mantissa + (*s - '0');
+            if (mantissa > 0.0)
+                digits++;
+        }
+        else {
+            exponent++;
+        }
+    }
+    if (s < end && *s == '.') {
+        for (++s; s < end && *s >= '0' && *s <= '9'; ++s) {
+            valid = true;
+            if (digits < 18) {
+                mantissa = 10.0 * mantissa + (*s - '0');
+                exponent--;
+                if (mantissa > 0.0)
+                    digits++;
+            }
+        }
+    }
+    if (!valid)
+        return false;
+
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        ++s;
+        bool negexp = false;
+        if (s < end && (*s == '-' || *s == '+')) {
+            negexp = (*s == '-');
+            ++s;
+        }
+        if (s == end || *s < '0' || *s > '9')
+            return false;
+        int e = 0;
+        for (; s < end && *s >= '0' && *s <= '9'; ++s) {
+            if (e < 10000)
+                e = 10 * e + (*s - '0');
+        }
+        exponent += negexp ? -e : e;
+    }
+    if (!isTokenEnd(s, end))
+        return false;
+
+    // An exact mantissa scaled by an exact power of ten is rounded only once and thus
+    // gives the correctly rounded result. Otherwise the number is left to strtod.
+    double v = mantissa;
+    char buf[64];
+    if (digits <= 15 && exponent >= 0 && exponent <= 22) {
+        v *= pow10[exponent];
+    }
+    else if (digits <= 15 && exponent < 0 && exponent >= -22) {
+        v /= pow10[-exponent];
+    }
+    else if (s - start < static_cast<std::ptrdiff_t>(sizeof(buf))) {
+        std::memcpy(buf, start, s - start);
+        buf[s - start] = '\0';
+        v = std::fabs(std::strtod(buf, 0));
+    }
+    else {
+        v *= std::pow(10.0, exponent);
+    }
+    value = static_cast<T>(negative ? -v : v);
+    p = s;
+    return true;
+}
+
+// parses an unsigned integer, the token must end at a blank unless slash is true where it
+// may also end at '/'
+inline bool parseIndex(const char*& p, const char* end, unsigned long& value, bool slash = false)
+{
+    const char* s = skipBlanks(p, end);
+    if (s == end || *s < '0' || *s > '9')
+        return false;
+    unsigned long v = 0;
+    for (; s < end && *s >= '0' && *s <= '9'; ++s)
+        v = 10 * v + (*s - '0');
+    if (!isTokenEnd(s, end) && !(slash && *s == '/'))
+        return false;
+    value = v;
+    p = s;
+    return true;
+}
+
+} // namespace Tokenizer
+
+} // namespace Base
+
+#endif // BASE_TOKENIZER_H
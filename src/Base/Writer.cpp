@@ -24,6 +24,12 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <cstring>
+# include <list>
+# include <vector>
+# include <QFuture>
+# include <QThread>
+# include <QtConcurrentMap>
 #endif
 
 /// Here the FreeCAD includes sorted by Base,App,Gui......
@@ -98,6 +104,29 @@ bool Writer::isForceXML(void)
     return forceXML;
 }
 
+void Writer::setMode(const std::string& mode)
+{
+    Modes.insert(mode);
+}
+
+bool Writer::getMode(const std::string& mode) const
+{
+    std::set<std::string>::const_iterator it = Modes.find(mode);
+    return it != Modes.end();
+}
+
+void Writer::clearMode(const std::string& mode)
+{
+    std::set<std::string>::iterator it = Modes.find(mode);
+    if (it != Modes.end())
+        Modes.erase(it);
+}
+
+void Writer::clearModes()
+{
+    Modes.clear();
+}
+
 std::string Writer::addFile(const char* Name,const Base::Persistence *Object)
 {
     // always check isForceXML() before requesting a file!
@@ -169,7 +198,7 @@ void Writer::decInd(void)
 }
 
 ZipWriter::ZipWriter(const char* FileName) 
-  : ZipStream(FileName)
+  : ZipStream(FileName), FileStream(0)
 {
 #ifdef _MSC_VER
     ZipStream.imbue(std::locale::empty());
@@ -182,7 +211,7 @@ ZipWriter::ZipWriter(const char* FileName)
 }
 
 ZipWriter::ZipWriter(std::ostream& os) 
-  : ZipStream(os)
+  : ZipStream(os), FileStream(0)
 {
 #ifdef _MSC_VER
     ZipStream.imbue(std::locale::empty());
@@ -194,8 +223,236 @@ ZipWriter::ZipWriter(std::ostream& os)
     ZipStream.setf(ios::fixed,ios::floatfield);
 }
 
+#ifdef ZIPIOS_HAVE_RAW_ENTRIES
+namespace {
+
+/// A part of a file that is deflated in a worker thread
+struct DeflateChunk
+{
+    const char* data;
+    zipios::uint32 size;
+    zipios::uint32 prevSize;
+    int level;
+    bool last;
+    bool ok;
+    zipios::uint32 crc;
+    std::vector<char> deflated;
+
+    void deflate()
+    {
+        try {
+            crc = zipios::ZipOutputStreambuf::deflateChunk(data, size, prevSize, level, last, deflated);
+        }
+        catch (...) {
+            ok = false;
+        }
+    }
+};
+
+/// A file serialized to memory that waits for its chunks to be deflated
+struct PendingFile
+{
+    std::string FileName;
+    std::string Data;
+    std::vector<DeflateChunk> Chunks;
+    QFuture<void> Future;
+
+    ~PendingFile()
+    {
+        // the worker threads must not access the file any more
+        Future.waitForFinished();
+    }
+};
+
+// The size of the chunks that are deflated in parallel
+const std::size_t DeflateChunkSize = 1024 * 1024;
+// The maximum size of the files kept in memory at the same time
+const std::size_t MaxPendingSize = 256 * 1024 * 1024;
+
+void writePendingFile(zipios::ZipOutputStream& zip, PendingFile& file)
+{
+    file.Future.waitForFinished();
+
+    std::vector< std::vector<char> > chunks(file.Chunks.size());
+    zipios::uint32 crc = 0;
+    for (std::size_t i = 0; i < file.Chunks.size(); i++) {
+        DeflateChunk& chunk = file.Chunks[i];
+        if (!chunk.ok) {
+            std::stringstream str;
+            str << "Failed to compress file '" << file.FileName << "'";
+            throw Base::Exception(str.str());
+        }
+        chunks[i].swap(chunk.deflated);
+        crc = (i == 0 ? chunk.crc : zipios::ZipOutputStreambuf::combineCrc(crc, chunk.crc, chunk.size));
+    }
+
+    zip.putDeflatedEntry(file.FileName, chunks, crc, file.Data.size());
+}
+
+/// Collects a pending file in memory. A file that gets too big to be kept there is
+/// written directly to the zip stream instead, after the files pending in front of it.
+class PendingFileBuffer : public std::streambuf
+{
+public:
+    PendingFileBuffer(zipios::ZipOutputStream& zip, std::list<PendingFile>& pending)
+      : _zip(zip), _pending(pending), _file(pending.back()), _buffer(BufferSize), _direct(false)
+    {
+        setp(&_buffer[0], &_buffer[0] + _buffer.size());
+    }
+    /// Returns true if the file has been written with putNextEntry()
+    bool isDirect() const
+    {
+        return _direct;
+    }
+
+protected:
+    int_type overflow(int_type c)
+    {
+        if (!flushBuffer())
+            return traits_type::eof();
+        if (c != traits_type::eof()) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+    std::streamsize xsputn(const char* s, std::streamsize n)
+    {
+        if (n <= epptr() - pptr()) {
+            memcpy(pptr(), s, static_cast<std::size_t>(n));
+            pbump(static_cast<int>(n));
+            return n;
+        }
+        if (!flushBuffer() || !append(s, n))
+            return 0;
+        return n;
+    }
+    int sync()
+    {
+        return flushBuffer() ? 0 : -1;
+    }
+
+private:
+    bool flushBuffer()
+    {
+        std::streamsize n = pptr() - pbase();
+        setp(&_buffer[0], &_buffer[0] + _buffer.size());
+        return append(pbase(), n);
+    }
+    bool append(const char* s, std::streamsize n)
+    {
+        if (!_direct) {
+            if (_file.Data.size() + n <= MaxFileSize) {
+                _file.Data.append(s, static_cast<std::string::size_type>(n));
+                return true;
+            }
+
+            // the files in front must be written first to keep the order
+            while (&_pending.front() != &_file) {
+                writePendingFile(_zip, _pending.front());
+                _pending.pop_front();
+            }
+            _zip.putNextEntry(_file.FileName);
+            _zip.write(_file.Data.data(), _file.Data.size());
+            std::string().swap(_file.Data);
+            _direct = true;
+        }
+        _zip.write(s, n);
+        return true;
+    }
+
+private:
+    static const std::size_t BufferSize = 64 * 1024;
+    // The maximum size of a file that is deflated in parallel
+    static const std::size_t MaxFileSize = 64 * DeflateChunkSize;
+
+    zipios::ZipOutputStream& _zip;
+    std::list<PendingFile>& _pending;
+    PendingFile& _file;
+    std::vector<char> _buffer;
+    bool _direct;
+};
+
+}
+#endif
+
 void ZipWriter::writeFiles(void)
 {
+#ifdef ZIPIOS_HAVE_RAW_ENTRIES
+    // The files are serialized one after the other into memory. While the next files
+    // are serialized the chunks of the previous files are deflated in parallel. The
+    // files are written in the order they were added, so the output doesn't depend
+    // on the number of threads. Files that are too big are written without being
+    // kept in memory.
+    std::list<PendingFile> pending;
+    std::size_t pendingSize = 0;
+    std::size_t maxPending = 2 * std::max(QThread::idealThreadCount(), 1);
+    int level = ZipStream.getLevel();
+
+    try {
+        // use a while loop because it is possible that while
+        // processing the files new ones can be added
+        size_t index = 0;
+        while (index < FileList.size()) {
+            FileEntry entry = FileList.begin()[index];
+            pending.push_back(PendingFile());
+            PendingFile& file = pending.back();
+            file.FileName = entry.FileName;
+
+            PendingFileBuffer buf(ZipStream, pending);
+            std::ostream str(&buf);
+            str.imbue(ZipStream.getloc());
+            str.precision(ZipStream.precision());
+            str.flags(ZipStream.flags());
+            // an exception of the buffer is passed on instead of only setting the badbit
+            str.exceptions(std::ios::badbit);
+            FileStream = &str;
+            entry.Object->SaveDocFile(*this);
+            str.flush();
+            FileStream = 0;
+            index++;
+
+            if (buf.isDirect()) {
+                // all files in front have been written, too
+                pending.pop_back();
+                pendingSize = 0;
+                continue;
+            }
+
+            std::size_t size = file.Data.size();
+            std::size_t count = std::max<std::size_t>(1, (size + DeflateChunkSize - 1) / DeflateChunkSize);
+            file.Chunks.resize(count);
+            for (std::size_t i = 0; i < count; i++) {
+                DeflateChunk& chunk = file.Chunks[i];
+                std::size_t offset = i * DeflateChunkSize;
+                chunk.data = file.Data.data() + offset;
+                chunk.size = std::min(DeflateChunkSize, size - offset);
+                chunk.prevSize = offset;
+                chunk.level = level;
+                chunk.last = (i + 1 == count);
+                chunk.ok = true;
+                chunk.crc = 0;
+            }
+            file.Future = QtConcurrent::map(file.Chunks, &DeflateChunk::deflate);
+            pendingSize += size;
+
+            while (pending.size() > maxPending || pendingSize > MaxPendingSize) {
+                pendingSize -= pending.front().Data.size();
+                writePendingFile(ZipStream, pending.front());
+                pending.pop_front();
+            }
+        }
+
+        while (!pending.empty()) {
+            writePendingFile(ZipStream, pending.front());
+            pending.pop_front();
+        }
+    }
+    catch (...) {
+        FileStream = 0;
+        throw;
+    }
+#else
     // use a while loop because it is possible that while
     // processing the files new ones can be added
     size_t index = 0;
@@ -205,6 +462,7 @@ void ZipWriter::writeFiles(void)
         entry.Object->SaveDocFile(*this);
         index++;
     }
+#endif
 }
 
 ZipWriter::~ZipWriter()
@@ -24,6 +24,7 @@
 #define BASE_WRITER_H
 
 
+#include <set>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -63,6 +64,20 @@ public:
     /// check on state
     bool isForceXML(void);
 
+    /** @name modes */
+    //@{
+    /** Set a mode the persistent objects can query when saving their data,
+     * e.g. "BinaryBrep" to store shapes in binary instead of ASCII format.
+     */
+    void setMode(const std::string& mode);
+    /// check if the mode is set
+    bool getMode(const std::string& mode) const;
+    /// clear the mode
+    void clearMode(const std::string& mode);
+    /// clear all modes
+    void clearModes();
+    //@}
+
     /// insert a file as CDATA section in the XML file
     void insertAsciiFile(const char* FileName);
     /// insert a binary file BASE64 coded as CDATA section in the XML file
@@ -106,6 +121,7 @@ protected:
     char indBuf[256];
 
     bool forceXML;
+    std::set<std::string> Modes;
 };
 
 
@@ -125,7 +141,7 @@ public:
 
     virtual void writeFiles(void);
 
-    virtual std::ostream &Stream(void){return ZipStream;}
+    virtual std::ostream &Stream(void){return FileStream ? *FileStream : ZipStream;}
 
     void setComment(const char* str){ZipStream.setComment(str);}
     void setLevel(int level){ZipStream.setLevel( level );}
@@ -133,6 +149,8 @@ public:
 
 private:
     zipios::ZipOutputStream ZipStream;
+    /// the stream of the file that is currently serialized by writeFiles()
+    std::ostream* FileStream;
 };
 
 /** The StringWriter class 
@@ -199,18 +199,15 @@ void ObjectLabelObserver::slotRelabelObject(const App::DocumentObject& obj, cons
         std::string label = obj.Label.getValue();
         App::Document* doc = obj.getDocument();
         if (doc && !_hPGrp->GetBool("DuplicateLabels")) {
-            std::vector<std::string> objectLabels;
             std::vector<App::DocumentObject*>::const_iterator it;
-            std::vector<App::DocumentObject*> objs = doc->getObjects();
+            std::vector<App::DocumentObject*> objs = doc->getObjectsByLabel(label);
             bool match = false;
 
             for (it = objs.begin();it != objs.end();++it) {
-                if (*it == &obj)
-                    continue; // don't compare object with itself
-                std::string objLabel = (*it)->Label.getValue();
-                if (!match && objLabel == label)
+                if (*it != &obj) { // don't compare object with itself
                     match = true;
-                objectLabels.push_back(objLabel);
+                    break;
+                }
             }
 
             // make sure that there is a name conflict otherwise we don't have to do anything
@@ -220,7 +217,7 @@ void ObjectLabelObserver::slotRelabelObject(const App::DocumentObject& obj, cons
                 while (label[lastpos] >= 48 && label[lastpos] <= 57)
                     lastpos--;
                 label = label.substr(0, lastpos+1);
-                label = Base::Tools::getUniqueName(label, objectLabels, 3);
+                label = doc->getStandardObjectName(label.c_str(), 3);
                 this->current = &obj;
                 const_cast<App::DocumentObject&>(obj).Label.setValue(label);
                 this->current = 0;
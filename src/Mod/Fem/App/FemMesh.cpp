@@ -24,6 +24,7 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
 # include <cstdlib>
 # include <memory>
 # include <strstream>
@@ -66,6 +67,9 @@
 //to simplify parsing input files we use the boost lib
 #include <boost/tokenizer.hpp>
 
+#include <QThread>
+#include <QtConcurrentMap>
+
 
 using namespace Fem;
 using namespace Base;
@@ -408,6 +412,212 @@ std::set<long> FemMesh::getSurfaceNodes(const TopoDS_Face &face)const
     return result;
 }
 
+namespace {
+// corner nodes of the faces of the volume elements, the mid nodes of a Tet10 are
+// not needed to identify a face
+const int TetFaceNodes[4][4] = {{0,1,2,-1},{0,3,1,-1},{1,3,2,-1},{2,3,0,-1}};
+const int HexFaceNodes[6][4] = {{0,1,2,3},{4,5,6,7},{0,1,4,5},{1,2,5,6},{2,3,6,7},{0,3,4,7}};
+
+inline int countVolumeFaces(const SMDS_MeshElement* elem)
+{
+    switch (elem->NbNodes()) {
+        case 4:  // Tet4
+        case 10: // Tet10
+            return 4;
+        case 8:  // Hex8
+            return 6;
+        default:
+            return 0;
+    }
+}
+
+inline const int* getFaceNodes(const SMDS_MeshElement* elem, int faceNo)
+{
+    return (elem->NbNodes() == 8) ? HexFaceNodes[faceNo] : TetFaceNodes[faceNo];
+}
+
+// the hash of a face doesn't depend on the order of its nodes
+inline std::size_t hashFace(const SMDS_MeshElement* elem, int faceNo, std::size_t numBuckets)
+{
+    const int* corners = getFaceNodes(elem, faceNo);
+    std::size_t h = 0;
+    for (int i=0; i<4 && corners[i] >= 0; i++) {
+        std::size_t id = elem->GetNode(corners[i])->GetID();
+        h += (id * 2654435761u) ^ (id >> 7);
+    }
+    return h % numBuckets;
+}
+
+// the sorted node ids of a face, triangles start with 0 which is no valid id
+struct FaceKey
+{
+    int Nodes[4];
+    unsigned long Face;
+
+    void set(const SMDS_MeshElement* elem, int faceNo, unsigned long face)
+    {
+        const int* corners = getFaceNodes(elem, faceNo);
+        for (int i=0; i<4; i++)
+            Nodes[i] = corners[i] < 0 ? 0 : elem->GetNode(corners[i])->GetID();
+        // sorting network for four elements
+        if (Nodes[0] > Nodes[1]) std::swap(Nodes[0], Nodes[1]);
+        if (Nodes[2] > Nodes[3]) std::swap(Nodes[2], Nodes[3]);
+        if (Nodes[0] > Nodes[2]) std::swap(Nodes[0], Nodes[2]);
+        if (Nodes[1] > Nodes[3]) std::swap(Nodes[1], Nodes[3]);
+        if (Nodes[1] > Nodes[2]) std::swap(Nodes[1], Nodes[2]);
+        Face = face;
+    }
+    std::size_t hash() const
+    {
+        return (std::size_t)Nodes[0] * 73856093u ^ (std::size_t)Nodes[1] * 19349663u
+             ^ (std::size_t)Nodes[2] * 83492791u ^ (std::size_t)Nodes[3] * 50331653u;
+    }
+    bool operator == (const FaceKey& key) const
+    {
+        return std::equal(Nodes, Nodes+4, key.Nodes);
+    }
+};
+
+// A range of elements whose face keys are distributed to the buckets. The
+// first pass counts the keys per bucket, the second one writes them to their
+// slots.
+struct FaceChunk
+{
+    const SMDS_MeshElement* const* begin;
+    const SMDS_MeshElement* const* end;
+    unsigned long firstFace;
+    std::vector<std::size_t> slots;
+    FaceKey* keys;
+
+    void count()
+    {
+        for (const SMDS_MeshElement* const* it = begin; it != end; ++it) {
+            int num = countVolumeFaces(*it);
+            for (int i=0; i<num; i++)
+                slots[hashFace(*it, i, slots.size())]++;
+        }
+    }
+    void distribute()
+    {
+        FaceKey key;
+        unsigned long face = firstFace;
+        for (const SMDS_MeshElement* const* it = begin; it != end; ++it) {
+            int num = countVolumeFaces(*it);
+            for (int i=0; i<num; i++) {
+                key.set(*it, i, face++);
+                keys[slots[hashFace(*it, i, slots.size())]++] = key;
+            }
+        }
+    }
+};
+
+// The keys of a bucket are put into a hash table, a key found there already
+// belongs to a shared face
+struct FaceBucket
+{
+    FaceKey* begin;
+    FaceKey* end;
+    std::vector<char>* shared;
+
+    void findShared()
+    {
+        std::size_t size = 16;
+        while (size < 2 * std::size_t(end - begin))
+            size *= 2;
+        std::vector<FaceKey*> table(size, (FaceKey*)0);
+        for (FaceKey* it = begin; it != end; ++it) {
+            std::size_t pos = it->hash() & (size - 1);
+            while (table[pos] && !(*table[pos] == *it))
+                pos = (pos + 1) & (size - 1);
+            if (table[pos]) {
+                (*shared)[table[pos]->Face] = 1;
+                (*shared)[it->Face] = 1;
+            }
+            else {
+                table[pos] = it;
+            }
+        }
+    }
+};
+}
+
+std::vector<FemMesh::VolumeFace> FemMesh::getVolumeFaces(bool inner) const
+{
+    const SMESHDS_Mesh* data = myMesh->GetMeshDS();
+
+    std::vector<const SMDS_MeshElement*> elements;
+    elements.reserve(data->NbVolumes());
+    unsigned long numFaces = 0;
+    SMDS_VolumeIteratorPtr aVolIter = data->volumesIterator();
+    while (aVolIter->more()) {
+        const SMDS_MeshElement* elem = aVolIter->next();
+        int num = countVolumeFaces(elem);
+        if (num > 0) {
+            elements.push_back(elem);
+            numFaces += num;
+        }
+    }
+
+    std::vector<char> shared(numFaces, 0);
+    if (!inner && numFaces > 0) {
+        // The faces are distributed by the hash of their sorted node ids to buckets,
+        // a face shared by two elements ends up twice in the same bucket.
+        std::size_t numThreads = std::max<int>(1, QThread::idealThreadCount());
+        std::size_t numChunks = std::min<std::size_t>(elements.size(), 4 * numThreads);
+        std::size_t numBuckets = std::min<std::size_t>(numFaces / 1024 + 1, 4096);
+
+        std::vector<FaceChunk> chunks(numChunks);
+        std::size_t elemsPerChunk = (elements.size() + numChunks - 1) / numChunks;
+        std::vector<FaceKey> keys(numFaces);
+        unsigned long face = 0;
+        for (std::size_t i=0; i<numChunks; i++) {
+            FaceChunk& chunk = chunks[i];
+            std::size_t begin = std::min(i * elemsPerChunk, elements.size());
+            std::size_t end = std::min(begin + elemsPerChunk, elements.size());
+            chunk.begin = &elements[0] + begin;
+            chunk.end = &elements[0] + end;
+            chunk.firstFace = face;
+            chunk.slots.resize(numBuckets, 0);
+            chunk.keys = &keys[0];
+            for (const SMDS_MeshElement* const* it = chunk.begin; it != chunk.end; ++it)
+                face += countVolumeFaces(*it);
+        }
+        QtConcurrent::map(chunks, &FaceChunk::count).waitForFinished();
+
+        // turn the counts into the first slot of each chunk in each bucket
+        std::vector<FaceBucket> buckets(numBuckets);
+        std::size_t slot = 0;
+        for (std::size_t b=0; b<numBuckets; b++) {
+            buckets[b].begin = &keys[0] + slot;
+            for (std::size_t i=0; i<numChunks; i++) {
+                std::size_t count = chunks[i].slots[b];
+                chunks[i].slots[b] = slot;
+                slot += count;
+            }
+            buckets[b].end = &keys[0] + slot;
+            buckets[b].shared = &shared;
+        }
+        QtConcurrent::map(chunks, &FaceChunk::distribute).waitForFinished();
+        QtConcurrent::map(buckets, &FaceBucket::findShared).waitForFinished();
+    }
+
+    std::vector<VolumeFace> faces;
+    unsigned long face = 0;
+    for (std::vector<const SMDS_MeshElement*>::const_iterator it = elements.begin(); it != elements.end(); ++it) {
+        int num = countVolumeFaces(*it);
+        for (int i=0; i<num; i++, face++) {
+            if (!shared[face]) {
+                VolumeFace vf;
+                vf.Element = *it;
+                vf.FaceNo = i+1;
+                faces.push_back(vf);
+            }
+        }
+    }
+
+    return faces;
+}
+
 
 
 void FemMesh::readNastran(const std::string &Filename)
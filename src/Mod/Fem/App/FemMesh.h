@@ -34,6 +34,7 @@
 class SMESH_Gen;
 class SMESH_Mesh;
 class SMESH_Hypothesis;
+class SMDS_MeshElement;
 class TopoDS_Shape;
 class TopoDS_Face;
 
@@ -88,6 +89,21 @@ public:
     std::set<long> getSurfaceNodes(const TopoDS_Face &face)const;
     //@}
 
+    /** @name Faces of volume elements */
+    //@{
+    /// A face of a volume element, the faces of an element are numbered from 1
+    struct VolumeFace
+    {
+        const SMDS_MeshElement* Element;
+        short FaceNo;
+    };
+    /** Returns the faces of the Tet4, Tet10 and Hex8 elements which are not shared
+     * by two elements, i.e. the outer surface of the mesh. If \a inner is true the
+     * shared faces are returned, too.
+     */
+    std::vector<VolumeFace> getVolumeFaces(bool inner=false) const;
+    //@}
+
     /** @name Placement control */
     //@{
     /// set the transformation 
@@ -365,6 +365,23 @@ PyObject* FemMeshPy::copy(PyObject *args)
     return new FemMeshPy(new FemMesh(mesh));
 }
 
+PyObject* FemMeshPy::getVolumeFaces(PyObject *args)
+{
+    PyObject *inner = Py_False;
+    if (!PyArg_ParseTuple(args, "|O!", &PyBool_Type, &inner))
+        return 0;
+
+    std::vector<FemMesh::VolumeFace> faces = getFemMeshPtr()->getVolumeFaces(PyObject_IsTrue(inner) ? true : false);
+    Py::List list;
+    for (std::vector<FemMesh::VolumeFace>::const_iterator it = faces.begin(); it != faces.end(); ++it) {
+        Py::Tuple face(2);
+        face.setItem(0, Py::Int(it->Element->GetID()));
+        face.setItem(1, Py::Int(it->FaceNo));
+        list.append(face);
+    }
+    return Py::new_reference_to(list);
+}
+
 PyObject* FemMeshPy::read(PyObject *args)
 {
     char* filename;
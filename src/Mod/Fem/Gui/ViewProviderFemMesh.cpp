@@ -24,6 +24,7 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
 # include <Standard_math.hxx>
 # include <Inventor/SoDB.h>
 # include <Inventor/SoInput.h>
@@ -74,90 +75,27 @@ using namespace FemGui;
 
 
 
-struct FemFace 
-{
-	const SMDS_MeshNode *Nodes[8];
-	unsigned long  ElementNumber; 
-    const SMDS_MeshElement* Element;
-	unsigned short Size;
-	unsigned short FaceNo;
-    bool hide;
-    Base::Vector3d getFirstNodePoint(void) {
-        return Base::Vector3d(Nodes[0]->X(),Nodes[0]->Y(),Nodes[0]->Z());
-    }
-	
-	Base::Vector3d set(short size,const SMDS_MeshElement* element,unsigned short id, short faceNo, const SMDS_MeshNode* n1,const SMDS_MeshNode* n2,const SMDS_MeshNode* n3,const SMDS_MeshNode* n4=0,const SMDS_MeshNode* n5=0,const SMDS_MeshNode* n6=0,const SMDS_MeshNode* n7=0,const SMDS_MeshNode* n8=0);
-	
-	bool isSameFace (FemFace &face);
-};
-
-Base::Vector3d FemFace::set(short size,const SMDS_MeshElement* element,unsigned short id,short faceNo, const SMDS_MeshNode* n1,const SMDS_MeshNode* n2,const SMDS_MeshNode* n3,const SMDS_MeshNode* n4,const SMDS_MeshNode* n5,const SMDS_MeshNode* n6,const SMDS_MeshNode* n7,const SMDS_MeshNode* n8)
-{
-	Nodes[0] = n1;
-	Nodes[1] = n2;
-	Nodes[2] = n3;
-	Nodes[3] = n4;
-	Nodes[4] = n5;
-	Nodes[5] = n6;
-	Nodes[6] = n7;
-	Nodes[7] = n8;
-
-    Element         = element;
-    ElementNumber   = id; 
-    Size            = size;
-    FaceNo          = faceNo;
-    hide            = false;
-
-	// sorting the nodes for later easier comparison (bubble sort)
-    int i, j, flag = 1;    // set flag to 1 to start first pass
-	const SMDS_MeshNode* temp;   // holding variable
-	
-	for(i = 1; (i <= size) && flag; i++)
-	{
-		flag = 0;
-		for (j=0; j < (size -1); j++)
-		{
-			if (Nodes[j+1] > Nodes[j])      // ascending order simply changes to <
-			{ 
-				temp = Nodes[j];             // swap elements
-				Nodes[j] = Nodes[j+1];
-				Nodes[j+1] = temp;
-				flag = 1;               // indicates that a swap occurred.
-			}
-		}
-	}
-
-    return Base::Vector3d(Nodes[0]->X(),Nodes[0]->Y(),Nodes[0]->Z());
-};
-
-class FemFaceGridItem :public std::vector<FemFace*>{
-public:
-    //FemFaceGridItem(void){reserve(200);}
-};
+// the nodes of the faces of the volume elements as used in createMesh()
+static const int Tet4FaceNodes[4][3]  = {{0,1,2},{0,3,1},{1,3,2},{2,3,0}};
+static const int Hex8FaceNodes[6][4]  = {{0,1,2,3},{4,5,6,7},{0,1,4,5},{1,2,5,6},{2,3,6,7},{0,3,4,7}};
+static const int Tet10FaceNodes[4][6] = {{0,1,2,4,5,6},{0,3,1,7,8,4},{1,3,2,8,9,5},{2,3,0,9,7,6}};
 
-bool FemFace::isSameFace (FemFace &face) 
+static int getFaceNodes(const Fem::FemMesh::VolumeFace& face, const int*& nodes)
 {
-    // the same element can not have the same face
-    if(face.ElementNumber == ElementNumber)
-        return false;
-	if(face.Size != Size)
-        return false;
-	// if the same face size just compare if the sorted nodes are the same
-	if( Nodes[0] == face.Nodes[0] &&
-	    Nodes[1] == face.Nodes[1] &&
-		Nodes[2] == face.Nodes[2] &&
-		Nodes[3] == face.Nodes[3] &&
-		Nodes[4] == face.Nodes[4] &&
-		Nodes[5] == face.Nodes[5] &&
-		Nodes[6] == face.Nodes[6] &&
-        Nodes[7] == face.Nodes[7] ){
-            hide = true;
-            face.hide = true;
-            return true;
+    switch (face.Element->NbNodes()) {
+        case 4:
+            nodes = Tet4FaceNodes[face.FaceNo-1];
+            return 3;
+        case 8:
+            nodes = Hex8FaceNodes[face.FaceNo-1];
+            return 4;
+        case 10:
+            nodes = Tet10FaceNodes[face.FaceNo-1];
+            return 6;
+        default:
+            return 0;
     }
-
-    return false;
-};
+}
 
 PROPERTY_SOURCE(FemGui::ViewProviderFemMesh, Gui::ViewProviderGeometryObject)
 
@@ -502,12 +440,12 @@ void ViewProviderFEMMeshBuilder::buildNodes(const App::Property* prop, std::vect
     }
 }
 
-inline void insEdgeVec(std::map<int,std::set<int> > &map, int n1, int n2)
+inline void insEdgeVec(std::vector<std::pair<int,int> > &edges, int n1, int n2)
 {
     if(n1<n2)
-        map[n2].insert(n1);
+        edges.push_back(std::make_pair(n1,n2));
     else
-        map[n2].insert(n1);
+        edges.push_back(std::make_pair(n2,n1));
 };
 
 inline unsigned long ElemFold(unsigned long Element,unsigned long FaceNbr)
@@ -545,195 +483,50 @@ void ViewProviderFEMMeshBuilder::createMesh(const App::Property* prop, SoCoordin
     int numHedr = info.NbPolyhedrons();
 
 
-    bool ShowFaces = false;
-
-    int numTries;
-    if(ShowFaces)
-        numTries = numTria+numQuad+numPoly+numTetr*4+numHexa*6+numPyrd*5+numPris*6;
-    else
-        numTries = numTetr*4+numHexa*6+numPyrd*5+numPris*6;
-        
-    std::vector<FemFace> facesHelper(numTries);
-
-    Base::Console().Log("    %f: Start build up %i face helper\n",Base::TimeInfo::diffTimeF(Start,Base::TimeInfo()),facesHelper.size());
-    Base::BoundBox3d BndBox;
-
-    int i=0;
-
-    if(false){
-        SMDS_FaceIteratorPtr aFaceIter = data->facesIterator();
-        for (;aFaceIter->more();) {
-            const SMDS_MeshFace* aFace = aFaceIter->next();
-
-            int num = aFace->NbNodes();
-            switch(num){
-                
-                case 4:// quad face
-                    BndBox.Add(facesHelper[i++].set(4,aFace,aFace->GetID(),0,aFace->GetNode(0),aFace->GetNode(1),aFace->GetNode(2),aFace->GetNode(3)));
-                    break;
-                    
-                //unknown case
-                default: assert(0);
-            }
-        }
-    }
-
-    SMDS_VolumeIteratorPtr aVolIter = data->volumesIterator();
-    for (;aVolIter->more();) {
-        const SMDS_MeshVolume* aVol = aVolIter->next();
-        
-        int num = aVol->NbNodes();
-
-        switch(num){
-            // tet 4 element 
-            case 4:
-                // face 1
-                BndBox.Add(facesHelper[i++].set(3,aVol,aVol->GetID(),1,aVol->GetNode(0),aVol->GetNode(1),aVol->GetNode(2)));
-                // face 2
-                BndBox.Add(facesHelper[i++].set(3,aVol,aVol->GetID(),2,aVol->GetNode(0),aVol->GetNode(3),aVol->GetNode(1)));
-                // face 3
-                BndBox.Add(facesHelper[i++].set(3,aVol,aVol->GetID(),3,aVol->GetNode(1),aVol->GetNode(3),aVol->GetNode(2)));
-                // face 4
-                BndBox.Add(facesHelper[i++].set(3,aVol,aVol->GetID(),4,aVol->GetNode(2),aVol->GetNode(3),aVol->GetNode(0)));
-                break;
-                //unknown case
-            case 8:
-                // face 1
-                BndBox.Add(facesHelper[i++].set(4,aVol,aVol->GetID(),1,aVol->GetNode(0),aVol->GetNode(1),aVol->GetNode(2),aVol->GetNode(3)));
-                // face 2
-                BndBox.Add(facesHelper[i++].set(4,aVol,aVol->GetID(),2,aVol->GetNode(4),aVol->GetNode(5),aVol->GetNode(6),aVol->GetNode(7)));
-                // face 3
-                BndBox.Add(facesHelper[i++].set(4,aVol,aVol->GetID(),3,aVol->GetNode(0),aVol->GetNode(1),aVol->GetNode(4),aVol->GetNode(5)));
-                // face 4
-                BndBox.Add(facesHelper[i++].set(4,aVol,aVol->GetID(),4,aVol->GetNode(1),aVol->GetNode(2),aVol->GetNode(5),aVol->GetNode(6)));
-                // face 5
-                BndBox.Add(facesHelper[i++].set(4,aVol,aVol->GetID(),5,aVol->GetNode(2),aVol->GetNode(3),aVol->GetNode(6),aVol->GetNode(7)));
-                // face 6
-                BndBox.Add(facesHelper[i++].set(4,aVol,aVol->GetID(),6,aVol->GetNode(0),aVol->GetNode(3),aVol->GetNode(4),aVol->GetNode(7)));
-                break;
-                //unknown case
-            case 10:
-                // face 1
-                BndBox.Add(facesHelper[i++].set(6,aVol,aVol->GetID(),1,aVol->GetNode(0),aVol->GetNode(1),aVol->GetNode(2),aVol->GetNode(4),aVol->GetNode(5),aVol->GetNode(6)));
-                // face 2
-                BndBox.Add(facesHelper[i++].set(6,aVol,aVol->GetID(),2,aVol->GetNode(0),aVol->GetNode(3),aVol->GetNode(1),aVol->GetNode(7),aVol->GetNode(8),aVol->GetNode(4)));
-                // face 3
-                BndBox.Add(facesHelper[i++].set(6,aVol,aVol->GetID(),3,aVol->GetNode(1),aVol->GetNode(3),aVol->GetNode(2),aVol->GetNode(8),aVol->GetNode(9),aVol->GetNode(5)));
-                // face 4
-                BndBox.Add(facesHelper[i++].set(6,aVol,aVol->GetID(),4,aVol->GetNode(2),aVol->GetNode(3),aVol->GetNode(0),aVol->GetNode(9),aVol->GetNode(7),aVol->GetNode(6)));
-                break;
-                //unknown case
-            default: assert(0);
-        }
-    }
-
+    // the outer faces of the volume elements, or all of them with ShowInner
+    Base::Console().Log("    %f: Start search outer faces of %i volumes\n",Base::TimeInfo::diffTimeF(Start,Base::TimeInfo()),numVolu);
+    std::vector<Fem::FemMesh::VolumeFace> facesHelper = mesh->getValue().getVolumeFaces(ShowInner);
     int FaceSize = facesHelper.size();
 
-
-    if( FaceSize < 5000){
-        Base::Console().Log("    %f: Start eliminate internal faces SIMPLE\n",Base::TimeInfo::diffTimeF(Start,Base::TimeInfo()));
-        
-        // search for double (inside) faces and hide them
-        if(!ShowInner){
-            for(int l=0; l< FaceSize;l++){
-                if(! facesHelper[l].hide){
-                    for(int i=l+1; i<FaceSize; i++){
-                        if(facesHelper[l].isSameFace(facesHelper[i]) ){
-                            break;
-                        }
-                    }
-                }
-            }
-        }
-    }else{
-        Base::Console().Log("    %f: Start eliminate internal faces GRID\n",Base::TimeInfo::diffTimeF(Start,Base::TimeInfo()));
-        BndBox.Enlarge(BndBox.CalcDiagonalLength()/10000.0);
-        // calculate grid properties
-        double edge = pow(FaceSize,1.0/3.0);
-        double edgeL = BndBox.LengthX() + BndBox.LengthY() + BndBox.LengthZ();
-        double gridFactor = 5.0;
-        double size = ( edgeL /(3*edge) )*gridFactor;
-
-        unsigned int NbrX = (unsigned int)(BndBox.LengthX()/size)+1;
-        unsigned int NbrY = (unsigned int)(BndBox.LengthY()/size)+1;
-        unsigned int NbrZ = (unsigned int)(BndBox.LengthZ()/size)+1;
-        Base::Console().Log("      Size:F:%f,  X:%i  ,Y:%i  ,Z:%i\n",gridFactor,NbrX,NbrY,NbrZ);
-
-        double Xmin = BndBox.MinX;
-        double Ymin = BndBox.MinY;
-        double Zmin = BndBox.MinZ;
-        double Xln  = BndBox.LengthX() / NbrX;
-        double Yln  = BndBox.LengthY() / NbrY;
-        double Zln  = BndBox.LengthZ() / NbrZ;
-
-        std::vector<FemFaceGridItem> Grid(NbrX*NbrY*NbrZ);
-
-
-        unsigned int iX = 0;
-        unsigned int iY = 0;
-        unsigned int iZ = 0;
-
-        for(int l=0; l< FaceSize;l++){
-            Base::Vector3d point(facesHelper[l].getFirstNodePoint());
-            double x = (point.x - Xmin) / Xln;
-            double y = (point.y - Ymin) / Yln;
-            double z = (point.z - Zmin) / Zln;
-
-            iX = x;
-            iY = y;
-            iZ = z;
-
-            if(iX >= NbrX || iY >= NbrY || iZ >= NbrZ)
-                Base::Console().Log("      Outof range!\n");
-            
-            Grid[iX + iY*NbrX + iZ*NbrX*NbrY].push_back(&facesHelper[l]);
-        }
-
-        unsigned int max =0, avg = 0;
-        for(std::vector<FemFaceGridItem>::iterator it=Grid.begin();it!=Grid.end();++it){
-            for(unsigned int l=0; l< it->size();l++){
-                if(! it->operator[](l)->hide){
-                    for(unsigned int i=l+1; i<it->size(); i++){
-                        if(it->operator[](l)->isSameFace(*(it->operator[](i))) ){
-                            break;
-                        }
-                    }
-                }
-            }
-            if(it->size() > max)max=it->size();
-            avg += it->size();
-        }
-        avg = avg/Grid.size();
-         
-        Base::Console().Log("      VoxelSize: Max:%i ,Average:%i\n",max,avg);
-
-    } //if( FaceSize < 1000)
-
-
     Base::Console().Log("    %f: Start build up node map\n",Base::TimeInfo::diffTimeF(Start,Base::TimeInfo()));
 
-    // sort out double nodes and build up index map
-    std::map<const SMDS_MeshNode*, int> mapNodeIndex;
+    // sort out double nodes and build up index map, the node ids are used as index
+    int maxNodeId = 0;
     for(int l=0; l< FaceSize;l++){
-        if(!facesHelper[l].hide)
-            for(int i=0; i<8;i++)
-                if(facesHelper[l].Nodes[i])
-                    mapNodeIndex[facesHelper[l].Nodes[i]]=0;
-                else
-                    break;
+        const int* faceNodes;
+        int num = getFaceNodes(facesHelper[l],faceNodes);
+        for(int i=0; i<num;i++)
+            maxNodeId = std::max(maxNodeId, facesHelper[l].Element->GetNode(faceNodes[i])->GetID());
+    }
+    std::vector<const SMDS_MeshNode*> nodeOfId(maxNodeId+1, (const SMDS_MeshNode*)0);
+    for(int l=0; l< FaceSize;l++){
+        const int* faceNodes;
+        int num = getFaceNodes(facesHelper[l],faceNodes);
+        for(int i=0; i<num;i++){
+            const SMDS_MeshNode* node = facesHelper[l].Element->GetNode(faceNodes[i]);
+            nodeOfId[node->GetID()] = node;
+        }
     }
+    std::vector<int> mapNodeIndex(maxNodeId+1, -1);
+    int numPoints = 0;
+    for(int id=0; id<=maxNodeId; id++)
+        if(nodeOfId[id])
+            mapNodeIndex[id] = numPoints++;
+
     Base::Console().Log("    %f: Start set point vector\n",Base::TimeInfo::diffTimeF(Start,Base::TimeInfo()));
 
     // set the point coordinates
-    coords->point.setNum(mapNodeIndex.size());
-    vNodeElementIdx.resize(mapNodeIndex.size() );
-    std::map<const SMDS_MeshNode*, int>::iterator it=  mapNodeIndex.begin();
+    coords->point.setNum(numPoints);
+    vNodeElementIdx.resize(numPoints);
     SbVec3f* verts = coords->point.startEditing();
-    for (int i=0;it != mapNodeIndex.end() ;++it,i++) {
-        verts[i].setValue((float)it->first->X(),(float)it->first->Y(),(float)it->first->Z());
-        it->second = i;
-        // set selection idx
-        vNodeElementIdx[i] = it->first->GetID();
+    for (int id=0; id<=maxNodeId; id++) {
+        const SMDS_MeshNode* node = nodeOfId[id];
+        if (node) {
+            int i = mapNodeIndex[id];
+            verts[i].setValue((float)node->X(),(float)node->Y(),(float)node->Z());
+            // set selection idx
+            vNodeElementIdx[i] = id;
+        }
     }
     coords->point.finishEditing();
 
@@ -742,16 +535,16 @@ void ViewProviderFEMMeshBuilder::createMesh(const App::Property* prop, SoCoordin
     // count triangle size
     int triangleCount=0;
     for(int l=0; l< FaceSize;l++)
-        if(! facesHelper[l].hide)
-            switch(facesHelper[l].Size){
-                case 3:triangleCount++  ;break;
-                case 4:triangleCount+=2 ;break;
-                case 6:triangleCount+=4 ;break;
-                default: assert(0);
+        switch(facesHelper[l].Element->NbNodes()){
+            case 4: triangleCount++  ;break;
+            case 8: triangleCount+=2 ;break;
+            case 10:triangleCount+=4 ;break;
+            default: assert(0);
         }
 
-    // edge map collect and sort edges of the faces to be shown. 
-    std::map<int,std::set<int> > EdgeMap;
+    // edges of the faces to be shown, sorted and made unique afterwards
+    std::vector<std::pair<int,int> > EdgeMap;
+    EdgeMap.reserve(3*triangleCount);
 
     Base::Console().Log("    %f: Start build up triangle vector\n",Base::TimeInfo::diffTimeF(Start,Base::TimeInfo()));
     // set the triangle face indices
@@ -761,386 +554,384 @@ void ViewProviderFEMMeshBuilder::createMesh(const App::Property* prop, SoCoordin
     int32_t* indices = faces->coordIndex.startEditing();
 	// iterate all element faces, allways assure CLOCKWISE triangle ordering to allow backface culling
     for(int l=0; l< FaceSize;l++){
-        if(! facesHelper[l].hide){
-            switch( facesHelper[l].Element->NbNodes()){
-                case 4: // Tet 4
-                    switch(facesHelper[l].FaceNo){
-                        case 0: { // case for quad faces
-                            int nIdx0 = mapNodeIndex[facesHelper[l].Element->GetNode(0)];
-                            int nIdx1 = mapNodeIndex[facesHelper[l].Element->GetNode(1)];
-                            int nIdx2 = mapNodeIndex[facesHelper[l].Element->GetNode(2)];
-                            int nIdx3 = mapNodeIndex[facesHelper[l].Element->GetNode(3)];
-                            indices[index++] = nIdx0;
-                            indices[index++] = nIdx2;
-                            indices[index++] = nIdx1;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx0,nIdx1);
-                            insEdgeVec(EdgeMap,nIdx1,nIdx2);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,0);
-                            indices[index++] = nIdx0;
-                            indices[index++] = nIdx3;
-                            indices[index++] = nIdx2;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx2,nIdx3);
-                            insEdgeVec(EdgeMap,nIdx3,nIdx0);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,0);
-                            break;    }
-                        case 1: { // face 1 of Tet10
-                            int nIdx0 = mapNodeIndex[facesHelper[l].Element->GetNode(0)];
-                            int nIdx1 = mapNodeIndex[facesHelper[l].Element->GetNode(1)];
-                            int nIdx2 = mapNodeIndex[facesHelper[l].Element->GetNode(2)];
-                            indices[index++] = nIdx0;     
-                            indices[index++] = nIdx2;     
-                            indices[index++] = nIdx1;     
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx0,nIdx1);
-                            insEdgeVec(EdgeMap,nIdx0,nIdx2);
-                            insEdgeVec(EdgeMap,nIdx1,nIdx2);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,0);
-                            break;    }
-                        case 2: {
-                            int nIdx0 = mapNodeIndex[facesHelper[l].Element->GetNode(0)];
-                            int nIdx1 = mapNodeIndex[facesHelper[l].Element->GetNode(1)];
-                            int nIdx3 = mapNodeIndex[facesHelper[l].Element->GetNode(3)];
-                            indices[index++] = nIdx0;   
-                            indices[index++] = nIdx1;   
-                            indices[index++] = nIdx3;   
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx0,nIdx1);
-                            insEdgeVec(EdgeMap,nIdx0,nIdx3);
-                            insEdgeVec(EdgeMap,nIdx1,nIdx3);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,1);
-                            break;    }
-                        case 3: {
-                            int nIdx1 = mapNodeIndex[facesHelper[l].Element->GetNode(1)];
-                            int nIdx2 = mapNodeIndex[facesHelper[l].Element->GetNode(2)];
-                            int nIdx3 = mapNodeIndex[facesHelper[l].Element->GetNode(3)];
-                            indices[index++] = nIdx1;
-                            indices[index++] = nIdx2;
-                            indices[index++] = nIdx3;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx1,nIdx2);
-                            insEdgeVec(EdgeMap,nIdx1,nIdx3);
-                            insEdgeVec(EdgeMap,nIdx2,nIdx3);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,2);
-                            break;    }
-                        case 4: {
-                            int nIdx0 = mapNodeIndex[facesHelper[l].Element->GetNode(0)];
-                            int nIdx2 = mapNodeIndex[facesHelper[l].Element->GetNode(2)];
-                            int nIdx3 = mapNodeIndex[facesHelper[l].Element->GetNode(3)];
-                            indices[index++] = nIdx0;
-                            indices[index++] = nIdx3;
-                            indices[index++] = nIdx2;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx0,nIdx2);
-                            insEdgeVec(EdgeMap,nIdx0,nIdx3);
-                            insEdgeVec(EdgeMap,nIdx3,nIdx2);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,3);
-                            break;    }
-                        default: assert(0);
-
-                    }
-                    break;
-                case 8: // Hex 8
-                    switch(facesHelper[l].FaceNo){
-                        case 1: {
-                            int nIdx0 = mapNodeIndex[facesHelper[l].Element->GetNode(0)];
-                            int nIdx1 = mapNodeIndex[facesHelper[l].Element->GetNode(1)];
-                            int nIdx2 = mapNodeIndex[facesHelper[l].Element->GetNode(2)];
-                            int nIdx3 = mapNodeIndex[facesHelper[l].Element->GetNode(3)];
-                            indices[index++] = nIdx1;
-                            indices[index++] = nIdx0;
-                            indices[index++] = nIdx3;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx0,nIdx1);
-                            insEdgeVec(EdgeMap,nIdx0,nIdx3);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,0);
-                            indices[index++] = nIdx3;
-                            indices[index++] = nIdx2;
-                            indices[index++] = nIdx1;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx2,nIdx1);
-                            insEdgeVec(EdgeMap,nIdx2,nIdx3);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,0);
-                            break;    }
-                        case 2: {
-                            int nIdx4 = mapNodeIndex[facesHelper[l].Element->GetNode(4)];
-                            int nIdx5 = mapNodeIndex[facesHelper[l].Element->GetNode(5)];
-                            int nIdx6 = mapNodeIndex[facesHelper[l].Element->GetNode(6)];
-                            int nIdx7 = mapNodeIndex[facesHelper[l].Element->GetNode(7)];
-                            indices[index++] = nIdx4;
-                            indices[index++] = nIdx5;
-                            indices[index++] = nIdx7;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx4,nIdx5);
-                            insEdgeVec(EdgeMap,nIdx4,nIdx7);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,1);
-                            indices[index++] = nIdx5;
-                            indices[index++] = nIdx6;
-                            indices[index++] = nIdx7;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx6,nIdx5);
-                            insEdgeVec(EdgeMap,nIdx6,nIdx7);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,1);
-                            break;    }
-                        case 3: {
-                            int nIdx0 = mapNodeIndex[facesHelper[l].Element->GetNode(0)];
-                            int nIdx1 = mapNodeIndex[facesHelper[l].Element->GetNode(1)];
-                            int nIdx4 = mapNodeIndex[facesHelper[l].Element->GetNode(4)];
-                            int nIdx5 = mapNodeIndex[facesHelper[l].Element->GetNode(5)];
-                            indices[index++] = nIdx0;
-                            indices[index++] = nIdx1;
-                            indices[index++] = nIdx5;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx1,nIdx0);
-                            insEdgeVec(EdgeMap,nIdx1,nIdx5);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,2);
-                            indices[index++] = nIdx0;
-                            indices[index++] = nIdx5;
-                            indices[index++] = nIdx4;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx4,nIdx0);
-                            insEdgeVec(EdgeMap,nIdx4,nIdx5);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,2);
-                            break;    }
-                        case 4: {
-                            int nIdx1 = mapNodeIndex[facesHelper[l].Element->GetNode(1)];
-                            int nIdx2 = mapNodeIndex[facesHelper[l].Element->GetNode(2)];
-                            int nIdx5 = mapNodeIndex[facesHelper[l].Element->GetNode(5)];
-                            int nIdx6 = mapNodeIndex[facesHelper[l].Element->GetNode(6)];
-                            indices[index++] = nIdx5;
-                            indices[index++] = nIdx1;
-                            indices[index++] = nIdx2;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx1,nIdx5);
-                            insEdgeVec(EdgeMap,nIdx1,nIdx2);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,3);
-                            indices[index++] = nIdx5;
-                            indices[index++] = nIdx2;
-                            indices[index++] = nIdx6;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx6,nIdx5);
-                            insEdgeVec(EdgeMap,nIdx6,nIdx2);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,3);
-                            break;    }
-                        case 5: {
-                            int nIdx2 = mapNodeIndex[facesHelper[l].Element->GetNode(2)];
-                            int nIdx3 = mapNodeIndex[facesHelper[l].Element->GetNode(3)];
-                            int nIdx6 = mapNodeIndex[facesHelper[l].Element->GetNode(6)];
-                            int nIdx7 = mapNodeIndex[facesHelper[l].Element->GetNode(7)];
-                            indices[index++] = nIdx2;
-                            indices[index++] = nIdx3;
-                            indices[index++] = nIdx7;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx3,nIdx2);
-                            insEdgeVec(EdgeMap,nIdx3,nIdx7);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,4);
-                            indices[index++] = nIdx2;
-                            indices[index++] = nIdx7;
-                            indices[index++] = nIdx6;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx6,nIdx2);
-                            insEdgeVec(EdgeMap,nIdx6,nIdx7);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,4);
-                            break;    }
-                        case 6: {
-                            int nIdx0 = mapNodeIndex[facesHelper[l].Element->GetNode(0)];
-                            int nIdx3 = mapNodeIndex[facesHelper[l].Element->GetNode(3)];
-                            int nIdx4 = mapNodeIndex[facesHelper[l].Element->GetNode(4)];
-                            int nIdx7 = mapNodeIndex[facesHelper[l].Element->GetNode(7)];
-                            indices[index++] = nIdx3;
-                            indices[index++] = nIdx0;
-                            indices[index++] = nIdx4;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx0,nIdx4);
-                            insEdgeVec(EdgeMap,nIdx0,nIdx3);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,5);
-                            indices[index++] = nIdx3;
-                            indices[index++] = nIdx4;
-                            indices[index++] = nIdx7;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx7,nIdx4);
-                            insEdgeVec(EdgeMap,nIdx7,nIdx3);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,5);
-                            break;    }
-                    }
-                    break;
-                case 10: // Tet 10
-                    switch(facesHelper[l].FaceNo){
-                        case 1: { // element face number 1
-                            // prefeche all node indexes of this face
-                            int nIdx0 = mapNodeIndex[facesHelper[l].Element->GetNode(0)];
-                            int nIdx1 = mapNodeIndex[facesHelper[l].Element->GetNode(1)];
-                            int nIdx2 = mapNodeIndex[facesHelper[l].Element->GetNode(2)];
-                            int nIdx4 = mapNodeIndex[facesHelper[l].Element->GetNode(4)];
-                            int nIdx5 = mapNodeIndex[facesHelper[l].Element->GetNode(5)];
-                            int nIdx6 = mapNodeIndex[facesHelper[l].Element->GetNode(6)];
-                            // create triangle number 1 ----------------------------------------------
-                            // fill in the node indexes in CLOCKWISE order
-                            indices[index++] = nIdx0;
-                            indices[index++] = nIdx6;
-                            indices[index++] = nIdx4;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            // add the two edge segments for that triangle
-                            insEdgeVec(EdgeMap,nIdx0,nIdx6);
-                            insEdgeVec(EdgeMap,nIdx0,nIdx4);
-                            // rember the element and face number for that triangle
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,0);
-                            // create triangle number 2 ----------------------------------------------
-                            indices[index++] = nIdx6;
-                            indices[index++] = nIdx2;
-                            indices[index++] = nIdx5;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx2,nIdx6);
-                            insEdgeVec(EdgeMap,nIdx2,nIdx5);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,0);
-                            // create triangle number 3 ----------------------------------------------
-                            indices[index++] = nIdx5;
-                            indices[index++] = nIdx1;
-                            indices[index++] = nIdx4;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx1,nIdx5);
-                            insEdgeVec(EdgeMap,nIdx1,nIdx4);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,0);
-                            // create triangle number 4 ----------------------------------------------
-                            indices[index++] = nIdx4;
-                            indices[index++] = nIdx6;
-                            indices[index++] = nIdx5;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            // this triangle has no edge (inner triangle).
-                            break;    }
-                        case 2: {
-                            int nIdx0 = mapNodeIndex[facesHelper[l].Element->GetNode(0)];
-                            int nIdx1 = mapNodeIndex[facesHelper[l].Element->GetNode(1)];
-                            int nIdx3 = mapNodeIndex[facesHelper[l].Element->GetNode(3)];
-                            int nIdx4 = mapNodeIndex[facesHelper[l].Element->GetNode(4)];
-                            int nIdx7 = mapNodeIndex[facesHelper[l].Element->GetNode(7)];
-                            int nIdx8 = mapNodeIndex[facesHelper[l].Element->GetNode(8)];
-                            indices[index++] = nIdx0;
-                            indices[index++] = nIdx4;
-                            indices[index++] = nIdx7;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx0,nIdx7);
-                            insEdgeVec(EdgeMap,nIdx0,nIdx4);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,1);
-                            indices[index++] = nIdx4;
-                            indices[index++] = nIdx1;
-                            indices[index++] = nIdx8;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx1,nIdx8);
-                            insEdgeVec(EdgeMap,nIdx1,nIdx4);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,1);
-                            indices[index++] = nIdx8;
-                            indices[index++] = nIdx3;
-                            indices[index++] = nIdx7;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx3,nIdx7);
-                            insEdgeVec(EdgeMap,nIdx3,nIdx8);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,1);
-                            indices[index++] = nIdx4;
-                            indices[index++] = nIdx8;
-                            indices[index++] = nIdx7;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,1);
-                            break;    }
-                        case 3: {
-                            int nIdx1 = mapNodeIndex[facesHelper[l].Element->GetNode(1)];
-                            int nIdx2 = mapNodeIndex[facesHelper[l].Element->GetNode(2)];
-                            int nIdx3 = mapNodeIndex[facesHelper[l].Element->GetNode(3)];
-                            int nIdx5 = mapNodeIndex[facesHelper[l].Element->GetNode(5)];
-                            int nIdx8 = mapNodeIndex[facesHelper[l].Element->GetNode(8)];
-                            int nIdx9 = mapNodeIndex[facesHelper[l].Element->GetNode(9)];
-                            indices[index++] = nIdx1;
-                            indices[index++] = nIdx5;
-                            indices[index++] = nIdx8;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx1,nIdx5);
-                            insEdgeVec(EdgeMap,nIdx1,nIdx8);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,2);
-                            indices[index++] = nIdx5;
-                            indices[index++] = nIdx2;
-                            indices[index++] = nIdx9;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx2,nIdx5);
-                            insEdgeVec(EdgeMap,nIdx2,nIdx9);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,2);
-                            indices[index++] = nIdx9;
-                            indices[index++] = nIdx3;
-                            indices[index++] = nIdx8;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx3,nIdx9);
-                            insEdgeVec(EdgeMap,nIdx3,nIdx8);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,2);
-                            indices[index++] = nIdx5;
-                            indices[index++] = nIdx9;
-                            indices[index++] = nIdx8;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,2);
-                            break;    }
-                        case 4: {
-                            int nIdx0 = mapNodeIndex[facesHelper[l].Element->GetNode(0)];
-                            int nIdx2 = mapNodeIndex[facesHelper[l].Element->GetNode(2)];
-                            int nIdx3 = mapNodeIndex[facesHelper[l].Element->GetNode(3)];
-                            int nIdx6 = mapNodeIndex[facesHelper[l].Element->GetNode(6)];
-                            int nIdx7 = mapNodeIndex[facesHelper[l].Element->GetNode(7)];
-                            int nIdx9 = mapNodeIndex[facesHelper[l].Element->GetNode(9)];
-                            indices[index++] = nIdx6;
-                            indices[index++] = nIdx0;
-                            indices[index++] = nIdx7;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx0,nIdx6);
-                            insEdgeVec(EdgeMap,nIdx0,nIdx7);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,3);
-                            indices[index++] = nIdx2;
-                            indices[index++] = nIdx6;
-                            indices[index++] = nIdx9;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx2,nIdx6);
-                            insEdgeVec(EdgeMap,nIdx2,nIdx9);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,3);
-                            indices[index++] = nIdx9;
-                            indices[index++] = nIdx7;
-                            indices[index++] = nIdx3;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            insEdgeVec(EdgeMap,nIdx3,nIdx9);
-                            insEdgeVec(EdgeMap,nIdx3,nIdx7);
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,3);
-                            indices[index++] = nIdx6;
-                            indices[index++] = nIdx7;
-                            indices[index++] = nIdx9;
-                            indices[index++] = SO_END_FACE_INDEX;
-                            vFaceElementIdx[indexIdx++] = ElemFold(facesHelper[l].ElementNumber,3);
-                            break;    }
-                        default: assert(0);
-
-                    }
-                    break;
-
-                default:assert(0); // not implemented node
-            }
+        const SMDS_MeshElement* elem = facesHelper[l].Element;
+        unsigned long elemId = elem->GetID();
+        switch( elem->NbNodes()){
+            case 4: // Tet 4
+                switch(facesHelper[l].FaceNo){
+                    case 0: { // case for quad faces
+                        int nIdx0 = mapNodeIndex[elem->GetNode(0)->GetID()];
+                        int nIdx1 = mapNodeIndex[elem->GetNode(1)->GetID()];
+                        int nIdx2 = mapNodeIndex[elem->GetNode(2)->GetID()];
+                        int nIdx3 = mapNodeIndex[elem->GetNode(3)->GetID()];
+                        indices[index++] = nIdx0;
+                        indices[index++] = nIdx2;
+                        indices[index++] = nIdx1;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx0,nIdx1);
+                        insEdgeVec(EdgeMap,nIdx1,nIdx2);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,0);
+                        indices[index++] = nIdx0;
+                        indices[index++] = nIdx3;
+                        indices[index++] = nIdx2;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx2,nIdx3);
+                        insEdgeVec(EdgeMap,nIdx3,nIdx0);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,0);
+                        break;    }
+                    case 1: { // face 1 of Tet10
+                        int nIdx0 = mapNodeIndex[elem->GetNode(0)->GetID()];
+                        int nIdx1 = mapNodeIndex[elem->GetNode(1)->GetID()];
+                        int nIdx2 = mapNodeIndex[elem->GetNode(2)->GetID()];
+                        indices[index++] = nIdx0;     
+                        indices[index++] = nIdx2;     
+                        indices[index++] = nIdx1;     
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx0,nIdx1);
+                        insEdgeVec(EdgeMap,nIdx0,nIdx2);
+                        insEdgeVec(EdgeMap,nIdx1,nIdx2);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,0);
+                        break;    }
+                    case 2: {
+                        int nIdx0 = mapNodeIndex[elem->GetNode(0)->GetID()];
+                        int nIdx1 = mapNodeIndex[elem->GetNode(1)->GetID()];
+                        int nIdx3 = mapNodeIndex[elem->GetNode(3)->GetID()];
+                        indices[index++] = nIdx0;   
+                        indices[index++] = nIdx1;   
+                        indices[index++] = nIdx3;   
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx0,nIdx1);
+                        insEdgeVec(EdgeMap,nIdx0,nIdx3);
+                        insEdgeVec(EdgeMap,nIdx1,nIdx3);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,1);
+                        break;    }
+                    case 3: {
+                        int nIdx1 = mapNodeIndex[elem->GetNode(1)->GetID()];
+                        int nIdx2 = mapNodeIndex[elem->GetNode(2)->GetID()];
+                        int nIdx3 = mapNodeIndex[elem->GetNode(3)->GetID()];
+                        indices[index++] = nIdx1;
+                        indices[index++] = nIdx2;
+                        indices[index++] = nIdx3;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx1,nIdx2);
+                        insEdgeVec(EdgeMap,nIdx1,nIdx3);
+                        insEdgeVec(EdgeMap,nIdx2,nIdx3);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,2);
+                        break;    }
+                    case 4: {
+                        int nIdx0 = mapNodeIndex[elem->GetNode(0)->GetID()];
+                        int nIdx2 = mapNodeIndex[elem->GetNode(2)->GetID()];
+                        int nIdx3 = mapNodeIndex[elem->GetNode(3)->GetID()];
+                        indices[index++] = nIdx0;
+                        indices[index++] = nIdx3;
+                        indices[index++] = nIdx2;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx0,nIdx2);
+                        insEdgeVec(EdgeMap,nIdx0,nIdx3);
+                        insEdgeVec(EdgeMap,nIdx3,nIdx2);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,3);
+                        break;    }
+                    default: assert(0);
+
+                }
+                break;
+            case 8: // Hex 8
+                switch(facesHelper[l].FaceNo){
+                    case 1: {
+                        int nIdx0 = mapNodeIndex[elem->GetNode(0)->GetID()];
+                        int nIdx1 = mapNodeIndex[elem->GetNode(1)->GetID()];
+                        int nIdx2 = mapNodeIndex[elem->GetNode(2)->GetID()];
+                        int nIdx3 = mapNodeIndex[elem->GetNode(3)->GetID()];
+                        indices[index++] = nIdx1;
+                        indices[index++] = nIdx0;
+                        indices[index++] = nIdx3;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx0,nIdx1);
+                        insEdgeVec(EdgeMap,nIdx0,nIdx3);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,0);
+                        indices[index++] = nIdx3;
+                        indices[index++] = nIdx2;
+                        indices[index++] = nIdx1;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx2,nIdx1);
+                        insEdgeVec(EdgeMap,nIdx2,nIdx3);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,0);
+                        break;    }
+                    case 2: {
+                        int nIdx4 = mapNodeIndex[elem->GetNode(4)->GetID()];
+                        int nIdx5 = mapNodeIndex[elem->GetNode(5)->GetID()];
+                        int nIdx6 = mapNodeIndex[elem->GetNode(6)->GetID()];
+                        int nIdx7 = mapNodeIndex[elem->GetNode(7)->GetID()];
+                        indices[index++] = nIdx4;
+                        indices[index++] = nIdx5;
+                        indices[index++] = nIdx7;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx4,nIdx5);
+                        insEdgeVec(EdgeMap,nIdx4,nIdx7);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,1);
+                        indices[index++] = nIdx5;
+                        indices[index++] = nIdx6;
+                        indices[index++] = nIdx7;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx6,nIdx5);
+                        insEdgeVec(EdgeMap,nIdx6,nIdx7);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,1);
+                        break;    }
+                    case 3: {
+                        int nIdx0 = mapNodeIndex[elem->GetNode(0)->GetID()];
+                        int nIdx1 = mapNodeIndex[elem->GetNode(1)->GetID()];
+                        int nIdx4 = mapNodeIndex[elem->GetNode(4)->GetID()];
+                        int nIdx5 = mapNodeIndex[elem->GetNode(5)->GetID()];
+                        indices[index++] = nIdx0;
+                        indices[index++] = nIdx1;
+                        indices[index++] = nIdx5;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx1,nIdx0);
+                        insEdgeVec(EdgeMap,nIdx1,nIdx5);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,2);
+                        indices[index++] = nIdx0;
+                        indices[index++] = nIdx5;
+                        indices[index++] = nIdx4;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx4,nIdx0);
+                        insEdgeVec(EdgeMap,nIdx4,nIdx5);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,2);
+                        break;    }
+                    case 4: {
+                        int nIdx1 = mapNodeIndex[elem->GetNode(1)->GetID()];
+                        int nIdx2 = mapNodeIndex[elem->GetNode(2)->GetID()];
+                        int nIdx5 = mapNodeIndex[elem->GetNode(5)->GetID()];
+                        int nIdx6 = mapNodeIndex[elem->GetNode(6)->GetID()];
+                        indices[index++] = nIdx5;
+                        indices[index++] = nIdx1;
+                        indices[index++] = nIdx2;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx1,nIdx5);
+                        insEdgeVec(EdgeMap,nIdx1,nIdx2);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,3);
+                        indices[index++] = nIdx5;
+                        indices[index++] = nIdx2;
+                        indices[index++] = nIdx6;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx6,nIdx5);
+                        insEdgeVec(EdgeMap,nIdx6,nIdx2);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,3);
+                        break;    }
+                    case 5: {
+                        int nIdx2 = mapNodeIndex[elem->GetNode(2)->GetID()];
+                        int nIdx3 = mapNodeIndex[elem->GetNode(3)->GetID()];
+                        int nIdx6 = mapNodeIndex[elem->GetNode(6)->GetID()];
+                        int nIdx7 = mapNodeIndex[elem->GetNode(7)->GetID()];
+                        indices[index++] = nIdx2;
+                        indices[index++] = nIdx3;
+                        indices[index++] = nIdx7;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx3,nIdx2);
+                        insEdgeVec(EdgeMap,nIdx3,nIdx7);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,4);
+                        indices[index++] = nIdx2;
+                        indices[index++] = nIdx7;
+                        indices[index++] = nIdx6;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx6,nIdx2);
+                        insEdgeVec(EdgeMap,nIdx6,nIdx7);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,4);
+                        break;    }
+                    case 6: {
+                        int nIdx0 = mapNodeIndex[elem->GetNode(0)->GetID()];
+                        int nIdx3 = mapNodeIndex[elem->GetNode(3)->GetID()];
+                        int nIdx4 = mapNodeIndex[elem->GetNode(4)->GetID()];
+                        int nIdx7 = mapNodeIndex[elem->GetNode(7)->GetID()];
+                        indices[index++] = nIdx3;
+                        indices[index++] = nIdx0;
+                        indices[index++] = nIdx4;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx0,nIdx4);
+                        insEdgeVec(EdgeMap,nIdx0,nIdx3);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,5);
+                        indices[index++] = nIdx3;
+                        indices[index++] = nIdx4;
+                        indices[index++] = nIdx7;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx7,nIdx4);
+                        insEdgeVec(EdgeMap,nIdx7,nIdx3);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,5);
+                        break;    }
+                }
+                break;
+            case 10: // Tet 10
+                switch(facesHelper[l].FaceNo){
+                    case 1: { // element face number 1
+                        // prefeche all node indexes of this face
+                        int nIdx0 = mapNodeIndex[elem->GetNode(0)->GetID()];
+                        int nIdx1 = mapNodeIndex[elem->GetNode(1)->GetID()];
+                        int nIdx2 = mapNodeIndex[elem->GetNode(2)->GetID()];
+                        int nIdx4 = mapNodeIndex[elem->GetNode(4)->GetID()];
+                        int nIdx5 = mapNodeIndex[elem->GetNode(5)->GetID()];
+                        int nIdx6 = mapNodeIndex[elem->GetNode(6)->GetID()];
+                        // create triangle number 1 ----------------------------------------------
+                        // fill in the node indexes in CLOCKWISE order
+                        indices[index++] = nIdx0;
+                        indices[index++] = nIdx6;
+                        indices[index++] = nIdx4;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        // add the two edge segments for that triangle
+                        insEdgeVec(EdgeMap,nIdx0,nIdx6);
+                        insEdgeVec(EdgeMap,nIdx0,nIdx4);
+                        // rember the element and face number for that triangle
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,0);
+                        // create triangle number 2 ----------------------------------------------
+                        indices[index++] = nIdx6;
+                        indices[index++] = nIdx2;
+                        indices[index++] = nIdx5;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx2,nIdx6);
+                        insEdgeVec(EdgeMap,nIdx2,nIdx5);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,0);
+                        // create triangle number 3 ----------------------------------------------
+                        indices[index++] = nIdx5;
+                        indices[index++] = nIdx1;
+                        indices[index++] = nIdx4;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx1,nIdx5);
+                        insEdgeVec(EdgeMap,nIdx1,nIdx4);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,0);
+                        // create triangle number 4 ----------------------------------------------
+                        indices[index++] = nIdx4;
+                        indices[index++] = nIdx6;
+                        indices[index++] = nIdx5;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        // this triangle has no edge (inner triangle).
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,0);
+                        break;    }
+                    case 2: {
+                        int nIdx0 = mapNodeIndex[elem->GetNode(0)->GetID()];
+                        int nIdx1 = mapNodeIndex[elem->GetNode(1)->GetID()];
+                        int nIdx3 = mapNodeIndex[elem->GetNode(3)->GetID()];
+                        int nIdx4 = mapNodeIndex[elem->GetNode(4)->GetID()];
+                        int nIdx7 = mapNodeIndex[elem->GetNode(7)->GetID()];
+                        int nIdx8 = mapNodeIndex[elem->GetNode(8)->GetID()];
+                        indices[index++] = nIdx0;
+                        indices[index++] = nIdx4;
+                        indices[index++] = nIdx7;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx0,nIdx7);
+                        insEdgeVec(EdgeMap,nIdx0,nIdx4);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,1);
+                        indices[index++] = nIdx4;
+                        indices[index++] = nIdx1;
+                        indices[index++] = nIdx8;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx1,nIdx8);
+                        insEdgeVec(EdgeMap,nIdx1,nIdx4);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,1);
+                        indices[index++] = nIdx8;
+                        indices[index++] = nIdx3;
+                        indices[index++] = nIdx7;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx3,nIdx7);
+                        insEdgeVec(EdgeMap,nIdx3,nIdx8);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,1);
+                        indices[index++] = nIdx4;
+                        indices[index++] = nIdx8;
+                        indices[index++] = nIdx7;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,1);
+                        break;    }
+                    case 3: {
+                        int nIdx1 = mapNodeIndex[elem->GetNode(1)->GetID()];
+                        int nIdx2 = mapNodeIndex[elem->GetNode(2)->GetID()];
+                        int nIdx3 = mapNodeIndex[elem->GetNode(3)->GetID()];
+                        int nIdx5 = mapNodeIndex[elem->GetNode(5)->GetID()];
+                        int nIdx8 = mapNodeIndex[elem->GetNode(8)->GetID()];
+                        int nIdx9 = mapNodeIndex[elem->GetNode(9)->GetID()];
+                        indices[index++] = nIdx1;
+                        indices[index++] = nIdx5;
+                        indices[index++] = nIdx8;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx1,nIdx5);
+                        insEdgeVec(EdgeMap,nIdx1,nIdx8);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,2);
+                        indices[index++] = nIdx5;
+                        indices[index++] = nIdx2;
+                        indices[index++] = nIdx9;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx2,nIdx5);
+                        insEdgeVec(EdgeMap,nIdx2,nIdx9);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,2);
+                        indices[index++] = nIdx9;
+                        indices[index++] = nIdx3;
+                        indices[index++] = nIdx8;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx3,nIdx9);
+                        insEdgeVec(EdgeMap,nIdx3,nIdx8);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,2);
+                        indices[index++] = nIdx5;
+                        indices[index++] = nIdx9;
+                        indices[index++] = nIdx8;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,2);
+                        break;    }
+                    case 4: {
+                        int nIdx0 = mapNodeIndex[elem->GetNode(0)->GetID()];
+                        int nIdx2 = mapNodeIndex[elem->GetNode(2)->GetID()];
+                        int nIdx3 = mapNodeIndex[elem->GetNode(3)->GetID()];
+                        int nIdx6 = mapNodeIndex[elem->GetNode(6)->GetID()];
+                        int nIdx7 = mapNodeIndex[elem->GetNode(7)->GetID()];
+                        int nIdx9 = mapNodeIndex[elem->GetNode(9)->GetID()];
+                        indices[index++] = nIdx6;
+                        indices[index++] = nIdx0;
+                        indices[index++] = nIdx7;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx0,nIdx6);
+                        insEdgeVec(EdgeMap,nIdx0,nIdx7);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,3);
+                        indices[index++] = nIdx2;
+                        indices[index++] = nIdx6;
+                        indices[index++] = nIdx9;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx2,nIdx6);
+                        insEdgeVec(EdgeMap,nIdx2,nIdx9);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,3);
+                        indices[index++] = nIdx9;
+                        indices[index++] = nIdx7;
+                        indices[index++] = nIdx3;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        insEdgeVec(EdgeMap,nIdx3,nIdx9);
+                        insEdgeVec(EdgeMap,nIdx3,nIdx7);
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,3);
+                        indices[index++] = nIdx6;
+                        indices[index++] = nIdx7;
+                        indices[index++] = nIdx9;
+                        indices[index++] = SO_END_FACE_INDEX;
+                        vFaceElementIdx[indexIdx++] = ElemFold(elemId,3);
+                        break;    }
+                    default: assert(0);
+
+                }
+                break;
+
+            default:assert(0); // not implemented node
         }
     }
 
     faces->coordIndex.finishEditing();
 
     Base::Console().Log("    %f: Start build up edge vector\n",Base::TimeInfo::diffTimeF(Start,Base::TimeInfo()));
-    // std::map<int,std::set<int> > EdgeMap;
-    // count edges
-    int EdgeSize = 0;
-    for(std::map<int,std::set<int> >::const_iterator it= EdgeMap.begin();it!= EdgeMap.end();++it)
-        EdgeSize += it->second.size();
+    // the edges shared by two triangles are only shown once
+    std::sort(EdgeMap.begin(), EdgeMap.end());
+    EdgeMap.erase(std::unique(EdgeMap.begin(), EdgeMap.end()), EdgeMap.end());
+    int EdgeSize = EdgeMap.size();
 
     // set the triangle face indices
     lines->coordIndex.setNum(3*EdgeSize);
     index=0;
     indices = lines->coordIndex.startEditing();
 
-    for(std::map<int,std::set<int> >::const_iterator it= EdgeMap.begin();it!= EdgeMap.end();++it){
-        for(std::set<int>::const_iterator it2=it->second.begin();it2!=it->second.end();++it2){
-            indices[index++] = it->first;
-            indices[index++] = *it2;
-            indices[index++] = -1;
-        }
+    for(std::vector<std::pair<int,int> >::const_iterator it= EdgeMap.begin();it!= EdgeMap.end();++it){
+        indices[index++] = it->first;
+        indices[index++] = it->second;
+        indices[index++] = -1;
     }
 
     lines->coordIndex.finishEditing();
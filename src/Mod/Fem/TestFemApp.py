@@ -0,0 +1,86 @@
+#***************************************************************************
+#*   (c) agent (agent[at]local) 2026                                       *
+#*                                                                         *
+#*   This file is part of the FreeCAD CAx development system.              *
+#*                                                                         *
+#*   This program is free software; you can redistribute it and/or modify  *
+#*   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#*   as published by the Free Software Foundation; either version 2 of     *
+#*   the License, or (at your option) any later version.                   *
+#*   for detail see the LICENCE text file.                                 *
+#*                                                                         *
+#*   FreeCAD is distributed in the hope that it will be useful,            *
+#*   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#*   GNU Library General Public License for more details.                  *
+#*                                                                         *
+#*   You should have received a copy of the GNU Library General Public     *
+#*   License along with FreeCAD; if not, write to the Free Software        *
+#*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#*   USA                                                                   *
+#*                                                                         *
+#***************************************************************************
+
+import FreeCAD, unittest, Fem
+
+#---------------------------------------------------------------------------
+# define the test cases to test the FEM mesh
+#---------------------------------------------------------------------------
+
+class FemMeshVolumeFaceCases(unittest.TestCase):
+	def checkFaces(self, faces, numFaces):
+		# every face is returned once and its number is valid for the element
+		self.failUnless(len(set(faces)) == len(faces))
+		for elem, face in faces:
+			self.failUnless(face >= 1 and face <= numFaces[elem])
+
+	def testTetras(self):
+		# two tetrahedra sharing the face of the nodes 1, 2 and 3
+		m = Fem.FemMesh()
+		n = [m.addNode(0,0,0), m.addNode(1,0,0), m.addNode(0,1,0), m.addNode(0,0,1), m.addNode(1,1,1)]
+		t1 = m.addVolume([n[0],n[1],n[2],n[3]])
+		t2 = m.addVolume([n[1],n[2],n[3],n[4]])
+		numFaces = {t1:4, t2:4}
+
+		outer = m.getVolumeFaces()
+		self.failUnless(len(outer) == 6)
+		self.checkFaces(outer, numFaces)
+		self.failUnless(len([f for f in outer if f[0] == t1]) == 3)
+		self.failUnless(len([f for f in outer if f[0] == t2]) == 3)
+
+		inner = m.getVolumeFaces(True)
+		self.failUnless(len(inner) == 8)
+		self.checkFaces(inner, numFaces)
+		self.failUnless(set(outer) < set(inner))
+
+	def testHexas(self):
+		# a block of 3x3x3 hexahedra, an element has an outer face for each side
+		# of the block it touches
+		size = 3
+		m = Fem.FemMesh()
+		nodes = {}
+		for i in range(size + 1):
+			for j in range(size + 1):
+				for k in range(size + 1):
+					nodes[(i,j,k)] = m.addNode(i,j,k)
+		sides = {}
+		for i in range(size):
+			for j in range(size):
+				for k in range(size):
+					corners = [(i,j,k), (i+1,j,k), (i+1,j+1,k), (i,j+1,k),
+					           (i,j,k+1), (i+1,j,k+1), (i+1,j+1,k+1), (i,j+1,k+1)]
+					elem = m.addVolume([nodes[c] for c in corners])
+					sides[elem] = len([c for c in (i,j,k) if c == 0]) + \
+					              len([c for c in (i,j,k) if c == size - 1])
+		numFaces = dict([(elem, 6) for elem in sides])
+
+		outer = m.getVolumeFaces()
+		self.failUnless(len(outer) == 6 * size * size)
+		self.checkFaces(outer, numFaces)
+		for elem in sides:
+			self.failUnless(len([f for f in outer if f[0] == elem]) == sides[elem])
+
+		inner = m.getVolumeFaces(True)
+		self.failUnless(len(inner) == 6 * size * size * size)
+		self.checkFaces(inner, numFaces)
+		self.failUnless(set(outer) < set(inner))
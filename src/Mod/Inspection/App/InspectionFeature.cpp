@@ -22,22 +22,40 @@
 
 
 #include "PreCompiled.h"
+#include <algorithm>
 #include <gp_Pnt.hxx>
+#include <gp_Pnt2d.hxx>
+#include <Standard.hxx>
+#include <Standard_Failure.hxx>
+#include <BRep_Tool.hxx>
 #include <BRepExtrema_DistShapeShape.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
 #include <BRepBuilderAPI_MakeVertex.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepTools.hxx>
+#include <BRepTopAdaptor_FClass2d.hxx>
+#include <GeomAPI_ProjectPointOnSurf.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Precision.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Face.hxx>
 #include <TopoDS_Vertex.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
 
-#include <QEventLoop>
+#include <QAtomicInt>
 #include <QFuture>
-#include <QFutureWatcher>
-#include <QtConcurrentMap>
+#include <QMutex>
+#include <QThread>
+#include <QtConcurrentRun>
 
 #include <boost/signals.hpp>
 #include <boost/bind.hpp>
 
 #include <Base/Console.h>
 #include <Base/Exception.h>
-#include <Base/FutureWatcherProgress.h>
 #include <Base/Parameter.h>
 #include <Base/Sequencer.h>
 #include <Base/Tools.h>
@@ -45,6 +63,7 @@
 #include <Mod/Mesh/App/Mesh.h>
 #include <Mod/Mesh/App/MeshFeature.h>
 #include <Mod/Mesh/App/Core/Algorithm.h>
+#include <Mod/Mesh/App/Core/Bvh.h>
 #include <Mod/Mesh/App/Core/Grid.h>
 #include <Mod/Mesh/App/Core/Iterator.h>
 #include <Mod/Mesh/App/Core/MeshKernel.h>
@@ -74,8 +93,10 @@ unsigned long InspectActualMesh::countPoints() const
 
 Base::Vector3f InspectActualMesh::getPoint(unsigned long index)
 {
-    _iter.Set(index);
-    return *_iter;
+    // use a copy of the iterator to be reentrant
+    MeshCore::MeshPointIterator iter(_iter);
+    iter.Set(index);
+    return *iter;
 }
 
 // ----------------------------------------------------------------
@@ -195,19 +216,17 @@ namespace Inspection {
                     for (ulY = ulY1; ulY <= ulY2; ulY++) {
                         for (ulZ = ulZ1; ulZ <= ulZ2; ulZ++) {
                             if (rclFacet.IntersectBoundingBox(GetBoundBox(ulX, ulY, ulZ)))
-                                _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
+                                AddElement(ulX, ulY, ulZ, ulFacetIndex);
                         }
                     }
                 }
             }
             else
-                _aulGrid[ulX1][ulY1][ulZ1].insert(ulFacetIndex);
+                AddElement(ulX1, ulY1, ulZ1, ulFacetIndex);
         }
 
         void InitGrid (void)
         {
-            unsigned long i, j;
-
             Base::BoundBox3f clBBMesh = _pclMesh->GetBoundBox().Transformed(_transform);
 
             float fLengthX = clBBMesh.LengthX(); 
@@ -223,13 +242,9 @@ namespace Inspection {
             _fGridLenZ = (1.0f + fLengthZ) / float(_ulCtGridsZ);
             _fMinZ = clBBMesh.MinZ - 0.5f;
 
-            _aulGrid.clear();
-            _aulGrid.resize(_ulCtGridsX);
-            for (i = 0; i < _ulCtGridsX; i++) {
-                _aulGrid[i].resize(_ulCtGridsY);
-                for (j = 0; j < _ulCtGridsY; j++)
-                    _aulGrid[i][j].resize(_ulCtGridsZ);
-            }
+            _aulPending.clear();
+            _aulGrid.Resize(_ulCtGridsX * _ulCtGridsY * _ulCtGridsZ);
+            _aulGrid.Allocate();
         }
 
         void RebuildGrid (void)
@@ -243,6 +258,8 @@ namespace Inspection {
             for (clFIter.Init(); clFIter.More(); clFIter.Next()) {
                 AddFacet(*clFIter, i++);
             }
+
+            FinishGrid();
         }
 
     private:
@@ -255,29 +272,16 @@ InspectNominalMesh::InspectNominalMesh(const Mesh::MeshObject& rMesh, float offs
     const MeshCore::MeshKernel& kernel = rMesh.getKernel();
     _iter.Transform(rMesh.getTransform());
 
-    // Max. limit of grid elements
-    float fMaxGridElements=8000000.0f;
-    Base::BoundBox3f box = kernel.GetBoundBox().Transformed(rMesh.getTransform());
-
-    // estimate the minimum allowed grid length
-    float fMinGridLen = (float)pow((box.LengthX()*box.LengthY()*box.LengthZ()/fMaxGridElements), 0.3333f);
-    float fGridLen = 5.0f * MeshCore::MeshAlgorithm(kernel).GetAverageEdgeLength();
-
-    // We want to avoid to get too small grid elements otherwise building up the grid structure would take
-    // too much time and memory. 
-    // Having quite a dense grid speeds up more the following algorithms extremely. Due to the issue above it's
-    // always a compromise between speed and memory usage.
-    fGridLen = std::max<float>(fMinGridLen, fGridLen);
-
-    // build up grid structure to speed up algorithms
-    _pGrid = new MeshInspectGrid(kernel, fGridLen, rMesh.getTransform());
-    _box = box;
+    // The hierarchy finds the exact nearest facet and unlike a grid needs no tuning
+    // for meshes with very different facet sizes
+    _pBVH = new MeshCore::MeshFacetBVH(kernel, rMesh.getTransform());
+    _box = kernel.GetBoundBox().Transformed(rMesh.getTransform());
     _box.Enlarge(offset);
 }
 
 InspectNominalMesh::~InspectNominalMesh()
 {
-    delete this->_pGrid;
+    delete this->_pBVH;
 }
 
 float InspectNominalMesh::getDistance(const Base::Vector3f& point)
@@ -285,26 +289,15 @@ float InspectNominalMesh::getDistance(const Base::Vector3f& point)
     if (!_box.IsInBox(point))
         return FLT_MAX; // must be inside bbox
 
-    std::vector<unsigned long> indices;
-    //_pGrid->GetElements(point, indices);
-    if (indices.empty()) {
-        std::set<unsigned long> inds;
-        _pGrid->MeshGrid::SearchNearestFromPoint(point, inds);
-        indices.insert(indices.begin(), inds.begin(), inds.end());
-    }
+    unsigned long index = _pBVH->SearchNearestFromPoint(point);
+    if (index == ULONG_MAX)
+        return FLT_MAX; // empty mesh
 
-    float fMinDist=FLT_MAX;
-    bool positive = true;
-    for (std::vector<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
-        _iter.Set(*it);
-        float fDist = _iter->DistanceToPoint(point);
-        if (fabs(fDist) < fabs(fMinDist)) {
-            fMinDist = fDist;
-            positive = point.DistanceToPlane(_iter->_aclPoints[0], _iter->GetNormal()) > 0;
-        }
-    }
-
-    if (!positive)
+    // use a copy of the iterator to be reentrant
+    MeshCore::MeshFacetIterator iter(_iter);
+    iter.Set(index);
+    float fMinDist = iter->DistanceToPoint(point);
+    if (point.DistanceToPlane(iter->_aclPoints[0], iter->GetNormal()) <= 0)
         fMinDist = -fMinDist;
     return fMinDist;
 }
@@ -366,14 +359,16 @@ float InspectNominalFastMesh::getDistance(const Base::Vector3f& point)
         _pGrid->GetHull(ulX, ulY, ulZ, ulLevel, indices);
 #endif
 
+    // use a copy of the iterator to be reentrant
+    MeshCore::MeshFacetIterator iter(_iter);
     float fMinDist=FLT_MAX;
     bool positive = true;
     for (std::set<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
-        _iter.Set(*it);
-        float fDist = _iter->DistanceToPoint(point);
+        iter.Set(*it);
+        float fDist = iter->DistanceToPoint(point);
         if (fabs(fDist) < fabs(fMinDist)) {
             fMinDist = fDist;
-            positive = point.DistanceToPlane(_iter->_aclPoints[0], _iter->GetNormal()) > 0;
+            positive = point.DistanceToPlane(iter->_aclPoints[0], iter->GetNormal()) > 0;
         }
     }
 
@@ -440,23 +435,203 @@ float InspectNominalShape::getDistance(const Base::Vector3f& point)
     return fMinDist;
 }
 
+InspectNominalGeometry* InspectNominalShape::clone() const
+{
+    return new InspectNominalShape(_rShape, 0.0f);
+}
+
+// ----------------------------------------------------------------
+
+struct InspectNominalFastShape::Tessellation
+{
+    Tessellation() : grid(0) {}
+    ~Tessellation() { delete grid; }
+
+    MeshCore::MeshKernel kernel;
+    MeshCore::MeshFacetGrid* grid;
+    /// index of the face in 'faces' for each triangle
+    std::vector<unsigned long> facetToFace;
+    TopTools_IndexedMapOfShape faces;
+    Base::BoundBox3f box;
+};
+
+struct InspectNominalFastShape::FaceProjector
+{
+    FaceProjector(const TopoDS_Face& face) : classifier(face, Precision::Confusion())
+    {
+        Standard_Real u1, u2, v1, v2;
+        BRepTools::UVBounds(face, u1, u2, v1, v2);
+        projector.Init(BRep_Tool::Surface(face), u1, u2, v1, v2);
+    }
+
+    GeomAPI_ProjectPointOnSurf projector;
+    BRepTopAdaptor_FClass2d classifier;
+};
+
+InspectNominalFastShape::InspectNominalFastShape(const TopoDS_Shape& nominal, float offset)
+  : _offset(offset)
+{
+    Tessellation* tessel = new Tessellation();
+    _tessel.reset(tessel);
+
+    // The tessellation only serves to find the nearest face, hence the deflection
+    // must be small compared to the search radius.
+    Base::BoundBox3d bbox = Part::TopoShape(nominal).getBoundBox();
+    Standard_Real deflection = std::max<Standard_Real>(0.1 * offset,
+        (bbox.LengthX() + bbox.LengthY() + bbox.LengthZ()) / 3000.0);
+    // The shape is shared with the document object and maybe displayed at the same
+    // time, so its triangulation must not be replaced. Mesh a copy instead.
+    TopoDS_Shape shape = BRepBuilderAPI_Copy(nominal).Shape();
+    BRepMesh_IncrementalMesh(shape, deflection);
+
+    MeshCore::MeshPointArray points;
+    MeshCore::MeshFacetArray facets;
+    TopExp::MapShapes(shape, TopAbs_FACE, tessel->faces);
+    for (int i = 1; i <= tessel->faces.Extent(); i++) {
+        const TopoDS_Face& face = TopoDS::Face(tessel->faces(i));
+        TopLoc_Location loc;
+        Handle(Poly_Triangulation) poly = BRep_Tool::Triangulation(face, loc);
+        if (poly.IsNull())
+            continue;
+
+        unsigned long offsetIndex = points.size();
+        gp_Trsf trsf = loc.Transformation();
+        const TColgp_Array1OfPnt& nodes = poly->Nodes();
+        for (Standard_Integer j = nodes.Lower(); j <= nodes.Upper(); j++) {
+            gp_Pnt p = nodes(j).Transformed(trsf);
+            points.push_back(MeshCore::MeshPoint(Base::Vector3f((float)p.X(),(float)p.Y(),(float)p.Z())));
+        }
+
+        bool reversed = (face.Orientation() != TopAbs_FORWARD);
+        const Poly_Array1OfTriangle& triangles = poly->Triangles();
+        for (Standard_Integer j = triangles.Lower(); j <= triangles.Upper(); j++) {
+            Standard_Integer n1, n2, n3;
+            triangles(j).Get(n1, n2, n3);
+            if (reversed)
+                std::swap(n1, n2);
+            facets.push_back(MeshCore::MeshFacet(offsetIndex + n1 - nodes.Lower(),
+                                                 offsetIndex + n2 - nodes.Lower(),
+                                                 offsetIndex + n3 - nodes.Lower()));
+            tessel->facetToFace.push_back(i - 1);
+        }
+    }
+
+    tessel->kernel.Adopt(points, facets);
+    _projectors.resize(tessel->faces.Extent(), 0);
+
+    // same grid length estimation as for InspectNominalMesh
+    float fMaxGridElements=8000000.0f;
+    Base::BoundBox3f box = tessel->kernel.GetBoundBox();
+    float fMinGridLen = (float)pow((box.LengthX()*box.LengthY()*box.LengthZ()/fMaxGridElements), 0.3333f);
+    float fGridLen = 5.0f * MeshCore::MeshAlgorithm(tessel->kernel).GetAverageEdgeLength();
+    fGridLen = std::max<float>(fMinGridLen, fGridLen);
+
+    tessel->grid = new MeshCore::MeshFacetGrid(tessel->kernel, fGridLen);
+    tessel->box = box;
+    tessel->box.Enlarge(offset);
+}
+
+InspectNominalFastShape::InspectNominalFastShape(const InspectNominalFastShape& that)
+  : _tessel(that._tessel), _projectors(that._projectors.size(), 0), _offset(that._offset)
+{
+}
+
+InspectNominalFastShape::~InspectNominalFastShape()
+{
+    for (std::vector<FaceProjector*>::iterator it = _projectors.begin(); it != _projectors.end(); ++it)
+        delete *it;
+}
+
+InspectNominalGeometry* InspectNominalFastShape::clone() const
+{
+    return new InspectNominalFastShape(*this);
+}
+
+float InspectNominalFastShape::getDistance(const Base::Vector3f& point)
+{
+    const Tessellation& tessel = *_tessel;
+    if (!tessel.box.IsInBox(point))
+        return FLT_MAX; // must be inside bbox
+
+    unsigned long facet = tessel.grid->SearchNearestFromPoint(point, _offset);
+    if (facet == ULONG_MAX)
+        return FLT_MAX;
+    float fMinDist = tessel.kernel.GetFacet(facet).DistanceToPoint(point);
+
+    // refine with the distance to the face the nearest triangle belongs to
+    unsigned long index = tessel.facetToFace[facet];
+    try {
+        FaceProjector*& face = _projectors[index];
+        if (!face)
+            face = new FaceProjector(TopoDS::Face(tessel.faces(index + 1)));
+        face->projector.Perform(gp_Pnt(point.x, point.y, point.z));
+        if (face->projector.NbPoints() > 0) {
+            Standard_Real u, v;
+            face->projector.LowerDistanceParameters(u, v);
+            TopAbs_State state = face->classifier.Perform(gp_Pnt2d(u, v));
+            if (state == TopAbs_IN || state == TopAbs_ON)
+                fMinDist = (float)face->projector.LowerDistance();
+        }
+    }
+    catch (Standard_Failure) {
+        // keep the distance to the triangle
+    }
+
+    return fMinDist;
+}
+
 // ----------------------------------------------------------------
 
+static InspectNominalGeometry* createNominal(App::DocumentObject* obj, float radius)
+{
+    if (obj->getTypeId().isDerivedFrom(Mesh::Feature::getClassTypeId())) {
+        Mesh::Feature* mesh = static_cast<Mesh::Feature*>(obj);
+        return new InspectNominalMesh(mesh->Mesh.getValue(), radius);
+    }
+    else if (obj->getTypeId().isDerivedFrom(Points::Feature::getClassTypeId())) {
+        Points::Feature* pts = static_cast<Points::Feature*>(obj);
+        return new InspectNominalPoints(pts->Points.getValue(), radius);
+    }
+    else if (obj->getTypeId().isDerivedFrom(Part::Feature::getClassTypeId())) {
+        Part::Feature* part = static_cast<Part::Feature*>(obj);
+        const TopoDS_Shape& shape = part->Shape.getValue();
+        // The parameter 'FastShapeNominal' switches to the tessellation-based algorithm.
+        // It is off by default because near the boundary of a face the distance to the
+        // tessellation is used, which deviates from the exact distance by up to the
+        // deflection. Besides, it needs faces.
+        ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+            ("User parameter:BaseApp/Preferences/Mod/Inspection");
+        if (hGrp->GetBool("FastShapeNominal", false) &&
+            TopExp_Explorer(shape, TopAbs_FACE).More())
+            return new InspectNominalFastShape(shape, radius);
+        return new InspectNominalShape(shape, radius);
+    }
+
+    return 0;
+}
+
 // helper class to use Qt's concurrent framework
-struct DistanceInspection
+class DistanceInspection
 {
+public:
+    /// a range of point indices inspected by one job
+    struct Block
+    {
+        unsigned long begin, end;
+    };
 
     DistanceInspection(float radius, InspectActualGeometry*  a,
-                       std::vector<InspectNominalGeometry*> n)
-                    : radius(radius), actual(a), nominal(n)
+                       const std::vector<InspectNominalGeometry*>& n,
+                       std::vector<float>& v)
+                    : radius(radius), actual(a), nominal(n), vals(v), stopped(0)
     {
     }
-    float mapped(unsigned long index)
+    float distance(const std::vector<InspectNominalGeometry*>& nominal, unsigned long index) const
     {
         Base::Vector3f pnt = actual->getPoint(index);
 
         float fMinDist=FLT_MAX;
-        for (std::vector<InspectNominalGeometry*>::iterator it = nominal.begin(); it != nominal.end(); ++it) {
+        for (std::vector<InspectNominalGeometry*>::const_iterator it = nominal.begin(); it != nominal.end(); ++it) {
             float fDist = (*it)->getDistance(pnt);
             if (fabs(fDist) < fabs(fMinDist))
                 fMinDist = fDist;
@@ -469,10 +644,69 @@ struct DistanceInspection
 
         return fMinDist;
     }
+    void inspect(const Block& block)
+    {
+        // nominals that are not thread-safe get their own instance for this block
+        std::vector<InspectNominalGeometry*> local(nominal);
+        for (std::size_t i = 0; i < local.size(); i++) {
+            if (!local[i]->isThreadSafe())
+                local[i] = local[i]->clone();
+        }
+
+        // an exception must not leave the worker thread, it is reported by the
+        // calling thread after all blocks are finished
+        try {
+            for (unsigned long index = block.begin; index < block.end && !stopped; index++)
+                vals[index] = distance(local, index);
+        }
+        catch (Standard_Failure) {
+            Handle_Standard_Failure e = Standard_Failure::Caught();
+            setError(e->GetMessageString());
+        }
+        catch (const Base::Exception& e) {
+            setError(e.what());
+        }
+        catch (const std::exception& e) {
+            setError(e.what());
+        }
+        catch (...) {
+            setError("Unknown exception");
+        }
+
+        for (std::size_t i = 0; i < local.size(); i++) {
+            if (local[i] != nominal[i])
+                delete local[i];
+        }
+    }
+    /// lets the running blocks finish early
+    void stop()
+    {
+        stopped = 1;
+    }
+    /// returns the message of the first exception thrown by a block, if any
+    std::string getError() const
+    {
+        QMutexLocker locker(&mutex);
+        return error;
+    }
+
+private:
+    void setError(const char* msg)
+    {
+        QMutexLocker locker(&mutex);
+        if (error.empty())
+            error = (msg && *msg) ? msg : "Unknown exception";
+        stopped = 1;
+    }
 
+private:
     float radius;
     InspectActualGeometry*  actual;
-    std::vector<InspectNominalGeometry*> nominal;
+    const std::vector<InspectNominalGeometry*>& nominal;
+    std::vector<float>& vals;
+    QAtomicInt stopped;
+    mutable QMutex mutex;
+    std::string error;
 };
 
 PROPERTY_SOURCE(Inspection::Feature, App::DocumentObject)
@@ -530,70 +764,63 @@ App::DocumentObjectExecReturn* Feature::execute(void)
     std::vector<InspectNominalGeometry*> inspectNominal;
     const std::vector<App::DocumentObject*>& nominals = Nominals.getValues();
     for (std::vector<App::DocumentObject*>::const_iterator it = nominals.begin(); it != nominals.end(); ++it) {
-        InspectNominalGeometry* nominal = 0;
-        if ((*it)->getTypeId().isDerivedFrom(Mesh::Feature::getClassTypeId())) {
-            Mesh::Feature* mesh = static_cast<Mesh::Feature*>(*it);
-            nominal = new InspectNominalMesh(mesh->Mesh.getValue(), this->SearchRadius.getValue());
-        }
-        else if ((*it)->getTypeId().isDerivedFrom(Points::Feature::getClassTypeId())) {
-            Points::Feature* pts = static_cast<Points::Feature*>(*it);
-            nominal = new InspectNominalPoints(pts->Points.getValue(), this->SearchRadius.getValue());
-        }
-        else if ((*it)->getTypeId().isDerivedFrom(Part::Feature::getClassTypeId())) {
-            Part::Feature* part = static_cast<Part::Feature*>(*it);
-            nominal = new InspectNominalShape(part->Shape.getValue(), this->SearchRadius.getValue());
-        }
-
+        InspectNominalGeometry* nominal = createNominal(*it, this->SearchRadius.getValue());
         if (nominal)
             inspectNominal.push_back(nominal);
     }
 
-#if 0 // test with some huge data sets
-    Standard::SetReentrant(Standard_True);
-    std::vector<unsigned long> index(actual->countPoints());
-    std::generate(index.begin(), index.end(), Base::iotaGen<unsigned long>(0));
-    DistanceInspection check(this->SearchRadius.getValue(), actual, inspectNominal);
-    QFuture<float> future = QtConcurrent::mapped
-        (index, boost::bind(&DistanceInspection::mapped, &check, _1));
-    //future.waitForFinished(); // blocks the GUI
-    Base::FutureWatcherProgress progress("Inspecting...", actual->countPoints());
-    QFutureWatcher<float> watcher;
-    QObject::connect(&watcher, SIGNAL(progressValueChanged(int)),
-                     &progress, SLOT(progressValueChanged(int)));
-    watcher.setFuture(future);
-
-    // keep it responsive during computation
-    QEventLoop loop;
-    QObject::connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
-    loop.exec();
-
-    std::vector<float> vals;
-    vals.insert(vals.end(), future.begin(), future.end());
-#else
     unsigned long count = actual->countPoints();
     std::stringstream str;
     str << "Inspecting " << this->Label.getValue() << "...";
-    Base::SequencerLauncher seq(str.str().c_str(), count);
 
     std::vector<float> vals(count);
-    for (unsigned long index = 0; index < count; index++) {
-        Base::Vector3f pnt = actual->getPoint(index);
+    DistanceInspection check(this->SearchRadius.getValue(), actual, inspectNominal, vals);
+
+    int threads = QThread::idealThreadCount();
+    if (threads > 1 && count > 1) {
+        // Split the points into a few blocks per thread to balance the load. As each
+        // distance is computed independently the result is the same as in serial mode.
+        Standard::SetReentrant(Standard_True);
+        unsigned long numBlocks = std::min<unsigned long>(count, 8 * threads);
+        std::vector<DistanceInspection::Block> blocks(numBlocks);
+        for (unsigned long i = 0; i < numBlocks; i++) {
+            blocks[i].begin = (count * i) / numBlocks;
+            blocks[i].end = (count * (i+1)) / numBlocks;
+        }
 
-        float fMinDist=FLT_MAX;
-        for (std::vector<InspectNominalGeometry*>::iterator it = inspectNominal.begin(); it != inspectNominal.end(); ++it) {
-            float fDist = (*it)->getDistance(pnt);
-            if (fabs(fDist) < fabs(fMinDist))
-                fMinDist = fDist;
+        std::vector< QFuture<void> > futures(numBlocks);
+        for (unsigned long i = 0; i < numBlocks; i++)
+            futures[i] = QtConcurrent::run(&check, &DistanceInspection::inspect, blocks[i]);
+
+        // The blocks are started in order, so waiting for them one after another
+        // advances the progress bar while the others are still running. All blocks
+        // must be finished before leaving because they write into 'vals'.
+        try {
+            Base::SequencerLauncher seq(str.str().c_str(), numBlocks);
+            for (unsigned long i = 0; i < numBlocks; i++) {
+                futures[i].waitForFinished();
+                seq.next();
+            }
+        }
+        catch (...) {
+            // e.g. the user aborted
+            check.stop();
+            for (unsigned long i = 0; i < numBlocks; i++)
+                futures[i].waitForFinished();
+            throw;
         }
 
-        if (fMinDist > this->SearchRadius.getValue())
-            fMinDist = FLT_MAX;
-        else if (-fMinDist > this->SearchRadius.getValue())
-            fMinDist = -FLT_MAX;
-        vals[index] = fMinDist;
-        seq.next();
+        std::string error = check.getError();
+        if (!error.empty())
+            throw Base::Exception(error);
+    }
+    else {
+        Base::SequencerLauncher seq(str.str().c_str(), count);
+        for (unsigned long index = 0; index < count; index++) {
+            vals[index] = check.distance(inspectNominal, index);
+            seq.next();
+        }
     }
-#endif
 
     Distances.setValues(vals);
 
@@ -28,6 +28,8 @@
 #include <App/PropertyLinks.h>
 #include <App/DocumentObjectGroup.h>
 
+#include <boost/shared_ptr.hpp>
+
 #include <Mod/Mesh/App/Core/Iterator.h>
 #include <Mod/Points/App/Points.h>
 
@@ -37,6 +39,7 @@ class BRepExtrema_DistShapeShape;
 namespace MeshCore {
 class MeshKernel;
 class MeshGrid;
+class MeshFacetBVH;
 }
 
 namespace Mesh   { class MeshObject; }
@@ -46,7 +49,9 @@ namespace Part   { class TopoShape;  }
 namespace Inspection
 {
 
-/** Delivers the number of points to be checked and returns the appropriate point to an index. */
+/** Delivers the number of points to be checked and returns the appropriate point to an index.
+ * getPoint() may be called from several threads at a time.
+ */
 class InspectionExport InspectActualGeometry
 {
 public:
@@ -100,8 +105,15 @@ public:
     InspectNominalGeometry() {}
     virtual ~InspectNominalGeometry() {}
     virtual float getDistance(const Base::Vector3f&) = 0;
+    /** Returns true if getDistance() may be called from several threads at a time.
+     * Otherwise each thread must use its own instance created with clone().
+     */
+    virtual bool isThreadSafe() const { return true; }
+    /// Must be reimplemented by sub-classes that are not thread-safe
+    virtual InspectNominalGeometry* clone() const { return 0; }
 };
 
+/** Uses a bounding volume hierarchy to determine the nearest facet of the mesh. */
 class InspectionExport InspectNominalMesh : public InspectNominalGeometry
 {
 public:
@@ -111,7 +123,7 @@ public:
 
 private:
     MeshCore::MeshFacetIterator _iter;
-    MeshCore::MeshGrid* _pGrid;
+    MeshCore::MeshFacetBVH* _pBVH;
     Base::BoundBox3f _box;
 };
 
@@ -147,12 +159,44 @@ public:
     InspectNominalShape(const TopoDS_Shape&, float offset);
     ~InspectNominalShape();
     virtual float getDistance(const Base::Vector3f&);
+    /// BRepExtrema_DistShapeShape is not reentrant
+    virtual bool isThreadSafe() const { return false; }
+    virtual InspectNominalGeometry* clone() const;
 
 private:
     BRepExtrema_DistShapeShape* distss;
     const TopoDS_Shape& _rShape;
 };
 
+/** This algorithm tessellates the shape once and uses the nearest triangle to determine
+ * the face the point is projected onto. Points whose projection lies outside the face
+ * (i.e. near its boundary) get the distance to the triangle. Thus the result is exact
+ * within the tessellation tolerance but by factors faster than InspectNominalShape.
+ * It is used instead of InspectNominalShape if the boolean parameter 'FastShapeNominal'
+ * of the group 'Preferences/Mod/Inspection' is set.
+ */
+class InspectionExport InspectNominalFastShape : public InspectNominalGeometry
+{
+public:
+    InspectNominalFastShape(const TopoDS_Shape&, float offset);
+    ~InspectNominalFastShape();
+    virtual float getDistance(const Base::Vector3f&);
+    /// The projectors are cached per instance
+    virtual bool isThreadSafe() const { return false; }
+    /// The clone shares the tessellation with this instance
+    virtual InspectNominalGeometry* clone() const;
+
+private:
+    InspectNominalFastShape(const InspectNominalFastShape&);
+    InspectNominalFastShape& operator=(const InspectNominalFastShape&);
+
+    struct Tessellation;
+    struct FaceProjector;
+    boost::shared_ptr<const Tessellation> _tessel;
+    std::vector<FaceProjector*> _projectors;
+    float _offset;
+};
+
 // ----------------------------------------------------------------
 
 /** The inspection feature.
@@ -0,0 +1,83 @@
+#***************************************************************************
+#*   (c) agent (agent[at]local) 2026                                       *
+#*                                                                         *
+#*   This file is part of the FreeCAD CAx development system.              *
+#*                                                                         *
+#*   This program is free software; you can redistribute it and/or modify  *
+#*   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#*   as published by the Free Software Foundation; either version 2 of     *
+#*   the License, or (at your option) any later version.                   *
+#*   for detail see the LICENCE text file.                                 *
+#*                                                                         *
+#*   FreeCAD is distributed in the hope that it will be useful,            *
+#*   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#*   GNU Library General Public License for more details.                  *
+#*                                                                         *
+#*   You should have received a copy of the GNU Library General Public     *
+#*   License along with FreeCAD; if not, write to the Free Software        *
+#*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#*   USA                                                                   *
+#*                                                                         *
+#***************************************************************************
+
+import FreeCAD, os, struct, tempfile, unittest, Points
+import FreeCAD, unittest, math, Part, Points, Inspection
+
+#---------------------------------------------------------------------------
+# define the test cases to test the inspection of shapes
+#---------------------------------------------------------------------------
+
+ParamPath = "User parameter:BaseApp/Preferences/Mod/Inspection"
+
+class InspectionShapeCases(unittest.TestCase):
+	def setUp(self):
+		self.Doc = FreeCAD.newDocument("InspectionTest")
+		box = self.Doc.addObject("Part::Feature","Box")
+		box.Shape = Part.makeBox(10,10,10)
+		cyl = self.Doc.addObject("Part::Feature","Cylinder")
+		cyl.Shape = Part.makeCylinder(3,4,FreeCAD.Vector(20,0,0))
+
+		# points outside of the solids with their exact distances, the last one is
+		# out of the search radius
+		a = 1.0
+		self.Expected = [((2,3,10.5), 0.5), ((5,5,11.2), 1.2), ((9.5,0.5,10.01), 0.01),
+		                 ((-0.7,4,6), 0.7), ((4,10.3,2), 0.3), ((3,7,-1.5), 1.5),
+		                 ((10.5,10.5,5), math.sqrt(0.5)), ((10.3,10.4,10.5), math.sqrt(0.5)),
+		                 ((23.5,0,2), 0.5), ((20,-3.8,1), 0.8),
+		                 ((20 + 3.4 * math.cos(a),3.4 * math.sin(a),3), 0.4),
+		                 ((30,30,30), None)]
+		pts = self.Doc.addObject("Points::Feature","Actual")
+		pts.Points = Points.Points([FreeCAD.Vector(*p) for p, d in self.Expected])
+
+		self.Feature = self.Doc.addObject("Inspection::Feature","Inspect")
+		self.Feature.Actual = pts
+		self.Feature.Nominals = [box, cyl]
+
+	def inspect(self, fast):
+		param = FreeCAD.ParamGet(ParamPath)
+		oldValue = param.GetBool("FastShapeNominal", False)
+		param.SetBool("FastShapeNominal", fast)
+		try:
+			# setting a property makes the feature recompute
+			self.Feature.SearchRadius = 2.0
+			self.Doc.recompute()
+		finally:
+			param.SetBool("FastShapeNominal", oldValue)
+		return self.Feature.Distances
+
+	def testFastShape(self):
+		# the tessellation-based algorithm must give the same distances as the exact one
+		exact = self.inspect(False)
+		fast = self.inspect(True)
+		self.failUnless(len(exact) == len(self.Expected))
+		self.failUnless(len(fast) == len(self.Expected))
+		for (p, d), e, f in zip(self.Expected, exact, fast):
+			if d is None:
+				self.failUnless(e > 1e30 and f > 1e30)
+			else:
+				self.failUnless(abs(e - d) < 1e-4)
+				self.failUnless(abs(f - e) < 1e-4)
+
+	def tearDown(self):
+		FreeCAD.closeDocument(self.Doc.Name)
@@ -29,6 +29,7 @@
 
 #include "Algorithm.h"
 #include "Approximation.h"
+#include "Bvh.h"
 #include "Elements.h"
 #include "Iterator.h"
 #include "Grid.h"
@@ -143,6 +144,12 @@ bool MeshAlgorithm::NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::
     return false;
 }
 
+bool MeshAlgorithm::NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir, const MeshFacetBVH &rclBVH,
+                                       Base::Vector3f &rclRes, unsigned long &rulFacet) const
+{
+    return rclBVH.NearestFacetOnRay(rclPt, rclDir, rclRes, rulFacet);
+}
+
 bool MeshAlgorithm::NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir, const std::vector<unsigned long> &raulFacets,
                                        Base::Vector3f &rclRes, unsigned long &rulFacet) const
 {
@@ -1401,6 +1408,35 @@ bool MeshAlgorithm::NearestPointFromPoint (const Base::Vector3f &rclPt, const Me
   return true;
 }
 
+bool MeshAlgorithm::NearestPointFromPoint (const Base::Vector3f &rclPt, const MeshFacetBVH& rclBVH, unsigned long &rclResFacetIndex, Base::Vector3f &rclResPoint) const
+{
+  unsigned long ulInd = rclBVH.SearchNearestFromPoint(rclPt);
+
+  if (ulInd == ULONG_MAX)
+    return false;  // empty mesh
+
+  MeshGeomFacet rclSFacet = _rclMesh.GetFacet(ulInd);
+  rclSFacet.DistanceToPoint(rclPt, rclResPoint);
+  rclResFacetIndex = ulInd;
+
+  return true;
+}
+
+bool MeshAlgorithm::NearestPointFromPoint (const Base::Vector3f &rclPt, const MeshFacetBVH& rclBVH, float fMaxSearchArea,
+                                           unsigned long &rclResFacetIndex, Base::Vector3f &rclResPoint) const
+{
+  unsigned long ulInd = rclBVH.SearchNearestFromPoint(rclPt, fMaxSearchArea);
+
+  if (ulInd == ULONG_MAX)
+    return false;  // no facets inside search area
+
+  MeshGeomFacet rclSFacet = _rclMesh.GetFacet(ulInd);
+  rclSFacet.DistanceToPoint(rclPt, rclResPoint);
+  rclResFacetIndex = ulInd;
+
+  return true;
+}
+
 bool MeshAlgorithm::CutWithPlane (const Base::Vector3f &clBase, const Base::Vector3f &clNormal, const MeshFacetGrid &rclGrid,
                                   std::list<std::vector<Base::Vector3f> > &rclResult, float fMinEps, bool bConnectPolygons) const
 {
@@ -1945,3 +1981,255 @@ MeshRefNormalToPoints::operator[] (unsigned long pos) const
 {
     return _norm[pos];
 }
+
+//----------------------------------------------------------------------------
+
+void MeshIndexTable::Clear()
+{
+    _offsets.clear();
+    _indices.clear();
+    _fill.clear();
+}
+
+void MeshIndexTable::Resize(unsigned long rows)
+{
+    Clear();
+    _offsets.resize(rows + 1, 0);
+}
+
+void MeshIndexTable::Allocate()
+{
+    // turn the counters into offsets
+    for (std::size_t i = 1; i < _offsets.size(); i++)
+        _offsets[i] += _offsets[i-1];
+    _indices.resize(_offsets.back());
+    _fill.assign(_offsets.begin(), _offsets.end() - 1);
+}
+
+void MeshIndexTable::Finish()
+{
+    unsigned long rows = CountRows();
+    unsigned long pos = 0;
+    for (unsigned long i = 0; i < rows; i++) {
+        std::vector<unsigned long>::iterator first = _indices.begin() + _offsets[i];
+        std::vector<unsigned long>::iterator last = _indices.begin() + _fill[i];
+        std::sort(first, last);
+        last = std::unique(first, last);
+        // move the list to its final position, this never overlaps with the next list
+        _offsets[i] = pos;
+        pos = std::copy(first, last, _indices.begin() + pos) - _indices.begin();
+    }
+
+    if (rows > 0)
+        _offsets[rows] = pos;
+    if (pos < _indices.size()) {
+        _indices.resize(pos);
+        std::vector<unsigned long>(_indices).swap(_indices);
+    }
+    std::vector<unsigned long>().swap(_fill);
+}
+
+//----------------------------------------------------------------------------
+
+void MeshCompactPointToFacets::Rebuild (void)
+{
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    _map.Resize(rPoints.size());
+
+    MeshFacetArray::_TConstIterator pFBegin = rFacets.begin();
+    for (MeshFacetArray::_TConstIterator pFIter = pFBegin; pFIter != rFacets.end(); ++pFIter) {
+        _map.Count(pFIter->_aulPoints[0]);
+        _map.Count(pFIter->_aulPoints[1]);
+        _map.Count(pFIter->_aulPoints[2]);
+    }
+
+    _map.Allocate();
+    for (MeshFacetArray::_TConstIterator pFIter = pFBegin; pFIter != rFacets.end(); ++pFIter) {
+        _map.Insert(pFIter->_aulPoints[0], pFIter - pFBegin);
+        _map.Insert(pFIter->_aulPoints[1], pFIter - pFBegin);
+        _map.Insert(pFIter->_aulPoints[2], pFIter - pFBegin);
+    }
+    _map.Finish();
+}
+
+Base::Vector3f MeshCompactPointToFacets::GetNormal(unsigned long pos) const
+{
+    MeshIndexTable::Range n = _map[pos];
+    Base::Vector3f normal;
+    MeshGeomFacet f;
+    for (MeshIndexTable::Range::const_iterator it = n.begin(); it != n.end(); ++it) {
+        f = _rclMesh.GetFacet(*it);
+        normal += f.Area() * f.GetNormal();
+    }
+
+    normal.Normalize();
+    return normal;
+}
+
+std::set<unsigned long> MeshCompactPointToFacets::NeighbourPoints(const std::vector<unsigned long>& pt, int level) const
+{
+    std::set<unsigned long> cp,nb,lp;
+    cp.insert(pt.begin(), pt.end());
+    lp.insert(pt.begin(), pt.end());
+    MeshFacetArray::_TConstIterator f_it = _rclMesh.GetFacets().begin();
+    for (int i=0; i < level; i++) {
+        std::set<unsigned long> cur;
+        for (std::set<unsigned long>::iterator it = lp.begin(); it != lp.end(); ++it) {
+            MeshIndexTable::Range ft = (*this)[*it];
+            for (MeshIndexTable::Range::const_iterator jt = ft.begin(); jt != ft.end(); ++jt) {
+                for (int j = 0; j < 3; j++) {
+                    unsigned long index = f_it[*jt]._aulPoints[j];
+                    if (cp.find(index) == cp.end() && nb.find(index) == nb.end()) {
+                        nb.insert(index);
+                        cur.insert(index);
+                    }
+                }
+            }
+        }
+
+        lp = cur;
+        if (lp.empty())
+            break;
+    }
+    return nb;
+}
+
+void MeshCompactPointToFacets::Neighbours (unsigned long ulFacetInd, float fMaxDist, MeshCollector& collect) const
+{
+    std::set<unsigned long> visited;
+    Base::Vector3f  clCenter = _rclMesh.GetFacet(ulFacetInd).GetGravityPoint();
+
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    SearchNeighbours(rFacets, ulFacetInd, clCenter, fMaxDist * fMaxDist, visited, collect);
+}
+
+void MeshCompactPointToFacets::SearchNeighbours(const MeshFacetArray& rFacets, unsigned long index, const Base::Vector3f &rclCenter,
+                                                float fMaxDist2, std::set<unsigned long>& visited, MeshCollector& collect) const
+{
+    if (visited.find(index) != visited.end())
+        return;
+
+    const MeshFacet& face = rFacets[index];
+    if (Base::DistanceP2(rclCenter, _rclMesh.GetFacet(face).GetGravityPoint()) > fMaxDist2)
+        return;
+
+    visited.insert(index);
+    collect.Append(_rclMesh, index);
+    for (int i = 0; i < 3; i++) {
+        MeshIndexTable::Range f = (*this)[face._aulPoints[i]];
+
+        for (MeshIndexTable::Range::const_iterator j = f.begin(); j != f.end(); ++j) {
+            SearchNeighbours(rFacets, *j, rclCenter, fMaxDist2, visited, collect);
+        }
+    }
+}
+
+MeshFacetArray::_TConstIterator
+MeshCompactPointToFacets::GetFacet (unsigned long index) const
+{
+    return _rclMesh.GetFacets().begin() + index;
+}
+
+MeshIndexTable::Range
+MeshCompactPointToFacets::operator[] (unsigned long pos) const
+{
+    return _map[pos];
+}
+
+//----------------------------------------------------------------------------
+
+void MeshCompactFacetToFacets::Rebuild (void)
+{
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    _map.Resize(rFacets.size());
+
+    MeshCompactPointToFacets vertexFace(_rclMesh);
+    MeshFacetArray::_TConstIterator pFBegin = rFacets.begin();
+    for (MeshFacetArray::_TConstIterator pFIter = pFBegin; pFIter != rFacets.end(); ++pFIter) {
+        for (int i = 0; i < 3; i++)
+            _map.Count(pFIter - pFBegin, vertexFace[pFIter->_aulPoints[i]].size());
+    }
+
+    _map.Allocate();
+    for (MeshFacetArray::_TConstIterator pFIter = pFBegin; pFIter != rFacets.end(); ++pFIter) {
+        for (int i = 0; i < 3; i++) {
+            MeshIndexTable::Range faces = vertexFace[pFIter->_aulPoints[i]];
+            for (MeshIndexTable::Range::const_iterator it = faces.begin(); it != faces.end(); ++it)
+                _map.Insert(pFIter - pFBegin, *it);
+        }
+    }
+    _map.Finish();
+}
+
+MeshIndexTable::Range
+MeshCompactFacetToFacets::operator[] (unsigned long pos) const
+{
+    return _map[pos];
+}
+
+//----------------------------------------------------------------------------
+
+void MeshCompactPointToPoints::Rebuild (void)
+{
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    _map.Resize(rPoints.size());
+
+    // each edge is counted once per adjacent facet, the duplicates are removed at the end
+    for (MeshFacetArray::_TConstIterator pFIter = rFacets.begin(); pFIter != rFacets.end(); ++pFIter) {
+        _map.Count(pFIter->_aulPoints[0], 2);
+        _map.Count(pFIter->_aulPoints[1], 2);
+        _map.Count(pFIter->_aulPoints[2], 2);
+    }
+
+    _map.Allocate();
+    for (MeshFacetArray::_TConstIterator pFIter = rFacets.begin(); pFIter != rFacets.end(); ++pFIter) {
+        unsigned long ulP0 = pFIter->_aulPoints[0];
+        unsigned long ulP1 = pFIter->_aulPoints[1];
+        unsigned long ulP2 = pFIter->_aulPoints[2];
+
+        _map.Insert(ulP0, ulP1);
+        _map.Insert(ulP0, ulP2);
+        _map.Insert(ulP1, ulP0);
+        _map.Insert(ulP1, ulP2);
+        _map.Insert(ulP2, ulP0);
+        _map.Insert(ulP2, ulP1);
+    }
+    _map.Finish();
+}
+
+Base::Vector3f MeshCompactPointToPoints::GetNormal(unsigned long pos) const
+{
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    MeshCore::PlaneFit pf;
+    pf.AddPoint(rPoints[pos]);
+    MeshIndexTable::Range cv = _map[pos];
+    for (MeshIndexTable::Range::const_iterator cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
+        pf.AddPoint(rPoints[*cv_it]);
+    }
+
+    pf.Fit();
+
+    Base::Vector3f normal = pf.GetNormal();
+    normal.Normalize();
+    return normal;
+}
+
+float MeshCompactPointToPoints::GetAverageEdgeLength(unsigned long index) const
+{
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    float len=0.0f;
+    MeshIndexTable::Range n = (*this)[index];
+    const Base::Vector3f& p = rPoints[index];
+    for (MeshIndexTable::Range::const_iterator it = n.begin(); it != n.end(); ++it) {
+        len += Base::Distance(p, rPoints[*it]);
+    }
+    return (len/n.size());
+}
+
+MeshIndexTable::Range
+MeshCompactPointToPoints::operator[] (unsigned long pos) const
+{
+    return _map[pos];
+}
@@ -24,6 +24,7 @@
 #ifndef MESHALGORITHM_H
 #define MESHALGORITHM_H
 
+#include <algorithm>
 #include <set>
 #include <vector>
 #include <map>
@@ -45,6 +46,7 @@ class MeshGeomFacet;
 class MeshGeomEdge;
 class MeshKernel;
 class MeshFacetGrid;
+class MeshFacetBVH;
 class MeshFacetArray;
 class MeshRefPointToFacets;
 class AbstractPolygonTriangulator;
@@ -100,6 +102,16 @@ public:
    */
   bool NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir, float fMaxSearchArea,
                           const MeshFacetGrid &rclGrid, Base::Vector3f &rclRes, unsigned long &rulFacet) const;
+  /**
+   * Searches for the nearest facet to the ray defined by
+   * (\a rclPt, \a rclDir).
+   * The point \a rclRes holds the intersection point with the ray and the
+   * nearest facet with index \a rulFacet.
+   * \note This method is optimized by using a bounding volume hierarchy. Unlike the
+   * grid it also performs well for meshes with very different facet sizes.
+   */
+  bool NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir, const MeshFacetBVH &rclBVH,
+                          Base::Vector3f &rclRes, unsigned long &rulFacet) const;
   /**
    * Searches for the first facet of the grid element (\a rclGrid) in that the point \a rclPt lies into which is a distance not
    * higher than \a fMaxDistance. Of no such facet is found \a rulFacet is undefined and false is returned, otherwise true.
@@ -276,6 +288,10 @@ public:
                               unsigned long &rclResFacetIndex, Base::Vector3f &rclResPoint) const;
   bool NearestPointFromPoint (const Base::Vector3f &rclPt, const MeshFacetGrid& rclGrid, float fMaxSearchArea,
                               unsigned long &rclResFacetIndex, Base::Vector3f &rclResPoint) const;
+  bool NearestPointFromPoint (const Base::Vector3f &rclPt, const MeshFacetBVH& rclBVH,
+                              unsigned long &rclResFacetIndex, Base::Vector3f &rclResPoint) const;
+  bool NearestPointFromPoint (const Base::Vector3f &rclPt, const MeshFacetBVH& rclBVH, float fMaxSearchArea,
+                              unsigned long &rclResFacetIndex, Base::Vector3f &rclResPoint) const;
   /** Cuts the mesh with a plane. The result is a list of polylines. */
   bool CutWithPlane (const Base::Vector3f &clBase, const Base::Vector3f &clNormal, const MeshFacetGrid &rclGrid,
                      std::list<std::vector<Base::Vector3f> > &rclResult, float fMinEps = 1.0e-2f, bool bConnectPolygons = false) const;
@@ -502,6 +518,164 @@ protected:
     std::vector<Base::Vector3f> _norm;
 };
 
+/**
+ * The MeshIndexTable maps an index to a sorted list of unique indices. All lists are
+ * stored in one flat array in compressed sparse row format, i.e. an offset array marks
+ * where the list of an index starts. Compared to a std::vector<std::set<unsigned long> >
+ * this needs only a fraction of memory and avoids an allocation per element.
+ *
+ * The table is built in two passes: first the number of elements of each list is
+ * counted with Count(), then after Allocate() the elements are added with Insert().
+ * Finish() sorts each list and removes duplicates.
+ */
+class MeshExport MeshIndexTable
+{
+public:
+    /// A read-only view on the list of one index with a std::set like interface.
+    class Range
+    {
+    public:
+        typedef const unsigned long* const_iterator;
+        typedef const_iterator iterator;
+
+        Range(const_iterator b, const_iterator e) : _begin(b), _end(e) {}
+        const_iterator begin() const { return _begin; }
+        const_iterator end() const { return _end; }
+        std::size_t size() const { return _end - _begin; }
+        bool empty() const { return _begin == _end; }
+        const_iterator find(unsigned long index) const
+        {
+            const_iterator it = std::lower_bound(_begin, _end, index);
+            return (it != _end && *it == index) ? it : _end;
+        }
+        std::size_t count(unsigned long index) const
+        { return find(index) != _end ? 1 : 0; }
+
+    private:
+        const_iterator _begin, _end;
+    };
+
+    MeshIndexTable() {}
+    ~MeshIndexTable() {}
+
+    Range operator[] (unsigned long pos) const
+    {
+        const unsigned long* data = _indices.empty() ? 0 : &(_indices[0]);
+        return Range(data + _offsets[pos], data + _offsets[pos+1]);
+    }
+    unsigned long CountRows() const
+    { return _offsets.empty() ? 0 : _offsets.size() - 1; }
+    void Clear();
+
+    /** @name Building up the table */
+    //@{
+    /// Sets the number of lists and resets all counters.
+    void Resize(unsigned long rows);
+    /// Reserves space for \a num more elements in the list of \a pos.
+    void Count(unsigned long pos, unsigned long num = 1)
+    { _offsets[pos+1] += num; }
+    /// Allocates the flat array after all elements have been counted.
+    void Allocate();
+    /// Adds \a index to the list of \a pos.
+    void Insert(unsigned long pos, unsigned long index)
+    { _indices[_fill[pos]++] = index; }
+    /// Sorts the lists and removes duplicates.
+    void Finish();
+    //@}
+
+protected:
+    std::vector<unsigned long> _offsets;
+    std::vector<unsigned long> _indices;
+    std::vector<unsigned long> _fill;
+};
+
+/**
+ * The MeshCompactPointToFacets offers the same as MeshRefPointToFacets but stores the
+ * data in a MeshIndexTable which is much faster to build and needs much less memory.
+ * \note If the underlying mesh kernel gets changed this structure becomes invalid and must
+ * be rebuilt.
+ */
+class MeshExport MeshCompactPointToFacets
+{
+public:
+    /// Construction
+    MeshCompactPointToFacets (const MeshKernel &rclM) : _rclMesh(rclM) 
+    { Rebuild(); }
+    /// Destruction
+    ~MeshCompactPointToFacets (void)
+    { }
+
+    /// Rebuilds up data structure
+    void Rebuild (void);
+    MeshIndexTable::Range operator[] (unsigned long) const;
+    MeshFacetArray::_TConstIterator GetFacet (unsigned long) const;
+    std::set<unsigned long> NeighbourPoints(const std::vector<unsigned long>& , int level) const;
+    void Neighbours (unsigned long ulFacetInd, float fMaxDist, MeshCollector& collect) const;
+    Base::Vector3f GetNormal(unsigned long) const;
+
+protected:
+    void SearchNeighbours(const MeshFacetArray& rFacets, unsigned long index, const Base::Vector3f &rclCenter, 
+        float fMaxDist, std::set<unsigned long> &visit, MeshCollector& collect) const;
+
+protected:
+    const MeshKernel  &_rclMesh; /**< The mesh kernel. */
+    MeshIndexTable _map;
+};
+
+/**
+ * The MeshCompactFacetToFacets offers the same as MeshRefFacetToFacets but stores the
+ * data in a MeshIndexTable.
+ * \note If the underlying mesh kernel gets changed this structure becomes invalid and must
+ * be rebuilt.
+ */
+class MeshExport MeshCompactFacetToFacets
+{
+public:
+    /// Construction
+    MeshCompactFacetToFacets (const MeshKernel &rclM) : _rclMesh(rclM)
+    { Rebuild(); }
+    /// Destruction
+    ~MeshCompactFacetToFacets (void)
+    { }
+    /// Rebuilds up data structure
+    void Rebuild (void);
+
+    /// Returns the facets sharing one or more points with the facet with
+    /// index \a ulFacetIndex.
+    MeshIndexTable::Range operator[] (unsigned long) const;
+
+protected:
+    const MeshKernel  &_rclMesh; /**< The mesh kernel. */
+    MeshIndexTable _map;
+};
+
+/**
+ * The MeshCompactPointToPoints offers the same as MeshRefPointToPoints but stores the
+ * data in a MeshIndexTable.
+ * \note If the underlying mesh kernel gets changed this structure becomes invalid and must
+ * be rebuilt.
+ */
+class MeshExport MeshCompactPointToPoints
+{
+public:
+    /// Construction
+    MeshCompactPointToPoints (const MeshKernel &rclM) : _rclMesh(rclM) 
+    { Rebuild(); }
+    /// Destruction
+    ~MeshCompactPointToPoints (void)
+    { }
+
+    /// Rebuilds up data structure
+    void Rebuild (void);
+    MeshIndexTable::Range operator[] (unsigned long) const;
+    Base::Vector3f GetNormal(unsigned long) const;
+    float GetAverageEdgeLength(unsigned long) const;
+
+protected:
+    const MeshKernel  &_rclMesh; /**< The mesh kernel. */
+    MeshIndexTable _map;
+};
+
 }; // namespace MeshCore 
 
 #endif  // MESH_ALGORITHM_H 
@@ -25,10 +25,16 @@
 
 #ifndef _PreComp_
 # include <algorithm>
+# include <climits>
 #endif
 
+#include <QThread>
+#include <QFuture>
+#include <QtConcurrentMap>
+
 #include <Base/Sequencer.h>
 #include <Base/Exception.h>
+#include <Base/PointHash.h>
 
 #include "Builder.h"
 #include "MeshKernel.h"
@@ -249,3 +255,260 @@ void MeshBuilder::Finish (bool freeMemory)
 
     _meshKernel.RecalcBoundBox();
 }
+
+// ----------------------------------------------------------------------------
+
+namespace {
+
+/** The data of one thread of MeshFastBuilder::WeldParallel(). */
+struct WeldShard
+{
+    typedef Base::PointHash<float> PointHash;
+
+    const std::vector<Base::Vector3f>* vertices;
+    const std::vector<int>* shards;
+    std::vector<unsigned long>* index;
+    int shard;
+    PointHash hash;
+    std::vector<unsigned long> ids; ///< vertex index of each point of the hash
+
+    WeldShard(float tolerance) : hash(tolerance)
+    {
+    }
+
+    /** Welds the vertices of this shard that have an equal point in their own cell or that
+     * are far enough from the cell border. The others are marked with ULONG_MAX.
+     */
+    void Weld()
+    {
+        const std::vector<Base::Vector3f>& rVertices = *vertices;
+        const std::vector<int>& rShards = *shards;
+        std::vector<unsigned long>& rIndex = *index;
+        PointHash::Cell cells[8];
+        for (std::size_t i = 0; i < rVertices.size(); i++) {
+            if (rShards[i] != shard)
+                continue;
+            int count = hash.getCells(rVertices[i], cells);
+            std::size_t pos = hash.find(rVertices[i], cells[0]);
+            if (pos != PointHash::npos) {
+                rIndex[i] = ids[pos];
+            }
+            else if (count > 1) {
+                rIndex[i] = ULONG_MAX;
+            }
+            else {
+                hash.append(rVertices[i]);
+                ids.push_back(i);
+                rIndex[i] = i;
+            }
+        }
+    }
+};
+
+/** Computes the shard of a range of vertices from the hash value of their cell. */
+struct WeldRange
+{
+    const std::vector<Base::Vector3f>* vertices;
+    std::vector<int>* shards;
+    const Base::PointHash<float>* hash;
+    std::size_t begin, end;
+    int numShards;
+
+    static int Shard(std::size_t h, int numShards)
+    {
+        // don't use the bits of the hash value directly as they also select the slots
+        // of the hash tables
+        unsigned int s = static_cast<unsigned int>(h) * 0x9e3779b1u;
+        return static_cast<int>((s >> 16) % numShards);
+    }
+    void Compute()
+    {
+        for (std::size_t i = begin; i < end; i++)
+            (*shards)[i] = Shard(hash->hash(hash->getCell((*vertices)[i])), numShards);
+    }
+};
+
+} // namespace
+
+MeshFastBuilder::MeshFastBuilder (MeshKernel& kernel) : _meshKernel(kernel)
+{
+}
+
+MeshFastBuilder::~MeshFastBuilder (void)
+{
+}
+
+void MeshFastBuilder::Initialize (unsigned long ctFacets)
+{
+    _vertices.reserve(3 * ctFacets);
+}
+
+void MeshFastBuilder::AddFacet (const MeshGeomFacet& facet)
+{
+    Base::Vector3f facetPoints[4] = { facet._aclPoints[0], facet._aclPoints[1], facet._aclPoints[2], facet.GetNormal() };
+    AddFacet(facetPoints);
+}
+
+void MeshFastBuilder::AddFacet (const Base::Vector3f* facetPoints)
+{
+    // adjust circulation direction
+    if ((((facetPoints[1] - facetPoints[0]) % (facetPoints[2] - facetPoints[0])) * facetPoints[3]) < 0.0f) {
+        _vertices.push_back(facetPoints[0]);
+        _vertices.push_back(facetPoints[2]);
+        _vertices.push_back(facetPoints[1]);
+    }
+    else {
+        _vertices.push_back(facetPoints[0]);
+        _vertices.push_back(facetPoints[1]);
+        _vertices.push_back(facetPoints[2]);
+    }
+}
+
+void MeshFastBuilder::AddFacets (std::vector<Base::Vector3f>& vertices)
+{
+    if (_vertices.empty()) {
+        _vertices.swap(vertices);
+    }
+    else {
+        _vertices.insert(_vertices.end(), vertices.begin(), vertices.end());
+        std::vector<Base::Vector3f>().swap(vertices);
+    }
+}
+
+void MeshFastBuilder::Finish (bool parallel)
+{
+    Base::SequencerLauncher seq("create mesh structure...", 3);
+
+    MeshPointArray points;
+    std::vector<unsigned long> index;
+    if (parallel && _vertices.size() >= 300000 && QThread::idealThreadCount() > 1)
+        WeldParallel(points, index);
+    else
+        Weld(points, index);
+    std::vector<Base::Vector3f>().swap(_vertices);
+    seq.next(true); // allow to cancel
+
+    // skip degenerated facets (one edge has length 0)
+    MeshFacetArray facets;
+    facets.reserve(index.size() / 3);
+    std::vector<bool> used(points.size());
+    for (std::size_t i = 0; i < index.size(); i += 3) {
+        unsigned long p0 = index[i], p1 = index[i+1], p2 = index[i+2];
+        if (p0 == p1 || p0 == p2 || p1 == p2)
+            continue;
+        facets.push_back(MeshFacet(p0, p1, p2));
+        used[p0] = used[p1] = used[p2] = true;
+    }
+    std::vector<unsigned long>().swap(index);
+
+    // remove the points that are only referenced by degenerated facets
+    unsigned long numUsed = std::count(used.begin(), used.end(), true);
+    if (numUsed < points.size()) {
+        std::vector<unsigned long> newIndex(points.size());
+        unsigned long count = 0;
+        for (std::size_t i = 0; i < points.size(); i++) {
+            if (used[i]) {
+                newIndex[i] = count;
+                points[count++] = points[i];
+            }
+        }
+        points.resize(count);
+        for (MeshFacetArray::_TIterator it = facets.begin(); it != facets.end(); ++it) {
+            for (int i = 0; i < 3; i++)
+                it->_aulPoints[i] = newIndex[it->_aulPoints[i]];
+        }
+    }
+    seq.next(true); // allow to cancel
+
+    _meshKernel.Adopt(points, facets, true);
+    seq.next(true);
+}
+
+void MeshFastBuilder::Weld (MeshPointArray& points, std::vector<unsigned long>& index) const
+{
+    Base::PointHash<float> hash(MeshDefinitions::_fMinPointDistanceD1);
+    // usually a point is shared by six facets
+    hash.reserve(_vertices.size() / 6);
+
+    index.resize(_vertices.size());
+    for (std::size_t i = 0; i < _vertices.size(); i++)
+        index[i] = hash.insert(_vertices[i]);
+
+    const std::vector<Base::Vector3f>& rPoints = hash.getPoints();
+    points.reserve(rPoints.size());
+    for (std::vector<Base::Vector3f>::const_iterator it = rPoints.begin(); it != rPoints.end(); ++it)
+        points.push_back(*it);
+}
+
+void MeshFastBuilder::WeldParallel (MeshPointArray& points, std::vector<unsigned long>& index) const
+{
+    // The vertices are distributed to several hash tables by the cell they lie in and
+    // each table is filled by a thread of its own. A vertex near a cell border that doesn't
+    // find an equal point in its own cell may have one in a neighbour cell of another
+    // table, so it's welded afterwards.
+    const int numShards = QThread::idealThreadCount();
+    const float tolerance = MeshDefinitions::_fMinPointDistanceD1;
+    const std::size_t numVertices = _vertices.size();
+    Base::PointHash<float> hash(tolerance);
+
+    std::vector<int> shards(numVertices);
+    std::vector<WeldRange> ranges(numShards);
+    for (int i = 0; i < numShards; i++) {
+        ranges[i].vertices = &_vertices;
+        ranges[i].shards = &shards;
+        ranges[i].hash = &hash;
+        ranges[i].begin = i * numVertices / numShards;
+        ranges[i].end = (i + 1) * numVertices / numShards;
+        ranges[i].numShards = numShards;
+    }
+    QtConcurrent::map(ranges, &WeldRange::Compute).waitForFinished();
+
+    index.resize(numVertices);
+    std::vector<WeldShard> welder(numShards, WeldShard(tolerance));
+    for (int i = 0; i < numShards; i++) {
+        welder[i].vertices = &_vertices;
+        welder[i].shards = &shards;
+        welder[i].index = &index;
+        welder[i].shard = i;
+        welder[i].hash.reserve(numVertices / (6 * numShards));
+    }
+    QtConcurrent::map(welder, &WeldShard::Weld).waitForFinished();
+    std::vector<int>().swap(shards);
+
+    // the remaining vertices near a cell border
+    Base::PointHash<float>::Cell cells[8];
+    for (std::size_t i = 0; i < numVertices; i++) {
+        if (index[i] != ULONG_MAX)
+            continue;
+        int count = hash.getCells(_vertices[i], cells);
+        for (int j = 0; j < count && index[i] == ULONG_MAX; j++) {
+            WeldShard& shard = welder[WeldRange::Shard(hash.hash(cells[j]), numShards)];
+            std::size_t pos = shard.hash.find(_vertices[i], cells[j]);
+            if (pos != Base::PointHash<float>::npos)
+                index[i] = shard.ids[pos];
+        }
+        if (index[i] == ULONG_MAX) {
+            WeldShard& shard = welder[WeldRange::Shard(hash.hash(cells[0]), numShards)];
+            shard.hash.append(_vertices[i]);
+            shard.ids.push_back(i);
+            index[i] = i;
+        }
+    }
+
+    // Now each vertex refers to the vertex that represents its point. Number the points in
+    // the order of these vertices and mark them with the highest bit until all vertices
+    // are resolved.
+    const unsigned long mark = ~(ULONG_MAX >> 1);
+    for (std::size_t i = 0; i < numVertices; i++) {
+        if (index[i] == i) {
+            index[i] = points.size() | mark;
+            points.push_back(_vertices[i]);
+        }
+    }
+    for (std::size_t i = 0; i < numVertices; i++) {
+        if (index[i] & mark)
+            index[i] &= ~mark;
+        else
+            index[i] = index[index[i]] & ~mark;
+    }
+}
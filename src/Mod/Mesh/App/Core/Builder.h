@@ -164,6 +164,63 @@ private:
     float _fSaveTolerance;
 };
 
+/**
+ * Class for creating the mesh structure from a set of unconnected facets as e.g. read from
+ * an STL file. Unlike MeshBuilder it doesn't search for duplicated points while adding the
+ * facets but collects their vertices and welds them in Finish() with a spatial hash. The
+ * points are compared with the same tolerance as in MeshBuilder.
+ * \code
+ * MeshFastBuilder builder(someMeshReference);
+ * builder.Initialize(numberOfFacets);
+ * ...
+ * for (...)
+ *   builder.AddFacet(...);
+ * ...
+ * builder.Finish();
+ * \endcode
+ * @author agent
+ */
+class MeshExport MeshFastBuilder
+{
+public:
+    MeshFastBuilder(MeshKernel &rclM);
+    ~MeshFastBuilder(void);
+
+    /** Reserves memory for \a ctFacets facets. */
+    void Initialize (unsigned long ctFacets);
+    /** Add new facet, the order of the vertices is adjusted to its normal. */
+    void AddFacet (const MeshGeomFacet& facet);
+    /** Add new facet
+     * @param facetPoints Array of vectors (size 4) in order of vec1, vec2,
+     *                    vec3, normal
+     */
+    void AddFacet (const Base::Vector3f* facetPoints);
+    /** Adds the facets given by three successive vertices each. The order of the vertices
+     * must already be adjusted to the normals. The content of \a vertices is taken over
+     * and the vector is left empty.
+     */
+    void AddFacets (std::vector<Base::Vector3f>& vertices);
+    /** Welds the vertices and replaces the data of the mesh kernel with the new structure.
+     * If \a parallel is true the vertices of large meshes are welded by several threads.
+     * @remarks In this case two points near a cell border of the spatial hash can be
+     * merged with another point than in the serial mode, but all merged points are within
+     * the tolerance.
+     */
+    void Finish (bool parallel = true);
+
+private:
+    void Weld (MeshPointArray& points, std::vector<unsigned long>& index) const;
+    void WeldParallel (MeshPointArray& points, std::vector<unsigned long>& index) const;
+
+private:
+    MeshFastBuilder (const MeshFastBuilder&);
+    void operator = (const MeshFastBuilder&);
+
+private:
+    MeshKernel& _meshKernel;
+    std::vector<Base::Vector3f> _vertices;
+};
+
 } // namespace MeshCore
 
 #endif 
@@ -0,0 +1,576 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent[at]local>                             *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <climits>
+# include <cmath>
+#endif
+
+#include "Bvh.h"
+#include "Definitions.h"
+#include "Iterator.h"
+#include "MeshKernel.h"
+
+using namespace MeshCore;
+
+#define MESH_BVH_BINS 16
+
+namespace MeshCore {
+struct MeshFacetBVH::Ray
+{
+  Base::Vector3f org;
+  Base::Vector3f dir;
+  float inv[3];
+  float tmax;
+  unsigned long facet;
+
+  void Init(const Base::Vector3f& p, const Base::Vector3f& d)
+  {
+    org = p;
+    dir = d;
+    for (unsigned short i=0; i<3; i++) {
+      // avoid the division by zero, a huge value does the same job as infinity
+      float f = d[i];
+      if (fabs(f) < 1.0e-30f)
+        f = f < 0.0f ? -1.0e-30f : 1.0e-30f;
+      inv[i] = 1.0f / f;
+    }
+    tmax = FLOAT_MAX;
+    facet = ULONG_MAX;
+  }
+};
+}
+
+namespace {
+  struct BuildItem
+  {
+    float bmin[3];
+    float bmax[3];
+    float cent[3];
+    unsigned long index;
+  };
+
+  struct BuildTask
+  {
+    unsigned long begin, end;
+    unsigned long parent;
+    bool right;
+  };
+
+  struct Bin
+  {
+    float bmin[3];
+    float bmax[3];
+    unsigned long count;
+  };
+
+  inline void ResetBox(float* bmin, float* bmax)
+  {
+    for (int i=0; i<3; i++) {
+      bmin[i] =  FLOAT_MAX;
+      bmax[i] = -FLOAT_MAX;
+    }
+  }
+
+  inline void GrowBox(float* bmin, float* bmax, const float* omin, const float* omax)
+  {
+    for (int i=0; i<3; i++) {
+      bmin[i] = std::min<float>(bmin[i], omin[i]);
+      bmax[i] = std::max<float>(bmax[i], omax[i]);
+    }
+  }
+
+  /// Half of the surface area, the factor doesn't matter for the SAH
+  inline float HalfArea(const float* bmin, const float* bmax)
+  {
+    float dx = bmax[0] - bmin[0];
+    float dy = bmax[1] - bmin[1];
+    float dz = bmax[2] - bmin[2];
+    if (dx < 0.0f || dy < 0.0f || dz < 0.0f)
+      return 0.0f;
+    return dx * dy + dy * dz + dz * dx;
+  }
+
+  inline unsigned long BinIndex(float c, float cmin, float k)
+  {
+    unsigned long b = (unsigned long)((c - cmin) * k);
+    return std::min<unsigned long>(b, MESH_BVH_BINS - 1);
+  }
+
+  struct BinPredicate
+  {
+    BinPredicate(int a, float m, float f, unsigned long b) : axis(a), cmin(m), k(f), bin(b) {}
+    bool operator()(const BuildItem& item) const
+    { return BinIndex(item.cent[axis], cmin, k) <= bin; }
+    int axis;
+    float cmin, k;
+    unsigned long bin;
+  };
+}
+
+MeshFacetBVH::MeshFacetBVH (const MeshKernel &rclM)
+{
+  Build(rclM, Base::Matrix4D());
+}
+
+MeshFacetBVH::MeshFacetBVH (const MeshKernel &rclM, const Base::Matrix4D &rclMat)
+{
+  Build(rclM, rclMat);
+}
+
+MeshFacetBVH::~MeshFacetBVH (void)
+{
+}
+
+void MeshFacetBVH::Build (const MeshKernel &rclM, const Base::Matrix4D &rclMat)
+{
+  unsigned long ulCtFacets = rclM.CountFacets();
+  if (ulCtFacets == 0)
+    return;
+
+  std::vector<BuildItem> aclItems(ulCtFacets);
+  std::vector<Triangle> aclTrias(ulCtFacets);
+
+  MeshFacetIterator clFIter(rclM);
+  clFIter.Transform(rclMat);
+  for (clFIter.Init(); clFIter.More(); clFIter.Next()) {
+    unsigned long ulPos = clFIter.Position();
+    const MeshGeomFacet& rclFacet = *clFIter;
+    Triangle& rclTria = aclTrias[ulPos];
+    rclTria.p0 = rclFacet._aclPoints[0];
+    rclTria.e1 = rclFacet._aclPoints[1] - rclFacet._aclPoints[0];
+    rclTria.e2 = rclFacet._aclPoints[2] - rclFacet._aclPoints[0];
+    rclTria.nn = (rclTria.e1 % rclTria.e2).Sqr();
+
+    BuildItem& rclItem = aclItems[ulPos];
+    rclItem.index = ulPos;
+    ResetBox(rclItem.bmin, rclItem.bmax);
+    for (int i=0; i<3; i++) {
+      const Base::Vector3f& p = rclFacet._aclPoints[i];
+      for (unsigned short j=0; j<3; j++) {
+        rclItem.bmin[j] = std::min<float>(rclItem.bmin[j], p[j]);
+        rclItem.bmax[j] = std::max<float>(rclItem.bmax[j], p[j]);
+      }
+    }
+    for (int j=0; j<3; j++)
+      rclItem.cent[j] = 0.5f * (rclItem.bmin[j] + rclItem.bmax[j]);
+  }
+
+  _aclNodes.reserve(2 * ulCtFacets / MESH_BVH_LEAF_SIZE + 1);
+
+  // the left child is always built directly after its parent
+  std::vector<BuildTask> aclTasks;
+  BuildTask clRoot = {0, ulCtFacets, 0, false};
+  aclTasks.push_back(clRoot);
+  while (!aclTasks.empty()) {
+    BuildTask clTask = aclTasks.back();
+    aclTasks.pop_back();
+
+    unsigned long ulNode = _aclNodes.size();
+    _aclNodes.push_back(Node());
+    if (clTask.right)
+      _aclNodes[clTask.parent].index = ulNode;
+
+    float cmin[3], cmax[3];
+    Node clNode;
+    ResetBox(clNode.bmin, clNode.bmax);
+    ResetBox(cmin, cmax);
+    for (unsigned long i = clTask.begin; i < clTask.end; i++) {
+      const BuildItem& rclItem = aclItems[i];
+      GrowBox(clNode.bmin, clNode.bmax, rclItem.bmin, rclItem.bmax);
+      GrowBox(cmin, cmax, rclItem.cent, rclItem.cent);
+    }
+
+    // search for the cheapest split plane between the bins of all three axes
+    unsigned long ulCount = clTask.end - clTask.begin;
+    float fBestCost = FLOAT_MAX;
+    int iBestAxis = -1;
+    unsigned long ulBestBin = 0;
+    for (int a=0; a<3 && ulCount > 1; a++) {
+      float fExtent = cmax[a] - cmin[a];
+      if (fExtent <= 0.0f)
+        continue;
+      float k = float(MESH_BVH_BINS) / fExtent;
+
+      Bin aclBins[MESH_BVH_BINS];
+      for (int b=0; b<MESH_BVH_BINS; b++) {
+        ResetBox(aclBins[b].bmin, aclBins[b].bmax);
+        aclBins[b].count = 0;
+      }
+      for (unsigned long i = clTask.begin; i < clTask.end; i++) {
+        const BuildItem& rclItem = aclItems[i];
+        Bin& rclBin = aclBins[BinIndex(rclItem.cent[a], cmin[a], k)];
+        GrowBox(rclBin.bmin, rclBin.bmax, rclItem.bmin, rclItem.bmax);
+        rclBin.count++;
+      }
+
+      float fRightArea[MESH_BVH_BINS];
+      unsigned long ulRightCount[MESH_BVH_BINS];
+      float bmin[3], bmax[3];
+      ResetBox(bmin, bmax);
+      unsigned long ulSum = 0;
+      for (int b=MESH_BVH_BINS-1; b>0; b--) {
+        GrowBox(bmin, bmax, aclBins[b].bmin, aclBins[b].bmax);
+        ulSum += aclBins[b].count;
+        fRightArea[b] = HalfArea(bmin, bmax);
+        ulRightCount[b] = ulSum;
+      }
+
+      ResetBox(bmin, bmax);
+      ulSum = 0;
+      for (int b=0; b<MESH_BVH_BINS-1; b++) {
+        GrowBox(bmin, bmax, aclBins[b].bmin, aclBins[b].bmax);
+        ulSum += aclBins[b].count;
+        if (ulSum == 0 || ulRightCount[b+1] == 0)
+          continue;
+        float fCost = HalfArea(bmin, bmax) * float(ulSum) + fRightArea[b+1] * float(ulRightCount[b+1]);
+        if (fCost < fBestCost) {
+          fBestCost = fCost;
+          iBestAxis = a;
+          ulBestBin = b;
+        }
+      }
+    }
+
+    // compare with the costs of a leaf, a traversal step is regarded as expensive as two facet tests
+    bool bSplit = false;
+    if (ulCount > MESH_BVH_LEAF_SIZE) {
+      bSplit = true;
+    }
+    else if (iBestAxis >= 0) {
+      float fArea = HalfArea(clNode.bmin, clNode.bmax);
+      bSplit = fArea > 0.0f && (2.0f + fBestCost / fArea) < float(ulCount);
+    }
+
+    unsigned long ulMid = clTask.begin + ulCount / 2;
+    if (bSplit && iBestAxis >= 0) {
+      float k = float(MESH_BVH_BINS) / (cmax[iBestAxis] - cmin[iBestAxis]);
+      std::vector<BuildItem>::iterator it = std::partition(aclItems.begin() + clTask.begin,
+        aclItems.begin() + clTask.end, BinPredicate(iBestAxis, cmin[iBestAxis], k, ulBestBin));
+      ulMid = it - aclItems.begin();
+    }
+    else if (bSplit) {
+      // all centroids coincide, so any split is as good as the other
+      iBestAxis = 0;
+    }
+
+    if (bSplit) {
+      clNode.count = 0;
+      clNode.axis = iBestAxis;
+      clNode.index = 0;
+      BuildTask clRight = {ulMid, clTask.end, ulNode, true};
+      BuildTask clLeft = {clTask.begin, ulMid, ulNode, false};
+      aclTasks.push_back(clRight);
+      aclTasks.push_back(clLeft);
+    }
+    else {
+      clNode.count = ulCount;
+      clNode.axis = 0;
+      clNode.index = clTask.begin;
+    }
+
+    // the index of the right child is set when it gets built
+    _aclNodes[ulNode] = clNode;
+  }
+
+  _aclTriangles.resize(ulCtFacets);
+  _aulFacets.resize(ulCtFacets);
+  for (unsigned long i = 0; i < ulCtFacets; i++) {
+    _aclTriangles[i] = aclTrias[aclItems[i].index];
+    _aulFacets[i] = aclItems[i].index;
+  }
+}
+
+Base::BoundBox3f MeshFacetBVH::GetBoundBox (void) const
+{
+  if (_aclNodes.empty())
+    return Base::BoundBox3f();
+  const Node& rclRoot = _aclNodes.front();
+  return Base::BoundBox3f(rclRoot.bmin[0], rclRoot.bmin[1], rclRoot.bmin[2],
+                          rclRoot.bmax[0], rclRoot.bmax[1], rclRoot.bmax[2]);
+}
+
+bool MeshFacetBVH::NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir,
+                                      Base::Vector3f &rclRes, unsigned long &rulFacet) const
+{
+  Ray clRay;
+  clRay.Init(rclPt, rclDir);
+  TraversePacket(&clRay, 1);
+  if (clRay.facet == ULONG_MAX)
+    return false;
+  rclRes = rclPt + clRay.tmax * rclDir;
+  rulFacet = clRay.facet;
+  return true;
+}
+
+void MeshFacetBVH::NearestFacetsOnRays (const std::vector<Base::Vector3f> &raclPts, const std::vector<Base::Vector3f> &raclDirs,
+                                        std::vector<Base::Vector3f> &raclRes, std::vector<unsigned long> &raulFacets) const
+{
+  unsigned long ulCtRays = std::min<unsigned long>(raclPts.size(), raclDirs.size());
+  raclRes.resize(ulCtRays);
+  raulFacets.resize(ulCtRays);
+
+  Ray aclRays[MESH_BVH_PACKET_SIZE];
+  for (unsigned long ulStart = 0; ulStart < ulCtRays; ulStart += MESH_BVH_PACKET_SIZE) {
+    unsigned long ulCount = std::min<unsigned long>(MESH_BVH_PACKET_SIZE, ulCtRays - ulStart);
+    for (unsigned long i = 0; i < ulCount; i++)
+      aclRays[i].Init(raclPts[ulStart + i], raclDirs[ulStart + i]);
+
+    TraversePacket(aclRays, ulCount);
+
+    for (unsigned long i = 0; i < ulCount; i++) {
+      const Ray& rclRay = aclRays[i];
+      raulFacets[ulStart + i] = rclRay.facet;
+      if (rclRay.facet != ULONG_MAX)
+        raclRes[ulStart + i] = rclRay.org + rclRay.tmax * rclRay.dir;
+    }
+  }
+}
+
+bool MeshFacetBVH::IntersectBox (const Node &rclNode, const Ray &rclRay) const
+{
+  // slab test, only boxes in front of the nearest facet found so far are of interest
+  float tnear = 0.0f, tfar = rclRay.tmax;
+  for (unsigned short a=0; a<3; a++) {
+    float t0 = (rclNode.bmin[a] - rclRay.org[a]) * rclRay.inv[a];
+    float t1 = (rclNode.bmax[a] - rclRay.org[a]) * rclRay.inv[a];
+    if (t0 > t1)
+      std::swap(t0, t1);
+    tnear = std::max<float>(tnear, t0);
+    tfar = std::min<float>(tfar, t1);
+  }
+  return tnear <= tfar;
+}
+
+void MeshFacetBVH::TraversePacket (Ray *pRays, unsigned long ulCount) const
+{
+  if (_aclNodes.empty())
+    return;
+
+  // the same criterion for parallel rays as in MeshGeomFacet::Foraminate()
+  const float eps = 1e-06f;
+
+  // A stack element holds the node and the first ray that may hit it. Rays that miss
+  // the box of a parent also miss the boxes of its children.
+  std::vector<std::pair<unsigned long, unsigned long> > aclStack;
+  aclStack.reserve(64);
+  aclStack.push_back(std::make_pair(0ul, 0ul));
+  while (!aclStack.empty()) {
+    unsigned long ulNode = aclStack.back().first;
+    unsigned long ulFirst = aclStack.back().second;
+    aclStack.pop_back();
+
+    const Node& rclNode = _aclNodes[ulNode];
+    while (ulFirst < ulCount && !IntersectBox(rclNode, pRays[ulFirst]))
+      ulFirst++;
+    if (ulFirst == ulCount)
+      continue;
+
+    if (rclNode.count > 0) {
+      for (unsigned long r = ulFirst; r < ulCount; r++) {
+        Ray& rclRay = pRays[r];
+        if (r > ulFirst && !IntersectBox(rclNode, rclRay))
+          continue;
+        for (unsigned long i = rclNode.index; i < rclNode.index + rclNode.count; i++) {
+          const Triangle& rclTria = _aclTriangles[i];
+          Base::Vector3f p = rclRay.dir % rclTria.e2;
+          float det = rclTria.e1 * p;
+          if (det * det <= eps * rclRay.dir.Sqr() * rclTria.nn)
+            continue;
+          float inv = 1.0f / det;
+          Base::Vector3f s = rclRay.org - rclTria.p0;
+          float u = (s * p) * inv;
+          if (u < 0.0f || u > 1.0f)
+            continue;
+          Base::Vector3f q = s % rclTria.e1;
+          float v = (rclRay.dir * q) * inv;
+          if (v < 0.0f || u + v > 1.0f)
+            continue;
+          float t = (rclTria.e2 * q) * inv;
+          if (t >= 0.0f && t < rclRay.tmax) {
+            rclRay.tmax = t;
+            rclRay.facet = _aulFacets[i];
+          }
+        }
+      }
+    }
+    else {
+      // visit the child first that lies in direction of the packet
+      if (pRays[ulFirst].dir[(unsigned short)rclNode.axis] < 0.0f) {
+        aclStack.push_back(std::make_pair(ulNode + 1, ulFirst));
+        aclStack.push_back(std::make_pair(rclNode.index, ulFirst));
+      }
+      else {
+        aclStack.push_back(std::make_pair(rclNode.index, ulFirst));
+        aclStack.push_back(std::make_pair(ulNode + 1, ulFirst));
+      }
+    }
+  }
+}
+
+float MeshFacetBVH::SqrDistance (const Triangle &rclTria, const Base::Vector3f &rclPt) const
+{
+  // determine the Voronoi region of the triangle the point lies in
+  const Base::Vector3f& ab = rclTria.e1;
+  const Base::Vector3f& ac = rclTria.e2;
+  Base::Vector3f ap = rclPt - rclTria.p0;
+  float d1 = ab * ap;
+  float d2 = ac * ap;
+  if (d1 <= 0.0f && d2 <= 0.0f)
+    return ap.Sqr();
+
+  Base::Vector3f bp = ap - ab;
+  float d3 = ab * bp;
+  float d4 = ac * bp;
+  if (d3 >= 0.0f && d4 <= d3)
+    return bp.Sqr();
+
+  float vc = d1 * d4 - d3 * d2;
+  if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+    return (ap - (d1 / (d1 - d3)) * ab).Sqr();
+
+  Base::Vector3f cp = ap - ac;
+  float d5 = ab * cp;
+  float d6 = ac * cp;
+  if (d6 >= 0.0f && d5 <= d6)
+    return cp.Sqr();
+
+  float vb = d5 * d2 - d1 * d6;
+  if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+    return (ap - (d2 / (d2 - d6)) * ac).Sqr();
+
+  float va = d3 * d6 - d5 * d4;
+  if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+    return (bp - ((d4 - d3) / ((d4 - d3) + (d5 - d6))) * (ac - ab)).Sqr();
+
+  float denom = 1.0f / (va + vb + vc);
+  return (ap - (vb * denom) * ab - (vc * denom) * ac).Sqr();
+}
+
+unsigned long MeshFacetBVH::SearchNearest (const Base::Vector3f &rclPt, float fMaxSqrDist) const
+{
+  unsigned long ulFacet = ULONG_MAX;
+  if (_aclNodes.empty())
+    return ulFacet;
+
+  float fMinDist = fMaxSqrDist;
+  std::vector<std::pair<unsigned long, float> > aclStack;
+  aclStack.reserve(64);
+  aclStack.push_back(std::make_pair(0ul, 0.0f));
+  while (!aclStack.empty()) {
+    std::pair<unsigned long, float> clTop = aclStack.back();
+    aclStack.pop_back();
+    if (clTop.second >= fMinDist)
+      continue;
+
+    const Node& rclNode = _aclNodes[clTop.first];
+    if (rclNode.count > 0) {
+      for (unsigned long i = rclNode.index; i < rclNode.index + rclNode.count; i++) {
+        float fDist = SqrDistance(_aclTriangles[i], rclPt);
+        if (fDist < fMinDist) {
+          fMinDist = fDist;
+          ulFacet = _aulFacets[i];
+        }
+      }
+    }
+    else {
+      // squared distances to the boxes of both children, the nearer one is visited first
+      unsigned long aulChild[2] = {clTop.first + 1, rclNode.index};
+      float afDist[2];
+      for (int c=0; c<2; c++) {
+        const Node& rclChild = _aclNodes[aulChild[c]];
+        float fDist = 0.0f;
+        for (unsigned short a=0; a<3; a++) {
+          float d = std::max<float>(std::max<float>(rclChild.bmin[a] - rclPt[a], rclPt[a] - rclChild.bmax[a]), 0.0f);
+          fDist += d * d;
+        }
+        afDist[c] = fDist;
+      }
+
+      int iNear = afDist[0] <= afDist[1] ? 0 : 1;
+      if (afDist[1-iNear] < fMinDist)
+        aclStack.push_back(std::make_pair(aulChild[1-iNear], afDist[1-iNear]));
+      if (afDist[iNear] < fMinDist)
+        aclStack.push_back(std::make_pair(aulChild[iNear], afDist[iNear]));
+    }
+  }
+
+  return ulFacet;
+}
+
+unsigned long MeshFacetBVH::SearchNearestFromPoint (const Base::Vector3f &rclPt) const
+{
+  return SearchNearest(rclPt, FLOAT_MAX);
+}
+
+unsigned long MeshFacetBVH::SearchNearestFromPoint (const Base::Vector3f &rclPt, float fMaxSearchArea) const
+{
+  return SearchNearest(rclPt, fMaxSearchArea * fMaxSearchArea);
+}
+
+void MeshFacetBVH::SearchFacets (const Base::BoundBox3f &rclBB, std::vector<unsigned long> &raulFacets) const
+{
+  if (_aclNodes.empty())
+    return;
+
+  const float bmin[3] = {rclBB.MinX, rclBB.MinY, rclBB.MinZ};
+  const float bmax[3] = {rclBB.MaxX, rclBB.MaxY, rclBB.MaxZ};
+  std::vector<unsigned long> aulStack;
+  aulStack.reserve(64);
+  aulStack.push_back(0);
+  while (!aulStack.empty()) {
+    unsigned long ulNode = aulStack.back();
+    aulStack.pop_back();
+
+    const Node& rclNode = _aclNodes[ulNode];
+    if (rclNode.bmin[0] > bmax[0] || rclNode.bmax[0] < bmin[0] ||
+        rclNode.bmin[1] > bmax[1] || rclNode.bmax[1] < bmin[1] ||
+        rclNode.bmin[2] > bmax[2] || rclNode.bmax[2] < bmin[2])
+      continue;
+
+    if (rclNode.count > 0) {
+      for (unsigned long i = rclNode.index; i < rclNode.index + rclNode.count; i++) {
+        // the box of the facet itself
+        const Triangle& rclTria = _aclTriangles[i];
+        bool bOverlap = true;
+        for (unsigned short a=0; a<3 && bOverlap; a++) {
+          float p0 = rclTria.p0[a];
+          float p1 = p0 + rclTria.e1[a];
+          float p2 = p0 + rclTria.e2[a];
+          float fMin = std::min<float>(p0, std::min<float>(p1, p2));
+          float fMax = std::max<float>(p0, std::max<float>(p1, p2));
+          bOverlap = fMin <= bmax[a] && fMax >= bmin[a];
+        }
+        if (bOverlap)
+          raulFacets.push_back(_aulFacets[i]);
+      }
+    }
+    else {
+      aulStack.push_back(rclNode.index);
+      aulStack.push_back(ulNode + 1);
+    }
+  }
+}
@@ -0,0 +1,151 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent[at]local>                             *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef MESH_BVH_H
+#define MESH_BVH_H
+
+#include <vector>
+
+#include <Base/Vector3D.h>
+#include <Base/BoundBox.h>
+#include <Base/Matrix.h>
+
+#define  MESH_BVH_LEAF_SIZE    4       // Max. number of facets of a leaf if a split is possible
+#define  MESH_BVH_PACKET_SIZE  16      // Number of rays traversed together in NearestFacetsOnRays()
+
+
+namespace MeshCore {
+
+class MeshKernel;
+
+/**
+ * The MeshFacetBVH is a bounding volume hierarchy over the facets of a mesh.
+ * It is an alternative to the MeshFacetGrid for ray casting and for searching the
+ * nearest facet to a point. Unlike the grid its size doesn't depend on the distribution
+ * of the facets and each facet is referenced exactly once, so it also copes with meshes
+ * with very different facet sizes.
+ *
+ * The tree is built with the surface area heuristic (SAH) over binned facet centroids.
+ * The facets are stored in the order of the leaves so that a traversal reads them
+ * sequentially. The structure keeps a copy of the facet geometry and thus doesn't refer to
+ * the mesh any more after it has been built, but it must be rebuilt if the mesh changes.
+ * All search methods are const and can be called from several threads at a time.
+ * @author agent
+ */
+class MeshExport MeshFacetBVH
+{
+public:
+  /** @name Construction */
+  //@{
+  /// Builds the hierarchy for the facets of \a rclM.
+  MeshFacetBVH (const MeshKernel &rclM);
+  /// Builds the hierarchy for the facets of \a rclM transformed by \a rclMat.
+  MeshFacetBVH (const MeshKernel &rclM, const Base::Matrix4D &rclMat);
+  /// Destruction
+  ~MeshFacetBVH (void);
+  //@}
+
+  /** @name Search */
+  //@{
+  /**
+   * Searches for the nearest facet hit by the ray (\a rclPt, \a rclDir). Only intersections in
+   * direction of \a rclDir are taken into account. The intersection point is set to \a rclRes and
+   * the index of the facet to \a rulFacet. If no facet is hit false is returned.
+   */
+  bool NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir,
+                          Base::Vector3f &rclRes, unsigned long &rulFacet) const;
+  /**
+   * Does the same as NearestFacetOnRay() for a set of rays. The rays are traversed in packets of
+   * MESH_BVH_PACKET_SIZE which is much faster if neighboured rays are coherent, e.g. if they have
+   * nearly the same direction and close base points. For rays without a hit the facet index is
+   * set to ULONG_MAX.
+   */
+  void NearestFacetsOnRays (const std::vector<Base::Vector3f> &raclPts, const std::vector<Base::Vector3f> &raclDirs,
+                            std::vector<Base::Vector3f> &raclRes, std::vector<unsigned long> &raulFacets) const;
+  /** Returns the index of the facet nearest to \a rclPt or ULONG_MAX if the mesh is empty. */
+  unsigned long SearchNearestFromPoint (const Base::Vector3f &rclPt) const;
+  /**
+   * Returns the index of the facet nearest to \a rclPt with a distance less than \a fMaxSearchArea.
+   * If there is no such facet ULONG_MAX is returned.
+   */
+  unsigned long SearchNearestFromPoint (const Base::Vector3f &rclPt, float fMaxSearchArea) const;
+  /**
+   * Appends the indices of all facets whose bounding boxes intersect \a rclBB to \a raulFacets.
+   * The indices are not sorted.
+   */
+  void SearchFacets (const Base::BoundBox3f &rclBB, std::vector<unsigned long> &raulFacets) const;
+  //@}
+
+  /** @name Information */
+  //@{
+  /// Returns the bounding box of all facets.
+  Base::BoundBox3f GetBoundBox (void) const;
+  /// Returns the number of facets.
+  unsigned long CountFacets (void) const
+  { return _aulFacets.size(); }
+  /// Returns the number of nodes of the hierarchy.
+  unsigned long CountNodes (void) const
+  { return _aclNodes.size(); }
+  //@}
+
+private:
+  /**
+   * A node of the hierarchy. The left child of an inner node directly follows its parent,
+   * \a index is the position of the right child. For a leaf \a index is the position of its
+   * first facet and \a count the number of its facets.
+   */
+  struct Node
+  {
+    float bmin[3];
+    float bmax[3];
+    unsigned long index;
+    unsigned long count; ///< 0 for inner nodes
+    unsigned long axis;  ///< split axis of inner nodes
+  };
+  /// The facet data needed by the intersection tests.
+  struct Triangle
+  {
+    Base::Vector3f p0, e1, e2;
+    float nn; ///< squared length of the (not normalized) normal
+  };
+  struct Ray;
+
+  void Build (const MeshKernel &rclM, const Base::Matrix4D &rclMat);
+  float SqrDistance (const Triangle &rclTria, const Base::Vector3f &rclPt) const;
+  bool IntersectBox (const Node &rclNode, const Ray &rclRay) const;
+  unsigned long SearchNearest (const Base::Vector3f &rclPt, float fMaxSqrDist) const;
+  void TraversePacket (Ray *pRays, unsigned long ulCount) const;
+
+private:
+  MeshFacetBVH (const MeshFacetBVH&);
+  void operator = (const MeshFacetBVH&);
+
+private:
+  std::vector<Node>          _aclNodes;     /**< The nodes, the first one is the root. */
+  std::vector<Triangle>      _aclTriangles; /**< The facets in the order of the leaves. */
+  std::vector<unsigned long> _aulFacets;    /**< The mesh indices of the facets. */
+};
+
+} // namespace MeshCore
+
+#endif // MESH_BVH_H
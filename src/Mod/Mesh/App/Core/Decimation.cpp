@@ -0,0 +1,667 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent[at]local>                             *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <cfloat>
+# include <cmath>
+# include <functional>
+# include <queue>
+# include <vector>
+#endif
+
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include "Decimation.h"
+#include "MeshKernel.h"
+#include "Elements.h"
+#include "TopoAlgorithm.h"
+#include <Base/Tools.h>
+
+using namespace MeshCore;
+
+namespace MeshCore {
+namespace {
+
+/**
+ * The symmetric 4x4 matrix of a quadric error metric. Only the upper triangle is stored
+ * in the order a00, a01, a02, a03, a11, a12, a13, a22, a23, a33.
+ */
+struct Quadric
+{
+    double a[10];
+
+    Quadric()
+    {
+        std::fill(a, a + 10, 0.0);
+    }
+    /// Adds the squared distance to the plane n*x+d=0 with the weight w.
+    void AddPlane(const Base::Vector3d& n, double d, double w)
+    {
+        a[0] += w*n.x*n.x; a[1] += w*n.x*n.y; a[2] += w*n.x*n.z; a[3] += w*n.x*d;
+        a[4] += w*n.y*n.y; a[5] += w*n.y*n.z; a[6] += w*n.y*d;
+        a[7] += w*n.z*n.z; a[8] += w*n.z*d;
+        a[9] += w*d*d;
+    }
+    Quadric& operator += (const Quadric& q)
+    {
+        for (int i=0; i<10; i++)
+            a[i] += q.a[i];
+        return *this;
+    }
+    double Evaluate(const Base::Vector3d& p) const
+    {
+        return a[0]*p.x*p.x + 2.0*a[1]*p.x*p.y + 2.0*a[2]*p.x*p.z + 2.0*a[3]*p.x
+                            +     a[4]*p.y*p.y + 2.0*a[5]*p.y*p.z + 2.0*a[6]*p.y
+                                               +     a[7]*p.z*p.z + 2.0*a[8]*p.z
+                                                                  +     a[9];
+    }
+    /// Computes the point of minimal error if the problem is well-conditioned.
+    bool Minimize(Base::Vector3d& p) const
+    {
+        double c00 = a[4]*a[7] - a[5]*a[5];
+        double c01 = a[2]*a[5] - a[1]*a[7];
+        double c02 = a[1]*a[5] - a[2]*a[4];
+        double det = a[0]*c00 + a[1]*c01 + a[2]*c02;
+        // on flat or cylindrical regions the matrix is (nearly) singular
+        double tr = (a[0] + a[4] + a[7]) / 3.0;
+        if (fabs(det) <= 1.0e-6 * tr * tr * tr)
+            return false;
+        double c11 = a[0]*a[7] - a[2]*a[2];
+        double c12 = a[1]*a[2] - a[0]*a[5];
+        double c22 = a[0]*a[4] - a[1]*a[1];
+        p.x = -(c00*a[3] + c01*a[6] + c02*a[8]) / det;
+        p.y = -(c01*a[3] + c11*a[6] + c12*a[8]) / det;
+        p.z = -(c02*a[3] + c12*a[6] + c22*a[8]) / det;
+        return true;
+    }
+};
+
+/**
+ * A candidate of the queue. It becomes stale as soon as one of both points is touched
+ * by another collapse which is detected by the stamps of the points.
+ * The queue is ordered by the error plus a small fraction of the squared edge length so that
+ * on flat regions, where the error of all collapses is zero, the short edges go first.
+ */
+struct Collapse
+{
+    double error;
+    double cost;
+    unsigned long keep, remove;
+    unsigned long keepStamp, removeStamp;
+    Base::Vector3f target;
+
+    bool operator > (const Collapse& c) const
+    {
+        if (cost != c.cost)
+            return cost > c.cost;
+        if (keep != c.keep)
+            return keep > c.keep;
+        return remove > c.remove;
+    }
+};
+
+typedef std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse> > CollapseQueue;
+
+/**
+ * The per-point data shared by all partitions. A partition only touches the points it owns,
+ * i.e. whose facets all belong to it, and their facets so that the partitions can be processed
+ * at the same time.
+ */
+class QuadricDecimation
+{
+public:
+    QuadricDecimation(MeshKernel& rclM, float fFeatureAngle)
+      : kernel(rclM), facets(rclM.GetFacets()), points(rclM.GetPoints())
+    {
+        Initialize(fFeatureAngle);
+    }
+
+    void SetOwner(unsigned long ulPart, const std::vector<unsigned long>& raulFacets);
+    void Rebuild();
+    unsigned long Decimate(MeshTopoAlgorithm& topAlg, unsigned long ulPart,
+                           const std::vector<unsigned long>& raulFacets,
+                           unsigned long ulMaxRemove, double dMaxError);
+
+    std::vector<unsigned long> owner;
+
+private:
+    void Initialize(float fFeatureAngle);
+    bool CollectFan(unsigned long ulPoint, std::vector<unsigned long>& raulFan) const;
+    bool ComputeCollapse(unsigned long u, unsigned long v, Collapse& c) const;
+    bool DoCollapse(MeshTopoAlgorithm& topAlg, unsigned long ulPart, const Collapse& c);
+    bool FlipsFacet(const MeshFacet& rFace, unsigned long ulPoint, const Base::Vector3f& rclTarget) const;
+    void AddCandidates(unsigned long ulPoint, unsigned long ulPart, double dMaxError, CollapseQueue& queue);
+    Base::Vector3d ToLocal(const Base::Vector3f& p) const
+    {
+        return Base::Vector3d(p.x - origin.x, p.y - origin.y, p.z - origin.z);
+    }
+
+private:
+    MeshKernel& kernel;
+    const MeshFacetArray& facets;
+    const MeshPointArray& points;
+    // the quadrics are relative to the center of the bounding box to keep them accurate
+    Base::Vector3d origin;
+    std::vector<Quadric> quadrics;
+    std::vector<unsigned long> stamps;
+    std::vector<unsigned long> valence;
+    std::vector<unsigned long> pointFacet;
+    std::vector<char> locked;
+};
+
+void QuadricDecimation::Initialize(float fFeatureAngle)
+{
+    unsigned long ulCtPoints = points.size();
+    unsigned long ulCtFacets = facets.size();
+    Base::BoundBox3f clBB = kernel.GetBoundBox();
+    origin.Set(0.5*(clBB.MinX+clBB.MaxX), 0.5*(clBB.MinY+clBB.MaxY), 0.5*(clBB.MinZ+clBB.MaxZ));
+
+    quadrics.resize(ulCtPoints);
+    stamps.resize(ulCtPoints, 0);
+    locked.resize(ulCtPoints, 0);
+    owner.resize(ulCtPoints, 0);
+
+    std::vector<Base::Vector3d> normals(ulCtFacets);
+    for (unsigned long i = 0; i < ulCtFacets; i++) {
+        const MeshFacet& rFace = facets[i];
+        if (!rFace.IsValid())
+            continue;
+        Base::Vector3d p0 = ToLocal(points[rFace._aulPoints[0]]);
+        Base::Vector3d p1 = ToLocal(points[rFace._aulPoints[1]]);
+        Base::Vector3d p2 = ToLocal(points[rFace._aulPoints[2]]);
+        Base::Vector3d n = (p1 - p0) % (p2 - p0);
+        double len = n.Length();
+        if (len <= 0.0)
+            continue; // degenerated facets have no plane
+        n = n / len;
+        normals[i] = n;
+
+        Quadric q;
+        q.AddPlane(n, -(n * p0), 1.0);
+        for (int j=0; j<3; j++)
+            quadrics[rFace._aulPoints[j]] += q;
+    }
+
+    double fCosFeature = cos(fFeatureAngle);
+    for (unsigned long i = 0; i < ulCtFacets; i++) {
+        const MeshFacet& rFace = facets[i];
+        if (!rFace.IsValid())
+            continue;
+        for (int j=0; j<3; j++) {
+            unsigned long p = rFace._aulPoints[j];
+            unsigned long q = rFace._aulPoints[(j+1)%3];
+            unsigned long n = rFace._aulNeighbours[j];
+            if (n == ULONG_MAX) {
+                // points at open edges stay where they are
+                locked[p] = locked[q] = 1;
+            }
+            else if (n > i && normals[i] * normals[n] < fCosFeature) {
+                // the planes through a feature edge perpendicular to its facets keep
+                // the points on the edge but still allow to collapse it along the edge
+                Base::Vector3d p0 = ToLocal(points[p]);
+                Base::Vector3d e = ToLocal(points[q]) - p0;
+                double w = MESH_DECIMATION_FEATURE_WEIGHT;
+                Quadric c;
+                Base::Vector3d n1 = normals[i] % e;
+                Base::Vector3d n2 = normals[n] % e;
+                if (n1.Sqr() > 0.0) {
+                    n1.Normalize();
+                    c.AddPlane(n1, -(n1 * p0), w);
+                }
+                if (n2.Sqr() > 0.0) {
+                    n2.Normalize();
+                    c.AddPlane(n2, -(n2 * p0), w);
+                }
+                quadrics[p] += c;
+                quadrics[q] += c;
+            }
+        }
+    }
+
+    Rebuild();
+
+    // points at non-manifolds stay where they are because their facets cannot be reached
+    // by walking around them
+    std::vector<unsigned long> fan;
+    for (unsigned long i = 0; i < ulCtPoints; i++) {
+        if (pointFacet[i] == ULONG_MAX || locked[i])
+            continue;
+        if (!CollectFan(i, fan) || fan.size() != valence[i])
+            locked[i] = 1;
+    }
+}
+
+void QuadricDecimation::Rebuild()
+{
+    // the facets of the points shared by several partitions may have been removed
+    pointFacet.assign(points.size(), ULONG_MAX);
+    valence.assign(points.size(), 0);
+    std::fill(owner.begin(), owner.end(), 0);
+    for (unsigned long i = 0; i < facets.size(); i++) {
+        const MeshFacet& rFace = facets[i];
+        if (!rFace.IsValid())
+            continue;
+        for (int j=0; j<3; j++) {
+            pointFacet[rFace._aulPoints[j]] = i;
+            valence[rFace._aulPoints[j]]++;
+        }
+    }
+}
+
+void QuadricDecimation::SetOwner(unsigned long ulPart, const std::vector<unsigned long>& raulFacets)
+{
+    // Must be called in the order of the partitions. A point that already belongs to
+    // another partition is shared and thus not owned by any partition.
+    for (std::vector<unsigned long>::const_iterator it = raulFacets.begin(); it != raulFacets.end(); ++it) {
+        const MeshFacet& rFace = facets[*it];
+        for (int j=0; j<3; j++) {
+            unsigned long& o = owner[rFace._aulPoints[j]];
+            if (o == 0)
+                o = ulPart;
+            else if (o != ulPart)
+                o = ULONG_MAX;
+        }
+    }
+}
+
+bool QuadricDecimation::CollectFan(unsigned long ulPoint, std::vector<unsigned long>& raulFan) const
+{
+    raulFan.clear();
+    unsigned long ulStart = pointFacet[ulPoint];
+    if (ulStart == ULONG_MAX)
+        return false;
+
+    // walk around the point in both directions until either the start facet is reached
+    // again or an open edge
+    for (int dir=0; dir<2; dir++) {
+        unsigned long ulFacet = ulStart;
+        while (true) {
+            const MeshFacet& rFace = facets[ulFacet];
+            int pos = -1;
+            for (int j=0; j<3; j++) {
+                if (rFace._aulPoints[j] == ulPoint)
+                    pos = j;
+            }
+            if (pos < 0 || raulFan.size() > valence[ulPoint])
+                return false;
+            if (dir == 0 || ulFacet != ulStart)
+                raulFan.push_back(ulFacet);
+            unsigned long ulNext = dir == 0 ? rFace._aulNeighbours[pos] : rFace._aulNeighbours[(pos+2)%3];
+            if (ulNext == ulStart)
+                return true; // closed fan
+            if (ulNext == ULONG_MAX)
+                break;
+            ulFacet = ulNext;
+        }
+    }
+
+    return true;
+}
+
+bool QuadricDecimation::ComputeCollapse(unsigned long u, unsigned long v, Collapse& c) const
+{
+    if (locked[u] && locked[v])
+        return false;
+
+    Quadric q = quadrics[u];
+    q += quadrics[v];
+    if (locked[u] || locked[v]) {
+        c.keep = locked[u] ? u : v;
+        c.remove = locked[u] ? v : u;
+        c.target = points[c.keep];
+    }
+    else {
+        c.keep = std::min<unsigned long>(u, v);
+        c.remove = std::max<unsigned long>(u, v);
+        Base::Vector3d x;
+        if (q.Minimize(x)) {
+            c.target.Set((float)(x.x + origin.x), (float)(x.y + origin.y), (float)(x.z + origin.z));
+        }
+        else {
+            // take the best of the mid point and the end points
+            const Base::Vector3f& p = points[u];
+            const Base::Vector3f& r = points[v];
+            Base::Vector3f cand[3] = { 0.5f * (p + r), p, r };
+            double best = DBL_MAX;
+            for (int i=0; i<3; i++) {
+                double e = q.Evaluate(ToLocal(cand[i]));
+                if (e < best) {
+                    best = e;
+                    c.target = cand[i];
+                }
+            }
+        }
+    }
+
+    c.error = std::max<double>(0.0, q.Evaluate(ToLocal(c.target)));
+    c.cost = c.error + MESH_DECIMATION_LENGTH_WEIGHT * Base::DistanceP2(points[u], points[v]);
+    c.keepStamp = stamps[c.keep];
+    c.removeStamp = stamps[c.remove];
+    return true;
+}
+
+bool QuadricDecimation::FlipsFacet(const MeshFacet& rFace, unsigned long ulPoint, const Base::Vector3f& rclTarget) const
+{
+    Base::Vector3f p[3], q[3];
+    for (int j=0; j<3; j++) {
+        p[j] = points[rFace._aulPoints[j]];
+        q[j] = rFace._aulPoints[j] == ulPoint ? rclTarget : p[j];
+    }
+
+    Base::Vector3f n1 = (p[1] - p[0]) % (p[2] - p[0]);
+    Base::Vector3f n2 = (q[1] - q[0]) % (q[2] - q[0]);
+    // reject a collapse that turns a facet by more than 60 degree or degenerates it
+    float len = n1.Length() * n2.Length();
+    return len <= 0.0f || n1 * n2 < 0.5f * len;
+}
+
+bool QuadricDecimation::DoCollapse(MeshTopoAlgorithm& topAlg, unsigned long ulPart, const Collapse& c)
+{
+    unsigned long u = c.remove;
+    unsigned long k = c.keep;
+
+    // get the facet with the directed edge (u,k) and its neighbour with (k,u)
+    std::vector<unsigned long> fanU, fanK;
+    if (!CollectFan(u, fanU) || !CollectFan(k, fanK))
+        return false;
+    unsigned long ulF = ULONG_MAX, ulN = ULONG_MAX;
+    unsigned short sF = 0, sN = 0;
+    for (std::vector<unsigned long>::iterator it = fanU.begin(); it != fanU.end(); ++it) {
+        const MeshFacet& rFace = facets[*it];
+        for (unsigned short j=0; j<3; j++) {
+            if (rFace._aulPoints[j] == u && rFace._aulPoints[(j+1)%3] == k) {
+                ulF = *it;
+                sF = j;
+            }
+        }
+    }
+    if (ulF == ULONG_MAX)
+        return false;
+    ulN = facets[ulF]._aulNeighbours[sF];
+    if (ulN == ULONG_MAX)
+        return false;
+    const MeshFacet& rclF = facets[ulF];
+    const MeshFacet& rclN = facets[ulN];
+    sN = rclN.Side(ulF);
+    if (sN == USHRT_MAX || rclN._aulPoints[sN] != k || rclN._aulPoints[(sN+1)%3] != u)
+        return false; // inconsistent orientation
+
+    unsigned long a = rclF._aulPoints[(sF+2)%3];
+    unsigned long b = rclN._aulPoints[(sN+2)%3];
+    if (a == b || owner[a] != ulPart || owner[b] != ulPart)
+        return false;
+    // the opposite points must keep at least three facets unless they lie at the border
+    if (valence[a] <= (locked[a] ? 1UL : 3UL) || valence[b] <= (locked[b] ? 1UL : 3UL))
+        return false;
+    // a facet with two open edges would leave its opposite point alone
+    unsigned long ulFa = rclF._aulNeighbours[(sF+1)%3] != ULONG_MAX ? rclF._aulNeighbours[(sF+1)%3]
+                                                                   : rclF._aulNeighbours[(sF+2)%3];
+    unsigned long ulNb = rclN._aulNeighbours[(sN+2)%3] != ULONG_MAX ? rclN._aulNeighbours[(sN+2)%3]
+                                                                   : rclN._aulNeighbours[(sN+1)%3];
+    if (ulFa == ULONG_MAX || ulNb == ULONG_MAX)
+        return false;
+
+    // link condition: both points may only share the opposite points of the edge as
+    // neighbours, otherwise the collapse creates a non-manifold
+    std::vector<unsigned long> ringU, ringK, common;
+    for (std::vector<unsigned long>::iterator it = fanU.begin(); it != fanU.end(); ++it)
+        ringU.insert(ringU.end(), facets[*it]._aulPoints, facets[*it]._aulPoints + 3);
+    for (std::vector<unsigned long>::iterator it = fanK.begin(); it != fanK.end(); ++it)
+        ringK.insert(ringK.end(), facets[*it]._aulPoints, facets[*it]._aulPoints + 3);
+    std::sort(ringU.begin(), ringU.end());
+    ringU.erase(std::unique(ringU.begin(), ringU.end()), ringU.end());
+    std::sort(ringK.begin(), ringK.end());
+    ringK.erase(std::unique(ringK.begin(), ringK.end()), ringK.end());
+    std::set_intersection(ringU.begin(), ringU.end(), ringK.begin(), ringK.end(), std::back_inserter(common));
+    if (common.size() != 4) // a, b, u and k
+        return false;
+
+    for (std::vector<unsigned long>::iterator it = fanU.begin(); it != fanU.end(); ++it) {
+        if (*it != ulF && *it != ulN && FlipsFacet(facets[*it], u, c.target))
+            return false;
+    }
+    for (std::vector<unsigned long>::iterator it = fanK.begin(); it != fanK.end(); ++it) {
+        if (*it != ulF && *it != ulN && FlipsFacet(facets[*it], k, c.target))
+            return false;
+    }
+
+    if (!topAlg.CollapseEdge(ulF, ulN))
+        return false;
+
+    kernel.SetPoint(k, c.target);
+    quadrics[k] += quadrics[u];
+    stamps[k]++;
+    stamps[u]++;
+    valence[k] = valence[k] + valence[u] - 4;
+    valence[a]--;
+    valence[b]--;
+    pointFacet[k] = ulFa;
+    pointFacet[a] = ulFa;
+    pointFacet[b] = ulNb;
+    pointFacet[u] = ULONG_MAX;
+    return true;
+}
+
+void QuadricDecimation::AddCandidates(unsigned long ulPoint, unsigned long ulPart, double dMaxError, CollapseQueue& queue)
+{
+    std::vector<unsigned long> fan, ring;
+    if (!CollectFan(ulPoint, fan))
+        return;
+    for (std::vector<unsigned long>::iterator it = fan.begin(); it != fan.end(); ++it)
+        ring.insert(ring.end(), facets[*it]._aulPoints, facets[*it]._aulPoints + 3);
+    std::sort(ring.begin(), ring.end());
+    ring.erase(std::unique(ring.begin(), ring.end()), ring.end());
+
+    Collapse c;
+    for (std::vector<unsigned long>::iterator it = ring.begin(); it != ring.end(); ++it) {
+        if (*it != ulPoint && owner[*it] == ulPart &&
+            ComputeCollapse(ulPoint, *it, c) && c.error <= dMaxError)
+            queue.push(c);
+    }
+}
+
+unsigned long QuadricDecimation::Decimate(MeshTopoAlgorithm& topAlg, unsigned long ulPart,
+                                          const std::vector<unsigned long>& raulFacets,
+                                          unsigned long ulMaxRemove, double dMaxError)
+{
+    CollapseQueue queue;
+    Collapse c;
+    for (std::vector<unsigned long>::const_iterator it = raulFacets.begin(); it != raulFacets.end(); ++it) {
+        const MeshFacet& rFace = facets[*it];
+        for (int j=0; j<3; j++) {
+            // each inner edge is added once
+            unsigned long n = rFace._aulNeighbours[j];
+            if (n == ULONG_MAX || n < *it)
+                continue;
+            unsigned long p = rFace._aulPoints[j];
+            unsigned long q = rFace._aulPoints[(j+1)%3];
+            if (owner[p] == ulPart && owner[q] == ulPart &&
+                ComputeCollapse(p, q, c) && c.error <= dMaxError)
+                queue.push(c);
+        }
+    }
+
+    unsigned long ulRemoved = 0;
+    while (ulRemoved < ulMaxRemove && !queue.empty()) {
+        c = queue.top();
+        queue.pop();
+        if (stamps[c.keep] != c.keepStamp || stamps[c.remove] != c.removeStamp)
+            continue; // outdated
+        if (DoCollapse(topAlg, ulPart, c)) {
+            ulRemoved += 2;
+            AddCandidates(c.keep, ulPart, dMaxError, queue);
+        }
+    }
+
+    return ulRemoved;
+}
+
+/**
+ * A slab of facets that is decimated by a thread of its own.
+ */
+struct DecimationRange
+{
+    QuadricDecimation* data;
+    MeshTopoAlgorithm* topAlg;
+    unsigned long part;
+    std::vector<unsigned long> facets;
+    unsigned long maxRemove;
+    double maxError;
+    unsigned long removed;
+
+    void Decimate()
+    {
+        removed = data->Decimate(*topAlg, part, facets, maxRemove, maxError);
+    }
+};
+}
+}
+
+// ----------------------------------------------------------------------
+
+MeshSimplify::MeshSimplify(MeshKernel &rclM)
+  : _rclMesh(rclM), _fFeatureAngle(Base::toRadians<float>(30.0f)), _bParallel(false)
+{
+}
+
+MeshSimplify::~MeshSimplify()
+{
+}
+
+void MeshSimplify::SetFeatureAngle(float fAngle)
+{
+    _fFeatureAngle = fAngle;
+}
+
+void MeshSimplify::SetParallel(bool bParallel)
+{
+    _bParallel = bParallel;
+}
+
+void MeshSimplify::Simplify(float fTolerance, float fReduction)
+{
+    fReduction = std::max<float>(0.0f, std::min<float>(1.0f, fReduction));
+    unsigned long ulTargetSize = (unsigned long)((1.0f - fReduction) * _rclMesh.CountFacets());
+    Simplify(ulTargetSize, (double)fTolerance * (double)fTolerance);
+}
+
+void MeshSimplify::Simplify(unsigned long ulTargetSize)
+{
+    Simplify(ulTargetSize, DBL_MAX);
+}
+
+void MeshSimplify::Simplify(unsigned long ulTargetSize, double dMaxError)
+{
+    unsigned long ulCtFacets = _rclMesh.CountFacets();
+    if (ulTargetSize >= ulCtFacets)
+        return;
+
+    unsigned long ulRemove = ulCtFacets - ulTargetSize;
+    QuadricDecimation data(_rclMesh, _fFeatureAngle);
+    MeshTopoAlgorithm topAlg(_rclMesh);
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    std::vector<MeshTopoAlgorithm*> topAlgs;
+
+    // a big mesh is split also on a single core so that the result doesn't depend on the machine
+    unsigned long ulCtParts = std::min<unsigned long>(std::max<int>(2, QThread::idealThreadCount()),
+                                                      ulCtFacets / MESH_DECIMATION_PARTITION_SIZE);
+    if (_bParallel && ulCtParts > 1) {
+        // sort the facets along the longest side of the bounding box and split them into slabs
+        Base::BoundBox3f clBB = _rclMesh.GetBoundBox();
+        int axis = 0;
+        if (clBB.LengthY() > clBB.LengthX())
+            axis = 1;
+        if (clBB.LengthZ() > std::max<float>(clBB.LengthX(), clBB.LengthY()))
+            axis = 2;
+        std::vector<std::pair<float, unsigned long> > order;
+        order.reserve(ulCtFacets);
+        for (unsigned long i = 0; i < ulCtFacets; i++) {
+            const MeshFacet& rFace = rFacets[i];
+            if (!rFace.IsValid())
+                continue;
+            float fSum = 0.0f;
+            for (int j=0; j<3; j++)
+                fSum += rPoints[rFace._aulPoints[j]][axis];
+            order.push_back(std::make_pair(fSum, i));
+        }
+        std::sort(order.begin(), order.end());
+
+        // the partitions are numbered from 1 because 0 marks points that belong to none yet
+        std::vector<DecimationRange> ranges(ulCtParts);
+        topAlgs.resize(ulCtParts);
+        for (unsigned long i = 0; i < ulCtParts; i++) {
+            DecimationRange& range = ranges[i];
+            range.data = &data;
+            range.topAlg = topAlgs[i] = new MeshTopoAlgorithm(_rclMesh);
+            range.part = i + 1;
+            range.maxError = dMaxError;
+            range.removed = 0;
+            unsigned long ulBegin = i * order.size() / ulCtParts;
+            unsigned long ulEnd = (i + 1) * order.size() / ulCtParts;
+            range.facets.reserve(ulEnd - ulBegin);
+            for (unsigned long j = ulBegin; j < ulEnd; j++)
+                range.facets.push_back(order[j].second);
+            data.SetOwner(range.part, range.facets);
+        }
+
+        // Each slab gets the share of the reduction of its facets that don't touch a shared
+        // point, the rest is left for the pass over the whole mesh which removes the borders.
+        for (std::vector<DecimationRange>::iterator it = ranges.begin(); it != ranges.end(); ++it) {
+            unsigned long ulInner = 0;
+            for (std::vector<unsigned long>::iterator jt = it->facets.begin(); jt != it->facets.end(); ++jt) {
+                const MeshFacet& rFace = rFacets[*jt];
+                if (data.owner[rFace._aulPoints[0]] == it->part &&
+                    data.owner[rFace._aulPoints[1]] == it->part &&
+                    data.owner[rFace._aulPoints[2]] == it->part)
+                    ulInner++;
+            }
+            it->maxRemove = (unsigned long)((double)ulRemove * (double)ulInner / (double)ulCtFacets);
+        }
+
+        QtConcurrent::map(ranges, &DecimationRange::Decimate).waitForFinished();
+
+        for (std::vector<DecimationRange>::iterator it = ranges.begin(); it != ranges.end(); ++it)
+            ulRemove -= std::min<unsigned long>(ulRemove, it->removed);
+        data.Rebuild();
+    }
+
+    std::vector<unsigned long> facets;
+    facets.reserve(rFacets.size());
+    for (unsigned long i = 0; i < rFacets.size(); i++) {
+        if (rFacets[i].IsValid())
+            facets.push_back(i);
+    }
+    data.Decimate(topAlg, 0, facets, ulRemove, dMaxError);
+
+    // The collapsed elements are only marked as invalid until now. Once they are removed
+    // the instances used by the partitions find nothing to clean up when they get destroyed.
+    topAlg.Cleanup();
+    for (std::vector<MeshTopoAlgorithm*>::iterator it = topAlgs.begin(); it != topAlgs.end(); ++it)
+        delete *it;
+    _rclMesh.RecalcBoundBox();
+}
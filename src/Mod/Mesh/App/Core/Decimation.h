@@ -0,0 +1,90 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent[at]local>                             *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef MESH_DECIMATION_H
+#define MESH_DECIMATION_H
+
+#define  MESH_DECIMATION_FEATURE_WEIGHT    100.0   // Weight of the planes that keep feature edges in place
+#define  MESH_DECIMATION_LENGTH_WEIGHT     0.001   // Weight of the squared edge length in the order of collapses
+#define  MESH_DECIMATION_PARTITION_SIZE    50000   // Min. number of facets of a partition in parallel mode
+
+namespace MeshCore {
+
+class MeshKernel;
+
+/**
+ * The MeshSimplify class reduces the number of facets of a mesh by collapsing edges.
+ * The edges are collapsed in the order of their quadric error metric (QEM) as described
+ * by Garland and Heckbert, i.e. the remaining point of a collapsed edge is placed where the
+ * sum of squared distances to the planes of the original facets around it is minimal and this
+ * sum is the error of the collapse.
+ *
+ * The edges are collapsed with MeshTopoAlgorithm::CollapseEdge(). A collapse is rejected if it
+ * would create a non-manifold or flip the normal of a remaining facet. Points at open edges or
+ * non-manifolds are never moved or removed so that the boundaries stay untouched, and edges with
+ * an angle between their facets above the feature angle get additional planes that keep their
+ * points on the edge.
+ *
+ * In parallel mode the mesh is split into slabs along the longest side of its bounding box which
+ * are decimated independently. Points shared by several slabs are kept fixed until the slabs are
+ * done, then the whole mesh is decimated further which stitches the slabs by collapsing the edges
+ * along their borders.
+ */
+class MeshExport MeshSimplify
+{
+public:
+  /// Construction
+  MeshSimplify (MeshKernel &rclM);
+  /// Destruction
+  ~MeshSimplify (void);
+
+  /**
+   * Sets the angle in radian between the normals of two adjacent facets above which their
+   * common edge is treated as feature edge. The default is 30 degree.
+   */
+  void SetFeatureAngle (float fAngle);
+  /// Enables or disables the decimation of independent partitions in several threads.
+  void SetParallel (bool bParallel);
+  /**
+   * Removes the fraction \a fReduction (0 to 1) of the facets unless the error of the next collapse
+   * exceeds \a fTolerance squared.
+   */
+  void Simplify (float fTolerance, float fReduction);
+  /**
+   * Collapses edges until the mesh has at most \a ulTargetSize facets or no legal collapse
+   * is left.
+   */
+  void Simplify (unsigned long ulTargetSize);
+
+protected:
+  void Simplify (unsigned long ulTargetSize, double dMaxError);
+
+private:
+  MeshKernel &_rclMesh;
+  float _fFeatureAngle;
+  bool  _bParallel;
+};
+
+} // namespace MeshCore
+
+#endif // MESH_DECIMATION_H
@@ -797,6 +797,11 @@ int MeshGeomFacet::IntersectWithFacet (const MeshGeomFacet& rclFacet,
                                          &coplanar, isectpt1, isectpt2) == 0)
         return 0; // no intersections
 
+    // For co-planar facets the algorithm doesn't compute the intersection line
+    // and the points are undefined
+    if (coplanar)
+        return 0;
+
     rclPt0.x = isectpt1[0]; rclPt0.y = isectpt1[1]; rclPt0.z = isectpt1[2];
     rclPt1.x = isectpt2[0]; rclPt1.y = isectpt2[1]; rclPt1.z = isectpt2[2];
 
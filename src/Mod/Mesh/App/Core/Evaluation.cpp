@@ -28,6 +28,10 @@
 # include <vector>
 #endif
 
+#include <QAtomicInt>
+#include <QThread>
+#include <QtConcurrentMap>
+
 #include <Mod/Mesh/App/WildMagic4/Wm4Matrix3.h>
 #include <Mod/Mesh/App/WildMagic4/Wm4Vector3.h>
 
@@ -39,6 +43,7 @@
 #include "Helpers.h"
 #include "Grid.h"
 #include "TopoAlgorithm.h"
+#include "Bvh.h"
 #include <Base/Matrix.h>
 
 #include <Base/Sequencer.h>
@@ -588,76 +593,123 @@ bool MeshFixSingleFacet::Fixup ()
 
 // ----------------------------------------------------------------
 
-bool MeshEvalSelfIntersection::Evaluate ()
+namespace MeshCore {
+namespace {
+// If the facets share a common vertex we do not check for self-intersections because they
+// could but usually do not intersect each other and the intersection test would detect
+// false-positives, otherwise
+inline bool ShareVertex(const MeshFacet& rface1, const MeshFacet& rface2)
 {
-    // Contains bounding boxes for every facet 
-    std::vector<Base::BoundBox3f> boxes;
-
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(_rclMesh);
-    const MeshFacetArray& rFaces = _rclMesh.GetFacets();
-    MeshGridIterator clGridIter(cMeshFacetGrid);
-    unsigned long ulGridX, ulGridY, ulGridZ;
-    cMeshFacetGrid.GetCtGrids(ulGridX, ulGridY, ulGridZ);
-
-    MeshFacetIterator cMFI(_rclMesh);
-    for (cMFI.Begin(); cMFI.More(); cMFI.Next()) {
-        boxes.push_back((*cMFI).GetBoundBox());
+    for (int i=0; i<3; i++) {
+        if (rface1._aulPoints[i] == rface2._aulPoints[0] ||
+            rface1._aulPoints[i] == rface2._aulPoints[1] ||
+            rface1._aulPoints[i] == rface2._aulPoints[2])
+            return true;
     }
+    return false;
+}
 
-    // Calculates the intersections
-    Base::SequencerLauncher seq("Checking for self-intersections...", ulGridX*ulGridY*ulGridZ);
-    for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
-        //Get the facet indices, belonging to the current grid unit
-        std::vector<unsigned long> aulGridElements;
-        clGridIter.GetElements(aulGridElements);
-
-        seq.next();
-        if (aulGridElements.size()==0)
-            continue;
-
-        MeshGeomFacet facet1, facet2;
+/**
+ * Searches the intersections of the facets of the range with the facets of higher index,
+ * each range is handled by a thread of its own.
+ */
+struct SelfIntersectionRange
+{
+    const MeshKernel* mesh;
+    const MeshFacetBVH* bvh;
+    QAtomicInt* found;
+    bool firstOnly;
+    unsigned long begin, end;
+    std::vector<std::pair<unsigned long, unsigned long> > intersections;
+
+    void Search()
+    {
+        const MeshFacetArray& rFaces = mesh->GetFacets();
+        std::vector<unsigned long> candidates;
         Base::Vector3f pt1, pt2;
-        for (std::vector<unsigned long>::iterator it = aulGridElements.begin(); it != aulGridElements.end(); ++it) {
-            const Base::BoundBox3f& box1 = boxes[*it];
-            cMFI.Set(*it);
-            facet1 = *cMFI;
-            const MeshFacet& rface1 = rFaces[*it];
-            for (std::vector<unsigned long>::iterator jt = it; jt != aulGridElements.end(); ++jt) {
-                if (jt == it) // the identical facet
+        for (unsigned long i = begin; i < end; i++) {
+            // another thread has already found an intersection
+            if (firstOnly && *found != 0)
+                return;
+
+            MeshGeomFacet facet1 = mesh->GetFacet(i);
+            candidates.clear();
+            bvh->SearchFacets(facet1.GetBoundBox(), candidates);
+            std::sort(candidates.begin(), candidates.end());
+
+            const MeshFacet& rface1 = rFaces[i];
+            for (std::vector<unsigned long>::iterator it = candidates.begin(); it != candidates.end(); ++it) {
+                // each pair is tested only once
+                if (*it <= i || ShareVertex(rface1, rFaces[*it]))
                     continue;
-                // If the facets share a common vertex we do not check for self-intersections because they 
-                // could but usually do not intersect each other and the algorithm below would detect false-positives,
-                // otherwise
-                const MeshFacet& rface2 = rFaces[*jt];
-                if (rface1._aulPoints[0] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[0] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[0] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[1] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[1] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[1] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[2] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[2] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[2] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-
-                const Base::BoundBox3f& box2 = boxes[*jt];
-                if (box1 && box2) {
-                    cMFI.Set(*jt);
-                    facet2 = *cMFI;
-                    int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                    if (ret == 2) {
-                        // abort after the first detected self-intersection
-                        return false;
+                int ret = facet1.IntersectWithFacet(mesh->GetFacet(*it), pt1, pt2);
+                if (ret == 2) {
+                    intersections.push_back(std::make_pair(i, *it));
+                    if (firstOnly) {
+                        found->fetchAndStoreRelaxed(1);
+                        return;
                     }
                 }
             }
         }
     }
+};
+}
+}
 
-    return true;
+void MeshEvalSelfIntersection::SearchIntersections(std::vector<std::pair<unsigned long, unsigned long> >& intersection,
+                                                   bool firstOnly) const
+{
+    unsigned long ulCtFacets = _rclMesh.CountFacets();
+    if (ulCtFacets < 2)
+        return;
+
+    // Unlike a grid the hierarchy references every facet once, so no pair is found several
+    // times and the search doesn't degrade if the facets are of very different size
+    MeshFacetBVH cBVH(_rclMesh);
+
+    // The facets are split into blocks that are searched in parallel. To keep the sequencer
+    // working the blocks are processed in rounds of a few blocks per thread. As each block
+    // only reports pairs whose first facet it contains the result is sorted by the first and
+    // then by the second facet.
+    const unsigned long ulBlockSize = 4096;
+    unsigned long ulCtBlocks = (ulCtFacets + ulBlockSize - 1) / ulBlockSize;
+    unsigned long ulCtRound = 8 * std::max<int>(1, QThread::idealThreadCount());
+    QAtomicInt found(0);
+
+    Base::SequencerLauncher seq("Checking for self-intersections...", (ulCtBlocks + ulCtRound - 1) / ulCtRound);
+    for (unsigned long ulFirst = 0; ulFirst < ulCtBlocks; ulFirst += ulCtRound) {
+        unsigned long ulLast = std::min<unsigned long>(ulFirst + ulCtRound, ulCtBlocks);
+        std::vector<SelfIntersectionRange> ranges(ulLast - ulFirst);
+        for (unsigned long i = ulFirst; i < ulLast; i++) {
+            SelfIntersectionRange& range = ranges[i - ulFirst];
+            range.mesh = &_rclMesh;
+            range.bvh = &cBVH;
+            range.found = &found;
+            range.firstOnly = firstOnly;
+            range.begin = i * ulBlockSize;
+            range.end = std::min<unsigned long>((i + 1) * ulBlockSize, ulCtFacets);
+        }
+        QtConcurrent::map(ranges, &SelfIntersectionRange::Search).waitForFinished();
+
+        for (std::vector<SelfIntersectionRange>::iterator it = ranges.begin(); it != ranges.end(); ++it) {
+            intersection.insert(intersection.end(), it->intersections.begin(), it->intersections.end());
+            if (firstOnly && !intersection.empty()) {
+                intersection.resize(1);
+                return;
+            }
+        }
+
+        seq.next(!firstOnly);
+    }
+}
+
+bool MeshEvalSelfIntersection::Evaluate ()
+{
+    // abort after the first detected self-intersection
+    std::vector<std::pair<unsigned long, unsigned long> > intersection;
+    SearchIntersections(intersection, true);
+    return intersection.empty();
 }
 
 void MeshEvalSelfIntersection::GetIntersections(const std::vector<std::pair<unsigned long, unsigned long> >& indices,
@@ -684,77 +736,11 @@ void MeshEvalSelfIntersection::GetIntersections(const std::vector<std::pair<unsi
     }
 }
 
-void MeshEvalSelfIntersection::GetIntersections(std::vector<std::pair<unsigned long, unsigned long> >& intersection) const
+void MeshEvalSelfIntersection::GetIntersections(std::vector<std::pair<unsigned long, unsigned long> >& intersection) const
 {
-    // Contains bounding boxes for every facet 
-    std::vector<Base::BoundBox3f> boxes;
-    //intersection.clear();
-
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(_rclMesh);
-    const MeshFacetArray& rFaces = _rclMesh.GetFacets();
-    MeshGridIterator clGridIter(cMeshFacetGrid);
-    unsigned long ulGridX, ulGridY, ulGridZ;
-    cMeshFacetGrid.GetCtGrids(ulGridX, ulGridY, ulGridZ);
-
-    MeshFacetIterator cMFI(_rclMesh);
-    for(cMFI.Begin(); cMFI.More(); cMFI.Next()) {
-        boxes.push_back((*cMFI).GetBoundBox());
-    }
-
-    // Calculates the intersections
-    Base::SequencerLauncher seq("Checking for self-intersections...", ulGridX*ulGridY*ulGridZ);
-    for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
-        //Get the facet indices, belonging to the current grid unit
-        std::vector<unsigned long> aulGridElements;
-        clGridIter.GetElements(aulGridElements);
-
-        seq.next(true);
-        if (aulGridElements.size()==0)
-            continue;
-
-        MeshGeomFacet facet1, facet2;
-        Base::Vector3f pt1, pt2;
-        for (std::vector<unsigned long>::iterator it = aulGridElements.begin(); it != aulGridElements.end(); ++it) {
-            const Base::BoundBox3f& box1 = boxes[*it];
-            cMFI.Set(*it);
-            facet1 = *cMFI;
-            const MeshFacet& rface1 = rFaces[*it];
-            for (std::vector<unsigned long>::iterator jt = it; jt != aulGridElements.end(); ++jt) {
-                if (jt == it) // the identical facet
-                    continue;
-                // If the facets share a common vertex we do not check for self-intersections because they 
-                // could but usually do not intersect each other and the algorithm below would detect false-positives,
-                // otherwise
-                const MeshFacet& rface2 = rFaces[*jt];
-                if (rface1._aulPoints[0] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[0] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[0] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[1] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[1] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[1] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[2] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[2] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[2] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-
-                const Base::BoundBox3f& box2 = boxes[*jt];
-                if (box1 && box2) {
-                    cMFI.Set(*jt);
-                    facet2 = *cMFI;
-                    int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                    if (ret == 2) {
-                        intersection.push_back(std::make_pair
-                            <unsigned long, unsigned long>(*it,*jt));
-                    }
-                }
-            }
-        }
-    }
+    SearchIntersections(intersection, false);
 }
-
+
 bool MeshFixSelfIntersection::Fixup()
 {
     std::vector<unsigned long> indices;
@@ -295,8 +295,11 @@ public:
     /// collect all intersection lines
     void GetIntersections(const std::vector<std::pair<unsigned long, unsigned long> >&,
         std::vector<std::pair<Base::Vector3f, Base::Vector3f> >&) const;
-    /// collect the index of all facets with self intersections
+    /// collect the index of all facets with self intersections, sorted by the first and then by the second index
     void GetIntersections(std::vector<std::pair<unsigned long, unsigned long> >&) const;
+
+private:
+    void SearchIntersections(std::vector<std::pair<unsigned long, unsigned long> >&, bool firstOnly) const;
 };
 
 /**
@@ -62,7 +62,8 @@ void MeshGrid::Attach (const MeshKernel &rclM)
 
 void MeshGrid::Clear (void)
 {
-  _aulGrid.clear();
+  _aulGrid.Clear();
+  _aulPending.clear();
   _pclMesh = NULL;  
 }
 
@@ -93,8 +94,6 @@ void MeshGrid::InitGrid (void)
 {
   assert(_pclMesh != NULL);
 
-  unsigned long i, j;
-
   // Grid Laengen berechnen wenn nicht initialisiert
   //
   if ((_ulCtGridsX == 0) || (_ulCtGridsX == 0) || (_ulCtGridsX == 0))
@@ -128,14 +127,24 @@ void MeshGrid::InitGrid (void)
   }
 
   // Daten-Struktur anlegen
-  _aulGrid.clear();
-  _aulGrid.resize(_ulCtGridsX);
-  for (i = 0; i < _ulCtGridsX; i++)
-  {
-    _aulGrid[i].resize(_ulCtGridsY);
-    for (j = 0; j < _ulCtGridsY; j++)
-      _aulGrid[i][j].resize(_ulCtGridsZ);
-  }
+  _aulPending.clear();
+  _aulGrid.Resize(_ulCtGridsX * _ulCtGridsY * _ulCtGridsZ);
+  _aulGrid.Allocate();
+}
+
+void MeshGrid::FinishGrid (void)
+{
+  // counting sort of all elements by their grid
+  _aulGrid.Resize(_ulCtGridsX * _ulCtGridsY * _ulCtGridsZ);
+  std::vector<std::pair<unsigned long, unsigned long> >::const_iterator it;
+  for (it = _aulPending.begin(); it != _aulPending.end(); ++it)
+    _aulGrid.Count(it->first);
+  _aulGrid.Allocate();
+  for (it = _aulPending.begin(); it != _aulPending.end(); ++it)
+    _aulGrid.Insert(it->first, it->second);
+  _aulGrid.Finish();
+
+  std::vector<std::pair<unsigned long, unsigned long> >().swap(_aulPending);
 }
 
 unsigned long MeshGrid::Inside (const Base::BoundBox3f &rclBB, std::vector<unsigned long> &raulElements,
@@ -155,7 +164,7 @@ unsigned long MeshGrid::Inside (const Base::BoundBox3f &rclBB, std::vector<unsig
     {
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
-        raulElements.insert(raulElements.end(), _aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+        raulElements.insert(raulElements.end(), GetCell(i, j, k).begin(), GetCell(i, j, k).end());
       }
     }
   }  
@@ -190,7 +199,7 @@ unsigned long MeshGrid::Inside (const Base::BoundBox3f &rclBB, std::vector<unsig
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
         if (Base::DistanceP2(GetBoundBox(i, j, k).CalcCenter(), rclOrg) < fMinDistP2)
-          raulElements.insert(raulElements.end(), _aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+          raulElements.insert(raulElements.end(), GetCell(i, j, k).begin(), GetCell(i, j, k).end());
       }
     }
   }  
@@ -221,7 +230,7 @@ unsigned long MeshGrid::Inside (const Base::BoundBox3f &rclBB, std::set<unsigned
     {
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
-        raulElements.insert(_aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+        raulElements.insert(GetCell(i, j, k).begin(), GetCell(i, j, k).end());
       }
     }
   }  
@@ -450,7 +459,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsY; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+              raclInd.insert(GetCell(nX, i, j).begin(), GetCell(nX, i, j).end());
           }
           nX++;
         }
@@ -464,7 +473,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsY; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+              raclInd.insert(GetCell(nX, i, j).begin(), GetCell(nX, i, j).end());
           }
           nX++;
         }
@@ -478,7 +487,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+              raclInd.insert(GetCell(i, nY, j).begin(), GetCell(i, nY, j).end());
           }
           nY++;
         }
@@ -492,7 +501,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+              raclInd.insert(GetCell(i, nY, j).begin(), GetCell(i, nY, j).end());
           }
           nY--;
         }
@@ -506,7 +515,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsY; j++)
-              raclInd.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+              raclInd.insert(GetCell(i, j, nZ).begin(), GetCell(i, j, nZ).end());
           }
           nZ++;
         }
@@ -520,7 +529,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsY; j++)
-              raclInd.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+              raclInd.insert(GetCell(i, j, nZ).begin(), GetCell(i, j, nZ).end());
           }
           nZ--;
         }
@@ -586,7 +595,7 @@ void MeshGrid::GetHull (unsigned long ulX, unsigned long ulY, unsigned long ulZ,
 unsigned long MeshGrid::GetElements (unsigned long ulX, unsigned long ulY, unsigned long ulZ,  
                                      std::set<unsigned long> &raclInd) const
 {
-  const std::set<unsigned long> &rclSet = _aulGrid[ulX][ulY][ulZ];
+  MeshIndexTable::Range rclSet = GetCell(ulX, ulY, ulZ);
   if (rclSet.size() > 0)
   {
     raclInd.insert(rclSet.begin(), rclSet.end());
@@ -602,9 +611,9 @@ unsigned long MeshGrid::GetElements(const Base::Vector3f &rclPoint, std::vector<
   if (!CheckPosition(rclPoint, ulX, ulY, ulZ))
     return 0;
 
-  aulFacets.resize(_aulGrid[ulX][ulY][ulZ].size());
+  aulFacets.resize(GetCell(ulX, ulY, ulZ).size());
 
-  std::copy(_aulGrid[ulX][ulY][ulZ].begin(), _aulGrid[ulX][ulY][ulZ].end(), aulFacets.begin());
+  std::copy(GetCell(ulX, ulY, ulZ).begin(), GetCell(ulX, ulY, ulZ).end(), aulFacets.begin());
   return aulFacets.size();
 }
 
@@ -718,6 +727,8 @@ void MeshFacetGrid::RebuildGrid (void)
     AddFacet(*clFIter, i++);
   }
 
+  FinishGrid();
+
 }
 
 unsigned long MeshFacetGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt) const
@@ -918,8 +929,8 @@ void MeshFacetGrid::SearchNearestFacetInGrid(unsigned long ulX, unsigned long ul
                                              const Base::Vector3f &rclPt, float &rfMinDist,
                                              unsigned long &rulFacetInd) const
 {
-  const std::set<unsigned long> &rclSet = _aulGrid[ulX][ulY][ulZ];
-  for (std::set<unsigned long>::const_iterator pI = rclSet.begin(); pI != rclSet.end(); pI++)
+  MeshIndexTable::Range rclSet = GetCell(ulX, ulY, ulZ);
+  for (MeshIndexTable::Range::const_iterator pI = rclSet.begin(); pI != rclSet.end(); pI++)
   {
     float fDist = _pclMesh->GetFacet(*pI).DistanceToPoint(rclPt);
     if (fDist < rfMinDist)
@@ -969,7 +980,7 @@ void MeshPointGrid::AddPoint (const MeshPoint &rclPt, unsigned long ulPtIndex, f
   unsigned long ulX, ulY, ulZ;
   Pos(Base::Vector3f(rclPt.x, rclPt.y, rclPt.z), ulX, ulY, ulZ);
   if ( (ulX < _ulCtGridsX) && (ulY < _ulCtGridsY) && (ulZ < _ulCtGridsZ) )
-    _aulGrid[ulX][ulY][ulZ].insert(ulPtIndex);
+    AddElement(ulX, ulY, ulZ, ulPtIndex);
 }
 
 void MeshPointGrid::Validate (const MeshKernel &rclMesh)
@@ -1028,6 +1039,8 @@ void MeshPointGrid::RebuildGrid (void)
   {
     AddPoint(*cPIter, i++);
   }
+
+  FinishGrid();
 }
 
 void MeshPointGrid::Pos (const Base::Vector3f &rclPoint, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ) const
@@ -1089,7 +1102,7 @@ bool MeshGridIterator::InitOnRay (const Base::Vector3f &rclPt, const Base::Vecto
   if ((_rclGrid.GetBoundBox().IsInBox(rclPt)) == true)
   {  // Voxel bestimmen, indem der Startpunkt liegt
     _rclGrid.Position(rclPt, _ulX, _ulY, _ulZ);
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+    raulElements.insert(raulElements.end(), _rclGrid.GetCell(_ulX, _ulY, _ulZ).begin(), _rclGrid.GetCell(_ulX, _ulY, _ulZ).end());
     _bValidRay = true;
   }
   else
@@ -1102,7 +1115,7 @@ bool MeshGridIterator::InitOnRay (const Base::Vector3f &rclPt, const Base::Vecto
       else
         _rclGrid.Position(cP1, _ulX, _ulY, _ulZ);
 
-      raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+      raulElements.insert(raulElements.end(), _rclGrid.GetCell(_ulX, _ulY, _ulZ).begin(), _rclGrid.GetCell(_ulX, _ulY, _ulZ).end());
       _bValidRay = true;
     }
   }
@@ -1153,7 +1166,7 @@ bool MeshGridIterator::NextOnRay (std::vector<unsigned long> &raulElements)
   if ((_bValidRay == true) && (_rclGrid.CheckPos(_ulX, _ulY, _ulZ) == true))
   {
     GridElement pos(_ulX, _ulY, _ulZ); _cSearchPositions.insert(pos);
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end()); 
+    raulElements.insert(raulElements.end(), _rclGrid.GetCell(_ulX, _ulY, _ulZ).begin(), _rclGrid.GetCell(_ulX, _ulY, _ulZ).end()); 
   }
   else
     _bValidRay = false;  // Strahl ausgetreten
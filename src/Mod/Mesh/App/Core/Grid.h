@@ -27,6 +27,7 @@
 #include <set>
 
 #include "MeshKernel.h"
+#include "Algorithm.h"
 #include <Base/Vector3D.h>
 #include <Base/BoundBox.h>
 
@@ -51,6 +52,10 @@ class MeshGrid;
  *
  * Grids can be used within algorithms to avoid to iterate through all elements,
  * so grids can speed up algorithms dramatically.
+ *
+ * The element indices of all grid elements are packed into one MeshIndexTable. While
+ * rebuilding the grid sub-classes add the elements with AddElement() and finally call
+ * FinishGrid() which sorts them into the table by their grid element.
  */
 class MeshExport MeshGrid
 {
@@ -125,7 +130,10 @@ public:
   bool GetPositionToIndex(unsigned long id, unsigned long& ulX, unsigned long& ulY, unsigned long& ulZ) const;
   /** Returns the number of elements in a given grid. */
   unsigned long GetCtElements(unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
-  { return _aulGrid[ulX][ulY][ulZ].size(); }
+  { return _aulGrid[CellIndex(ulX, ulY, ulZ)].size(); }
+  /** Returns the indices of the elements in a given grid. */
+  MeshIndexTable::Range GetCell(unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+  { return _aulGrid[CellIndex(ulX, ulY, ulZ)]; }
   /** Validates the grid structure and rebuilds it if needed. Must be implemented in sub-classes. */
   virtual void Validate (const MeshKernel &rclM) = 0;
   /** Verifies the grid structure and returns false if inconsistencies are found. */
@@ -151,13 +159,24 @@ protected:
   virtual void CalculateGridLength (unsigned long ulCtGrid, unsigned long ulMaxGrids);
   /** Calculates the grid length dependent on the number of grids per axis. */
   virtual void CalculateGridLength (int    iCtGridPerAxis);
-  /** Rebuilds the grid structure. Must be implemented in sub-classes. */
+  /** Rebuilds the grid structure. Must be implemented in sub-classes which add the elements with
+   * AddElement() and call FinishGrid() at the end. */
   virtual void RebuildGrid (void) = 0;
+  /** Adds the element with index \a ulIndex to the given grid while rebuilding the grid structure. */
+  void AddElement (unsigned long ulX, unsigned long ulY, unsigned long ulZ, unsigned long ulIndex)
+  { _aulPending.push_back(std::make_pair(CellIndex(ulX, ulY, ulZ), ulIndex)); }
+  /** Packs all elements added with AddElement() into the grid structure. */
+  void FinishGrid (void);
+  /** Returns the position of the given grid in the internal structure. Neighbours in z direction
+   * are stored next to each other. */
+  unsigned long CellIndex (unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+  { return (ulX * _ulCtGridsY + ulY) * _ulCtGridsZ + ulZ; }
   /** Returns the number of stored elements. Must be implemented in sub-classes. */
   virtual unsigned long HasElements (void) const = 0;
 
 protected:
-  std::vector<std::vector<std::vector<std::set<unsigned long> > > >  _aulGrid;   /**< Grid data structure. */
+  MeshIndexTable    _aulGrid;     /**< Grid data structure. */
+  std::vector<std::pair<unsigned long, unsigned long> > _aulPending; /**< Elements not yet packed into the grid. */
   const MeshKernel* _pclMesh;     /**< The mesh kernel. */
   unsigned long     _ulCtElements;/**< Number of grid elements for validation issues. */
   unsigned long     _ulCtGridsX;  /**< Number of grid elements in z. */
@@ -295,7 +314,8 @@ public:
   /** Returns indices of the elements in the current grid. */
   void GetElements (std::vector<unsigned long> &raulElements) const
   {
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+    MeshIndexTable::Range cell = _rclGrid.GetCell(_ulX, _ulY, _ulZ);
+    raulElements.insert(raulElements.end(), cell.begin(), cell.end());
   }
   /** Returns the number of elements in the current grid. */
   unsigned long GetCtElements() const
@@ -445,7 +465,7 @@ inline void MeshFacetGrid::AddFacet (const MeshGeomFacet &rclFacet, unsigned lon
   for (i = 0; i < 3; i++)
   {
     Pos(rclFacet._aclPoints[i], ulX, ulY, ulZ);
-    _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
+    AddElement(ulX, ulY, ulZ, ulFacetIndex);
     ulX1 = RSmin<unsigned long>(ulX1, ulX); ulY1 = RSmin<unsigned long>(ulY1, ulY); ulZ1 = RSmin<unsigned long>(ulZ1, ulZ);
     ulX2 = RSmax<unsigned long>(ulX2, ulX); ulY2 = RSmax<unsigned long>(ulY2, ulY); ulZ2 = RSmax<unsigned long>(ulZ2, ulZ);
   }
@@ -460,7 +480,7 @@ inline void MeshFacetGrid::AddFacet (const MeshGeomFacet &rclFacet, unsigned lon
         for (ulZ = ulZ1; ulZ <= ulZ2; ulZ++)
         {
           if (CMeshFacetFunc::BBoxContainFacet(GetBoundBox(ulX, ulY, ulZ), rclFacet) == TRUE)
-            _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
+            AddElement(ulX, ulY, ulZ, ulFacetIndex);
         }
       }
     }
@@ -503,13 +523,13 @@ inline void MeshFacetGrid::AddFacet (const MeshGeomFacet &rclFacet, unsigned lon
         for (ulZ = ulZ1; ulZ <= ulZ2; ulZ++)
         {
           if ( rclFacet.IntersectBoundingBox( GetBoundBox(ulX, ulY, ulZ) ) )
-            _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
+            AddElement(ulX, ulY, ulZ, ulFacetIndex);
         }
       }
     }
   }
   else
-    _aulGrid[ulX1][ulY1][ulZ1].insert(ulFacetIndex);
+    AddElement(ulX1, ulY1, ulZ1, ulFacetIndex);
 
 #endif
 }
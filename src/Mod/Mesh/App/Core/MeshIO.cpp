@@ -36,14 +36,21 @@
 #include <Base/FileInfo.h>
 #include <Base/Sequencer.h>
 #include <Base/Stream.h>
+#include <Base/Tokenizer.h>
 #include <zipios++/gzipoutputstream.h>
 
 #include <math.h>
+#include <cstring>
 #include <sstream>
 #include <iomanip>
 #include <boost/regex.hpp>
 #include <boost/algorithm/string.hpp>
 
+#include <QFile>
+#include <QThread>
+#include <QFuture>
+#include <QtConcurrentMap>
+
 
 using namespace MeshCore;
 
@@ -299,6 +306,600 @@ Convert_Camera_Model(Vector *pos, Vector *at, Vector *up, Vector *res_axis,
 
 // --------------------------------------------------------------
 
+namespace {
+
+using namespace Base::Tokenizer;
+
+bool parseVector(const char*& p, const char* end, Base::Vector3f& v)
+{
+    return parseFloat(p, end, v.x) && parseFloat(p, end, v.y) && parseFloat(p, end, v.z);
+}
+
+// ----------------------------------------------------
+
+/**
+ * A range of complete lines of an ASCII file. The subclasses for the different formats parse
+ * a line in their operator() and keep the result until it gets merged into the mesh.
+ */
+struct AsciiPart
+{
+    const char* begin;
+    const char* end;
+    unsigned long firstLine; ///< number of lines in the file before this part
+
+    void CountLines()
+    {
+        numLines = std::count(begin, end, '\n');
+    }
+    unsigned long numLines;
+
+    // calls func(p, eol, lineIndex) for each line of the part and stops if it returns false
+    template <class Func>
+    void ForEachLine(Func& func) const
+    {
+        unsigned long line = firstLine;
+        for (const char* p = begin; p < end; ++line) {
+            const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+            if (!eol)
+                eol = end;
+            if (!func(p, eol, line))
+                break;
+            p = eol + 1;
+        }
+    }
+};
+
+template <class Part>
+void parsePart(Part& part)
+{
+    part.ForEachLine(part);
+}
+
+template <class Part>
+void countPartLines(Part& part)
+{
+    part.CountLines();
+}
+
+/**
+ * Reads the rest of the stream in large blocks that end at a line boundary. Each block gets
+ * split into parts of complete lines that are parsed by several threads if the block is large
+ * enough. Afterwards the parts are handed over to merger.Merge() in the order of the file.
+ * Reading stops at the end of the stream or as soon as Merge() returns false.
+ */
+template <class Part, class Merger>
+void parseAsciiBlocks(std::istream &rstrIn, Merger& merger)
+{
+    const std::size_t blockSize = 32 * 1024 * 1024;
+    const std::size_t minPartSize = 1024 * 1024;
+    const std::size_t maxParts = std::max<int>(1, QThread::idealThreadCount());
+
+    // don't allocate a whole block for small files
+    std::size_t bufferSize = blockSize;
+    std::streambuf* buf = rstrIn.rdbuf();
+    std::streamoff cur = buf ? std::streamoff(buf->pubseekoff(0, std::ios::cur, std::ios::in)) : -1;
+    if (cur >= 0) {
+        std::streamoff end = buf->pubseekoff(0, std::ios::end, std::ios::in);
+        buf->pubseekoff(cur, std::ios::beg, std::ios::in);
+        if (end >= cur)
+            bufferSize = std::min<std::size_t>(blockSize, static_cast<std::size_t>(end - cur) + 1);
+    }
+
+    std::vector<char> buffer(bufferSize);
+    std::size_t filled = 0;
+    unsigned long lineCount = 0;
+    bool eof = false;
+
+    while (!eof) {
+        rstrIn.read(&buffer[filled], buffer.size() - filled);
+        std::size_t size = filled + static_cast<std::size_t>(rstrIn.gcount());
+        eof = !rstrIn;
+
+        // only complete lines are parsed, the rest is moved to the begin of the next block
+        std::size_t used = size;
+        if (!eof) {
+            while (used > 0 && buffer[used-1] != '\n')
+                used--;
+            if (used == 0) { // a single line longer than the buffer
+                filled = size;
+                buffer.resize(2 * buffer.size());
+                continue;
+            }
+        }
+
+        const char* data = size > 0 ? &buffer[0] : 0;
+        std::size_t numParts = std::min(maxParts, used / minPartSize + 1);
+        std::vector<Part> parts(numParts, merger.CreatePart());
+        const char* pos = data;
+        for (std::size_t i = 0; i < numParts; i++) {
+            const char* stop = data + used;
+            if (i + 1 < numParts) {
+                stop = std::max(pos, data + (i + 1) * used / numParts);
+                while (stop < data + used && *stop != '\n')
+                    ++stop;
+                if (stop < data + used)
+                    ++stop;
+            }
+            parts[i].begin = pos;
+            parts[i].end = stop;
+            pos = stop;
+        }
+
+        if (numParts > 1) {
+            QtConcurrent::map(parts, &countPartLines<Part>).waitForFinished();
+        }
+        else {
+            parts[0].CountLines();
+        }
+        for (std::size_t i = 0; i < numParts; i++) {
+            parts[i].firstLine = lineCount;
+            lineCount += parts[i].numLines;
+        }
+
+        if (numParts > 1) {
+            QtConcurrent::map(parts, &parsePart<Part>).waitForFinished();
+        }
+        else {
+            parsePart(parts[0]);
+        }
+
+        for (std::size_t i = 0; i < numParts; i++) {
+            if (!merger.Merge(parts[i]))
+                return;
+        }
+
+        filled = size - used;
+        if (filled > 0)
+            memmove(&buffer[0], &buffer[used], filled);
+    }
+}
+
+// ----------------------------------------------------
+
+struct ObjPart : public AsciiPart
+{
+    MeshPointArray points;
+    MeshFacetArray facets;  ///< the property is the segment relative to the part
+    bool readVertices;      ///< a vertex was read after the last facet
+    bool firstIsNewSegment; ///< vertices are in front of the first facet
+    unsigned long segment;
+
+    ObjPart() : readVertices(false), firstIsNewSegment(false), segment(0)
+    {
+    }
+    bool operator()(const char* p, const char* eol, unsigned long)
+    {
+        if (p == eol)
+            return true;
+        if (*p == 'v' || *p == 'V') {
+            Base::Vector3f v;
+            ++p;
+            if (isTokenEnd(p, eol) && parseVector(p, eol, v) && isLineEnd(p, eol)) {
+                readVertices = true;
+                points.push_back(MeshPoint(v));
+            }
+        }
+        else if (*p == 'f' || *p == 'F') {
+            ++p;
+            if (!isTokenEnd(p, eol))
+                return true;
+            // vertex/texture/normal indices where only the vertex index is used
+            unsigned long index[5], skip;
+            int count = 0;
+            while (count < 5 && parseIndex(p, eol, index[count], true)) {
+                for (int i=0; i<2 && p < eol && *p == '/'; i++) {
+                    ++p;
+                    if (p < eol && *p >= '0' && *p <= '9')
+                        parseIndex(p, eol, skip, true);
+                }
+                if (!isTokenEnd(p, eol))
+                    return true;
+                count++;
+            }
+            if ((count != 3 && count != 4) || !isLineEnd(p, eol))
+                return true;
+
+            // starts a new segment
+            if (readVertices) {
+                readVertices = false;
+                if (facets.empty())
+                    firstIsNewSegment = true;
+                segment++;
+            }
+
+            MeshFacet item;
+            item.SetVertices(index[0]-1,index[1]-1,index[2]-1);
+            item.SetProperty(segment);
+            facets.push_back(item);
+            if (count == 4) {
+                item.SetVertices(index[2]-1,index[3]-1,index[0]-1);
+                facets.push_back(item);
+            }
+        }
+        return true;
+    }
+};
+
+struct ObjMerger
+{
+    MeshPointArray meshPoints;
+    MeshFacetArray meshFacets;
+    unsigned long segment;
+    bool readVertices;
+
+    ObjMerger() : segment(0), readVertices(false)
+    {
+    }
+    ObjPart CreatePart() const
+    {
+        return ObjPart();
+    }
+    bool Merge(ObjPart& part)
+    {
+        meshPoints.insert(meshPoints.end(), part.points.begin(), part.points.end());
+        if (part.facets.empty()) {
+            readVertices = readVertices || !part.points.empty();
+            return true;
+        }
+
+        // the first facet starts a new segment if vertices were read before
+        unsigned long offset = segment;
+        if (readVertices && !part.firstIsNewSegment)
+            offset++;
+        for (MeshFacetArray::_TIterator it = part.facets.begin(); it != part.facets.end(); ++it)
+            it->_ulProp += offset;
+        meshFacets.insert(meshFacets.end(), part.facets.begin(), part.facets.end());
+        segment = offset + part.segment;
+        readVertices = part.readVertices;
+
+        // free the memory of the part
+        MeshPointArray().swap(part.points);
+        MeshFacetArray().swap(part.facets);
+        return true;
+    }
+};
+
+// ----------------------------------------------------
+
+struct OffPart : public AsciiPart
+{
+    MeshPointArray points;
+    MeshFacetArray facets;
+    /// for each face the number of points in front of it and the number of its triangles
+    std::vector<std::pair<unsigned long, int> > faces;
+
+    bool operator()(const char* p, const char* eol, unsigned long)
+    {
+        Base::Vector3f v;
+        const char* s = p;
+        if (parseVector(s, eol, v) && isLineEnd(s, eol)) {
+            points.push_back(MeshPoint(v));
+            return true;
+        }
+
+        unsigned long n, i[4];
+        if (!parseIndex(p, eol, n) || (n != 3 && n != 4))
+            return true;
+        for (unsigned long k=0; k<n; k++) {
+            if (!parseIndex(p, eol, i[k]))
+                return true;
+        }
+        if (!isLineEnd(p, eol))
+            return true;
+
+        facets.push_back(MeshFacet(i[0],i[1],i[2]));
+        if (n == 4)
+            facets.push_back(MeshFacet(i[2],i[3],i[0]));
+        faces.push_back(std::make_pair(static_cast<unsigned long>(points.size()), int(n - 2)));
+        return true;
+    }
+};
+
+struct OffMerger
+{
+    MeshPointArray meshPoints;
+    MeshFacetArray meshFacets;
+    unsigned long numPoints, numFaces;
+    unsigned long cntPoints, cntFaces;
+
+    OffMerger(unsigned long points, unsigned long faces)
+      : numPoints(points), numFaces(faces), cntPoints(0), cntFaces(0)
+    {
+        meshPoints.reserve(numPoints);
+        meshFacets.reserve(numFaces);
+    }
+    OffPart CreatePart() const
+    {
+        return OffPart();
+    }
+    bool Merge(OffPart& part)
+    {
+        // the first numPoints points are the vertices, the faces must follow them
+        unsigned long take = std::min<unsigned long>(part.points.size(), numPoints - meshPoints.size());
+        meshPoints.insert(meshPoints.end(), part.points.begin(), part.points.begin() + take);
+
+        MeshFacetArray::_TConstIterator it = part.facets.begin();
+        for (std::vector<std::pair<unsigned long, int> >::iterator jt = part.faces.begin();
+            jt != part.faces.end(); ++jt) {
+            if (cntFaces < numFaces && cntPoints + jt->first >= numPoints) {
+                meshFacets.insert(meshFacets.end(), it, it + jt->second);
+                cntFaces++;
+            }
+            it += jt->second;
+        }
+
+        cntPoints += part.points.size();
+        return cntFaces < numFaces;
+    }
+};
+
+// ----------------------------------------------------
+
+struct PlyPart : public AsciiPart
+{
+    MeshPointArray points;
+    MeshFacetArray facets;
+    std::vector<App::Color> colors;
+    std::size_t v_count, f_count;
+    bool rgb, error;
+
+    PlyPart(std::size_t v, std::size_t f, bool c)
+      : v_count(v), f_count(f), rgb(c), error(false)
+    {
+    }
+    bool operator()(const char* p, const char* eol, unsigned long line)
+    {
+        if (line < v_count) {
+            // each vertex line must be valid
+            Base::Vector3f v;
+            if (!parseVector(p, eol, v)) {
+                error = true;
+                return false;
+            }
+            if (rgb) {
+                unsigned long r, g, b;
+                if (!parseIndex(p, eol, r) || !parseIndex(p, eol, g) || !parseIndex(p, eol, b) ||
+                    r > 999 || g > 999 || b > 999) {
+                    error = true;
+                    return false;
+                }
+                colors.push_back(App::Color((float)std::min<unsigned long>(r,255)/255.0f,
+                                            (float)std::min<unsigned long>(g,255)/255.0f,
+                                            (float)std::min<unsigned long>(b,255)/255.0f));
+            }
+            if (!isLineEnd(p, eol)) {
+                error = true;
+                return false;
+            }
+            points.push_back(MeshPoint(v));
+        }
+        else if (line < v_count + f_count) {
+            unsigned long n, f1, f2, f3;
+            if (parseIndex(p, eol, n) && n == 3 && parseIndex(p, eol, f1) &&
+                parseIndex(p, eol, f2) && parseIndex(p, eol, f3) && isLineEnd(p, eol))
+                facets.push_back(MeshFacet(f1,f2,f3));
+        }
+        else {
+            return false;
+        }
+        return true;
+    }
+};
+
+struct PlyMerger
+{
+    MeshPointArray& meshPoints;
+    MeshFacetArray& meshFacets;
+    std::vector<App::Color>* colors;
+    std::size_t v_count, f_count;
+    bool rgb, error;
+
+    PlyMerger(MeshPointArray& p, MeshFacetArray& f, std::vector<App::Color>* c,
+              std::size_t v, std::size_t fc, bool rgb)
+      : meshPoints(p), meshFacets(f), colors(c), v_count(v), f_count(fc), rgb(rgb), error(false)
+    {
+    }
+    PlyPart CreatePart() const
+    {
+        return PlyPart(v_count, f_count, rgb);
+    }
+    bool Merge(PlyPart& part)
+    {
+        if (part.error) {
+            error = true;
+            return false;
+        }
+        meshPoints.insert(meshPoints.end(), part.points.begin(), part.points.end());
+        meshFacets.insert(meshFacets.end(), part.facets.begin(), part.facets.end());
+        if (colors)
+            colors->insert(colors->end(), part.colors.begin(), part.colors.end());
+        return part.firstLine + part.numLines < v_count + f_count;
+    }
+};
+
+// ----------------------------------------------------
+
+struct StlPart : public AsciiPart
+{
+    std::vector<Base::Vector3f> points;
+    std::vector<Base::Vector3f> normals;
+    /// for each point the index of the current normal, -1 if the normal is in front of the part
+    std::vector<int> normalIndex;
+
+    bool operator()(const char* p, const char* eol, unsigned long)
+    {
+        Base::Vector3f v;
+        if (parseKeyword(p, eol, "VERTEX")) {
+            if (parseVector(p, eol, v) && isLineEnd(p, eol)) {
+                points.push_back(v);
+                normalIndex.push_back(int(normals.size()) - 1);
+            }
+        }
+        else if (parseKeyword(p, eol, "FACET") && parseKeyword(p, eol, "NORMAL")) {
+            if (parseVector(p, eol, v) && isLineEnd(p, eol))
+                normals.push_back(v);
+        }
+        return true;
+    }
+};
+
+struct StlMerger
+{
+    MeshFastBuilder& builder;
+    std::streamoff size;
+    bool initialized;
+    MeshGeomFacet facet;
+    Base::Vector3f normal;
+    bool hasNormal;
+    int vertexCt;
+
+    StlMerger(MeshFastBuilder& b, std::streamoff s)
+      : builder(b), size(s), initialized(false), hasNormal(false), vertexCt(0)
+    {
+    }
+    StlPart CreatePart() const
+    {
+        return StlPart();
+    }
+    bool Merge(StlPart& part)
+    {
+        // instead of counting the facets in an extra pass over the file estimate their number
+        // from the size of the first part that contains vertices
+        if (!initialized && !part.points.empty()) {
+            double facetsPerByte = double(part.points.size()) / double(3 * (part.end - part.begin));
+            builder.Initialize((unsigned long)(facetsPerByte * double(size)));
+            initialized = true;
+        }
+
+        for (std::size_t i = 0; i < part.points.size(); i++) {
+            facet._aclPoints[vertexCt++] = part.points[i];
+            if (vertexCt == 3) {
+                vertexCt = 0;
+                int n = part.normalIndex[i];
+                if (n >= 0)
+                    facet.SetNormal(part.normals[n]);
+                else if (hasNormal)
+                    facet.SetNormal(normal);
+                else
+                    facet.CalcNormal();
+                builder.AddFacet(facet);
+            }
+        }
+        if (!part.normals.empty()) {
+            normal = part.normals.back();
+            hasNormal = true;
+        }
+        return true;
+    }
+};
+
+/** Checks the data behind the header of an STL file for keywords of the ASCII format.
+ * The data is converted to upper case.
+ */
+bool hasAsciiSTLKeyword(char* data)
+{
+    upper(data);
+    return (strstr(data, "SOLID") != NULL)  || (strstr(data, "FACET") != NULL)    || (strstr(data, "NORMAL") != NULL) ||
+           (strstr(data, "VERTEX") != NULL) || (strstr(data, "ENDFACET") != NULL) || (strstr(data, "ENDLOOP") != NULL);
+}
+
+/** Checks if the data of an STL file is in binary format the same way as
+ * MeshInput::LoadSTL() does. If the data is too short to decide it returns false.
+ */
+bool isBinarySTL(const char* data, std::size_t size)
+{
+    char szBuf[101];
+    uint32_t ulCt;
+    if (size < 84)
+        return false;
+    std::memcpy(&ulCt, data + 80, sizeof(ulCt));
+    std::size_t ulBytes = (ulCt > 1 ? 100 : 50);
+    if (size < 84 + ulBytes)
+        return false;
+    std::memcpy(szBuf, data + 84, ulBytes);
+    szBuf[ulBytes] = 0;
+    return !hasAsciiSTLKeyword(szBuf);
+}
+
+/** Decodes a range of the 50 byte facet records of a binary STL file. */
+struct StlBinaryRange
+{
+    const char* records;
+    Base::Vector3f* vertices;
+    std::size_t begin, end;
+
+    void Decode()
+    {
+        float data[12];
+        Base::Vector3f* v = vertices + 3 * begin;
+        for (std::size_t i = begin; i < end; i++) {
+            // the records are not aligned
+            std::memcpy(data, records + 50 * i, sizeof(data));
+            // for compatibility with older versions a facet starts with the third point
+            Base::Vector3f normal(data[0], data[1], data[2]);
+            Base::Vector3f p0(data[9], data[10], data[11]);
+            Base::Vector3f p1(data[3], data[4], data[5]);
+            Base::Vector3f p2(data[6], data[7], data[8]);
+
+            // adjust circulation direction
+            *v++ = p0;
+            if ((((p1 - p0) % (p2 - p0)) * normal) < 0.0f) {
+                *v++ = p2;
+                *v++ = p1;
+            }
+            else {
+                *v++ = p1;
+                *v++ = p2;
+            }
+        }
+    }
+};
+
+/** Formats a range of facets as records of a binary STL file. */
+struct StlBinaryBlock
+{
+    const MeshPointArray* points;
+    const MeshFacetArray* facets;
+    const Base::Matrix4D* transform; ///< null if the points are not transformed
+    std::size_t begin, end;
+    std::vector<char> buffer;
+
+    void Format()
+    {
+        buffer.resize(50 * (end - begin));
+        char* b = buffer.empty() ? 0 : &buffer[0];
+        const MeshPointArray& rPoints = *points;
+        float data[12];
+        for (std::size_t i = begin; i < end; i++) {
+            const MeshFacet& face = (*facets)[i];
+            Base::Vector3f p[3];
+            for (int j = 0; j < 3; j++) {
+                p[j] = rPoints[face._aulPoints[j]];
+                if (transform)
+                    p[j] = (*transform) * p[j];
+            }
+            Base::Vector3f normal = (p[1] - p[0]) % (p[2] - p[0]);
+            normal.Normalize();
+
+            data[0] = normal.x; data[1] = normal.y; data[2] = normal.z;
+            for (int j = 0; j < 3; j++) {
+                data[3*j+3] = p[j].x;
+                data[3*j+4] = p[j].y;
+                data[3*j+5] = p[j].z;
+            }
+            std::memcpy(b, data, sizeof(data));
+            // attribute
+            b[48] = 0;
+            b[49] = 0;
+            b += 50;
+        }
+    }
+};
+
+} // namespace
+
+// --------------------------------------------------------------
+
 bool MeshInput::LoadAny(const char* FileName)
 {
     // ask for read permission
@@ -318,7 +919,16 @@ bool MeshInput::LoadAny(const char* FileName)
         // read file
         bool ok = false;
         if (fi.hasExtension("stl") || fi.hasExtension("ast")) {
-            ok = LoadSTL(str);
+            // decode binary files directly from a memory mapping of the file
+            QFile file(QString::fromUtf8(fi.filePath().c_str()));
+            const char* data = 0;
+            qint64 size = file.size();
+            if (file.open(QIODevice::ReadOnly) && size > 0)
+                data = reinterpret_cast<const char*>(file.map(0, size));
+            if (data && isBinarySTL(data, static_cast<std::size_t>(size)))
+                ok = LoadBinarySTL(data, static_cast<std::size_t>(size));
+            else
+                ok = LoadSTL(str);
         }
         else if (fi.hasExtension("iv")) {
             ok = LoadInventor( str );
@@ -372,11 +982,9 @@ bool MeshInput::LoadSTL (std::istream &rstrIn)
     if (rstrIn.read(szBuf, ulBytes) == false)
         return (ulCt==0);
     szBuf[ulBytes] = 0;
-    upper(szBuf);
 
     try {
-        if ((strstr(szBuf, "SOLID") == NULL)  && (strstr(szBuf, "FACET") == NULL)    && (strstr(szBuf, "NORMAL") == NULL) &&
-            (strstr(szBuf, "VERTEX") == NULL) && (strstr(szBuf, "ENDFACET") == NULL) && (strstr(szBuf, "ENDLOOP") == NULL)) {
+        if (!hasAsciiSTLKeyword(szBuf)) {
             // probably binary STL
             buf->pubseekoff(0, std::ios::beg, std::ios::in);
             return LoadBinarySTL(rstrIn);
@@ -410,28 +1018,6 @@ bool MeshInput::LoadSTL (std::istream &rstrIn)
 /** Loads an OBJ file. */
 bool MeshInput::LoadOBJ (std::istream &rstrIn)
 {
-    boost::regex rx_p("^v\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                        "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                        "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)\\s*$");
-    boost::regex rx_f3("^f\\s+([0-9]+)/?[0-9]*/?[0-9]*"
-                         "\\s+([0-9]+)/?[0-9]*/?[0-9]*"
-                         "\\s+([0-9]+)/?[0-9]*/?[0-9]*\\s*$");
-    boost::regex rx_f4("^f\\s+([0-9]+)/?[0-9]*/?[0-9]*"
-                         "\\s+([0-9]+)/?[0-9]*/?[0-9]*"
-                         "\\s+([0-9]+)/?[0-9]*/?[0-9]*"
-                         "\\s+([0-9]+)/?[0-9]*/?[0-9]*\\s*$");
-    boost::cmatch what;
-
-    unsigned long segment=0;
-    MeshPointArray meshPoints;
-    MeshFacetArray meshFacets;
-
-    std::string line;
-    float fX, fY, fZ;
-    unsigned int  i1=1,i2=1,i3=1,i4=1;
-    MeshGeomFacet clFacet;
-    MeshFacet item;
-
     if (!rstrIn || rstrIn.bad() == true)
         return false;
 
@@ -439,54 +1025,10 @@ bool MeshInput::LoadOBJ (std::istream &rstrIn)
     if (!buf)
         return false;
 
-    bool readvertices=false;
-    while (std::getline(rstrIn, line)) {
-        for (std::string::iterator it = line.begin(); it != line.end(); ++it)
-            *it = tolower(*it);
-        if (boost::regex_match(line.c_str(), what, rx_p)) {
-            readvertices = true;
-            fX = (float)std::atof(what[1].first);
-            fY = (float)std::atof(what[4].first);
-            fZ = (float)std::atof(what[7].first);
-            meshPoints.push_back(MeshPoint(Base::Vector3f(fX, fY, fZ)));
-        }
-        else if (boost::regex_match(line.c_str(), what, rx_f3)) {
-            // starts a new segment
-            if (readvertices) {
-                readvertices = false;
-                segment++;
-            }
-
-            // 3-vertex face
-            i1 = std::atoi(what[1].first);
-            i2 = std::atoi(what[2].first);
-            i3 = std::atoi(what[3].first);
-            item.SetVertices(i1-1,i2-1,i3-1);
-            item.SetProperty(segment);
-            meshFacets.push_back(item);
-        }
-        else if (boost::regex_match(line.c_str(), what, rx_f4)) {
-            // starts a new segment
-            if (readvertices) {
-                readvertices = false;
-                segment++;
-            }
-
-            // 4-vertex face
-            i1 = std::atoi(what[1].first);
-            i2 = std::atoi(what[2].first);
-            i3 = std::atoi(what[3].first);
-            i4 = std::atoi(what[4].first);
-
-            item.SetVertices(i1-1,i2-1,i3-1);
-            item.SetProperty(segment);
-            meshFacets.push_back(item);
-
-            item.SetVertices(i3-1,i4-1,i1-1);
-            item.SetProperty(segment);
-            meshFacets.push_back(item);
-        }
-    }
+    ObjMerger merger;
+    parseAsciiBlocks<ObjPart>(rstrIn, merger);
+    MeshPointArray& meshPoints = merger.meshPoints;
+    MeshFacetArray& meshFacets = merger.meshFacets;
 
     this->_rclMesh.Clear(); // remove all data before
     // Don't use Assign() because Merge() checks which points are really needed.
@@ -519,23 +1061,7 @@ bool MeshInput::LoadOBJ (std::istream &rstrIn)
 /** Loads an OFF file. */
 bool MeshInput::LoadOFF (std::istream &rstrIn)
 {
-    boost::regex rx_n("^\\s*([0-9]+)\\s+([0-9]+)\\s+([0-9]+)\\s*$");
-    boost::regex rx_p("^\\s*([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                       "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                       "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)\\s*$");
-    boost::regex rx_f3("^\\s*([0-9]+)\\s+([0-9]+)\\s+([0-9]+)\\s+([0-9]+)\\s*$");
-    boost::regex rx_f4("^\\s*([0-9]+)\\s+([0-9]+)\\s+([0-9]+)\\s+([0-9]+)\\s+([0-9]+)\\s*$");
-
-    boost::cmatch what;
-
-    MeshPointArray meshPoints;
-    MeshFacetArray meshFacets;
-
     std::string line;
-    float fX, fY, fZ;
-    unsigned int  i1=1,i2=1,i3=1,i4=1;
-    MeshGeomFacet clFacet;
-    MeshFacet item;
 
     if (!rstrIn || rstrIn.bad() == true)
         return false;
@@ -550,66 +1076,21 @@ bool MeshInput::LoadOFF (std::istream &rstrIn)
         return false; // not an OFF file
 
     // get number of vertices and faces
-    int numPoints=0, numFaces=0;
+    unsigned long numPoints=0, numFaces=0, numEdges=0;
     std::getline(rstrIn, line);
-    boost::algorithm::to_lower(line);
-    if (boost::regex_match(line.c_str(), what, rx_n)) {
-        numPoints = std::atoi(what[1].first);
-        numFaces = std::atoi(what[2].first);
-    }
-    else {
+    const char* pos = line.c_str();
+    const char* end = pos + line.size();
+    if (!parseIndex(pos, end, numPoints) || !parseIndex(pos, end, numFaces) ||
+        !parseIndex(pos, end, numEdges) || !isLineEnd(pos, end)) {
         // Cannot read number of elements
         return false;
     }
 
-    meshPoints.reserve(numPoints);
-    meshFacets.reserve(numFaces);
-
-    int cntPoints = 0;
-    while (cntPoints < numPoints) {
-        if (!std::getline(rstrIn, line))
-            break;
-        if (boost::regex_match(line.c_str(), what, rx_p)) {
-            fX = (float)std::atof(what[1].first);
-            fY = (float)std::atof(what[4].first);
-            fZ = (float)std::atof(what[7].first);
-            meshPoints.push_back(MeshPoint(Base::Vector3f(fX, fY, fZ)));
-            cntPoints++;
-        }
-    }
-
-    int cntFaces = 0;
-    while (cntFaces < numFaces) {
-        if (!std::getline(rstrIn, line))
-            break;
-        if (boost::regex_match(line.c_str(), what, rx_f3)) {
-            // 3-vertex face
-            if (std::atoi(what[1].first) == 3) {
-                i1 = std::atoi(what[2].first);
-                i2 = std::atoi(what[3].first);
-                i3 = std::atoi(what[4].first);
-                item.SetVertices(i1,i2,i3);
-                meshFacets.push_back(item);
-                cntFaces++;
-            }
-        }
-        else if (boost::regex_match(line.c_str(), what, rx_f4)) {
-            // 4-vertex face
-            if (std::atoi(what[1].first) == 4) {
-                i1 = std::atoi(what[2].first);
-                i2 = std::atoi(what[3].first);
-                i3 = std::atoi(what[4].first);
-                i4 = std::atoi(what[5].first);
-
-                item.SetVertices(i1,i2,i3);
-                meshFacets.push_back(item);
-
-                item.SetVertices(i3,i4,i1);
-                meshFacets.push_back(item);
-                cntFaces++;
-            }
-        }
-    }
+    OffMerger merger(numPoints, numFaces);
+    if (numFaces > 0)
+        parseAsciiBlocks<OffPart>(rstrIn, merger);
+    MeshPointArray& meshPoints = merger.meshPoints;
+    MeshFacetArray& meshFacets = merger.meshFacets;
 
     this->_rclMesh.Clear(); // remove all data before
     // Don't use Assign() because Merge() checks which points are really needed.
@@ -760,62 +1241,12 @@ bool MeshInput::LoadPLY (std::istream &inp)
     }
 
     if (format == ascii) {
-        boost::regex rx_p("^([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                          "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                          "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)\\s*$");
-        boost::regex rx_c("^([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                          "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                          "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                          "\\s+([0-9]{1,3})\\s+([0-9]{1,3})\\s+([0-9]{1,3})\\s*$");
-        boost::regex rx_f("^\\s*3\\s+([0-9]+)\\s+([0-9]+)\\s+([0-9]+)\\s*$");
-        boost::cmatch what;
-        Base::Vector3f pt;
-
-        if (rgb_value == MeshIO::PER_VERTEX) {
-            int r,g,b;
-            for (std::size_t i = 0; i < v_count && std::getline(inp, line); i++) {
-                if (boost::regex_match(line.c_str(), what, rx_c)) {
-                    pt.x = (float)std::atof(what[1].first);
-                    pt.y = (float)std::atof(what[4].first);
-                    pt.z = (float)std::atof(what[7].first);
-                    meshPoints.push_back(pt);
-                    if (_material) {
-                        r = std::min<int>(std::atoi(what[10].first),255);
-                        g = std::min<int>(std::atoi(what[11].first),255);
-                        b = std::min<int>(std::atoi(what[12].first),255);
-                        float fr = (float)r/255.0f;
-                        float fg = (float)g/255.0f;
-                        float fb = (float)b/255.0f;
-                        _material->diffuseColor.push_back(App::Color(fr, fg, fb));
-                    }
-                }
-                else {
-                    return false;
-                }
-            }
-        }
-        else {
-            for (std::size_t i = 0; i < v_count && std::getline(inp, line); i++) {
-                if (boost::regex_match(line.c_str(), what, rx_p)) {
-                    pt.x = (float)std::atof(what[1].first);
-                    pt.y = (float)std::atof(what[4].first);
-                    pt.z = (float)std::atof(what[7].first);
-                    meshPoints.push_back(pt);
-                }
-                else {
-                    return false;
-                }
-            }
-        }
-        int f1, f2, f3;
-        for (std::size_t i = 0; i < f_count && std::getline(inp, line); i++) {
-            if (boost::regex_match(line.c_str(), what, rx_f)) {
-                f1 = std::atoi(what[1].first);
-                f2 = std::atoi(what[2].first);
-                f3 = std::atoi(what[3].first);
-                meshFacets.push_back(MeshFacet(f1,f2,f3));
-            }
-        }
+        PlyMerger merger(meshPoints, meshFacets, _material ? &_material->diffuseColor : 0,
+                         v_count, f_count, rgb_value == MeshIO::PER_VERTEX);
+        if (v_count + f_count > 0)
+            parseAsciiBlocks<PlyPart>(inp, merger);
+        if (merger.error)
+            return false;
     }
     // binary
     else {
@@ -880,20 +1311,12 @@ bool MeshInput::LoadPLY (std::istream &inp)
 
 bool MeshInput::LoadMeshNode (std::istream &rstrIn)
 {
-    boost::regex rx_p("^v\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                      "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                      "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)\\s*$");
-    boost::regex rx_f("^f\\s+([0-9]+)\\s+([0-9]+)\\s+([0-9]+)\\s*$");
-    boost::regex rx_e("\\s*]\\s*");
-    boost::cmatch what;
-
     MeshPointArray meshPoints;
     MeshFacetArray meshFacets;
 
     std::string line;
-    float fX, fY, fZ;
-    unsigned int  i1=1,i2=1,i3=1;
-    MeshGeomFacet clFacet;
+    Base::Vector3f pt;
+    unsigned long i1=1,i2=1,i3=1;
 
     if (!rstrIn || rstrIn.bad() == true)
         return false;
@@ -902,23 +1325,27 @@ bool MeshInput::LoadMeshNode (std::istream &rstrIn)
     if (!buf)
         return false;
 
+    // the node is part of an Inventor file, so read line by line and stop at its end
     while (std::getline(rstrIn, line)) {
-        for (std::string::iterator it = line.begin(); it != line.end(); ++it)
-            *it = tolower(*it);
-        if (boost::regex_match(line.c_str(), what, rx_p)) {
-            fX = (float)std::atof(what[1].first);
-            fY = (float)std::atof(what[4].first);
-            fZ = (float)std::atof(what[7].first);
-            meshPoints.push_back(MeshPoint(Base::Vector3f(fX, fY, fZ)));
-        }
-        else if (boost::regex_match(line.c_str(), what, rx_f)) {
-            i1 = std::atoi(what[1].first);
-            i2 = std::atoi(what[2].first);
-            i3 = std::atoi(what[3].first);
-            meshFacets.push_back(MeshFacet(i1-1,i2-1,i3-1));
-        }
-        else if (boost::regex_match(line.c_str(), what, rx_e)) {
-            break;
+        const char* pos = line.c_str();
+        const char* end = pos + line.size();
+        if (pos == end)
+            continue;
+        if (*pos == 'v' || *pos == 'V') {
+            ++pos;
+            if (isTokenEnd(pos, end) && parseVector(pos, end, pt) && isLineEnd(pos, end))
+                meshPoints.push_back(MeshPoint(pt));
+        }
+        else if (*pos == 'f' || *pos == 'F') {
+            ++pos;
+            if (isTokenEnd(pos, end) && parseIndex(pos, end, i1) && parseIndex(pos, end, i2) &&
+                parseIndex(pos, end, i3) && isLineEnd(pos, end))
+                meshFacets.push_back(MeshFacet(i1-1,i2-1,i3-1));
+        }
+        else {
+            pos = skipBlanks(pos, end);
+            if (pos < end && *pos == ']' && isLineEnd(pos + 1, end))
+                break;
         }
     }
 
@@ -935,19 +1362,6 @@ bool MeshInput::LoadMeshNode (std::istream &rstrIn)
 /** Loads an ASCII STL file. */
 bool MeshInput::LoadAsciiSTL (std::istream &rstrIn)
 {
-    boost::regex rx_p("^\\s*VERTEX\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                      "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                      "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)\\s*$");
-    boost::regex rx_f("^\\s*FACET\\s+NORMAL\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                      "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                      "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)\\s*$");
-    boost::cmatch what;
-
-    std::string line;
-    float fX, fY, fZ;
-    unsigned long ulVertexCt, ulFacetCt=0;
-    MeshGeomFacet clFacet;
-
     if (!rstrIn || rstrIn.bad() == true)
         return false;
 
@@ -955,48 +1369,10 @@ bool MeshInput::LoadAsciiSTL (std::istream &rstrIn)
     std::streambuf* buf = rstrIn.rdbuf();
     ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
     buf->pubseekoff(0, std::ios::beg, std::ios::in);
-    ulSize -= 20;
 
-    // count facets
-    while (std::getline(rstrIn, line)) {
-        for (std::string::iterator it = line.begin(); it != line.end(); ++it)
-            *it = toupper(*it);
-        if (line.find("ENDFACET") != std::string::npos)
-            ulFacetCt++;
-        // prevent from reading EOF (as I don't know how to reread the file then)
-        if (rstrIn.tellg() > ulSize)
-            break;
-        else if (line.find("ENDSOLID") != std::string::npos)
-            break;
-    }
-
-    // restart from the beginning
-    buf->pubseekoff(0, std::ios::beg, std::ios::in);
-
-    MeshBuilder builder(this->_rclMesh);
-    builder.Initialize(ulFacetCt);
-
-    ulVertexCt = 0;
-    while (std::getline(rstrIn, line)) {
-        for (std::string::iterator it = line.begin(); it != line.end(); ++it)
-            *it = toupper(*it);
-        if (boost::regex_match(line.c_str(), what, rx_f)) {
-            fX = (float)std::atof(what[1].first);
-            fY = (float)std::atof(what[4].first);
-            fZ = (float)std::atof(what[7].first);
-            clFacet.SetNormal(Base::Vector3f(fX, fY, fZ));
-        }
-        else if (boost::regex_match(line.c_str(), what, rx_p)) {
-            fX = (float)std::atof(what[1].first);
-            fY = (float)std::atof(what[4].first);
-            fZ = (float)std::atof(what[7].first);
-            clFacet._aclPoints[ulVertexCt++].Set(fX, fY, fZ);
-            if (ulVertexCt == 3) {
-                ulVertexCt = 0;
-                builder.AddFacet(clFacet);
-            }
-        }
-    }
+    MeshFastBuilder builder(this->_rclMesh);
+    StlMerger merger(builder, ulSize);
+    parseAsciiBlocks<StlPart>(rstrIn, merger);
 
     builder.Finish();
 
@@ -1007,8 +1383,6 @@ bool MeshInput::LoadAsciiSTL (std::istream &rstrIn)
 bool MeshInput::LoadBinarySTL (std::istream &rstrIn)
 {
     char szInfo[80];
-    Base::Vector3f clVects[4];
-    uint16_t usAtt; 
     uint32_t ulCt;
 
     if (!rstrIn || rstrIn.bad() == true)
@@ -1037,22 +1411,71 @@ bool MeshInput::LoadBinarySTL (std::istream &rstrIn)
     // compare the calculated with the read value
     if (ulCt > ulFac)
         return false;// not a valid STL file
- 
-    MeshBuilder builder(this->_rclMesh);
-    builder.Initialize(ulCt);
 
-    for (uint32_t i = 0; i < ulCt; i++) {
-        // read normal, points
-        rstrIn.read((char*)&clVects, sizeof(clVects));
+    // read the records in blocks
+    std::vector<Base::Vector3f> vertices(3 * std::size_t(ulCt));
+    std::vector<char> records;
+    const std::size_t blockSize = 65536;
+    for (std::size_t i = 0; i < ulCt; i += blockSize) {
+        StlBinaryRange range;
+        range.begin = 0;
+        range.end = std::min<std::size_t>(blockSize, ulCt - i);
+        records.resize(50 * range.end);
+        if (!rstrIn.read(&records[0], records.size()))
+            return false;
+        range.records = &records[0];
+        range.vertices = &vertices[3 * i];
+        range.Decode();
+    }
+
+    MeshFastBuilder builder(this->_rclMesh);
+    builder.AddFacets(vertices);
+    builder.Finish();
 
-        std::swap(clVects[0], clVects[3]);
-        builder.AddFacet(clVects);
+    return true;
+}
 
-        // overread 2 bytes attribute
-        rstrIn.read((char*)&usAtt, sizeof(usAtt));
-    }
+/** Loads a binary STL file from memory, e.g. a memory-mapped file.
+ * For large files the facet records are decoded by several threads.
+ */
+bool MeshInput::LoadBinarySTL (const char* data, std::size_t size)
+{
+    uint32_t ulCt;
+    if (size < 80 + sizeof(ulCt))
+        return false;
 
-    builder.Finish();
+    // skip header info and read the number of facets
+    std::memcpy(&ulCt, data + 80, sizeof(ulCt));
+
+    // compare with the number of facets of the data size
+    if (ulCt > (size - (80 + sizeof(ulCt))) / 50)
+        return false;// not a valid STL file
+
+    try {
+        std::vector<Base::Vector3f> vertices(3 * std::size_t(ulCt));
+        int numRanges = 1;
+        if (ulCt >= 100000)
+            numRanges = std::max<int>(1, QThread::idealThreadCount());
+        std::vector<StlBinaryRange> ranges(numRanges);
+        for (int i = 0; i < numRanges; i++) {
+            ranges[i].records = data + 80 + sizeof(ulCt);
+            ranges[i].vertices = vertices.empty() ? 0 : &vertices[0];
+            ranges[i].begin = i * std::size_t(ulCt) / numRanges;
+            ranges[i].end = (i + 1) * std::size_t(ulCt) / numRanges;
+        }
+        if (numRanges > 1)
+            QtConcurrent::map(ranges, &StlBinaryRange::Decode).waitForFinished();
+        else
+            ranges[0].Decode();
+
+        MeshFastBuilder builder(this->_rclMesh);
+        builder.AddFacets(vertices);
+        builder.Finish();
+    }
+    catch (const Base::AbortException&) {
+        _rclMesh.Clear();
+        return false;
+    }
 
     return true;
 }
@@ -1583,47 +2006,46 @@ bool MeshOutput::SaveAsciiSTL (std::ostream &rstrOut) const
 /** Saves the mesh object into a binary file. */
 bool MeshOutput::SaveBinarySTL (std::ostream &rstrOut) const
 {
-    MeshFacetIterator clIter(_rclMesh), clEnd(_rclMesh);
-    clIter.Transform(this->_transform);
-    const MeshGeomFacet *pclFacet;
-    uint32_t i;
-    uint16_t usAtt;
     char szInfo[81];
 
     if (!rstrOut || rstrOut.bad() == true /*|| _rclMesh.CountFacets() == 0*/)
         return false;
 
-    Base::SequencerLauncher seq("saving...", _rclMesh.CountFacets() + 1);  
+    // The facets are formatted in blocks by several threads and each block is
+    // written at once.
+    const std::size_t blockSize = 65536;
+    const std::size_t numFacets = _rclMesh.CountFacets();
+    const std::size_t numBlocks = (numFacets + blockSize - 1) / blockSize;
+    const std::size_t numThreads = std::max<int>(1, QThread::idealThreadCount());
+
+    Base::SequencerLauncher seq("saving...", numBlocks + 1);  
  
     strcpy(szInfo, stl_header.c_str());
     rstrOut.write(szInfo, std::strlen(szInfo));
 
-    uint32_t uCtFts = (uint32_t)_rclMesh.CountFacets();
+    uint32_t uCtFts = (uint32_t)numFacets;
     rstrOut.write((const char*)&uCtFts, sizeof(uCtFts));
 
-    usAtt = 0;
-    clIter.Begin();
-    clEnd.End();
-    while (clIter < clEnd) {
-        pclFacet = &(*clIter);
-        // normal
-        Base::Vector3f normal = pclFacet->GetNormal();
-        rstrOut.write((const char*)&(normal.x), sizeof(float));
-        rstrOut.write((const char*)&(normal.y), sizeof(float));
-        rstrOut.write((const char*)&(normal.z), sizeof(float));
+    std::vector<StlBinaryBlock> blocks(std::min(numThreads, numBlocks));
+    for (std::size_t i = 0; i < numBlocks; i += blocks.size()) {
+        std::size_t count = std::min(blocks.size(), numBlocks - i);
+        blocks.resize(count);
+        for (std::size_t j = 0; j < count; j++) {
+            blocks[j].points = &_rclMesh.GetPoints();
+            blocks[j].facets = &_rclMesh.GetFacets();
+            blocks[j].transform = apply_transform ? &_transform : 0;
+            blocks[j].begin = (i + j) * blockSize;
+            blocks[j].end = std::min(numFacets, (i + j + 1) * blockSize);
+        }
+        if (count > 1)
+            QtConcurrent::map(blocks, &StlBinaryBlock::Format).waitForFinished();
+        else
+            blocks[0].Format();
 
-        // vertices
-        for (i = 0; i < 3; i++) {
-            rstrOut.write((const char*)&(pclFacet->_aclPoints[i].x), sizeof(float));
-            rstrOut.write((const char*)&(pclFacet->_aclPoints[i].y), sizeof(float));
-            rstrOut.write((const char*)&(pclFacet->_aclPoints[i].z), sizeof(float));
+        for (std::size_t j = 0; j < count; j++) {
+            rstrOut.write(&blocks[j].buffer[0], blocks[j].buffer.size());
+            seq.next(true); // allow to cancel
         }
-
-        // attribute 
-        rstrOut.write((const char*)&usAtt, sizeof(usAtt));
-
-        ++clIter;
-        seq.next(true); // allow to cancel
     }
 
     return true;
@@ -25,9 +25,12 @@
 #include <algorithm>
 #endif
 
+#include <QtConcurrentMap>
+
 #include "Segmentation.h"
 #include "Algorithm.h"
 #include "Approximation.h"
+#include "TopoAlgorithm.h"
 
 using namespace MeshCore;
 
@@ -187,52 +190,171 @@ bool MeshSurfaceVisitor::Visit (const MeshFacet & face, const MeshFacet &,
 
 // --------------------------------------------------------
 
+namespace MeshCore {
+namespace {
+/**
+ * Tests the free facets of a block against a stateless segment in a thread of its own.
+ */
+struct SegmentTestRange
+{
+    const MeshFacetArray* facets;
+    const MeshSurfaceSegment* segm;
+    std::vector<char>* accepted;
+    unsigned long begin, end;
+
+    void Test()
+    {
+        const MeshFacetArray& rFacets = *facets;
+        for (unsigned long i = begin; i < end; i++) {
+            const MeshFacet& face = rFacets[i];
+            (*accepted)[i] = !face.IsFlag(MeshFacet::VISIT) && segm->TestFacet(face);
+        }
+    }
+};
+}
+}
+
 void MeshSegmentAlgorithm::FindSegments(std::vector<MeshSurfaceSegment*>& segm)
 {
     // reset VISIT flags
-    unsigned long startFacet;
     MeshCore::MeshAlgorithm cAlgo(myKernel);
     cAlgo.ResetFacetFlag(MeshCore::MeshFacet::VISIT);
+    std::vector<unsigned long> resetVisited;
+
+    for (std::vector<MeshSurfaceSegment*>::iterator it = segm.begin(); it != segm.end(); ++it) {
+        cAlgo.ResetFacetsFlag(resetVisited, MeshCore::MeshFacet::VISIT);
+        resetVisited.clear();
+
+        if ((*it)->IsStateless())
+            GrowSegments(**it, resetVisited);
+        else
+            VisitSegments(**it, resetVisited);
+    }
+}
 
+void MeshSegmentAlgorithm::VisitSegments(MeshSurfaceSegment& segm, std::vector<unsigned long>& resetVisited)
+{
+    unsigned long startFacet;
     const MeshCore::MeshFacetArray& rFAry = myKernel.GetFacets();
     MeshCore::MeshFacetArray::_TConstIterator iCur = rFAry.begin();
     MeshCore::MeshFacetArray::_TConstIterator iBeg = rFAry.begin();
     MeshCore::MeshFacetArray::_TConstIterator iEnd = rFAry.end();
 
     // start from the first not visited facet
-    cAlgo.CountFacetFlag(MeshCore::MeshFacet::VISIT);
-    std::vector<unsigned long> resetVisited;
-
-    for (std::vector<MeshSurfaceSegment*>::iterator it = segm.begin(); it != segm.end(); ++it) {
-        cAlgo.ResetFacetsFlag(resetVisited, MeshCore::MeshFacet::VISIT);
-        resetVisited.clear();
+    iCur = std::find_if(iBeg, iEnd, std::bind2nd(MeshCore::MeshIsNotFlag<MeshCore::MeshFacet>(),
+        MeshCore::MeshFacet::VISIT));
+    if (iCur < iEnd)
+        startFacet = iCur - iBeg;
+    else
+        startFacet = ULONG_MAX;
+    while (startFacet != ULONG_MAX) {
+        // collect all facets of the same geometry
+        std::vector<unsigned long> indices;
+        indices.push_back(startFacet);
+        segm.Initialize(startFacet);
+        MeshSurfaceVisitor pv(segm, indices);
+        myKernel.VisitNeighbourFacets(pv, startFacet);
+
+        // add or discard the segment
+        if (indices.size() == 1) {
+            resetVisited.push_back(startFacet);
+        }
+        else {
+            segm.AddSegment(indices);
+        }
 
-        iCur = std::find_if(iBeg, iEnd, std::bind2nd(MeshCore::MeshIsNotFlag<MeshCore::MeshFacet>(),
+        // search for the next start facet
+        iCur = std::find_if(iCur, iEnd, std::bind2nd(MeshCore::MeshIsNotFlag<MeshCore::MeshFacet>(),
             MeshCore::MeshFacet::VISIT));
-        startFacet = iCur - iBeg;
-        while (startFacet != ULONG_MAX) {
-            // collect all facets of the same geometry
-            std::vector<unsigned long> indices;
-            indices.push_back(startFacet);
-            (*it)->Initialize(startFacet);
-            MeshSurfaceVisitor pv(**it, indices);
-            myKernel.VisitNeighbourFacets(pv, startFacet);
-
-            // add or discard the segment
-            if (indices.size() == 1) {
-                resetVisited.push_back(startFacet);
-            }
-            else {
-                (*it)->AddSegment(indices);
+        if (iCur < iEnd)
+            startFacet = iCur - iBeg;
+        else
+            startFacet = ULONG_MAX;
+    }
+}
+
+void MeshSegmentAlgorithm::GrowSegments(MeshSurfaceSegment& segm, std::vector<unsigned long>& resetVisited)
+{
+    const MeshCore::MeshFacetArray& rFAry = myKernel.GetFacets();
+    unsigned long ulCtFacets = rFAry.size();
+
+    // test all facets that are not part of a segment yet in parallel
+    std::vector<char> accepted(ulCtFacets);
+    const unsigned long ulBlockSize = 4096;
+    unsigned long ulCtBlocks = (ulCtFacets + ulBlockSize - 1) / ulBlockSize;
+    std::vector<SegmentTestRange> ranges(ulCtBlocks);
+    for (unsigned long i = 0; i < ulCtBlocks; i++) {
+        SegmentTestRange& range = ranges[i];
+        range.facets = &rFAry;
+        range.segm = &segm;
+        range.accepted = &accepted;
+        range.begin = i * ulBlockSize;
+        range.end = std::min<unsigned long>((i + 1) * ulBlockSize, ulCtFacets);
+    }
+    QtConcurrent::map(ranges, &SegmentTestRange::Test).waitForFinished();
+
+    // The connected regions of accepted facets are labelled by their smallest facet index.
+    // Replace the labels by the numbers of the regions and list the facets region by region.
+    std::vector<unsigned long> label;
+    MeshComponents(myKernel).LabelComponents(MeshComponents::OverEdge, accepted, label);
+    std::vector<unsigned long> offset(1, 0);
+    for (unsigned long i = 0; i < ulCtFacets; i++) {
+        if (label[i] == ULONG_MAX)
+            continue;
+        if (label[i] == i) {
+            label[i] = offset.size() - 1;
+            offset.push_back(0);
+        }
+        else {
+            label[i] = label[label[i]];
+        }
+        offset[label[i] + 1]++;
+    }
+    for (std::size_t i = 1; i < offset.size(); i++)
+        offset[i] += offset[i - 1];
+    std::vector<unsigned long> regions(offset.back());
+    std::vector<unsigned long> next(offset.begin(), offset.end() - 1);
+    for (unsigned long i = 0; i < ulCtFacets; i++) {
+        if (accepted[i])
+            regions[next[label[i]]++] = i;
+    }
+
+    // Gives the same segments as VisitSegments(): the visitor starts at the free facet of lowest
+    // index and adds the accepted facets that are reachable over accepted facets. As the start
+    // facet itself isn't tested it is either the first facet of a region or, if rejected, joins
+    // the regions around it.
+    for (unsigned long i = 0; i < ulCtFacets; i++) {
+        if (rFAry[i].IsFlag(MeshCore::MeshFacet::VISIT))
+            continue;
+
+        std::vector<unsigned long> indices;
+        if (accepted[i]) {
+            indices.assign(regions.begin() + offset[label[i]], regions.begin() + offset[label[i] + 1]);
+        }
+        else {
+            indices.push_back(i);
+            for (int j = 0; j < 3; j++) {
+                unsigned long n = rFAry[i]._aulNeighbours[j];
+                if (n < ulCtFacets && accepted[n] && !rFAry[n].IsFlag(MeshCore::MeshFacet::VISIT)) {
+                    std::vector<unsigned long>::iterator first = regions.begin() + offset[label[n]];
+                    std::vector<unsigned long>::iterator last = regions.begin() + offset[label[n] + 1];
+                    for (std::vector<unsigned long>::iterator it = first; it != last; ++it)
+                        rFAry[*it].SetFlag(MeshCore::MeshFacet::VISIT);
+                    indices.insert(indices.end(), first, last);
+                }
             }
+            std::sort(indices.begin(), indices.end());
+        }
 
-            // search for the next start facet
-            iCur = std::find_if(iCur, iEnd, std::bind2nd(MeshCore::MeshIsNotFlag<MeshCore::MeshFacet>(),
-                MeshCore::MeshFacet::VISIT));
-            if (iCur < iEnd)
-                startFacet = iCur - iBeg;
-            else
-                startFacet = ULONG_MAX;
+        for (std::vector<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it)
+            rFAry[*it].SetFlag(MeshCore::MeshFacet::VISIT);
+
+        // add or discard the segment
+        if (indices.size() == 1) {
+            resetVisited.push_back(i);
+        }
+        else {
+            segm.AddSegment(indices);
         }
     }
 }
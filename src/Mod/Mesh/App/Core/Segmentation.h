@@ -44,6 +44,12 @@ public:
     virtual const char* GetType() const = 0;
     virtual void Initialize(unsigned long);
     virtual void AddFacet(const MeshFacet& rclFacet);
+    /**
+     * Returns true if TestFacet() only depends on the tested facet but not on the facets
+     * added to the segment so far. Such segments are grown in parallel, so TestFacet()
+     * must be safe to call from several threads.
+     */
+    virtual bool IsStateless() const { return false; }
     void AddSegment(const std::vector<unsigned long>&);
     const std::vector<MeshSegment>& GetSegments() const { return segments; }
     MeshSegment FindSegment(unsigned long) const;
@@ -89,6 +95,7 @@ class MeshExport MeshCurvatureSurfaceSegment : public MeshSurfaceSegment
 public:
     MeshCurvatureSurfaceSegment(const std::vector<CurvatureInfo>& ci, unsigned long minFacets)
         : MeshSurfaceSegment(minFacets), info(ci) {}
+    bool IsStateless() const { return true; }
 
 protected:
     const std::vector<CurvatureInfo>& info;
@@ -171,6 +178,10 @@ public:
     MeshSegmentAlgorithm(const MeshKernel& kernel) : myKernel(kernel) {}
     void FindSegments(std::vector<MeshSurfaceSegment*>&);
 
+private:
+    void VisitSegments(MeshSurfaceSegment&, std::vector<unsigned long>&);
+    void GrowSegments(MeshSurfaceSegment&, std::vector<unsigned long>&);
+
 private:
     const MeshKernel& myKernel;
 };
@@ -23,8 +23,11 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
 #endif
 
+#include <QtConcurrentMap>
+
 #include "Smoothing.h"
 #include "MeshKernel.h"
 #include "Algorithm.h"
@@ -65,7 +68,7 @@ void PlaneFitSmoothing::Smooth(unsigned int iterations)
     MeshCore::MeshPointArray PointArray = kernel.GetPoints();
 
     MeshCore::MeshPointIterator v_it(kernel);
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
+    MeshCore::MeshCompactPointToPoints vv_it(kernel);
     MeshCore::MeshPointArray::_TConstIterator v_beg = kernel.GetPoints().begin();
 
     for (unsigned int i=0; i<iterations; i++) {
@@ -74,11 +77,11 @@ void PlaneFitSmoothing::Smooth(unsigned int iterations)
             MeshCore::PlaneFit pf;
             pf.AddPoint(*v_it);
             center = *v_it;
-            const std::set<unsigned long>& cv = vv_it[v_it.Position()];
+            MeshIndexTable::Range cv = vv_it[v_it.Position()];
             if (cv.size() < 3)
                 continue;
 
-            std::set<unsigned long>::const_iterator cv_it;
+            MeshIndexTable::Range::const_iterator cv_it;
             for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
                 pf.AddPoint(v_beg[*cv_it]);
                 center += v_beg[*cv_it];
@@ -118,7 +121,7 @@ void PlaneFitSmoothing::SmoothPoints(unsigned int iterations, const std::vector<
     MeshCore::MeshPointArray PointArray = kernel.GetPoints();
 
     MeshCore::MeshPointIterator v_it(kernel);
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
+    MeshCore::MeshCompactPointToPoints vv_it(kernel);
     MeshCore::MeshPointArray::_TConstIterator v_beg = kernel.GetPoints().begin();
 
     for (unsigned int i=0; i<iterations; i++) {
@@ -128,11 +131,11 @@ void PlaneFitSmoothing::SmoothPoints(unsigned int iterations, const std::vector<
             MeshCore::PlaneFit pf;
             pf.AddPoint(*v_it);
             center = *v_it;
-            const std::set<unsigned long>& cv = vv_it[v_it.Position()];
+            MeshIndexTable::Range cv = vv_it[v_it.Position()];
             if (cv.size() < 3)
                 continue;
 
-            std::set<unsigned long>::const_iterator cv_it;
+            MeshIndexTable::Range::const_iterator cv_it;
             for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
                 pf.AddPoint(v_beg[*cv_it]);
                 center += v_beg[*cv_it];
@@ -166,104 +169,264 @@ void PlaneFitSmoothing::SmoothPoints(unsigned int iterations, const std::vector<
     }
 }
 
-LaplaceSmoothing::LaplaceSmoothing(MeshKernel& m)
-  : AbstractSmoothing(m), lambda(0.6307)
-{
-}
-
-LaplaceSmoothing::~LaplaceSmoothing()
+namespace MeshCore {
+namespace {
+/**
+ * The umbrella operator of the points to be smoothed. It keeps a copy of the coordinates in
+ * two sets of arrays, one per coordinate, which are read and written alternately. The
+ * neighbours of the points are stored in one flat array.
+ */
+class UmbrellaOperator
 {
-}
-
-void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it, double stepsize)
+public:
+    UmbrellaOperator(const MeshKernel& kernel, const std::vector<unsigned long>& indices,
+                     LaplaceSmoothing::Weighting weighting);
+
+    void Step(double stepsize);
+    void Apply(MeshKernel& kernel) const;
+
+private:
+    void Relax(unsigned long begin, unsigned long end);
+    void ComputeCotangents(unsigned long begin, unsigned long end);
+
+    struct Range
+    {
+        UmbrellaOperator* op;
+        unsigned long begin, end;
+        void Relax() { op->Relax(begin, end); }
+        void ComputeCotangents() { op->ComputeCotangents(begin, end); }
+    };
+    void MakeRanges(unsigned long count, std::vector<Range>& ranges);
+
+private:
+    const MeshFacetArray& facets;
+    bool cotangent;
+    double stepsize;
+    int src;
+    std::vector<float> x[2], y[2], z[2];
+    std::vector<unsigned long> points;
+    std::vector<unsigned long> offsets;
+    std::vector<unsigned long> neighbours;
+    std::vector<Range> pointRanges;
+
+    // For the cotangent weights the cotangents of the corners of the facets around the points
+    // and for each neighbour the positions of the two corners opposite to the edge
+    std::vector<unsigned long> usedFacets;
+    std::vector<double> cotangents;
+    std::vector<unsigned long> opposite;
+    std::vector<Range> facetRanges;
+};
+
+UmbrellaOperator::UmbrellaOperator(const MeshKernel& kernel, const std::vector<unsigned long>& indices,
+                                   LaplaceSmoothing::Weighting weighting)
+  : facets(kernel.GetFacets()), cotangent(weighting == LaplaceSmoothing::Cotangent)
+  , stepsize(0.0), src(0)
 {
-    const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_it,
-    v_beg = points.begin(), v_end = points.end();
+    const MeshPointArray& rPoints = kernel.GetPoints();
+    unsigned long count = rPoints.size();
+    for (int i=0; i<2; i++) {
+        x[i].resize(count);
+        y[i].resize(count);
+        z[i].resize(count);
+    }
+    for (unsigned long i = 0; i < count; i++) {
+        x[0][i] = x[1][i] = rPoints[i].x;
+        y[0][i] = y[1][i] = rPoints[i].y;
+        z[0][i] = z[1][i] = rPoints[i].z;
+    }
 
-    unsigned long pos = 0;
-    for (v_it = points.begin(); v_it != v_end; ++v_it,++pos) {
-        const std::set<unsigned long>& cv = vv_it[pos];
+    MeshCompactPointToPoints vv_it(kernel);
+    MeshCompactPointToFacets vf_it(kernel);
+    std::vector<unsigned long> facetPos;
+    if (cotangent)
+        facetPos.resize(facets.size(), ULONG_MAX);
+    offsets.push_back(0);
+    for (std::vector<unsigned long>::const_iterator it = indices.begin(); it != indices.end(); ++it) {
+        MeshIndexTable::Range cv = vv_it[*it];
+        MeshIndexTable::Range cf = vf_it[*it];
         if (cv.size() < 3)
             continue;
-        if (cv.size() != vf_it[pos].size()) {
+        if (cv.size() != cf.size()) {
             // do nothing for border points
             continue;
         }
 
-        unsigned int n_count = cv.size();
-        double w;
-        w=1.0/double(n_count);
-
-        double delx=0.0,dely=0.0,delz=0.0;
-        std::set<unsigned long>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-            delx += w*((v_beg[*cv_it]).x-v_it->x);
-            dely += w*((v_beg[*cv_it]).y-v_it->y);
-            delz += w*((v_beg[*cv_it]).z-v_it->z);
+        unsigned long first = neighbours.size();
+        points.push_back(*it);
+        neighbours.insert(neighbours.end(), cv.begin(), cv.end());
+        offsets.push_back(neighbours.size());
+        if (cotangent) {
+            opposite.resize(2 * neighbours.size(), ULONG_MAX);
+            for (MeshIndexTable::Range::const_iterator jt = cf.begin(); jt != cf.end(); ++jt) {
+                if (facetPos[*jt] == ULONG_MAX) {
+                    facetPos[*jt] = usedFacets.size();
+                    usedFacets.push_back(*jt);
+                }
+                const MeshFacet& face = facets[*jt];
+                int c = face._aulPoints[0] == *it ? 0 : (face._aulPoints[1] == *it ? 1 : 2);
+                for (int k=1; k<3; k++) {
+                    // the corner opposite to the edge to the k-th next point
+                    unsigned long slot = first + (cv.find(face._aulPoints[(c+k)%3]) - cv.begin());
+                    unsigned long cot = 3 * facetPos[*jt] + (c+3-k)%3;
+                    if (opposite[2*slot] == ULONG_MAX)
+                        opposite[2*slot] = cot;
+                    else
+                        opposite[2*slot+1] = cot;
+                }
+            }
         }
+    }
 
-        float x = (float)(v_it->x+stepsize*delx);
-        float y = (float)(v_it->y+stepsize*dely);
-        float z = (float)(v_it->z+stepsize*delz);
-        kernel.SetPoint(pos,x,y,z);
+    if (cotangent) {
+        // the last element of the cotangents is a zero for edges with only one facet
+        cotangents.resize(3 * usedFacets.size() + 1, 0.0);
+        for (std::vector<unsigned long>::iterator it = opposite.begin(); it != opposite.end(); ++it) {
+            if (*it == ULONG_MAX)
+                *it = 3 * usedFacets.size();
+        }
+        MakeRanges(usedFacets.size(), facetRanges);
     }
+
+    MakeRanges(points.size(), pointRanges);
 }
 
-void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it, double stepsize,
-                                const std::vector<unsigned long>& point_indices)
+void UmbrellaOperator::MakeRanges(unsigned long count, std::vector<Range>& ranges)
 {
-    const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_beg = points.begin();
+    const unsigned long blockSize = 4096;
+    for (unsigned long i = 0; i < count; i += blockSize) {
+        Range range;
+        range.op = this;
+        range.begin = i;
+        range.end = std::min<unsigned long>(i + blockSize, count);
+        ranges.push_back(range);
+    }
+}
 
-    for (std::vector<unsigned long>::const_iterator pos = point_indices.begin(); pos != point_indices.end(); ++pos) {
-        const std::set<unsigned long>& cv = vv_it[*pos];
-        if (cv.size() < 3)
-            continue;
-        if (cv.size() != vf_it[*pos].size()) {
-            // do nothing for border points
-            continue;
+void UmbrellaOperator::ComputeCotangents(unsigned long begin, unsigned long end)
+{
+    const std::vector<float>& px = x[src];
+    const std::vector<float>& py = y[src];
+    const std::vector<float>& pz = z[src];
+    for (unsigned long pos = begin; pos < end; pos++) {
+        const MeshFacet& face = facets[usedFacets[pos]];
+        Base::Vector3d p[3];
+        for (int c=0; c<3; c++) {
+            unsigned long i = face._aulPoints[c];
+            p[c].Set(px[i], py[i], pz[i]);
         }
 
-        unsigned int n_count = cv.size();
-        double w;
-        w=1.0/double(n_count);
+        // the cotangent of a corner is the dot product of its edges divided by the length of
+        // their cross product which is twice the area for all corners
+        double area2 = ((p[1] - p[0]) % (p[2] - p[0])).Length();
+        for (int c=0; c<3; c++) {
+            double dot = (p[(c+1)%3] - p[c]) * (p[(c+2)%3] - p[c]);
+            cotangents[3*pos+c] = area2 > 0.0 ? dot / area2 : 0.0;
+        }
+    }
+}
 
+void UmbrellaOperator::Relax(unsigned long begin, unsigned long end)
+{
+    const float* sx = &x[src][0];
+    const float* sy = &y[src][0];
+    const float* sz = &z[src][0];
+    float* dx = &x[1-src][0];
+    float* dy = &y[1-src][0];
+    float* dz = &z[1-src][0];
+
+    for (unsigned long pos = begin; pos < end; pos++) {
+        unsigned long i = points[pos];
         double delx=0.0,dely=0.0,delz=0.0;
-        std::set<unsigned long>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-            delx += w*((v_beg[*cv_it]).x-(v_beg[*pos]).x);
-            dely += w*((v_beg[*cv_it]).y-(v_beg[*pos]).y);
-            delz += w*((v_beg[*cv_it]).z-(v_beg[*pos]).z);
+        double sum = 0.0;
+        if (cotangent) {
+            // The weight of the edge (i,j) is the sum of the cotangents of both angles
+            // opposite to it. Negative weights of obtuse angles are clamped to zero.
+            for (unsigned long k = offsets[pos]; k < offsets[pos+1]; k++) {
+                unsigned long j = neighbours[k];
+                double w = std::max<double>(0.0, cotangents[opposite[2*k]] + cotangents[opposite[2*k+1]]);
+                delx += w*(sx[j]-sx[i]);
+                dely += w*(sy[j]-sy[i]);
+                delz += w*(sz[j]-sz[i]);
+                sum += w;
+            }
+            if (sum > 0.0) {
+                delx /= sum;
+                dely /= sum;
+                delz /= sum;
+            }
+        }
+        if (sum <= 0.0) {
+            // uniform weights, also if all cotangent weights are zero
+            double w = 1.0/double(offsets[pos+1] - offsets[pos]);
+            for (unsigned long k = offsets[pos]; k < offsets[pos+1]; k++) {
+                unsigned long j = neighbours[k];
+                delx += w*(sx[j]-sx[i]);
+                dely += w*(sy[j]-sy[i]);
+                delz += w*(sz[j]-sz[i]);
+            }
         }
 
-        float x = (float)((v_beg[*pos]).x+stepsize*delx);
-        float y = (float)((v_beg[*pos]).y+stepsize*dely);
-        float z = (float)((v_beg[*pos]).z+stepsize*delz);
-        kernel.SetPoint(*pos,x,y,z);
+        dx[i] = (float)(sx[i]+stepsize*delx);
+        dy[i] = (float)(sy[i]+stepsize*dely);
+        dz[i] = (float)(sz[i]+stepsize*delz);
     }
 }
 
-void LaplaceSmoothing::Smooth(unsigned int iterations)
+void UmbrellaOperator::Step(double step)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    // Every point is only written to its own slot of the destination arrays and the points
+    // that are not smoothed have the same coordinates in both sets of arrays.
+    stepsize = step;
+    if (cotangent)
+        QtConcurrent::map(facetRanges, &Range::ComputeCotangents).waitForFinished();
+    QtConcurrent::map(pointRanges, &Range::Relax).waitForFinished();
+    src = 1 - src;
+}
 
-    for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda);
-    }
+void UmbrellaOperator::Apply(MeshKernel& kernel) const
+{
+    for (std::vector<unsigned long>::const_iterator it = points.begin(); it != points.end(); ++it)
+        kernel.SetPoint(*it, x[src][*it], y[src][*it], z[src][*it]);
+}
+}
 }
 
-void LaplaceSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
+LaplaceSmoothing::LaplaceSmoothing(MeshKernel& m)
+  : AbstractSmoothing(m), lambda(0.6307), weighting(Uniform)
+{
+}
+
+LaplaceSmoothing::~LaplaceSmoothing()
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+}
 
+void LaplaceSmoothing::Umbrella(unsigned int iterations, const std::vector<double>& stepsizes)
+{
+    std::vector<unsigned long> point_indices(kernel.CountPoints());
+    for (unsigned long i = 0; i < point_indices.size(); i++)
+        point_indices[i] = i;
+    Umbrella(iterations, stepsizes, point_indices);
+}
+
+void LaplaceSmoothing::Umbrella(unsigned int iterations, const std::vector<double>& stepsizes,
+                                const std::vector<unsigned long>& point_indices)
+{
+    UmbrellaOperator op(kernel, point_indices, weighting);
     for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda, point_indices);
+        for (std::vector<double>::const_iterator it = stepsizes.begin(); it != stepsizes.end(); ++it)
+            op.Step(*it);
     }
+    op.Apply(kernel);
+}
+
+void LaplaceSmoothing::Smooth(unsigned int iterations)
+{
+    Umbrella(iterations, std::vector<double>(1, lambda));
+}
+
+void LaplaceSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
+{
+    Umbrella(iterations, std::vector<double>(1, lambda), point_indices);
 }
 
 TaubinSmoothing::TaubinSmoothing(MeshKernel& m)
@@ -277,28 +440,22 @@ TaubinSmoothing::~TaubinSmoothing()
 
 void TaubinSmoothing::Smooth(unsigned int iterations)
 {
-    MeshCore::MeshPointArray::_TConstIterator v_it;
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    std::vector<double> stepsizes;
+    stepsizes.push_back(lambda);
+    stepsizes.push_back(-(lambda+micro));
 
     // Theoretically Taubin does not shrink the surface
     iterations = (iterations+1)/2; // two steps per iteration
-    for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda);
-        Umbrella(vv_it, vf_it, -(lambda+micro));
-    }
+    Umbrella(iterations, stepsizes);
 }
 
 void TaubinSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
 {
-    MeshCore::MeshPointArray::_TConstIterator v_it;
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    std::vector<double> stepsizes;
+    stepsizes.push_back(lambda);
+    stepsizes.push_back(-(lambda+micro));
 
     // Theoretically Taubin does not shrink the surface
     iterations = (iterations+1)/2; // two steps per iteration
-    for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda, point_indices);
-        Umbrella(vv_it, vf_it, -(lambda+micro), point_indices);
-    }
+    Umbrella(iterations, stepsizes, point_indices);
 }
@@ -29,8 +29,6 @@
 namespace MeshCore
 {
 class MeshKernel;
-class MeshRefPointToPoints;
-class MeshRefPointToFacets;
 
 /** Base class for smoothing algorithms. */
 class MeshExport AbstractSmoothing
@@ -73,24 +71,35 @@ public:
     void SmoothPoints(unsigned int, const std::vector<unsigned long>&);
 };
 
+/**
+ * Moves each inner point towards the weighted mean of its neighbours. All points of an
+ * iteration are computed from the positions of the previous iteration (Jacobi iteration),
+ * so the result doesn't depend on the order of the points and they are processed in parallel.
+ */
 class MeshExport LaplaceSmoothing : public AbstractSmoothing
 {
 public:
+    enum Weighting {
+        Uniform,            ///< All neighbours have the same weight
+        Cotangent           ///< Neighbours are weighted by the cotangents of the opposite angles
+    };
+
     LaplaceSmoothing(MeshKernel&);
     virtual ~LaplaceSmoothing();
     void Smooth(unsigned int);
     void SmoothPoints(unsigned int, const std::vector<unsigned long>&);
     void SetLambda(double l) { lambda = l;}
+    void SetWeighting(Weighting w) { weighting = w;}
 
 protected:
-    void Umbrella(const MeshRefPointToPoints&,
-                  const MeshRefPointToFacets&, double);
-    void Umbrella(const MeshRefPointToPoints&,
-                  const MeshRefPointToFacets&, double,
+    /** Applies the given step sizes one after another as often as given by the first argument. */
+    void Umbrella(unsigned int, const std::vector<double>&);
+    void Umbrella(unsigned int, const std::vector<double>&,
                   const std::vector<unsigned long>&);
 
 protected:
     double lambda;
+    Weighting weighting;
 };
 
 class MeshExport TaubinSmoothing : public LaplaceSmoothing
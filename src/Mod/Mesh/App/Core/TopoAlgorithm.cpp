@@ -29,6 +29,9 @@
 # include <queue>
 #endif
 
+#include <QAtomicInt>
+#include <QtConcurrentMap>
+
 #include <Mod/Mesh/App/WildMagic4/Wm4MeshCurvature.h>
 #include <Mod/Mesh/App/WildMagic4/Wm4Vector3.h>
 
@@ -1433,58 +1436,235 @@ void MeshComponents::SearchForComponents(TMode tMode, std::vector<std::vector<un
   SearchForComponents( tMode, aulAllFacets, aclT );
 }
 
-void MeshComponents::SearchForComponents(TMode tMode, const std::vector<unsigned long>& aSegment, std::vector<std::vector<unsigned long> >& aclT) const
+namespace MeshCore {
+namespace {
+
+/**
+ * Disjoint sets whose root is always the smallest element of a set, i.e. a root is only
+ * linked to a root of lower index. Hence the links never form a cycle and several threads
+ * can merge sets at the same time by replacing a root with compare-and-swap.
+ */
+class ComponentSets
 {
-  unsigned long ulStartFacet, ulVisited;
+public:
+  ComponentSets(unsigned long ulSize) : _parent(ulSize)
+  {
+    for (unsigned long i = 0; i < ulSize; i++)
+      _parent[i] = static_cast<int>(i);
+  }
 
-  if (_rclMesh.CountFacets() == 0)
-    return;
+  int Find(int i)
+  {
+    for (;;) {
+      int p = _parent[i];
+      if (p == i)
+        return i;
+      // path halving, the grandparent is still an element of the same set
+      int g = _parent[p];
+      if (g != p)
+        _parent[i].testAndSetRelaxed(p, g);
+      i = g;
+    }
+  }
 
-  // reset VISIT flags
-  MeshAlgorithm cAlgo(_rclMesh);
-  cAlgo.SetFacetFlag(MeshFacet::VISIT);
-  cAlgo.ResetFacetsFlag(aSegment, MeshFacet::VISIT);
-  
-  const MeshFacetArray& rFAry = _rclMesh.GetFacets();
-  MeshFacetArray::_TConstIterator iTri = rFAry.begin();
-  MeshFacetArray::_TConstIterator iBeg = rFAry.begin();
-  MeshFacetArray::_TConstIterator iEnd = rFAry.end();
+  void Unite(int a, int b)
+  {
+    for (;;) {
+      a = Find(a);
+      b = Find(b);
+      if (a == b)
+        return;
+      if (a > b)
+        std::swap(a, b);
+      // fails if another thread has linked b in the meantime
+      if (_parent[b].testAndSetOrdered(b, a))
+        return;
+    }
+  }
 
-  // start from the first not visited facet
-  ulVisited = cAlgo.CountFacetFlag(MeshFacet::VISIT);
-  iTri = std::find_if(iTri, iEnd, std::bind2nd(MeshIsNotFlag<MeshFacet>(), MeshFacet::VISIT));
-  ulStartFacet = iTri - iBeg;
+private:
+  std::vector<QAtomicInt> _parent;
+};
 
-  // visitor
-  std::vector<unsigned long> aclComponent;
-  std::vector<std::vector<unsigned long> > aclConnectComp;
-  MeshTopFacetVisitor clFVisitor( aclComponent );
+// orders pairs of size and number of components like CNofFacetsCompare
+struct CNofFacetsOrder
+{
+  bool operator () (const std::pair<unsigned long, unsigned long>& rclC1,
+                    const std::pair<unsigned long, unsigned long>& rclC2) const
+  {
+    if (rclC1.first != rclC2.first)
+      return rclC1.first > rclC2.first;
+    return rclC1.second < rclC2.second;
+  }
+};
 
-  while ( ulStartFacet !=  ULONG_MAX )
+/**
+ * A block of facets that is connected in a thread of its own. Links to facets of other
+ * blocks are kept until all blocks are done and then merged into the common sets.
+ */
+struct ComponentRange
+{
+  const MeshFacetArray* facets;
+  const std::vector<char>* mask;
+  ComponentSets* sets;
+  std::vector<unsigned long>* label;
+  MeshComponents::TMode mode;
+  unsigned long begin, end;
+  std::vector<std::pair<unsigned long, unsigned long> > border;
+
+  void Grow()
   {
-    // collect all facets of a component
-    aclComponent.clear();
-    if (tMode == OverEdge)
-      ulVisited += _rclMesh.VisitNeighbourFacets(clFVisitor, ulStartFacet);
-    else if (tMode == OverPoint)
-      ulVisited += _rclMesh.VisitNeighbourFacetsOverCorners(clFVisitor, ulStartFacet);
-
-    // get also start facet
-    aclComponent.push_back(ulStartFacet);
-    aclConnectComp.push_back(aclComponent);
-
-    // if the mesh consists of several topologic independent components
-    // We can search from position 'iTri' on because all elements _before_ are already visited
-    // what we know from the previous iteration.
-    iTri = std::find_if(iTri, iEnd, std::bind2nd(MeshIsNotFlag<MeshFacet>(), MeshFacet::VISIT));
-
-    if (iTri < iEnd)
-      ulStartFacet = iTri - iBeg;
+    if (mode == MeshComponents::OverEdge)
+      GrowOverEdge();
     else
-      ulStartFacet = ULONG_MAX;
+      GrowOverPoint();
+  }
+
+  void GrowOverEdge()
+  {
+    const MeshFacetArray& rFacets = *facets;
+    const std::vector<char>& rMask = *mask;
+    unsigned long ulCount = rFacets.size();
+    for (unsigned long i = begin; i < end; i++) {
+      if (!rMask[i])
+        continue;
+      for (int j = 0; j < 3; j++) {
+        unsigned long n = rFacets[i]._aulNeighbours[j];
+        if (n >= ulCount || !rMask[n])
+          continue;
+        if (n >= begin && n < end)
+          sets->Unite(i, n);
+        else
+          border.push_back(std::make_pair(i, n));
+      }
+    }
+  }
+
+  void GrowOverPoint()
+  {
+    // the points follow the facets in the sets, a facet is linked with the point over
+    // the first facet of the block that uses it
+    const MeshFacetArray& rFacets = *facets;
+    const std::vector<char>& rMask = *mask;
+    unsigned long ulCount = rFacets.size();
+    std::vector<std::pair<unsigned long, unsigned long> > corners;
+    corners.reserve(3 * (end - begin));
+    for (unsigned long i = begin; i < end; i++) {
+      if (!rMask[i])
+        continue;
+      for (int j = 0; j < 3; j++)
+        corners.push_back(std::make_pair(rFacets[i]._aulPoints[j], i));
+    }
+
+    std::sort(corners.begin(), corners.end());
+    unsigned long ulFirst = 0;
+    for (std::vector<std::pair<unsigned long, unsigned long> >::iterator it = corners.begin(); it != corners.end(); ++it) {
+      if (it == corners.begin() || it->first != (it - 1)->first) {
+        ulFirst = it->second;
+        border.push_back(std::make_pair(ulFirst, ulCount + it->first));
+      }
+      else {
+        sets->Unite(ulFirst, it->second);
+      }
+    }
+  }
+
+  void Merge()
+  {
+    for (std::vector<std::pair<unsigned long, unsigned long> >::iterator it = border.begin(); it != border.end(); ++it)
+      sets->Unite(it->first, it->second);
+  }
+
+  void Label()
+  {
+    const std::vector<char>& rMask = *mask;
+    for (unsigned long i = begin; i < end; i++)
+      (*label)[i] = rMask[i] ? sets->Find(i) : ULONG_MAX;
+  }
+};
+}
+}
+
+void MeshComponents::SearchForComponents(TMode tMode, const std::vector<unsigned long>& aSegment, std::vector<std::vector<unsigned long> >& aclT) const
+{
+  unsigned long ulCtFacets = _rclMesh.CountFacets();
+  if (ulCtFacets == 0)
+    return;
+
+  std::vector<char> aMask(ulCtFacets, 0);
+  for (std::vector<unsigned long>::const_iterator it = aSegment.begin(); it != aSegment.end(); ++it) {
+    if (*it < ulCtFacets)
+      aMask[*it] = 1;
+  }
+
+  std::vector<unsigned long> aLabel;
+  LabelComponents(tMode, aMask, aLabel);
+
+  // The label of a facet is the smallest index of its component, so going through the facets
+  // in ascending order meets the labelling facet of a component before all others. There the
+  // label is replaced by the number of the component.
+  std::vector<std::pair<unsigned long, unsigned long> > aclSizes;
+  for (unsigned long i = 0; i < ulCtFacets; i++) {
+    unsigned long ulLabel = aLabel[i];
+    if (ulLabel == ULONG_MAX)
+      continue;
+    if (ulLabel == i) {
+      aLabel[i] = aclSizes.size();
+      aclSizes.push_back(std::make_pair(0, aclSizes.size()));
+    }
+    else {
+      aLabel[i] = aLabel[ulLabel];
+    }
+    aclSizes[aLabel[i]].first++;
+  }
+
+  // sort components by size (descending order), keep the order of components of equal size
+  std::sort(aclSizes.begin(), aclSizes.end(), CNofFacetsOrder());
+  std::vector<unsigned long> aulPosition(aclSizes.size());
+  std::vector<std::vector<unsigned long> > aclConnectComp(aclSizes.size());
+  for (unsigned long i = 0; i < aclSizes.size(); i++) {
+    aulPosition[aclSizes[i].second] = i;
+    aclConnectComp[i].reserve(aclSizes[i].first);
+  }
+  for (unsigned long i = 0; i < ulCtFacets; i++) {
+    if (aMask[i])
+      aclConnectComp[aulPosition[aLabel[i]]].push_back(i);
+  }
+
+  aclT.swap(aclConnectComp);
+}
+
+void MeshComponents::LabelComponents(TMode tMode, const std::vector<char>& aMask,
+                                     std::vector<unsigned long>& aLabel) const
+{
+  const MeshFacetArray& rFAry = _rclMesh.GetFacets();
+  unsigned long ulCtFacets = rFAry.size();
+  aLabel.resize(ulCtFacets);
+
+  // connecting over points needs the points as additional elements
+  unsigned long ulCtElements = ulCtFacets;
+  if (tMode == OverPoint)
+    ulCtElements += _rclMesh.CountPoints();
+  ComponentSets sets(ulCtElements);
+
+  // First each block connects its own facets, then the links across the blocks are merged.
+  // As each set is labelled by its smallest element the result doesn't depend on the order
+  // the threads merged the sets.
+  const unsigned long ulBlockSize = 4096;
+  unsigned long ulCtBlocks = (ulCtFacets + ulBlockSize - 1) / ulBlockSize;
+  std::vector<ComponentRange> ranges(ulCtBlocks);
+  for (unsigned long i = 0; i < ulCtBlocks; i++) {
+    ComponentRange& range = ranges[i];
+    range.facets = &rFAry;
+    range.mask = &aMask;
+    range.sets = &sets;
+    range.label = &aLabel;
+    range.mode = tMode;
+    range.begin = i * ulBlockSize;
+    range.end = std::min<unsigned long>((i + 1) * ulBlockSize, ulCtFacets);
   }
 
-  // sort components by size (descending order)
-  std::sort(aclConnectComp.begin(), aclConnectComp.end(), CNofFacetsCompare());  
-  aclT = aclConnectComp;
+  QtConcurrent::map(ranges, &ComponentRange::Grow).waitForFinished();
+  QtConcurrent::map(ranges, &ComponentRange::Merge).waitForFinished();
+  QtConcurrent::map(ranges, &ComponentRange::Label).waitForFinished();
 }
@@ -307,6 +307,10 @@ private:
  * The MeshComponents class searches for topologic independent segments of the 
  * given mesh structure. 
  *
+ * The facets are split into blocks of consecutive indices which are connected
+ * in parallel. Afterwards the links between facets of different blocks are merged
+ * into the disjoint sets of all threads without locking.
+ *
  * @author Werner Mayer
  */
 class MeshExport MeshComponents
@@ -321,6 +325,8 @@ public:
      * Searches for 'isles' of the mesh. If \a tMode is \a OverEdge then facets
      * sharing the same edge are regarded as connected, if \a tMode is \a OverPoint
      * then facets sharing a common point are regarded as connected.
+     * The components are sorted by their size in descending order and the facets
+     * of a component by their index.
      */ 
     void SearchForComponents(TMode tMode, std::vector<std::vector<unsigned long> >& aclT) const;
 
@@ -331,6 +337,14 @@ public:
     void SearchForComponents(TMode tMode, const std::vector<unsigned long>& aSegment,
                              std::vector<std::vector<unsigned long> >& aclT) const;
 
+    /**
+     * Labels the components that consist of the facets whose entry in \a aMask is set.
+     * Afterwards \a aLabel holds for each of these facets the smallest facet index of
+     * its component and ULONG_MAX for all other facets.
+     */
+    void LabelComponents(TMode tMode, const std::vector<char>& aMask,
+                         std::vector<unsigned long>& aLabel) const;
+
 protected:
     // for sorting of elements
     struct CNofFacetsCompare : public std::binary_function<const std::vector<unsigned long>&, 
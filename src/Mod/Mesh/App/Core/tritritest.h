@@ -582,6 +582,7 @@ int tri_tri_intersect_with_isectline(float V0[3],float V1[3],float V2[3],
   float vp0,vp1,vp2;
   float up0,up1,up2;
   float b,c,max;
+  float eps;
   int smallest1,smallest2;
 
   /* compute plane equation of triangle(V0,V1,V2) */
@@ -598,9 +599,12 @@ int tri_tri_intersect_with_isectline(float V0[3],float V1[3],float V2[3],
 
   /* coplanarity robustness check */
 #if USE_EPSILON_TEST==TRUE
-  if(fabs(du0)<EPSILON) du0=0.0;
-  if(fabs(du1)<EPSILON) du1=0.0;
-  if(fabs(du2)<EPSILON) du2=0.0;
+  /* the distances are scaled by the length of N1 and so is the tolerance, */
+  /* otherwise small triangles are always considered as coplanar */
+  eps=EPSILON*(float)sqrt(DOT(N1,N1));
+  if(fabs(du0)<eps) du0=0.0;
+  if(fabs(du1)<eps) du1=0.0;
+  if(fabs(du2)<eps) du2=0.0;
 #endif
   du0du1=du0*du1;
   du0du2=du0*du2;
@@ -621,9 +625,10 @@ int tri_tri_intersect_with_isectline(float V0[3],float V1[3],float V2[3],
   dv2=DOT(N2,V2)+d2;
 
 #if USE_EPSILON_TEST==TRUE
-  if(fabs(dv0)<EPSILON) dv0=0.0;
-  if(fabs(dv1)<EPSILON) dv1=0.0;
-  if(fabs(dv2)<EPSILON) dv2=0.0;
+  eps=EPSILON*(float)sqrt(DOT(N2,N2));
+  if(fabs(dv0)<eps) dv0=0.0;
+  if(fabs(dv1)<eps) dv1=0.0;
+  if(fabs(dv2)<eps) dv2=0.0;
 #endif
 
   dv0dv1=dv0*dv1;
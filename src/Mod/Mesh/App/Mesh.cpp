@@ -38,6 +38,7 @@
 #include <Base/ViewProj.h>
 
 #include "Core/Builder.h"
+#include "Core/Decimation.h"
 #include "Core/MeshKernel.h"
 #include "Core/Grid.h"
 #include "Core/Iterator.h"
@@ -979,6 +980,28 @@ void MeshObject::optimizeEdges()
     topalg.AdjustEdgesToCurvatureDirection();
 }
 
+void MeshObject::decimate(float fTolerance, float fReduction, bool parallel)
+{
+    MeshCore::MeshSimplify dm(_kernel);
+    dm.SetParallel(parallel);
+    dm.Simplify(fTolerance, fReduction);
+
+    // clear the segments because we don't know how the new
+    // topology looks like
+    this->_segments.clear();
+}
+
+void MeshObject::decimate(unsigned long targetSize, bool parallel)
+{
+    MeshCore::MeshSimplify dm(_kernel);
+    dm.SetParallel(parallel);
+    dm.Simplify(targetSize);
+
+    // clear the segments because we don't know how the new
+    // topology looks like
+    this->_segments.clear();
+}
+
 void MeshObject::splitEdges()
 {
     std::vector<std::pair<unsigned long, unsigned long> > adjacentFacet;
@@ -239,6 +239,8 @@ public:
     void refine();
     void optimizeTopology(float);
     void optimizeEdges();
+    void decimate(float fTolerance, float fReduction, bool parallel = false);
+    void decimate(unsigned long targetSize, bool parallel = false);
     void splitEdges();
     void splitEdge(unsigned long, unsigned long, const Base::Vector3f&);
     void splitFacet(unsigned long, const Base::Vector3f&, const Base::Vector3f&);
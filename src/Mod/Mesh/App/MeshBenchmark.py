@@ -0,0 +1,111 @@
+#***************************************************************************
+#*   (c) agent (agent[at]local) 2026                                       *
+#*                                                                         *
+#*   This file is part of the FreeCAD CAx development system.              *
+#*                                                                         *
+#*   This program is free software; you can redistribute it and/or modify  *
+#*   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#*   as published by the Free Software Foundation; either version 2 of     *
+#*   the License, or (at your option) any later version.                   *
+#*   for detail see the LICENCE text file.                                 *
+#*                                                                         *
+#*   FreeCAD is distributed in the hope that it will be useful,            *
+#*   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#*   GNU Library General Public License for more details.                  *
+#*                                                                         *
+#*   You should have received a copy of the GNU Library General Public     *
+#*   License along with FreeCAD; if not, write to the Free Software        *
+#*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#*   USA                                                                   *
+#*                                                                         *
+#***************************************************************************
+
+# Measures the time to read and write large meshes and of the queries on a
+# fine mesh that use a facet grid.
+#
+# Usage:
+#   import MeshBenchmark
+#   MeshBenchmark.run()
+
+import FreeCAD, Mesh, os, tempfile, time, math
+
+def tempName(ext):
+	return tempfile.gettempdir() + os.sep + "mesh_benchmark" + ext
+
+def loadFile(mesh, ext, format):
+	# returns the time to load the mesh from a file written in the given format
+	name = tempName(ext)
+	mesh.write(name, format)
+	try:
+		start = time.time()
+		other = Mesh.Mesh(name)
+		seconds = time.time() - start
+	finally:
+		os.remove(name)
+	return seconds, other.CountFacets == mesh.CountFacets
+
+def loadAsciiSTL(mesh):
+	return loadFile(mesh, ".stl", "AST")
+
+def loadOBJ(mesh):
+	return loadFile(mesh, ".obj", "OBJ")
+
+def loadOFF(mesh):
+	return loadFile(mesh, ".off", "OFF")
+
+def binarySTL(mesh):
+	# a round trip of writing and reading a binary STL file
+	name = tempName(".stl")
+	try:
+		start = time.time()
+		mesh.write(name, "STL")
+		other = Mesh.Mesh(name)
+		seconds = time.time() - start
+	finally:
+		os.remove(name)
+	ok = other.CountFacets == mesh.CountFacets and abs(other.Area - mesh.Area) < 1e-3 * mesh.Area
+	return seconds, ok
+
+def crossSections(mesh):
+	# the sphere has got the radius 10
+	planes = []
+	for i in range(-9,10):
+		planes.append(((0.0,0.0,float(i)),(0.0,0.0,1.0)))
+	start = time.time()
+	sections = mesh.crossSections(planes)
+	seconds = time.time() - start
+	ok = len(sections) == len(planes)
+	for section in sections:
+		ok = ok and len(section) > 0
+	return seconds, ok
+
+def nearestFacetsOnRays(mesh):
+	# rays from outside to the center of the sphere
+	rays = []
+	for i in range(1000):
+		a = i * 0.3
+		base = FreeCAD.Vector(20.0*math.cos(a), 20.0*math.sin(a), (i % 19) - 9.0)
+		rays.append((base, base.negative()))
+	start = time.time()
+	hits = mesh.nearestFacetsOnRays(rays)
+	seconds = time.time() - start
+	ok = len(hits) == len(rays)
+	for hit in hits:
+		ok = ok and len(hit) == 1
+	return seconds, ok
+
+# the count is the sampling of the sphere the benchmark runs on
+Benchmarks = [("ASCII STL load", loadAsciiSTL, 400),
+              ("OBJ load", loadOBJ, 400),
+              ("OFF load", loadOFF, 400),
+              ("binary STL", binarySTL, 800),
+              ("cross-sections", crossSections, 200),
+              ("nearest facets", nearestFacetsOnRays, 200)]
+
+def run():
+	print "%-20s %8s %10s %6s" % ("benchmark", "facets", "time", "ok")
+	for name, benchmark, count in Benchmarks:
+		mesh = Mesh.createSphere(10.0, count)
+		seconds, ok = benchmark(mesh)
+		print "%-20s %8d %9.3fs %6s" % (name, mesh.CountFacets, seconds, ok)
@@ -35,6 +35,7 @@
 #include "MeshPy.cpp"
 #include "MeshProperties.h"
 #include "Core/Algorithm.h"
+#include "Core/Bvh.h"
 #include "Core/Triangulation.h"
 #include "Core/Iterator.h"
 #include "Core/Degeneration.h"
@@ -43,6 +44,7 @@
 #include "Core/MeshKernel.h"
 #include "Core/Segmentation.h"
 #include "Core/Curvature.h"
+#include "Core/Smoothing.h"
 
 using namespace Mesh;
 
@@ -388,6 +390,39 @@ PyObject*  MeshPy::coarsen(PyObject *args)
     return 0;
 }
 
+PyObject*  MeshPy::decimate(PyObject *args)
+{
+    unsigned long targetSize;
+    PyObject *parallel = Py_False;
+    if (PyArg_ParseTuple(args, "k|O!", &targetSize, &PyBool_Type, &parallel)) {
+        PY_TRY {
+            MeshPropertyLock lock(this->parentProperty);
+            getMeshObjectPtr()->decimate(targetSize, PyObject_IsTrue(parallel) ? true : false);
+        } PY_CATCH;
+
+        Py_Return;
+    }
+
+    PyErr_Clear();
+    float fTolerance, fReduction;
+    if (PyArg_ParseTuple(args, "ff|O!", &fTolerance, &fReduction, &PyBool_Type, &parallel)) {
+        if (fReduction < 0.0f || fReduction > 1.0f) {
+            PyErr_SetString(PyExc_ValueError, "Reduction must be in the range [0,1]");
+            return NULL;
+        }
+
+        PY_TRY {
+            MeshPropertyLock lock(this->parentProperty);
+            getMeshObjectPtr()->decimate(fTolerance, fReduction, PyObject_IsTrue(parallel) ? true : false);
+        } PY_CATCH;
+
+        Py_Return;
+    }
+
+    PyErr_SetString(PyExc_TypeError, "decimate(tolerance, reduction, [parallel]) or decimate(targetSize, [parallel]) expected");
+    return NULL;
+}
+
 PyObject*  MeshPy::translate(PyObject *args)
 {
     float x,y,z;
@@ -1363,6 +1398,70 @@ PyObject*  MeshPy::smooth(PyObject *args)
     Py_Return; 
 }
 
+// Smooths all points of the mesh or only the points of the given list
+static void smoothPoints(MeshCore::LaplaceSmoothing& smoother, const MeshCore::MeshKernel& kernel,
+                         int iter, PyObject* cotangent, PyObject* points)
+{
+    smoother.SetWeighting(PyObject_IsTrue(cotangent) ? MeshCore::LaplaceSmoothing::Cotangent
+                                                     : MeshCore::LaplaceSmoothing::Uniform);
+    if (!points) {
+        smoother.Smooth(iter);
+        return;
+    }
+
+    std::vector<unsigned long> indices;
+    Py::List list(points);
+    for (Py::List::iterator it = list.begin(); it != list.end(); ++it) {
+        unsigned long index = (unsigned long)(long)Py::Int(*it);
+        if (index >= kernel.CountPoints())
+            throw Base::Exception("Point index out of range");
+        indices.push_back(index);
+    }
+    smoother.SmoothPoints(iter, indices);
+}
+
+PyObject*  MeshPy::laplaceSmooth(PyObject *args)
+{
+    int iter;
+    double lambda = 0.6307;
+    PyObject *cotangent = Py_False;
+    PyObject *points = 0;
+    if (!PyArg_ParseTuple(args, "i|dO!O!", &iter, &lambda, &PyBool_Type, &cotangent, &PyList_Type, &points))
+        return NULL;
+
+    PY_TRY {
+        MeshPropertyLock lock(this->parentProperty);
+        MeshCore::MeshKernel& kernel = getMeshObjectPtr()->getKernel();
+        MeshCore::LaplaceSmoothing smoother(kernel);
+        smoother.SetLambda(lambda);
+        smoothPoints(smoother, kernel, iter, cotangent, points);
+    } PY_CATCH;
+
+    Py_Return;
+}
+
+PyObject*  MeshPy::taubinSmooth(PyObject *args)
+{
+    int iter;
+    double lambda = 0.6307;
+    double micro = 0.0424;
+    PyObject *cotangent = Py_False;
+    PyObject *points = 0;
+    if (!PyArg_ParseTuple(args, "i|ddO!O!", &iter, &lambda, &micro, &PyBool_Type, &cotangent, &PyList_Type, &points))
+        return NULL;
+
+    PY_TRY {
+        MeshPropertyLock lock(this->parentProperty);
+        MeshCore::MeshKernel& kernel = getMeshObjectPtr()->getKernel();
+        MeshCore::TaubinSmoothing smoother(kernel);
+        smoother.SetLambda(lambda);
+        smoother.SetMicro(micro);
+        smoothPoints(smoother, kernel, iter, cotangent, points);
+    } PY_CATCH;
+
+    Py_Return;
+}
+
 PyObject* MeshPy::nearestFacetOnRay(PyObject *args)
 {
     PyObject* pnt_p;
@@ -1426,6 +1525,80 @@ PyObject* MeshPy::nearestFacetOnRay(PyObject *args)
     }
 }
 
+PyObject*  MeshPy::nearestFacetsOnRays(PyObject *args)
+{
+    PyObject *obj;
+    if (!PyArg_ParseTuple(args, "O!", &PyList_Type, &obj))
+        return 0;
+
+    try {
+        Py::List list(obj);
+        union PyType_Object pyType = {&(Base::VectorPy::Type)};
+        Py::Type vType(pyType.o);
+
+        std::vector<Base::Vector3f> pnts, dirs;
+        for (Py::List::iterator it = list.begin(); it != list.end(); ++it) {
+            Py::Tuple pair(*it);
+            Py::Object p1 = pair.getItem(0);
+            Py::Object p2 = pair.getItem(1);
+            if (p1.isType(vType) && p2.isType(vType)) {
+                Base::Vector3d b = static_cast<Base::VectorPy*>(p1.ptr())->value();
+                Base::Vector3d d = static_cast<Base::VectorPy*>(p2.ptr())->value();
+                pnts.push_back(Base::Vector3f((float)b.x,(float)b.y,(float)b.z));
+                dirs.push_back(Base::Vector3f((float)d.x,(float)d.y,(float)d.z));
+            }
+            else {
+                Py::Tuple b(p1);
+                Py::Tuple d(p2);
+                pnts.push_back(Base::Vector3f((float)Py::Float(b.getItem(0)),
+                                              (float)Py::Float(b.getItem(1)),
+                                              (float)Py::Float(b.getItem(2))));
+                dirs.push_back(Base::Vector3f((float)Py::Float(d.getItem(0)),
+                                              (float)Py::Float(d.getItem(1)),
+                                              (float)Py::Float(d.getItem(2))));
+            }
+        }
+
+        // Like nearestFacetOnRay() we search in both directions of the ray
+        MeshCore::MeshFacetBVH bvh(getMeshObjectPtr()->getKernel());
+        std::vector<Base::Vector3f> fwdRes, bwdRes;
+        std::vector<unsigned long> fwdFacets, bwdFacets;
+        bvh.NearestFacetsOnRays(pnts, dirs, fwdRes, fwdFacets);
+        for (std::vector<Base::Vector3f>::iterator it = dirs.begin(); it != dirs.end(); ++it)
+            *it = -(*it);
+        bvh.NearestFacetsOnRays(pnts, dirs, bwdRes, bwdFacets);
+
+        Py::List result;
+        for (std::size_t i = 0; i < pnts.size(); i++) {
+            Py::Dict dict;
+            const Base::Vector3f* res = 0;
+            unsigned long index = ULONG_MAX;
+            if (fwdFacets[i] != ULONG_MAX) {
+                res = &fwdRes[i];
+                index = fwdFacets[i];
+            }
+            if (bwdFacets[i] != ULONG_MAX && (!res ||
+                Base::DistanceP2(pnts[i], bwdRes[i]) < Base::DistanceP2(pnts[i], *res))) {
+                res = &bwdRes[i];
+                index = bwdFacets[i];
+            }
+            if (res) {
+                Py::Tuple tuple(3);
+                tuple.setItem(0, Py::Float(res->x));
+                tuple.setItem(1, Py::Float(res->y));
+                tuple.setItem(2, Py::Float(res->z));
+                dict.setItem(Py::Int((int)index), tuple);
+            }
+            result.append(dict);
+        }
+
+        return Py::new_reference_to(result);
+    }
+    catch (const Py::Exception&) {
+        return 0;
+    }
+}
+
 PyObject*  MeshPy::getPlanarSegments(PyObject *args)
 {
     float dev;
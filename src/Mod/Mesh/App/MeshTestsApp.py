@@ -1,7 +1,7 @@
 #   (c) Juergen Riegel (juergen.riegel@web.de) 2007      LGPL
 
 import FreeCAD, os, sys, unittest, Mesh
-import thread, time, tempfile
+import thread, time, tempfile, math
 
 
 #---------------------------------------------------------------------------
@@ -36,6 +36,46 @@ class MeshTopoTestCases(unittest.TestCase):
 		planarMeshObject = Mesh.Mesh(self.planarMesh)
 		planarMeshObject.collapseFacets(range(18))
 
+	def testDecimate(self):
+		sphere = Mesh.createSphere(1.0, 50)
+		count = sphere.CountFacets
+		sphere.decimate(count / 4)
+		self.failUnless(sphere.CountFacets <= count / 4)
+		self.failUnless(sphere.isSolid())
+		self.failUnless(not sphere.hasNonManifolds())
+		sphere = Mesh.createSphere(1.0, 50)
+		sphere.decimate(0.01, 0.5, True)
+		self.failUnless(sphere.CountFacets < count)
+		self.failUnless(sphere.isSolid())
+		# above twice the partition size the mesh is decimated in slabs that are stitched afterwards
+		sphere = Mesh.createSphere(1.0, 240)
+		count = sphere.CountFacets
+		self.failUnless(count > 100000)
+		sphere.decimate(count / 4, True)
+		self.failUnless(sphere.CountFacets <= count / 4)
+		self.failUnless(sphere.isSolid())
+		self.failUnless(not sphere.hasNonManifolds())
+		# the border of an open mesh is kept
+		planarMeshObject = Mesh.Mesh(self.planarMesh)
+		planarMeshObject.decimate(0)
+		self.failUnless(planarMeshObject.CountPoints >= 12)
+		self.failUnless(planarMeshObject.BoundBox.XLength == 3.0)
+
+	def testComponents(self):
+		sphere = Mesh.createSphere(1.0, 20)
+		other = Mesh.createSphere(1.0, 20)
+		other.translate(3.0, 0.0, 0.0)
+		sphere.addMesh(other)
+		self.failUnless(sphere.countComponents() == 2)
+		meshes = sphere.getSeparateComponents()
+		self.failUnless(len(meshes) == 2)
+		self.failUnless(meshes[0].CountFacets + meshes[1].CountFacets == sphere.CountFacets)
+		# the planar mesh is one segment over all its facets
+		planarMeshObject = Mesh.Mesh(self.planarMesh)
+		segments = planarMeshObject.getSegmentsByCurvature([(0.0, 0.0, 0.1, 0.1, 2)])
+		self.failUnless(len(segments) == 1)
+		self.failUnless(sorted(segments[0]) == range(18))
+
 
 class MeshGeoTestCases(unittest.TestCase):
 	def setUp(self):
@@ -71,6 +111,107 @@ class MeshGeoTestCases(unittest.TestCase):
 		res=f1.intersect(f2)
 		self.failUnless(len(res) == 0)
 
+	def testSelfIntersection(self):
+		sphere = Mesh.createSphere(1.0, 50)
+		self.failUnless(not sphere.hasSelfIntersections())
+		other = Mesh.createSphere(1.0, 50)
+		other.translate(0.7, 0.1, 0.05)
+		sphere.addMesh(other)
+		self.failUnless(sphere.hasSelfIntersections())
+		sphere.fixSelfIntersections()
+		self.failUnless(not sphere.hasSelfIntersections())
+
+class MeshSmoothingTestCases(unittest.TestCase):
+	def setUp(self):
+		# an octahedron with the top point moved up, all points are inner points
+		self.corners = [(1,0,0), (0,1,0), (-1,0,0), (0,-1,0), (0,0,2), (0,0,-1)]
+		facets = [(0,1,4), (1,2,4), (2,3,4), (3,0,4), (1,0,5), (2,1,5), (3,2,5), (0,3,5)]
+		self.mesh = Mesh.Mesh([list(self.corners[i]) for f in facets for i in f])
+		# the mesh may number the points differently from the corners
+		self.pointIndex = {}
+		for p in self.mesh.Points:
+			self.pointIndex[(p.x, p.y, p.z)] = p.Index
+
+	def checkPoints(self, mesh, expected):
+		# compares the points with the expected coordinates of the corners
+		points = mesh.Points
+		for corner, coords in zip(self.corners, expected):
+			p = points[self.pointIndex[corner]]
+			self.failUnless((p.Vector - FreeCAD.Vector(*coords)).Length < 1e-5)
+
+	def testUniform(self):
+		self.mesh.laplaceSmooth(1, 0.5)
+		self.checkPoints(self.mesh, [(0.5,0,0.125), (0,0.5,0.125), (-0.5,0,0.125), (0,-0.5,0.125), (0,0,1), (0,0,-0.5)])
+
+	def testSubset(self):
+		# only the top point moves
+		self.mesh.laplaceSmooth(1, 0.5, False, [self.pointIndex[(0,0,2)]])
+		self.checkPoints(self.mesh, [(1,0,0), (0,1,0), (-1,0,0), (0,-1,0), (0,0,1), (0,0,-1)])
+
+	def testCotangent(self):
+		# the top and bottom point have symmetric neighbours, so they move as with uniform weights.
+		# The edges of a point of the equator to its neighbours on the equator have the weight
+		# 4/3+1/sqrt(3), to the top 2/3 and to the bottom 2/sqrt(3).
+		self.mesh.laplaceSmooth(1, 0.5, True)
+		r3 = math.sqrt(3.0)
+		z = 0.5 * (4.0/3.0 - 2.0/r3) / (10.0/3.0 + 4.0/r3)
+		self.checkPoints(self.mesh, [(0.5,0,z), (0,0.5,z), (-0.5,0,z), (0,-0.5,z), (0,0,1), (0,0,-0.5)])
+
+	def testTaubin(self):
+		# two steps of Taubin are a step forward and a larger step back
+		other = Mesh.Mesh(self.mesh)
+		self.mesh.taubinSmooth(2, 0.5, 0.1)
+		other.laplaceSmooth(1, 0.5)
+		other.laplaceSmooth(1, -0.6)
+		self.checkPoints(self.mesh, [(0.8,0,0.0875), (0,0.8,0.0875), (-0.8,0,0.0875), (0,-0.8,0.0875), (0,0,1.525), (0,0,-0.875)])
+		self.checkPoints(other, [(0.8,0,0.0875), (0,0.8,0.0875), (-0.8,0,0.0875), (0,-0.8,0.0875), (0,0,1.525), (0,0,-0.875)])
+
+	def testInvalidIndex(self):
+		self.failUnlessRaises(Exception, self.mesh.laplaceSmooth, 1, 0.5, False, [6])
+
+class MeshGridTestCases(unittest.TestCase):
+	def setUp(self):
+		# a fine sphere
+		self.mesh = Mesh.createSphere(10.0, 200)
+
+	def testCrossSections(self):
+		# cross-sections look up the cut facets with a facet grid
+		planes = []
+		for i in range(-9,10):
+			planes.append(((0.0,0.0,float(i)),(0.0,0.0,1.0)))
+		sections = self.mesh.crossSections(planes)
+		self.failUnless(len(sections) == len(planes))
+		for i in range(len(planes)):
+			self.failUnless(len(sections[i]) > 0)
+			for polyline in sections[i]:
+				for point in polyline:
+					self.failUnless(abs(point.z - planes[i][0][2]) < 1.0e-3)
+
+	def testNearestFacetsOnRays(self):
+		# rays from outside to the center of the sphere, the second half points outwards
+		rays = []
+		for i in range(20):
+			a = i * 0.3
+			base = FreeCAD.Vector(20.0*math.cos(a), 20.0*math.sin(a), float(i-10))
+			if i < 10:
+				rays.append((base, base.negative()))
+			else:
+				rays.append((base, base))
+		rays.append(((30.0,0.0,0.0),(0.0,0.0,1.0)))
+		hits = self.mesh.nearestFacetsOnRays(rays)
+		self.failUnless(len(hits) == len(rays))
+		self.failUnless(len(hits[-1]) == 0)
+		for i in range(len(rays)-1):
+			base = rays[i][0]
+			dir = (rays[i][1].x,rays[i][1].y,rays[i][1].z)
+			single = self.mesh.nearestFacetOnRay((base.x,base.y,base.z), dir)
+			self.failUnless(len(hits[i]) == 1)
+			self.failUnless(len(single) == 1)
+			p = FreeCAD.Vector(hits[i].values()[0])
+			q = FreeCAD.Vector(single.values()[0])
+			self.failUnless((p-q).Length < 1.0e-3)
+			self.failUnless(abs(p.Length - 10.0) < 0.1)
+
 class PivyTestCases(unittest.TestCase):
 	def setUp(self):
 		# set up a planar face with 2 triangles
@@ -141,6 +282,82 @@ def createMesh(r,s):
     mesh=Mesh.createSphere(r,s)
     FreeCAD.Console.PrintMessage("... destroy sphere\n")
 
+class AsciiImportTestCases(unittest.TestCase):
+    def setUp(self):
+        self.name = tempfile.gettempdir() + os.sep + "ascii_import"
+
+    def loadFile(self, ext, data):
+        name = self.name + ext
+        f = open(name, "w")
+        f.write(data)
+        f.close()
+        mesh = Mesh.Mesh(name)
+        os.remove(name)
+        return mesh
+
+    def testOBJ(self):
+        # two objects, one with a quad and texture/normal indices, and comment lines
+        data = "# two objects\n" \
+               "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n" \
+               "vn 0 0 1\nf 1//1 2//1 3//1 4//1\n" \
+               "V 0 0 1.0e0\nv 1. 0 1\nv .5 1 1\r\n" \
+               "F 5/1 6/1 7/1\r\n"
+        mesh = self.loadFile(".obj", data)
+        self.failUnless(mesh.CountPoints == 7)
+        self.failUnless(mesh.CountFacets == 3)
+        self.failUnless(mesh.countSegments() == 2)
+
+    def testOFF(self):
+        data = "OFF\n4 2 0\n\n0 0 0\n1 0 0\n1 1 0\n0 1 0\n4 0 1 2 3\n3 0 1 2\n"
+        mesh = self.loadFile(".off", data)
+        self.failUnless(mesh.CountPoints == 4)
+        self.failUnless(mesh.CountFacets == 3)
+
+    def testPLY(self):
+        data = "ply\nformat ascii 1.0\nelement vertex 4\n" \
+               "property float x\nproperty float y\nproperty float z\n" \
+               "element face 3\nproperty list uchar int vertex_index\nend_header\n" \
+               "0 0 0\n1 0 0\n1 1 0\n0 1 -1e-1\n3 0 1 2\n4 0 1 2 3\n3 0 2 3\n"
+        mesh = self.loadFile(".ply", data)
+        self.failUnless(mesh.CountPoints == 4)
+        self.failUnless(mesh.CountFacets == 2)
+
+    def testAsciiSTL(self):
+        data = "solid test\n"
+        for i in range(10):
+            data += "  facet normal 0 0 1\n    outer loop\n" \
+                    "      vertex %d 0 0\n      VERTEX %d 0 0\n      vertex %d 1 0\n" \
+                    "    endloop\n  endfacet\n" % (i, i+1, i)
+        data += "endsolid test\n"
+        mesh = self.loadFile(".stl", data)
+        self.failUnless(mesh.CountPoints == 21)
+        self.failUnless(mesh.CountFacets == 10)
+
+    def tearDown(self):
+        pass
+
+class BinarySTLTestCases(unittest.TestCase):
+    def setUp(self):
+        self.name = tempfile.gettempdir() + os.sep + "binary_stl.stl"
+
+    def testWriteRead(self):
+        mesh = Mesh.createSphere(10.0, 50)
+        mesh.write(self.name)
+        other = Mesh.Mesh(self.name)
+        self.failUnless(mesh.CountPoints == other.CountPoints)
+        self.failUnless(mesh.CountFacets == other.CountFacets)
+        self.failUnless(abs(mesh.Area - other.Area) < 1e-3)
+        self.failUnless(abs(mesh.Volume - other.Volume) < 1e-3)
+
+    def testEmpty(self):
+        Mesh.Mesh().write(self.name)
+        mesh = Mesh.Mesh(self.name)
+        self.failUnless(mesh.CountFacets == 0)
+
+    def tearDown(self):
+        if os.path.exists(self.name):
+            os.remove(self.name)
+
 class LoadMeshInThreadsCases(unittest.TestCase):
 
     def setUp(self):
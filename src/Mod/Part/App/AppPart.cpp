@@ -16,6 +16,7 @@
 # include <IGESControl_Controller.hxx>
 # include <STEPControl_Controller.hxx>
 # include <OSD.hxx>
+# include <Standard.hxx>
 # include <sstream>
 #endif
 
@@ -89,6 +90,13 @@ extern struct PyMethodDef Part_methods[];
 PyDoc_STRVAR(module_part_doc,
 "This is a module working with shapes.");
 
+// Features calling OCC may only be recomputed in worker threads if OCC's
+// memory manager and handles are set up for concurrent use
+static void onParallelRecompute(const App::Document&)
+{
+    Standard::SetReentrant(Standard_True);
+}
+
 extern "C" {
 void PartExport initPart()
 {
@@ -103,6 +111,7 @@ void PartExport initPart()
 //#if defined(FC_OS_LINUX)
     OSD::SetSignal(Standard_False);
 //#endif
+    App::GetApplication().signalParallelRecompute.connect(&onParallelRecompute);
 
     PyObject* partModule = Py_InitModule3("Part", Part_methods, module_part_doc);   /* mod name, table ptr */
     Base::Console().Log("Loading Part module... done\n");
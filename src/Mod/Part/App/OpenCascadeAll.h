@@ -159,6 +159,7 @@
 #include <BRepTools.hxx>
 #include <BRep_Tool.hxx>
 #include <BRepTools_ShapeSet.hxx>
+#include <BinTools.hxx>
 #include <BRepBuilderAPI_Copy.hxx>
 #include <BRepCheck_Analyzer.hxx>
 #include <BRepCheck_Result.hxx>
@@ -33,6 +33,7 @@
 # include <BRepTools.hxx>
 # include <BRepTools_ShapeSet.hxx>
 # include <BRepBuilderAPI_Copy.hxx>
+# include <BinTools.hxx>
 # include <TopTools_HSequenceOfShape.hxx>
 # include <TopTools_MapOfShape.hxx>
 # include <TopoDS.hxx>
@@ -44,13 +45,11 @@
 #endif
 
 
-#include <strstream>
 #include <Base/Console.h>
 #include <Base/Writer.h>
 #include <Base/Reader.h>
 #include <Base/Exception.h>
 #include <Base/FileInfo.h>
-#include <Base/Stream.h>
 #include <App/DocumentObject.h>
 
 #include "PropertyTopoShape.h"
@@ -68,7 +67,7 @@ using namespace Part;
 
 TYPESYSTEM_SOURCE(Part::PropertyPartShape , App::PropertyComplexGeoData);
 
-PropertyPartShape::PropertyPartShape()
+PropertyPartShape::PropertyPartShape() : _binary(false)
 {
 }
 
@@ -232,8 +231,10 @@ void PropertyPartShape::Save (Base::Writer &writer) const
 {
     if(!writer.isForceXML()) {
         //See SaveDocFile(), RestoreDocFile()
+        // The extension tells RestoreDocFile() which format to read
+        const char* file = writer.getMode("BinaryBrep") ? "PartShape.bin" : "PartShape.brp";
         writer.Stream() << writer.ind() << "<Part file=\"" 
-                        << writer.addFile("PartShape.brp", this)
+                        << writer.addFile(file, this)
                         << "\"/>" << std::endl;
     }
 }
@@ -245,6 +246,7 @@ void PropertyPartShape::Restore(Base::XMLReader &reader)
 
     if (!file.empty()) {
         // initate a file read
+        _binary = Base::FileInfo(file).hasExtension("bin");
         reader.addFile(file.c_str(),this);
     }
 }
@@ -261,91 +263,65 @@ void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
     const TopoDS_Shape& myShape = copy.Shape();
     BRepTools::Clean(myShape); // remove triangulation
 
-    // create a temporary file and copy the content to the zip stream
-    // once the tmp. filename is known use always the same because otherwise
-    // we may run into some problems on the Linux platform
-    static Base::FileInfo fi(Base::FileInfo::getTempFileName());
-
-    if (!BRepTools::Write(myShape,(const Standard_CString)fi.filePath().c_str())) {
-        // Note: Do NOT throw an exception here because if the tmp. file could
-        // not be created we should not abort.
+    // write the shape directly to the zip stream
+    try {
+        if (writer.getMode("BinaryBrep"))
+            BinTools::Write(myShape, writer.Stream());
+        else
+            BRepTools::Write(myShape, writer.Stream());
+    }
+    catch (const Standard_Failure&) {
+        // Note: Do NOT throw an exception here because we should not abort.
         // We only print an error message but continue writing the next files to the
         // stream...
         App::PropertyContainer* father = this->getContainer();
         if (father && father->isDerivedFrom(App::DocumentObject::getClassTypeId())) {
             App::DocumentObject* obj = static_cast<App::DocumentObject*>(father);
-            Base::Console().Error("Shape of '%s' cannot be written to BRep file '%s'\n", 
-                obj->Label.getValue(),fi.filePath().c_str());
+            Base::Console().Error("Shape of '%s' cannot be written to BRep file\n", 
+                obj->Label.getValue());
         }
         else {
-            Base::Console().Error("Cannot save BRep file '%s'\n", fi.filePath().c_str());
-        }
-    }
-
-    Base::ifstream file(fi, std::ios::in | std::ios::binary);
-    if (file){
-        unsigned long ulSize = 0; 
-        std::streambuf* buf = file.rdbuf();
-        if (buf) {
-            unsigned long ulCurr;
-            ulCurr = buf->pubseekoff(0, std::ios::cur, std::ios::in);
-            ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
-            buf->pubseekoff(ulCurr, std::ios::beg, std::ios::in);
+            Base::Console().Error("Cannot save BRep file\n");
         }
-
-        // read in the ASCII file and write back to the stream
-        std::strstreambuf sbuf(ulSize);
-        file >> &sbuf;
-        writer.Stream() << &sbuf;
     }
-
-    file.close();
-    // remove temp file
-    fi.deleteFile();
 }
 
 void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
 {
-    BRep_Builder builder;
-
-    // create a temporary file and copy the content from the zip stream
-    Base::FileInfo fi(Base::FileInfo::getTempFileName());
-
-    // read in the ASCII file and write back to the file stream
-    Base::ofstream file(fi, std::ios::out | std::ios::binary);
-    unsigned long ulSize = 0; 
-    if (reader) {
-        std::streambuf* buf = file.rdbuf();
-        reader >> buf;
-        file.flush();
-        ulSize = buf->pubseekoff(0, std::ios::cur, std::ios::in);
-    }
-    file.close();
-
-    // Read the shape from the temp file, if the file is empty the stored shape was already empty.
-    // If it's still empty after reading the (non-empty) file there must occurred an error.
+    // Read the shape directly from the zip stream, if the file is empty the stored shape
+    // was already empty. If it's still empty after reading the (non-empty) file there
+    // must occurred an error.
     TopoDS_Shape shape;
-    if (ulSize > 0) {
-        if (!BRepTools::Read(shape, (const Standard_CString)fi.filePath().c_str(), builder)) {
-            // Note: Do NOT throw an exception here because if the tmp. created file could
-            // not be read it's NOT an indication for an invalid input stream 'reader'.
+    if (reader && reader.peek() != std::istream::traits_type::eof()) {
+        try {
+            if (_binary) {
+                BinTools::Read(shape, reader);
+            }
+            else {
+                BRep_Builder builder;
+                BRepTools::Read(shape, reader, builder);
+            }
+        }
+        catch (const Standard_Failure&) {
+            shape.Nullify();
+        }
+
+        if (shape.IsNull()) {
+            // Note: Do NOT throw an exception here because we should not abort.
             // We only print an error message but continue reading the next files from the
             // stream...
             App::PropertyContainer* father = this->getContainer();
             if (father && father->isDerivedFrom(App::DocumentObject::getClassTypeId())) {
                 App::DocumentObject* obj = static_cast<App::DocumentObject*>(father);
-                Base::Console().Error("BRep file '%s' with shape of '%s' seems to be empty\n", 
-                    fi.filePath().c_str(),obj->Label.getValue());
+                Base::Console().Error("BRep file with shape of '%s' seems to be empty\n", 
+                    obj->Label.getValue());
             }
             else {
-                Base::Console().Warning("Loaded BRep file '%s' seems to be empty\n", fi.filePath().c_str());
+                Base::Console().Warning("Loaded BRep file seems to be empty\n");
             }
         }
     }
 
-    // delete the temp file
-    fi.deleteFile();
-
     setValue(shape);
 }
 
@@ -96,6 +96,8 @@ public:
 
 private:
     TopoShape _Shape;
+    /// the shape to restore is stored in binary BRep format
+    bool _binary;
 };
 
 struct PartExport ShapeHistory {
@@ -151,6 +151,7 @@
 #include <Base/Builder3D.h>
 #include <Base/FileInfo.h>
 #include <Base/Exception.h>
+#include <Base/PointHash.h>
 #include <Base/Tools.h>
 
 #include "TopoShape.h"
@@ -2102,7 +2103,8 @@ void TopoShape::getFaces(std::vector<Base::Vector3d> &aPoints,
 #if 1
     if (this->_Shape.IsNull())
         return;
-    std::set<MeshVertex> vertices;
+    // the tolerance of MeshVertex is gp::Resolution() so it only merges identical points
+    Base::PointHash<double> vertices(0.0);
     Standard_Real x1, y1, z1;
     Standard_Real x2, y2, z2;
     Standard_Real x3, y3, z3;
@@ -2118,43 +2120,9 @@ void TopoShape::getFaces(std::vector<Base::Vector3d> &aPoints,
         for (xp.InitTriangle (nbd); xp.MoreTriangle (); xp.NextTriangle ()) {
             xp.TriangleVertices (x1,y1,z1,x2,y2,z2,x3,y3,z3);
             Data::ComplexGeoData::Facet face;
-            std::set<MeshVertex>::iterator it;
-
-            // 1st vertex
-            MeshVertex v1(x1,y1,z1);
-            it = vertices.find(v1);
-            if (it == vertices.end()) {
-                v1.i = vertices.size();
-                face.I1 = v1.i;
-                vertices.insert(v1);
-            }
-            else {
-                face.I1 = it->i;
-            }
-
-            // 2nd vertex
-            MeshVertex v2(x2,y2,z2);
-            it = vertices.find(v2);
-            if (it == vertices.end()) {
-                v2.i = vertices.size();
-                face.I2 = v2.i;
-                vertices.insert(v2);
-            }
-            else {
-                face.I2 = it->i;
-            }
-
-            // 3rd vertex
-            MeshVertex v3(x3,y3,z3);
-            it = vertices.find(v3);
-            if (it == vertices.end()) {
-                v3.i = vertices.size();
-                face.I3 = v3.i;
-                vertices.insert(v3);
-            }
-            else {
-                face.I3 = it->i;
-            }
+            face.I1 = vertices.insert(Base::Vector3d(x1,y1,z1));
+            face.I2 = vertices.insert(Base::Vector3d(x2,y2,z2));
+            face.I3 = vertices.insert(Base::Vector3d(x3,y3,z3));
 
             // make sure that we don't insert invalid facets
             if (face.I1 != face.I2 &&
@@ -2164,12 +2132,8 @@ void TopoShape::getFaces(std::vector<Base::Vector3d> &aPoints,
         }
     }
 
-    std::vector<gp_Pnt> points;
-    points.resize(vertices.size());
-    for (std::set<MeshVertex>::iterator it = vertices.begin(); it != vertices.end(); ++it)
-        points[it->i] = it->toPoint();
-    for (std::vector<gp_Pnt>::iterator it = points.begin(); it != points.end(); ++it)
-        aPoints.push_back(Base::Vector3d(it->X(),it->Y(),it->Z()));
+    const std::vector<Base::Vector3d>& points = vertices.getPoints();
+    aPoints.insert(aPoints.end(), points.begin(), points.end());
 #endif
 #if 0
     BRepMesh::Mesh (this->_Shape, accuracy);
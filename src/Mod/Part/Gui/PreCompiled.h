@@ -71,7 +71,9 @@
 #endif
 
 // OpenCasCade Base
+#include <Standard.hxx>
 #include <Standard_Failure.hxx>
+#include <Standard_Version.hxx>
 
 #include <BRepMesh.hxx>
 #include <BRepMesh_IncrementalMesh.hxx>
@@ -113,10 +115,16 @@
 
 #include <Python.h>
 
+// Boost
+#include <boost/bind.hpp>
+
 // Qt Toolkit
 #ifndef __Qt4All__
 # include <Gui/Qt4All.h>
 #endif
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrentMap>
 
 // Inventor
 #ifndef __InventorAll__
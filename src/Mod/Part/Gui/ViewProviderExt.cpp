@@ -56,6 +56,8 @@
 # include <TopExp.hxx>
 # include <TopTools_IndexedMapOfShape.hxx>
 # include <Poly_PolygonOnTriangulation.hxx>
+# include <Standard.hxx>
+# include <Standard_Version.hxx>
 # include <TColStd_Array1OfInteger.hxx>
 # include <TopTools_ListOfShape.hxx>
 # include <Inventor/SoPickedPoint.h>
@@ -82,7 +84,11 @@
 # include <Inventor/nodes/SoScale.h>
 # include <Inventor/nodes/SoLightModel.h>
 # include <QAction>
+# include <QFuture>
 # include <QMenu>
+# include <QThread>
+# include <QtConcurrentMap>
+# include <boost/bind.hpp>
 #endif
 
 /// Here the FreeCAD includes sorted by Base,App,Gui......
@@ -111,6 +117,92 @@
 
 using namespace PartGui;
 
+namespace PartGui {
+/** The triangulation of a face and the position of its nodes and triangles
+ * in the Inventor buffers.
+ */
+struct FaceTessellation
+{
+    TopoDS_Face face;
+    TopLoc_Location loc;
+    Handle(Poly_Triangulation) mesh;
+    int nodeOffset;
+    int triaOffset;
+};
+
+/** Fills the nodes, normals and triangle indices of one face into the Inventor buffers.
+ * Each face has its own range of nodes so that several faces can be handled at a time.
+ */
+static void fillFaceBuffers(const FaceTessellation& data, SbVec3f* verts, SbVec3f* norms, int32_t* index)
+{
+    const Handle(Poly_Triangulation)& mesh = data.mesh;
+    if (mesh.IsNull())
+        return;
+
+    // getting the transformation of the shape/face
+    gp_Trsf myTransf;
+    Standard_Boolean identity = true;
+    if (!data.loc.IsIdentity()) {
+        identity = false;
+        myTransf = data.loc.Transformation();
+    }
+
+    // getting size of triangle array of this face
+    int nbTriInFace = mesh->NbTriangles();
+    int FaceNodeOffset = data.nodeOffset;
+    int FaceTriaOffset = data.triaOffset;
+    // check orientation
+    TopAbs_Orientation orient = data.face.Orientation();
+
+    // cycling through the poly mesh
+    const Poly_Array1OfTriangle& Triangles = mesh->Triangles();
+    const TColgp_Array1OfPnt& Nodes = mesh->Nodes();
+    for (int g=1;g<=nbTriInFace;g++) {
+        // Get the triangle
+        Standard_Integer N1,N2,N3;
+        Triangles(g).Get(N1,N2,N3);
+
+        // change orientation of the triangle if the face is reversed
+        if ( orient != TopAbs_FORWARD ) {
+            Standard_Integer tmp = N1;
+            N1 = N2;
+            N2 = tmp;
+        }
+
+        // get the 3 points of this triangle
+        gp_Pnt V1(Nodes(N1)), V2(Nodes(N2)), V3(Nodes(N3));
+
+        // transform the vertices to the place of the face
+        if (!identity) {
+            V1.Transform(myTransf);
+            V2.Transform(myTransf);
+            V3.Transform(myTransf);
+        }
+
+        // calculating per vertex normals
+        // Calculate triangle normal
+        gp_Vec v1(V1.X(),V1.Y(),V1.Z()),v2(V2.X(),V2.Y(),V2.Z()),v3(V3.X(),V3.Y(),V3.Z());
+        gp_Vec Normal = (v2-v1)^(v3-v1);
+
+        // add the triangle normal to the vertex normal for all points of this triangle
+        norms[FaceNodeOffset+N1-1] += SbVec3f(Normal.X(),Normal.Y(),Normal.Z());
+        norms[FaceNodeOffset+N2-1] += SbVec3f(Normal.X(),Normal.Y(),Normal.Z());
+        norms[FaceNodeOffset+N3-1] += SbVec3f(Normal.X(),Normal.Y(),Normal.Z());
+
+        // set the vertices
+        verts[FaceNodeOffset+N1-1].setValue((float)(V1.X()),(float)(V1.Y()),(float)(V1.Z()));
+        verts[FaceNodeOffset+N2-1].setValue((float)(V2.X()),(float)(V2.Y()),(float)(V2.Z()));
+        verts[FaceNodeOffset+N3-1].setValue((float)(V3.X()),(float)(V3.Y()),(float)(V3.Z()));
+
+        // set the index vector with the 3 point indexes and the end delimiter
+        index[FaceTriaOffset*4+4*(g-1)]   = FaceNodeOffset+N1-1;
+        index[FaceTriaOffset*4+4*(g-1)+1] = FaceNodeOffset+N2-1;
+        index[FaceTriaOffset*4+4*(g-1)+2] = FaceNodeOffset+N3-1;
+        index[FaceTriaOffset*4+4*(g-1)+3] = SO_END_FACE_INDEX;
+    }
+}
+}
+
 PROPERTY_SOURCE(PartGui::ViewProviderPartExt, Gui::ViewProviderGeometryObject)
 
 
@@ -605,21 +697,34 @@ void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
             Deviation.getValue();
 
         // create or use the mesh on the data structure
+#if OCC_VERSION_HEX >= 0x060700
+        // the edges are discretized once and then the faces are meshed in parallel
+        Standard::SetReentrant(Standard_True);
+        BRepMesh_IncrementalMesh myMesh(cShape,deflection,Standard_False,0.5,
+            QThread::idealThreadCount() > 1 ? Standard_True : Standard_False);
+#else
         BRepMesh_IncrementalMesh myMesh(cShape,deflection);
+#endif
         // We must reset the location here because the transformation data
         // are set in the placement property
         TopLoc_Location aLoc;
         cShape.Location(aLoc);
 
-        // count triangles and nodes in the mesh
+        // count triangles and nodes in the mesh and get the offsets of each face
+        std::vector<FaceTessellation> faceData;
         TopExp_Explorer Ex;
         for (Ex.Init(cShape,TopAbs_FACE);Ex.More();Ex.Next()) {
-            Handle (Poly_Triangulation) mesh = BRep_Tool::Triangulation(TopoDS::Face(Ex.Current()), aLoc);
+            FaceTessellation data;
+            data.face = TopoDS::Face(Ex.Current());
+            data.mesh = BRep_Tool::Triangulation(data.face, data.loc);
+            data.nodeOffset = nbrNodes;
+            data.triaOffset = nbrTriangles;
+            faceData.push_back(data);
             // Note: we must also count empty faces
-            if (!mesh.IsNull()) {
-                nbrTriangles += mesh->NbTriangles();
-                nbrNodes     += mesh->NbNodes();
-                nbrNorms     += mesh->NbNodes();
+            if (!data.mesh.IsNull()) {
+                nbrTriangles += data.mesh->NbTriangles();
+                nbrNodes     += data.mesh->NbNodes();
+                nbrNorms     += data.mesh->NbNodes();
             }
 
             TopExp_Explorer xp;
@@ -683,12 +788,24 @@ void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
         for (int i=0;i < nbrNorms;i++) 
             norms[i]= SbVec3f(0.0,0.0,0.0);
 
-        int ii = 0,FaceNodeOffset=0,FaceTriaOffset=0;
-        for (Ex.Init(cShape, TopAbs_FACE); Ex.More(); Ex.Next(),ii++) {
-            TopLoc_Location aLoc;
-            const TopoDS_Face &actFace = TopoDS::Face(Ex.Current());
+        // The faces don't share any nodes, so their buffers can be filled independently
+        // of each other. The result is the same as when done one face after the other.
+        if (QThread::idealThreadCount() > 1 && faceData.size() > 1) {
+            QFuture<void> future = QtConcurrent::map
+                (faceData, boost::bind(&fillFaceBuffers, _1, verts, norms, index));
+            future.waitForFinished();
+        }
+        else {
+            for (std::vector<FaceTessellation>::iterator it = faceData.begin(); it != faceData.end(); ++it)
+                fillFaceBuffers(*it, verts, norms, index);
+        }
+
+        int ii = 0,FaceNodeOffset=0;
+        for (std::vector<FaceTessellation>::iterator it = faceData.begin(); it != faceData.end(); ++it,ii++) {
+            TopLoc_Location aLoc = it->loc;
+            const TopoDS_Face &actFace = it->face;
             // get the mesh of the shape
-            Handle (Poly_Triangulation) mesh = BRep_Tool::Triangulation(actFace,aLoc);
+            const Handle (Poly_Triangulation)& mesh = it->mesh;
             if (mesh.IsNull()) continue;
 
             // getting the transformation of the shape/face
@@ -702,56 +819,7 @@ void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
             // getting size of node and triangle array of this face
             int nbNodesInFace = mesh->NbNodes();
             int nbTriInFace   = mesh->NbTriangles();
-            // check orientation
-            TopAbs_Orientation orient = actFace.Orientation();
-
-
-            // cycling through the poly mesh
-            const Poly_Array1OfTriangle& Triangles = mesh->Triangles();
             const TColgp_Array1OfPnt& Nodes = mesh->Nodes();
-            for (int g=1;g<=nbTriInFace;g++) {
-                // Get the triangle
-                Standard_Integer N1,N2,N3;
-                Triangles(g).Get(N1,N2,N3);
-
-                // change orientation of the triangle if the face is reversed
-                if ( orient != TopAbs_FORWARD ) {
-                    Standard_Integer tmp = N1;
-                    N1 = N2;
-                    N2 = tmp;
-                }
-
-                // get the 3 points of this triangle
-                gp_Pnt V1(Nodes(N1)), V2(Nodes(N2)), V3(Nodes(N3));
-
-                // transform the vertices to the place of the face
-                if (!identity) {
-                    V1.Transform(myTransf);
-                    V2.Transform(myTransf);
-                    V3.Transform(myTransf);
-                }
-                
-                // calculating per vertex normals                    
-                // Calculate triangle normal
-                gp_Vec v1(V1.X(),V1.Y(),V1.Z()),v2(V2.X(),V2.Y(),V2.Z()),v3(V3.X(),V3.Y(),V3.Z());
-                gp_Vec Normal = (v2-v1)^(v3-v1); 
-
-                // add the triangle normal to the vertex normal for all points of this triangle
-                norms[FaceNodeOffset+N1-1] += SbVec3f(Normal.X(),Normal.Y(),Normal.Z());
-                norms[FaceNodeOffset+N2-1] += SbVec3f(Normal.X(),Normal.Y(),Normal.Z());
-                norms[FaceNodeOffset+N3-1] += SbVec3f(Normal.X(),Normal.Y(),Normal.Z());                 
-
-                // set the vertices
-                verts[FaceNodeOffset+N1-1].setValue((float)(V1.X()),(float)(V1.Y()),(float)(V1.Z()));
-                verts[FaceNodeOffset+N2-1].setValue((float)(V2.X()),(float)(V2.Y()),(float)(V2.Z()));
-                verts[FaceNodeOffset+N3-1].setValue((float)(V3.X()),(float)(V3.Y()),(float)(V3.Z()));
-
-                // set the index vector with the 3 point indexes and the end delimiter
-                index[FaceTriaOffset*4+4*(g-1)]   = FaceNodeOffset+N1-1; 
-                index[FaceTriaOffset*4+4*(g-1)+1] = FaceNodeOffset+N2-1; 
-                index[FaceTriaOffset*4+4*(g-1)+2] = FaceNodeOffset+N3-1; 
-                index[FaceTriaOffset*4+4*(g-1)+3] = SO_END_FACE_INDEX;
-            }
 
             parts[ii] = nbTriInFace; // new part
 
@@ -797,7 +865,6 @@ void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
             
             // counting up the per Face offsets
             FaceNodeOffset += nbNodesInFace;
-            FaceTriaOffset += nbTriInFace;
         }
 
         // handling of the free edges
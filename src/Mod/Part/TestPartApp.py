@@ -19,7 +19,7 @@
 #   USA                                                                   *
 #**************************************************************************
 
-import FreeCAD, os, sys, unittest, Part
+import FreeCAD, os, sys, unittest, tempfile, Part
 App = FreeCAD
 
 #---------------------------------------------------------------------------
@@ -35,8 +35,62 @@ class PartTestCases(unittest.TestCase):
 		self.Box = App.ActiveDocument.addObject("Part::Box","Box")
 		self.Doc.recompute()
 		self.failUnless(len(self.Box.Shape.Faces)==6)
+
+	def testTessellate(self):
+		# the vertices of the triangles are merged if they are identical and numbered
+		# in the order of their first occurrence
+		for shape in (Part.makeBox(1,2,3), Part.makeCylinder(2,5)):
+			points, faces = shape.tessellate(0.01)
+			self.failUnless(len(faces) > 0)
+			keys = [(p.x, p.y, p.z) for p in points]
+			self.failUnless(len(set(keys)) == len(keys))
+			count = 0
+			for face in faces:
+				self.failUnless(len(set(face)) == 3)
+				for i in face:
+					self.failUnless(i <= count)
+					if i == count:
+						count = count + 1
+			self.failUnless(count == len(points))
+		points, faces = Part.makeBox(1,2,3).tessellate(0.01)
+		self.failUnless(len(points) == 8)
+		self.failUnless(len(faces) == 12)
 		
 	def tearDown(self):
 		#closing doc
 		FreeCAD.closeDocument("PartTest")
 		#print ("omit clos document for debuging")
+
+
+class PartSaveRestoreCases(unittest.TestCase):
+	def setUp(self):
+		self.Param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+		self.Binary = self.Param.GetBool("SaveBinaryBrep", False)
+		self.FileName = tempfile.gettempdir() + os.sep + "PartSaveRestore.FCStd"
+
+	def saveAndRestore(self, binary):
+		self.Param.SetBool("SaveBinaryBrep", binary)
+		doc = FreeCAD.newDocument("PartSaveRestore")
+		box = doc.addObject("Part::Feature","Box")
+		box.Shape = Part.makeBox(1,2,3)
+		doc.addObject("Part::Feature","Empty")
+		doc.saveAs(self.FileName)
+		FreeCAD.closeDocument("PartSaveRestore")
+
+		doc = FreeCAD.openDocument(self.FileName)
+		shape = doc.getObject("Box").Shape
+		self.failUnless(len(shape.Faces)==6)
+		self.failUnless(abs(shape.Volume - 6.0) < 1e-7)
+		self.failUnless(doc.getObject("Empty").Shape.isNull())
+		FreeCAD.closeDocument(doc.Name)
+
+	def testAsciiBrep(self):
+		self.saveAndRestore(False)
+
+	def testBinaryBrep(self):
+		self.saveAndRestore(True)
+
+	def tearDown(self):
+		self.Param.SetBool("SaveBinaryBrep", self.Binary)
+		if os.path.exists(self.FileName):
+			os.remove(self.FileName)
@@ -38,9 +38,50 @@
 #include "PointsPy.h"
 #include "PointsAlgos.h"
 #include "FeaturePointsImportAscii.h"
+#include "PointsFeature.h"
+#include "Properties.h"
 
 using namespace Points;
 
+static bool
+isPointsFile(const Base::FileInfo& file)
+{
+    return file.hasExtension("asc") || file.hasExtension("xyz") || file.hasExtension("pts") ||
+           file.hasExtension("ply") || file.hasExtension("pcd");
+}
+
+/* Loads the points and adds them to the document. If the file has intensities, colors or
+ * normals they are added as properties to a Python feature. */
+static void
+importPoints(App::Document* pcDoc, const char* Name)
+{
+    Base::FileInfo file(Name);
+    Points::PointKernel pkTemp;
+    Points::PointAttributes attributes;
+    Points::PointsAlgos::Load(pkTemp, Name, &attributes);
+
+    if (attributes.intensity.empty() && attributes.colors.empty() && attributes.normals.empty()) {
+        Points::Feature *pcFeature = (Points::Feature *)pcDoc->addObject("Points::Feature", file.fileNamePure().c_str());
+        pcFeature->Points.setValue( pkTemp );
+        return;
+    }
+
+    Points::FeaturePython *pcFeature = (Points::FeaturePython *)pcDoc->addObject("Points::FeaturePython", file.fileNamePure().c_str());
+    pcFeature->Points.setValue( pkTemp );
+    if (!attributes.intensity.empty()) {
+        App::Property* prop = pcFeature->addDynamicProperty("Points::PropertyGreyValueList", "Intensity");
+        static_cast<Points::PropertyGreyValueList*>(prop)->setValues(attributes.intensity);
+    }
+    if (!attributes.colors.empty()) {
+        App::Property* prop = pcFeature->addDynamicProperty("App::PropertyColorList", "Color");
+        static_cast<App::PropertyColorList*>(prop)->setValues(attributes.colors);
+    }
+    if (!attributes.normals.empty()) {
+        App::Property* prop = pcFeature->addDynamicProperty("Points::PropertyNormalList", "Normal");
+        static_cast<Points::PropertyNormalList*>(prop)->setValues(attributes.normals);
+    }
+}
+
 /* module functions */
 static PyObject *
 open(PyObject *self, PyObject *args)
@@ -57,14 +98,10 @@ open(PyObject *self, PyObject *args)
         if (file.extension() == "")
             Py_Error(PyExc_Exception,"no file ending");
 
-        if (file.hasExtension("asc")) {
+        if (isPointsFile(file)) {
             // create new document and add Import feature
             App::Document *pcDoc = App::GetApplication().newDocument("Unnamed");
-            Points::Feature *pcFeature = (Points::Feature *)pcDoc->addObject("Points::Feature", file.fileNamePure().c_str());
-            Points::PointKernel pkTemp;
-            pkTemp.load(Name);
-            pcFeature->Points.setValue( pkTemp );
-
+            importPoints(pcDoc, Name);
         }
         else {
             Py_Error(PyExc_Exception,"unknown file ending");
@@ -90,17 +127,14 @@ insert(PyObject *self, PyObject *args)
         if (file.extension() == "")
             Py_Error(PyExc_Exception,"no file ending");
 
-        if (file.hasExtension("asc")) {
+        if (isPointsFile(file)) {
             // add Import feature
             App::Document *pcDoc = App::GetApplication().getDocument(DocName);
             if (!pcDoc) {
                 pcDoc = App::GetApplication().newDocument(DocName);
             }
 
-            Points::Feature *pcFeature = (Points::Feature *)pcDoc->addObject("Points::Feature", file.fileNamePure().c_str());
-            Points::PointKernel pkTemp;
-            pkTemp.load(Name);
-            pcFeature->Points.setValue( pkTemp );
+            importPoints(pcDoc, Name);
         }
         else {
             Py_Error(PyExc_Exception,"unknown file ending");
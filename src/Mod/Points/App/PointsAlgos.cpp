@@ -26,6 +26,8 @@
 #ifdef FC_OS_LINUX
 # include <unistd.h>
 #endif
+# include <algorithm>
+# include <cstring>
 # include <sstream>
 #endif
 
@@ -38,12 +40,497 @@
 #include <Base/Console.h>
 #include <Base/Sequencer.h>
 #include <Base/Stream.h>
+#include <Base/Swap.h>
+#include <Base/Tokenizer.h>
 
-#include <boost/regex.hpp>
+#include <QThread>
+#include <QFuture>
+#include <QtConcurrentMap>
 
 using namespace Points;
 
-void PointsAlgos::Load(PointKernel &points, const char *FileName)
+namespace {
+
+using namespace Base::Tokenizer;
+
+/// The data that can be read for a point. RGB is a packed color of a PCD file.
+enum Field { X, Y, Z, Intensity, Red, Green, Blue, NX, NY, NZ, RGB, NumFields };
+
+/// The types of values in binary files
+enum ValueType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+const int valueSize[] = { 1, 1, 2, 2, 4, 4, 4, 8 };
+
+/**
+ * Describes where the fields of a point are in a line of an ASCII file or in a record
+ * of a binary file. For ASCII files the position is the column, for binary files the
+ * byte offset in the record.
+ */
+struct Layout
+{
+    int position[NumFields]; ///< -1 if the file doesn't have the field
+    ValueType type[NumFields];
+    int numColumns;     ///< the number of columns of a line that must be parsed
+    int recordSize;     ///< the size of a binary record
+    bool swapBytes;     ///< true if the byte order of the file differs from the machine
+    float colorScale;   ///< maps colors to [0,1], 0 if it must be decided from the values
+
+    Layout() : numColumns(0), recordSize(0), swapBytes(false), colorScale(1.0f)
+    {
+        std::fill(position, position + NumFields, -1);
+        std::fill(type, type + NumFields, Float32);
+    }
+    bool has(Field f) const
+    {
+        return position[f] >= 0;
+    }
+    bool hasColor() const
+    {
+        return has(RGB) || (has(Red) && has(Green) && has(Blue));
+    }
+    bool hasNormal() const
+    {
+        return has(NX) && has(NY) && has(NZ);
+    }
+    void set(Field f, int pos, ValueType t = Float32)
+    {
+        position[f] = pos;
+        type[f] = t;
+        if (f == Red && t != Float32 && t != Float64)
+            colorScale = 1.0f / 255.0f;
+    }
+    void setColumns()
+    {
+        numColumns = *std::max_element(position, position + NumFields) + 1;
+    }
+
+    double value(const char* record, Field f) const
+    {
+        char data[8];
+        ValueType t = type[f];
+        std::memcpy(data, record + position[f], valueSize[t]);
+        if (swapBytes)
+            std::reverse(data, data + valueSize[t]);
+        switch (t) {
+        case Int8:    return get<signed char>(data);
+        case UInt8:   return get<unsigned char>(data);
+        case Int16:   return get<int16_t>(data);
+        case UInt16:  return get<uint16_t>(data);
+        case Int32:   return get<int32_t>(data);
+        case UInt32:  return get<uint32_t>(data);
+        case Float32: return get<float>(data);
+        default:      return get<double>(data);
+        }
+    }
+    /// returns the bits of the packed color without converting them to a floating-point
+    /// value, which would change the bits of a signalling NaN
+    uint32_t packedColor(const char* record) const
+    {
+        ValueType t = type[RGB];
+        if (valueSize[t] != sizeof(uint32_t))
+            return (uint32_t)value(record, RGB);
+        char data[4];
+        std::memcpy(data, record + position[RGB], sizeof(data));
+        if (swapBytes)
+            std::reverse(data, data + sizeof(data));
+        uint32_t rgb;
+        std::memcpy(&rgb, data, sizeof(rgb));
+        return rgb;
+    }
+    /// returns the packed color of a number parsed from an ASCII file
+    uint32_t packedColor(double v) const
+    {
+        // the color is stored as bits of a float or as unsigned integer
+        if (type[RGB] == Float32) {
+            float f = (float)v;
+            uint32_t rgb;
+            std::memcpy(&rgb, &f, sizeof(rgb));
+            return rgb;
+        }
+        return (uint32_t)v;
+    }
+    template <class T>
+    static double get(const char* data)
+    {
+        // the data may not be aligned
+        T v;
+        std::memcpy(&v, data, sizeof(T));
+        return v;
+    }
+};
+
+/** The points and their attributes of a part of a file. */
+struct Cloud
+{
+    std::vector<Base::Vector3f> points;
+    std::vector<float> intensity;
+    std::vector<App::Color> colors;
+    std::vector<Base::Vector3f> normals;
+
+    /// \a rgb is the packed color if the layout has the field RGB
+    void add(const Layout& layout, const double* v, uint32_t rgb)
+    {
+        points.push_back(Base::Vector3f((float)v[X], (float)v[Y], (float)v[Z]));
+        if (layout.has(Intensity))
+            intensity.push_back((float)v[Intensity]);
+        if (layout.has(RGB)) {
+            colors.push_back(App::Color(((rgb >> 16) & 0xff) / 255.0f,
+                                        ((rgb >>  8) & 0xff) / 255.0f,
+                                        ( rgb        & 0xff) / 255.0f));
+        }
+        else if (layout.hasColor()) {
+            colors.push_back(App::Color((float)v[Red], (float)v[Green], (float)v[Blue]));
+        }
+        if (layout.hasNormal())
+            normals.push_back(Base::Vector3f((float)v[NX], (float)v[NY], (float)v[NZ]));
+    }
+};
+
+/** A range of complete lines of an ASCII file that is parsed by a thread. */
+struct AsciiPart
+{
+    const char* begin;
+    const char* end;
+    const Layout* layout;
+    Cloud cloud;
+
+    void Parse()
+    {
+        const Layout& rLayout = *layout;
+        std::vector<double> columns(rLayout.numColumns);
+        double values[NumFields] = {0};
+        for (const char* p = begin; p < end;) {
+            const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+            if (!eol)
+                eol = end;
+            int i = 0;
+            for (const char* s = p; i < rLayout.numColumns; i++) {
+                if (!parseFloat(s, eol, columns[i]))
+                    break;
+            }
+            // lines with less numbers are comments or invalid points
+            if (i == rLayout.numColumns) {
+                for (int f = 0; f < NumFields; f++) {
+                    if (rLayout.position[f] >= 0)
+                        values[f] = columns[rLayout.position[f]];
+                }
+                uint32_t rgb = rLayout.has(RGB) ? rLayout.packedColor(values[RGB]) : 0;
+                cloud.add(rLayout, values, rgb);
+            }
+            p = eol + 1;
+        }
+    }
+};
+
+/** A range of records of a binary file that is decoded by a thread. */
+struct BinaryPart
+{
+    const char* begin;
+    std::size_t count;
+    const Layout* layout;
+    Cloud cloud;
+
+    void Decode()
+    {
+        const Layout& rLayout = *layout;
+        double values[NumFields] = {0};
+        cloud.points.reserve(count);
+        for (std::size_t i = 0; i < count; i++) {
+            const char* record = begin + i * rLayout.recordSize;
+            for (int f = 0; f < NumFields; f++) {
+                if (rLayout.position[f] >= 0)
+                    values[f] = rLayout.value(record, Field(f));
+            }
+            uint32_t rgb = rLayout.has(RGB) ? rLayout.packedColor(record) : 0;
+            cloud.add(rLayout, values, rgb);
+        }
+    }
+};
+
+/** Collects the points of the parts in the order of the file. */
+class PointCollector
+{
+public:
+    PointCollector(PointKernel& kernel, PointAttributes* attributes, const Layout& layout)
+      : kernel(kernel), points(kernel.getBasicPoints()), attributes(attributes), layout(layout)
+    {
+        kernel.clear();
+        if (attributes) {
+            attributes->intensity.clear();
+            attributes->colors.clear();
+            attributes->normals.clear();
+        }
+    }
+    void reserve(std::size_t n)
+    {
+        points.reserve(n);
+        if (attributes) {
+            if (layout.has(Intensity))
+                attributes->intensity.reserve(n);
+            if (layout.hasColor())
+                attributes->colors.reserve(n);
+            if (layout.hasNormal())
+                attributes->normals.reserve(n);
+        }
+    }
+    std::size_t size() const
+    {
+        return points.size();
+    }
+    void append(const Cloud& cloud)
+    {
+        points.insert(points.end(), cloud.points.begin(), cloud.points.end());
+        if (attributes) {
+            attributes->intensity.insert(attributes->intensity.end(), cloud.intensity.begin(), cloud.intensity.end());
+            attributes->colors.insert(attributes->colors.end(), cloud.colors.begin(), cloud.colors.end());
+            attributes->normals.insert(attributes->normals.end(), cloud.normals.begin(), cloud.normals.end());
+        }
+    }
+    /** Removes the points behind the first \a n points and maps the colors to [0,1]. */
+    void finish(std::size_t n)
+    {
+        if (n < points.size())
+            points.resize(n);
+
+        // the points are appended without the transformation of the kernel
+        Base::Matrix4D mat = kernel.getTransform();
+        if (mat != Base::Matrix4D()) {
+            mat.inverse();
+            for (std::vector<Base::Vector3f>::iterator it = points.begin(); it != points.end(); ++it) {
+                Base::Vector3d p = mat * Base::Vector3d(it->x, it->y, it->z);
+                it->Set((float)p.x, (float)p.y, (float)p.z);
+            }
+        }
+
+        if (!attributes)
+            return;
+        if (n < attributes->intensity.size())
+            attributes->intensity.resize(n);
+        if (n < attributes->normals.size())
+            attributes->normals.resize(n);
+        std::vector<App::Color>& colors = attributes->colors;
+        if (n < colors.size())
+            colors.resize(n);
+
+        float scale = layout.colorScale;
+        if (scale == 0.0f) {
+            scale = 1.0f;
+            for (std::vector<App::Color>::iterator it = colors.begin(); it != colors.end(); ++it) {
+                if (it->r > 1.0f || it->g > 1.0f || it->b > 1.0f) {
+                    scale = 1.0f / 255.0f;
+                    break;
+                }
+            }
+        }
+        if (scale != 1.0f) {
+            for (std::vector<App::Color>::iterator it = colors.begin(); it != colors.end(); ++it) {
+                it->r *= scale;
+                it->g *= scale;
+                it->b *= scale;
+            }
+        }
+    }
+
+private:
+    PointKernel& kernel;
+    std::vector<Base::Vector3f>& points;
+    PointAttributes* attributes;
+    const Layout& layout;
+};
+
+const std::size_t blockSize = 16 * 1024 * 1024;
+const std::size_t minPartSize = 256 * 1024;
+
+std::streamoff remainingSize(std::istream& str)
+{
+    std::streambuf* buf = str.rdbuf();
+    std::streamoff pos = buf->pubseekoff(0, std::ios::cur, std::ios::in);
+    std::streamoff end = buf->pubseekoff(0, std::ios::end, std::ios::in);
+    buf->pubseekoff(pos, std::ios::beg, std::ios::in);
+    return (pos < 0 || end < pos) ? 0 : end - pos;
+}
+
+/** Reads the lines of an ASCII stream from its current position in blocks. The lines of
+ * a block are parsed by several threads while the points are appended in the order of
+ * the file. Stops after \a maxPoints points.
+ */
+void readAscii(std::istream& str, const Layout& layout, std::size_t maxPoints, PointCollector& collector)
+{
+    std::streamoff size = remainingSize(str);
+    Base::SequencerLauncher seq("Loading points...", size / blockSize + 1);
+
+    const int numThreads = std::max<int>(1, QThread::idealThreadCount());
+    std::vector<char> buffer(std::min<std::streamoff>(size + 1, blockSize));
+    std::size_t filled = 0;
+    bool initialized = false;
+    while (collector.size() < maxPoints) {
+        str.read(&buffer[filled], buffer.size() - filled);
+        std::size_t count = static_cast<std::size_t>(str.gcount());
+        bool eof = (filled + count < buffer.size());
+        filled += count;
+        if (filled == 0)
+            break;
+
+        // the block must end with a complete line
+        std::size_t length = filled;
+        if (!eof) {
+            const char* last = &buffer[0] + filled;
+            while (last > &buffer[0] && last[-1] != '\n')
+                --last;
+            if (last == &buffer[0]) {
+                // a line that doesn't fit into the buffer
+                buffer.resize(2 * buffer.size());
+                continue;
+            }
+            length = last - &buffer[0];
+        }
+
+        // split the block into parts of complete lines
+        std::size_t numParts = std::max<std::size_t>(1, std::min<std::size_t>(numThreads, length / minPartSize));
+        std::vector<AsciiPart> parts(numParts);
+        const char* begin = &buffer[0];
+        const char* end = begin + length;
+        const char* p = begin;
+        for (std::size_t i = 0; i < numParts; i++) {
+            const char* q = (i + 1 == numParts) ? end : begin + (i + 1) * length / numParts;
+            if (q < p)
+                q = p;
+            const char* eol = static_cast<const char*>(memchr(q, '\n', end - q));
+            q = (eol && i + 1 < numParts) ? eol + 1 : end;
+            parts[i].begin = p;
+            parts[i].end = q;
+            parts[i].layout = &layout;
+            p = q;
+        }
+        if (numParts > 1)
+            QtConcurrent::map(parts, &AsciiPart::Parse).waitForFinished();
+        else
+            parts[0].Parse();
+
+        for (std::size_t i = 0; i < numParts; i++) {
+            if (!initialized) {
+                // estimate the number of points from the first block
+                double pointsPerByte = double(parts[i].cloud.points.size()) / double(length);
+                collector.reserve(std::min<std::size_t>(maxPoints, std::size_t(pointsPerByte * size * 1.05)));
+                initialized = true;
+            }
+            collector.append(parts[i].cloud);
+        }
+
+        filled -= length;
+        std::memmove(&buffer[0], &buffer[0] + length, filled);
+        seq.next(true); // allow to cancel
+        if (eof)
+            break;
+    }
+
+    collector.finish(maxPoints);
+}
+
+/** Reads \a numPoints binary records from the current position of a stream in blocks
+ * that are decoded by several threads.
+ */
+void readBinary(std::istream& str, const Layout& layout, std::size_t numPoints, PointCollector& collector)
+{
+    const std::size_t recordsPerBlock = std::max<std::size_t>(1, blockSize / layout.recordSize);
+    Base::SequencerLauncher seq("Loading points...", numPoints / recordsPerBlock + 1);
+
+    const int numThreads = std::max<int>(1, QThread::idealThreadCount());
+    std::vector<char> buffer(std::min(numPoints, recordsPerBlock) * layout.recordSize);
+    collector.reserve(numPoints);
+    for (std::size_t done = 0; done < numPoints;) {
+        std::size_t count = std::min(numPoints - done, recordsPerBlock);
+        str.read(&buffer[0], count * layout.recordSize);
+        // ignore a truncated record at the end of the file
+        count = static_cast<std::size_t>(str.gcount()) / layout.recordSize;
+        if (count == 0)
+            break;
+
+        std::size_t numParts = std::max<std::size_t>(1, std::min<std::size_t>(numThreads,
+            count * layout.recordSize / minPartSize));
+        std::vector<BinaryPart> parts(numParts);
+        for (std::size_t i = 0; i < numParts; i++) {
+            std::size_t first = i * count / numParts;
+            parts[i].begin = &buffer[0] + first * layout.recordSize;
+            parts[i].count = (i + 1) * count / numParts - first;
+            parts[i].layout = &layout;
+        }
+        if (numParts > 1)
+            QtConcurrent::map(parts, &BinaryPart::Decode).waitForFinished();
+        else
+            parts[0].Decode();
+
+        for (std::size_t i = 0; i < numParts; i++)
+            collector.append(parts[i].cloud);
+        done += count;
+        seq.next(true); // allow to cancel
+    }
+
+    collector.finish(numPoints);
+}
+
+/** Calls the reader and clears the points if it fails. */
+template <class Reader>
+void readPoints(Reader reader, std::istream& str, const Layout& layout, std::size_t numPoints,
+                PointKernel& points, PointAttributes* attributes)
+{
+    try {
+        PointCollector collector(points, attributes, layout);
+        reader(str, layout, numPoints, collector);
+    }
+    catch (const Base::AbortException&) {
+        points.clear();
+        throw;
+    }
+    catch (...) {
+        points.clear();
+        throw Base::Exception("Reading in points failed.");
+    }
+}
+
+bool parseValueType(const std::string& name, ValueType& type)
+{
+    if (name == "char" || name == "int8")
+        type = Int8;
+    else if (name == "uchar" || name == "uint8")
+        type = UInt8;
+    else if (name == "short" || name == "int16")
+        type = Int16;
+    else if (name == "ushort" || name == "uint16")
+        type = UInt16;
+    else if (name == "int" || name == "int32")
+        type = Int32;
+    else if (name == "uint" || name == "uint32")
+        type = UInt32;
+    else if (name == "float" || name == "float32")
+        type = Float32;
+    else if (name == "double" || name == "float64")
+        type = Float64;
+    else
+        return false;
+    return true;
+}
+
+bool parsePcdType(char type, int size, ValueType& value)
+{
+    switch (type) {
+    case 'I':
+        value = (size == 1 ? Int8 : size == 2 ? Int16 : Int32);
+        return size == 1 || size == 2 || size == 4;
+    case 'U':
+        value = (size == 1 ? UInt8 : size == 2 ? UInt16 : UInt32);
+        return size == 1 || size == 2 || size == 4;
+    case 'F':
+        value = (size == 4 ? Float32 : Float64);
+        return size == 4 || size == 8;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+void PointsAlgos::Load(PointKernel &points, const char *FileName, PointAttributes* attributes)
 {
     Base::FileInfo File(FileName);
 
@@ -51,63 +538,238 @@ void PointsAlgos::Load(PointKernel &points, const char *FileName)
     if (!File.isReadable())
         throw Base::FileException("File to load not existing or not readable", FileName);
 
-    if (File.extension() == "asc" ||File.extension() == "ASC")
-        LoadAscii(points,FileName);
+    if (File.hasExtension("asc") || File.hasExtension("xyz") || File.hasExtension("pts"))
+        LoadAscii(points,FileName,attributes);
+    else if (File.hasExtension("ply"))
+        LoadPly(points,FileName,attributes);
+    else if (File.hasExtension("pcd"))
+        LoadPcd(points,FileName,attributes);
     else
         throw Base::Exception("Unknown ending");
 }
 
-void PointsAlgos::LoadAscii(PointKernel &points, const char *FileName)
+void PointsAlgos::LoadAscii(PointKernel &points, const char *FileName, PointAttributes* attributes)
 {
-    boost::regex rx("^\\s*([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                     "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                     "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)\\s*$");
-    //boost::regex rx("(\\b[0-9]+\\.([0-9]+\\b)?|\\.[0-9]+\\b)");
-    //boost::regex rx("^\\s*(-?[0-9]*)\\.([0-9]+)\\s+(-?[0-9]*)\\.([0-9]+)\\s+(-?[0-9]*)\\.([0-9]+)\\s*$");
-    boost::cmatch what;
-
-    Base::Vector3d pt;
-    int LineCnt=0;
-    std::string line;
     Base::FileInfo fi(FileName);
+    Base::ifstream file(fi, std::ios::in | std::ios::binary);
 
-    Base::ifstream tmp_str(fi, std::ios::in);
+    // decide the layout from the number of columns of the first line with a point
+    int numColumns = 0;
+    std::string line;
+    while (numColumns < 3 && std::getline(file, line)) {
+        const char* p = line.c_str();
+        const char* end = p + line.size();
+        double value;
+        for (numColumns = 0; parseFloat(p, end, value); numColumns++)
+            ;
+    }
+    file.clear();
+    file.seekg(0, std::ios::beg);
 
-    // estimating size
-    while (std::getline(tmp_str,line))
-        LineCnt++;
+    Layout layout;
+    layout.colorScale = 0.0f;
+    int column = 0;
+    layout.set(X, column++);
+    layout.set(Y, column++);
+    layout.set(Z, column++);
+    if (numColumns == 4 || numColumns == 7 || numColumns == 10)
+        layout.set(Intensity, column++);
+    if (numColumns >= 6 && numColumns != 8) {
+        layout.set(Red, column++);
+        layout.set(Green, column++);
+        layout.set(Blue, column++);
+    }
+    if (numColumns == 9 || numColumns == 10) {
+        layout.set(NX, column++);
+        layout.set(NY, column++);
+        layout.set(NZ, column++);
+    }
+    layout.setColumns();
 
-    // resize the PointKernel
-    points.resize(LineCnt);
+    readPoints(readAscii, file, layout, ~std::size_t(0), points, attributes);
+}
 
-    Base::SequencerLauncher seq( "Loading points...", LineCnt );
+void PointsAlgos::LoadPly(PointKernel &points, const char *FileName, PointAttributes* attributes)
+{
+    Base::FileInfo fi(FileName);
+    Base::ifstream file(fi, std::ios::in | std::ios::binary);
 
-    // again to the beginning
-    Base::ifstream file(fi, std::ios::in);
-    LineCnt = 0;
+    std::string line, format;
+    std::getline(file, line);
+    if (line.compare(0, 3, "ply") != 0)
+        throw Base::Exception("Not a PLY file");
 
-    try {
-        // read file
-        while (std::getline(file, line)) {
-            if (boost::regex_match(line.c_str(), what, rx)) {
-                pt.x = std::atof(what[1].first);
-                pt.y = std::atof(what[4].first);
-                pt.z = std::atof(what[7].first);
-
-                points.setPoint(LineCnt,pt);
-                seq.next();
-                LineCnt++;
+    Layout layout;
+    std::size_t numPoints = 0;
+    int numElements = 0;
+    int numColumns = 0;
+    bool inVertex = false;
+    while (std::getline(file, line)) {
+        std::istringstream str(line);
+        std::string kw;
+        str >> kw;
+        if (kw == "format") {
+            str >> format;
+        }
+        else if (kw == "element") {
+            std::string name;
+            str >> name;
+            inVertex = (name == "vertex");
+            if (inVertex) {
+                if (numElements > 0)
+                    throw Base::Exception("The vertices must be the first element of a PLY file");
+                str >> numPoints;
             }
+            numElements++;
+        }
+        else if (kw == "property" && inVertex) {
+            std::string type, name;
+            str >> type >> name;
+            ValueType t;
+            if (type == "list" || !parseValueType(type, t))
+                throw Base::Exception("Unsupported property type in PLY file");
+            Field f = NumFields;
+            if (name == "x")
+                f = X;
+            else if (name == "y")
+                f = Y;
+            else if (name == "z")
+                f = Z;
+            else if (name == "nx")
+                f = NX;
+            else if (name == "ny")
+                f = NY;
+            else if (name == "nz")
+                f = NZ;
+            else if (name == "red" || name == "diffuse_red")
+                f = Red;
+            else if (name == "green" || name == "diffuse_green")
+                f = Green;
+            else if (name == "blue" || name == "diffuse_blue")
+                f = Blue;
+            else if (name == "intensity" || name == "scalar_intensity")
+                f = Intensity;
+            if (f != NumFields)
+                layout.set(f, format == "ascii" ? numColumns : layout.recordSize, t);
+            numColumns++;
+            layout.recordSize += valueSize[t];
+        }
+        else if (kw == "end_header") {
+            break;
         }
     }
-    catch (...) {
-        points.clear();
-        throw Base::Exception("Reading in points failed.");
+
+    if (!layout.has(X) || !layout.has(Y) || !layout.has(Z))
+        throw Base::Exception("No vertex coordinates in PLY file");
+    layout.setColumns();
+
+    if (format == "ascii") {
+        readPoints(readAscii, file, layout, numPoints, points, attributes);
+    }
+    else if (format == "binary_little_endian" || format == "binary_big_endian") {
+        bool bigEndian = (format == "binary_big_endian");
+        layout.swapBytes = (bigEndian != (Base::SwapOrder() == HIGH_ENDIAN));
+        readPoints(readBinary, file, layout, numPoints, points, attributes);
+    }
+    else {
+        throw Base::Exception("Unknown format of PLY file");
+    }
+}
+
+void PointsAlgos::LoadPcd(PointKernel &points, const char *FileName, PointAttributes* attributes)
+{
+    Base::FileInfo fi(FileName);
+    Base::ifstream file(fi, std::ios::in | std::ios::binary);
+
+    std::vector<std::string> fields;
+    std::vector<int> sizes, counts;
+    std::vector<char> types;
+    std::string data;
+    std::size_t numPoints = 0;
+    std::string line;
+    while (data.empty() && std::getline(file, line)) {
+        std::istringstream str(line);
+        std::string kw;
+        str >> kw;
+        if (kw == "FIELDS") {
+            std::string name;
+            while (str >> name)
+                fields.push_back(name);
+        }
+        else if (kw == "SIZE") {
+            int size;
+            while (str >> size)
+                sizes.push_back(size);
+        }
+        else if (kw == "TYPE") {
+            char type;
+            while (str >> type)
+                types.push_back(type);
+        }
+        else if (kw == "COUNT") {
+            int count;
+            while (str >> count)
+                counts.push_back(count);
+        }
+        else if (kw == "POINTS") {
+            str >> numPoints;
+        }
+        else if (kw == "DATA") {
+            str >> data;
+        }
+    }
+
+    // COUNT is optional
+    if (counts.empty())
+        counts.resize(fields.size(), 1);
+    if (sizes.size() != fields.size() || types.size() != fields.size() || counts.size() != fields.size())
+        throw Base::Exception("Invalid header of PCD file");
+
+    Layout layout;
+    bool ascii = (data == "ascii");
+    int numColumns = 0;
+    for (std::size_t i = 0; i < fields.size(); i++) {
+        ValueType t;
+        if (!parsePcdType(types[i], sizes[i], t))
+            throw Base::Exception("Unsupported field type in PCD file");
+        const std::string& name = fields[i];
+        Field f = NumFields;
+        if (name == "x")
+            f = X;
+        else if (name == "y")
+            f = Y;
+        else if (name == "z")
+            f = Z;
+        else if (name == "normal_x")
+            f = NX;
+        else if (name == "normal_y")
+            f = NY;
+        else if (name == "normal_z")
+            f = NZ;
+        else if (name == "rgb" || name == "rgba")
+            f = RGB;
+        else if (name == "intensity")
+            f = Intensity;
+        if (f != NumFields)
+            layout.set(f, ascii ? numColumns : layout.recordSize, t);
+        numColumns += counts[i];
+        layout.recordSize += sizes[i] * counts[i];
     }
 
-    // now remove the last points from the kernel
-    // Note: first we allocate memory corresponding to the number of lines (points and comments)
-    //       and read in the file twice. But then the size of the kernel is too high
-    if (LineCnt < (int)points.size())
-        points.erase(LineCnt, points.size());
+    if (!layout.has(X) || !layout.has(Y) || !layout.has(Z))
+        throw Base::Exception("No point coordinates in PCD file");
+    layout.setColumns();
+
+    if (ascii) {
+        readPoints(readAscii, file, layout, numPoints, points, attributes);
+    }
+    else if (data == "binary") {
+        // the data is in the byte order of the machine that wrote the file, which is
+        // usually little endian
+        layout.swapBytes = (Base::SwapOrder() == HIGH_ENDIAN);
+        readPoints(readBinary, file, layout, numPoints, points, attributes);
+    }
+    else {
+        throw Base::Exception("Unsupported data format of PCD file");
+    }
 }
@@ -25,22 +25,50 @@
 #define _PointsAlgos_h_
 
 #include "Points.h"
+#include <App/Material.h>
 
 namespace Points
 {
 
+/** Additional data of the points of a cloud. A list is empty if a file doesn't
+ * contain the data, otherwise it has an entry for each point.
+ */
+struct PointsExport PointAttributes
+{
+  std::vector<float> intensity;
+  std::vector<App::Color> colors;
+  std::vector<Base::Vector3f> normals;
+};
+
 /** The Points algorithms container class
  */
 class PointsExport PointsAlgos
 {
 public:
-  /** Load a point cloud
+  /** Load a point cloud, the format is decided by the extension.
+   * If \a attributes is not null it gets the additional data of the points.
    */
-  static void Load(PointKernel&, const char *FileName);
-  /** Load a point cloud
+  static void Load(PointKernel&, const char *FileName, PointAttributes* attributes=0);
+  /** Load a point cloud from an ASCII file with a point per line.
+   * The meaning of the columns is decided by their number in the first line with
+   * at least three numbers:
+   * \li 3: x y z
+   * \li 4: x y z intensity
+   * \li 6: x y z r g b
+   * \li 7: x y z intensity r g b
+   * \li 9: x y z r g b nx ny nz
+   * \li 10: x y z intensity r g b nx ny nz
+   * Further columns are ignored. Lines with less numbers are skipped. The color values
+   * may be in the range [0,1] or [0,255].
+   * The file is read in blocks that are parsed by several threads.
    */
-  static void LoadAscii(PointKernel&, const char *FileName);
-
+  static void LoadAscii(PointKernel&, const char *FileName, PointAttributes* attributes=0);
+  /** Load the vertices of a PLY file in ASCII or binary format.
+   */
+  static void LoadPly(PointKernel&, const char *FileName, PointAttributes* attributes=0);
+  /** Load a PCD file of the Point Cloud Library in ASCII or binary format.
+   */
+  static void LoadPcd(PointKernel&, const char *FileName, PointAttributes* attributes=0);
 };
 
 } // namespace Points
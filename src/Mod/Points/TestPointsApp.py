@@ -0,0 +1,152 @@
+#***************************************************************************
+#*   (c) agent (agent[at]local) 2026                                       *
+#*                                                                         *
+#*   This file is part of the FreeCAD CAx development system.              *
+#*                                                                         *
+#*   This program is free software; you can redistribute it and/or modify  *
+#*   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#*   as published by the Free Software Foundation; either version 2 of     *
+#*   the License, or (at your option) any later version.                   *
+#*   for detail see the LICENCE text file.                                 *
+#*                                                                         *
+#*   FreeCAD is distributed in the hope that it will be useful,            *
+#*   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#*   GNU Library General Public License for more details.                  *
+#*                                                                         *
+#*   You should have received a copy of the GNU Library General Public     *
+#*   License along with FreeCAD; if not, write to the Free Software        *
+#*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#*   USA                                                                   *
+#*                                                                         *
+#***************************************************************************
+
+import FreeCAD, os, struct, tempfile, unittest, Points
+
+#---------------------------------------------------------------------------
+# define the test cases to test the point cloud loaders
+#---------------------------------------------------------------------------
+
+# the coordinates and colors of the small point clouds
+Coords = [(1.0,2.0,3.0), (-4.5,0.25,6.0), (0.0,-7.0,8.5)]
+Colors = [(255,128,0), (128,64,255), (255,255,255)]
+
+class PointsLoaderCases(unittest.TestCase):
+	def setUp(self):
+		self.Doc = FreeCAD.newDocument("PointsTest")
+		self.Files = []
+
+	def writeFile(self, name, data):
+		path = os.path.join(tempfile.gettempdir(), name)
+		f = open(path, "wb")
+		f.write(data)
+		f.close()
+		self.Files.append(path)
+		return path
+
+	def load(self, name, data):
+		Points.insert(self.writeFile(name, data), self.Doc.Name)
+		return self.Doc.Objects[-1]
+
+	def checkCoords(self, obj, coords):
+		points = obj.Points.Points
+		self.failUnless(len(points) == len(coords))
+		self.failUnless(obj.Points.CountPoints == len(coords))
+		for p, c in zip(points, coords):
+			self.failUnless((p - FreeCAD.Vector(*c)).Length < 1e-6)
+
+	def checkColors(self, obj, colors):
+		self.failUnless(len(obj.Color) == len(colors))
+		for c, e in zip(obj.Color, colors):
+			for i in range(3):
+				self.failUnless(abs(c[i] - e[i] / 255.0) < 1e-6)
+
+	def testAsciiPoints(self):
+		# comment lines and lines with too few numbers are skipped
+		data = "# x y z\n" + "".join(["%g %g %g\n" % c for c in Coords]) + "1 2\n"
+		obj = self.load("PointsTest.asc", data)
+		self.checkCoords(obj, Coords)
+		self.failUnless(not hasattr(obj, "Intensity"))
+		self.failUnless(not hasattr(obj, "Color"))
+
+	def testAsciiIntensity(self):
+		data = "".join(["%g %g %g %d\n" % (c + (i,)) for i, c in enumerate(Coords)])
+		obj = self.load("PointsTest.xyz", data)
+		self.checkCoords(obj, Coords)
+		self.failUnless(list(obj.Intensity) == [0.0, 1.0, 2.0])
+
+	def testAsciiColor(self):
+		# the colors are in [0,255] and are mapped to [0,1]
+		data = "".join(["%g %g %g %d %d %d\n" % (c + k) for c, k in zip(Coords, Colors)])
+		obj = self.load("PointsTest.pts", data)
+		self.checkCoords(obj, Coords)
+		self.checkColors(obj, Colors)
+
+	def testAsciiManyPoints(self):
+		# large enough to be split into several parts that are parsed in parallel
+		coords = [(i, 0.5 * i, -2.0 * i) for i in range(60000)]
+		data = "".join(["%d %g %g\n" % c for c in coords])
+		obj = self.load("PointsTest.asc", data)
+		self.checkCoords(obj, coords)
+
+	def testPlyAscii(self):
+		header = "ply\nformat ascii 1.0\ncomment test\nelement vertex 3\n" \
+		         "property float x\nproperty float y\nproperty float z\n" \
+		         "property uchar red\nproperty uchar green\nproperty uchar blue\n" \
+		         "element face 0\nproperty list uchar int vertex_indices\nend_header\n"
+		data = header + "".join(["%g %g %g %d %d %d\n" % (c + k) for c, k in zip(Coords, Colors)])
+		obj = self.load("PointsTest.ply", data)
+		self.checkCoords(obj, Coords)
+		self.checkColors(obj, Colors)
+
+	def testPlyBinary(self):
+		for fmt, order in (("binary_little_endian", "<"), ("binary_big_endian", ">")):
+			header = "ply\nformat %s 1.0\nelement vertex 3\n" \
+			         "property float x\nproperty float y\nproperty float z\n" \
+			         "property double intensity\nproperty uchar red\nproperty uchar green\n" \
+			         "property uchar blue\nend_header\n" % fmt
+			data = header + "".join([struct.pack(order + "fffdBBB", *(c + (i,) + k))
+			                         for i, (c, k) in enumerate(zip(Coords, Colors))])
+			obj = self.load("PointsTest.ply", data)
+			self.checkCoords(obj, Coords)
+			self.checkColors(obj, Colors)
+			self.failUnless(list(obj.Intensity) == [0.0, 1.0, 2.0])
+
+	def testPcdAscii(self):
+		header = "# .PCD v0.7\nVERSION 0.7\nFIELDS x y z normal_x normal_y normal_z\n" \
+		         "SIZE 4 4 4 4 4 4\nTYPE F F F F F F\nCOUNT 1 1 1 1 1 1\n" \
+		         "WIDTH 3\nHEIGHT 1\nPOINTS 3\nDATA ascii\n"
+		data = header + "".join(["%g %g %g 0 0 1\n" % c for c in Coords])
+		obj = self.load("PointsTest.pcd", data)
+		self.checkCoords(obj, Coords)
+		self.failUnless(len(obj.Normal) == 3)
+		for n in obj.Normal:
+			self.failUnless((n - FreeCAD.Vector(0,0,1)).Length < 1e-6)
+
+	def testPcdBinary(self):
+		# the color is packed into the bits of a float
+		header = "VERSION 0.7\nFIELDS x y z rgb\nSIZE 4 4 4 4\nTYPE F F F F\n" \
+		         "WIDTH 3\nHEIGHT 1\nPOINTS 3\nDATA binary\n"
+		data = header + "".join([struct.pack("<fffI", *(c + ((k[0] << 16) | (k[1] << 8) | k[2],)))
+		                         for c, k in zip(Coords, Colors)])
+		obj = self.load("PointsTest.pcd", data)
+		self.checkCoords(obj, Coords)
+		self.checkColors(obj, Colors)
+
+	def testPcdBinaryAlpha(self):
+		# with an alpha of 255 and a red in [128,191] the packed color is the bit
+		# pattern of a signalling NaN, which must not change when it is read
+		colors = [(160,16,32), (191,200,7), (128,0,255)]
+		header = "VERSION 0.7\nFIELDS x y z rgb\nSIZE 4 4 4 4\nTYPE F F F F\n" \
+		         "WIDTH 3\nHEIGHT 1\nPOINTS 3\nDATA binary\n"
+		data = header + "".join([struct.pack("<fffI", *(c + ((255 << 24) | (k[0] << 16) | (k[1] << 8) | k[2],)))
+		                         for c, k in zip(Coords, colors)])
+		obj = self.load("PointsTest.pcd", data)
+		self.checkCoords(obj, Coords)
+		self.checkColors(obj, colors)
+
+	def tearDown(self):
+		FreeCAD.closeDocument(self.Doc.Name)
+		for path in self.Files:
+			if os.path.exists(path):
+				os.remove(path)
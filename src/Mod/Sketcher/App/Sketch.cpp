@@ -35,6 +35,8 @@
 
 #include <Base/VectorPy.h>
 
+#include <App/Application.h>
+
 #include <Mod/Part/App/Geometry.h>
 #include <Mod/Part/App/GeometryCurvePy.h>
 #include <Mod/Part/App/ArcOfCirclePy.h>
@@ -46,6 +48,9 @@
 #include <TopoDS_Edge.hxx>
 #include <BRepBuilderAPI_MakeWire.hxx>
 
+#include <QAtomicInt>
+#include <QtConcurrentMap>
+
 #include "Sketch.h"
 #include "Constraint.h"
 #include <math.h>
@@ -62,6 +67,9 @@ TYPESYSTEM_SOURCE(Sketcher::Sketch, Base::Persistence)
 Sketch::Sketch()
 : GCSsys(), ConstraintsCounter(0), isInitMove(false)
 {
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Sketcher");
+    isPortfolio = hGrp->GetBool("PortfolioSolving", false);
 }
 
 Sketch::~Sketch()
@@ -1604,6 +1612,58 @@ bool Sketch::updateGeometry()
 
 // solving ==========================================================
 
+namespace {
+// one solver of the portfolio, see Sketch::solve()
+struct SolverRun
+{
+    SolverRun() : sys(0), alg(GCS::DogLeg), isFine(true), stop(0), runs(0), index(0), ret(GCS::Failed) {}
+
+    GCS::System *sys;
+    GCS::Algorithm alg;
+    bool isFine;
+    QAtomicInt stop;
+    std::vector<SolverRun> *runs;
+    int index;
+    int ret;
+
+    void Solve()
+    {
+        ret = sys->solve(isFine, alg);
+        // the less preferred solvers are not needed any more
+        if (ret == GCS::Success) {
+            for (int i=index+1; i < int(runs->size()); i++)
+                (*runs)[i].stop.fetchAndStoreRelaxed(1);
+        }
+    }
+    int Result()
+    {
+        // an interrupted solver may have stopped anywhere, so it solves again from the start
+        if (stop != 0) {
+            stop = 0;
+            ret = sys->solve(isFine, alg);
+        }
+        return ret;
+    }
+};
+
+// detaches the system from the portfolio and deletes the copies, also if solving throws
+class SolverRunGuard
+{
+public:
+    SolverRunGuard(GCS::System &sys, std::vector<SolverRun> &runs) : sys(sys), runs(runs) {}
+    ~SolverRunGuard()
+    {
+        sys.setInterrupt(0);
+        for (int i=1; i < int(runs.size()); i++)
+            delete runs[i].sys;
+    }
+
+private:
+    GCS::System &sys;
+    std::vector<SolverRun> &runs;
+};
+}
+
 int Sketch::solve(void)
 {
 
@@ -1613,6 +1673,26 @@ int Sketch::solve(void)
         isFine = true;
     }
 
+    // In portfolio mode the DogLeg solver works on the system while the LevenbergMarquardt
+    // and BFGS solvers work on copies of it at the same time. The results are still used
+    // in the order of the loop below, so the first solver that is successful cancels only
+    // the solvers after it and the solution is the same as without portfolio mode.
+    std::vector<SolverRun> runs;
+    SolverRunGuard guard(GCSsys, runs);
+    if (isPortfolio && !isInitMove) {
+        const GCS::Algorithm algs[] = { GCS::DogLeg, GCS::LevenbergMarquardt, GCS::BFGS };
+        runs.resize(3);
+        for (int i=0; i < int(runs.size()); i++) {
+            runs[i].sys = (i == 0) ? &GCSsys : GCSsys.copy();
+            runs[i].alg = algs[i];
+            runs[i].isFine = isFine;
+            runs[i].runs = &runs;
+            runs[i].index = i;
+            runs[i].sys->setInterrupt(&runs[i].stop);
+        }
+        QtConcurrent::map(runs, &SolverRun::Solve).waitForFinished();
+    }
+
     int ret;
     bool valid_solution;
     for (int soltype=0; soltype < (isInitMove ? 1 : 4); soltype++) {
@@ -1621,15 +1701,15 @@ int Sketch::solve(void)
         case 0: // solving with the default DogLeg solver
                 // (or with SQP if we are in moving mode)
             solvername = isInitMove ? "SQP" : "DogLeg";
-            ret = GCSsys.solve(isFine, GCS::DogLeg);
+            ret = runs.empty() ? GCSsys.solve(isFine, GCS::DogLeg) : runs[0].Result();
             break;
         case 1: // solving with the LevenbergMarquardt solver
             solvername = "LevenbergMarquardt";
-            ret = GCSsys.solve(isFine, GCS::LevenbergMarquardt);
+            ret = runs.empty() ? GCSsys.solve(isFine, GCS::LevenbergMarquardt) : runs[1].Result();
             break;
         case 2: // solving with the BFGS solver
             solvername = "BFGS";
-            ret = GCSsys.solve(isFine, GCS::BFGS);
+            ret = runs.empty() ? GCSsys.solve(isFine, GCS::BFGS) : runs[2].Result();
             break;
         case 3: // last resort: augment the system with a second subsystem and use the SQP solver
             solvername = "SQP(augmented system)";
@@ -1646,7 +1726,10 @@ int Sketch::solve(void)
 
         // if successfully solved try to write the parameters back
         if (ret == GCS::Success) {
-            GCSsys.applySolution();
+            if (soltype > 0 && soltype < 3 && !runs.empty())
+                GCSsys.applySolution(*runs[soltype].sys);
+            else
+                GCSsys.applySolution();
             valid_solution = updateGeometry();
             if (!valid_solution) {
                 GCSsys.undoSolution();
@@ -49,7 +49,13 @@ public:
     virtual void Save(Base::Writer &/*writer*/) const;
     virtual void Restore(Base::XMLReader &/*reader*/);
 
-    /// solve the actual set up sketch
+    /** solve the actual set up sketch
+      *
+      * The DogLeg, LevenbergMarquardt and BFGS solvers are tried one after another until
+      * one of them finds a valid solution. If the user parameter "PortfolioSolving" of the
+      * Sketcher is set they solve the sketch at the same time instead, the result is the
+      * same as in the sequential case.
+      */
     int solve(void);
     /// delete all geometry and constraints, leave an empty sketch
     void clear(void);
@@ -218,6 +224,7 @@ protected:
 
     bool isInitMove;
     bool isFine;
+    bool isPortfolio;
 
 private:
     /// retrieves the index of a point
@@ -51,6 +51,17 @@ void Constraint::revertParams()
     pvec = origpvec;
 }
 
+void Constraint::replaceParams(const MAP_pD_pD &replacementmap)
+{
+    for (VEC_pD::iterator param=origpvec.begin();
+         param != origpvec.end(); ++param) {
+        MAP_pD_pD::const_iterator it = replacementmap.find(*param);
+        if (it != replacementmap.end())
+            *param = it->second;
+    }
+    pvec = origpvec;
+}
+
 ConstraintType Constraint::getTypeId()
 {
     return None;
@@ -63,6 +63,8 @@ namespace GCS
 
         void redirectParams(MAP_pD_pD redirectionmap);
         void revertParams();
+        // unlike redirectParams() the replacement is permanent, used to copy constraints
+        void replaceParams(const MAP_pD_pD &replacementmap);
         void setTag(int tagId) { tag = tagId; }
         int getTag() { return tag; }
 
@@ -26,15 +26,56 @@
 #include "GCS.h"
 #include "qp_eq.h"
 #include <Eigen/QR>
+#ifdef FREEGCS_SPARSE
+# include <Eigen/SparseCholesky>
+# include <Eigen/SparseQR>
+# include <Eigen/OrderingMethods>
+#endif
 
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/connected_components.hpp>
 
+#include <QAtomicInt>
+
 namespace GCS
 {
 
 typedef boost::adjacency_list <boost::vecS, boost::vecS, boost::undirectedS> Graph;
 
+// creates a (shallow) copy of a constraint, the copy refers to the same parameters
+static Constraint *copyConstraint(Constraint *constr)
+{
+    switch (constr->getTypeId()) {
+        case Equal:
+            return new ConstraintEqual(*static_cast<ConstraintEqual *>(constr));
+        case Difference:
+            return new ConstraintDifference(*static_cast<ConstraintDifference *>(constr));
+        case P2PDistance:
+            return new ConstraintP2PDistance(*static_cast<ConstraintP2PDistance *>(constr));
+        case P2PAngle:
+            return new ConstraintP2PAngle(*static_cast<ConstraintP2PAngle *>(constr));
+        case P2LDistance:
+            return new ConstraintP2LDistance(*static_cast<ConstraintP2LDistance *>(constr));
+        case PointOnLine:
+            return new ConstraintPointOnLine(*static_cast<ConstraintPointOnLine *>(constr));
+        case PointOnPerpBisector:
+            return new ConstraintPointOnPerpBisector(*static_cast<ConstraintPointOnPerpBisector *>(constr));
+        case Parallel:
+            return new ConstraintParallel(*static_cast<ConstraintParallel *>(constr));
+        case Perpendicular:
+            return new ConstraintPerpendicular(*static_cast<ConstraintPerpendicular *>(constr));
+        case L2LAngle:
+            return new ConstraintL2LAngle(*static_cast<ConstraintL2LAngle *>(constr));
+        case MidpointOnLine:
+            return new ConstraintMidpointOnLine(*static_cast<ConstraintMidpointOnLine *>(constr));
+        case TangentCircumf:
+            return new ConstraintTangentCircumf(*static_cast<ConstraintTangentCircumf *>(constr));
+        case None:
+        default:
+            return 0;
+    }
+}
+
 ///////////////////////////////////////
 // Solver
 ///////////////////////////////////////
@@ -45,7 +86,8 @@ System::System()
   c2p(), p2c(),
   subSystems(0), subSystemsAux(0),
   reference(0),
-  hasUnknowns(false), hasDiagnosis(false), isInit(false)
+  hasUnknowns(false), hasDiagnosis(false), isInit(false),
+  jacobianType(AutoJacobian), interrupt(0)
 {
 }
 
@@ -54,66 +96,13 @@ System::System(std::vector<Constraint *> clist_)
   c2p(), p2c(),
   subSystems(0), subSystemsAux(0),
   reference(0),
-  hasUnknowns(false), hasDiagnosis(false), isInit(false)
+  hasUnknowns(false), hasDiagnosis(false), isInit(false),
+  jacobianType(AutoJacobian), interrupt(0)
 {
     // create own (shallow) copy of constraints
     for (std::vector<Constraint *>::iterator constr=clist_.begin();
          constr != clist_.end(); ++constr) {
-        Constraint *newconstr;
-        switch ((*constr)->getTypeId()) {
-            case Equal: {
-                ConstraintEqual *oldconstr = static_cast<ConstraintEqual *>(*constr);
-                newconstr = new ConstraintEqual(*oldconstr);
-                break;
-            }
-            case Difference: {
-                ConstraintDifference *oldconstr = static_cast<ConstraintDifference *>(*constr);
-                newconstr = new ConstraintDifference(*oldconstr);
-                break;
-            }
-            case P2PDistance: {
-                ConstraintP2PDistance *oldconstr = static_cast<ConstraintP2PDistance *>(*constr);
-                newconstr = new ConstraintP2PDistance(*oldconstr);
-                break;
-            }
-            case P2PAngle: {
-                ConstraintP2PAngle *oldconstr = static_cast<ConstraintP2PAngle *>(*constr);
-                newconstr = new ConstraintP2PAngle(*oldconstr);
-                break;
-            }
-            case P2LDistance: {
-                ConstraintP2LDistance *oldconstr = static_cast<ConstraintP2LDistance *>(*constr);
-                newconstr = new ConstraintP2LDistance(*oldconstr);
-                break;
-            }
-            case PointOnLine: {
-                ConstraintPointOnLine *oldconstr = static_cast<ConstraintPointOnLine *>(*constr);
-                newconstr = new ConstraintPointOnLine(*oldconstr);
-                break;
-            }
-            case Parallel: {
-                ConstraintParallel *oldconstr = static_cast<ConstraintParallel *>(*constr);
-                newconstr = new ConstraintParallel(*oldconstr);
-                break;
-            }
-            case Perpendicular: {
-                ConstraintPerpendicular *oldconstr = static_cast<ConstraintPerpendicular *>(*constr);
-                newconstr = new ConstraintPerpendicular(*oldconstr);
-                break;
-            }
-            case L2LAngle: {
-                ConstraintL2LAngle *oldconstr = static_cast<ConstraintL2LAngle *>(*constr);
-                newconstr = new ConstraintL2LAngle(*oldconstr);
-                break;
-            }
-            case MidpointOnLine: {
-                ConstraintMidpointOnLine *oldconstr = static_cast<ConstraintMidpointOnLine *>(*constr);
-                newconstr = new ConstraintMidpointOnLine(*oldconstr);
-                break;
-            }
-            case None:
-                break;
-        }
+        Constraint *newconstr = copyConstraint(*constr);
         if (newconstr)
             addConstraint(newconstr);
     }
@@ -722,6 +711,59 @@ void System::initSolution()
     isInit = true;
 }
 
+System *System::copy()
+{
+    System *sys = new System(clist);
+    sys->jacobianType = jacobianType;
+
+    // The subsystems order their parameters by address, so the copied unknowns are stored
+    // in the order of the addresses of the original ones. Then the copy solves the same
+    // equations in the same order and finds exactly the same solution as this system.
+    VEC_pD sorted(plist);
+    std::sort(sorted.begin(), sorted.end());
+    sys->ownParams.resize(sorted.size());
+    MAP_pD_pD replacementmap;
+    for (int i=0; i < int(sorted.size()); ++i) {
+        int index = pIndex[sorted[i]];
+        sys->ownParams[i] = reference.size() == plist.size() ? reference[index] : *sorted[i];
+        replacementmap[sorted[i]] = &sys->ownParams[i];
+    }
+
+    VEC_pD params(plist.size());
+    for (int i=0; i < int(plist.size()); ++i)
+        params[i] = replacementmap[plist[i]];
+    for (std::vector<Constraint *>::iterator constr=sys->clist.begin();
+         constr != sys->clist.end(); ++constr)
+        (*constr)->replaceParams(replacementmap);
+    sys->c2p.clear();
+    sys->p2c.clear();
+    for (std::vector<Constraint *>::iterator constr=sys->clist.begin();
+         constr != sys->clist.end(); ++constr) {
+        VEC_pD constr_params = (*constr)->params();
+        for (VEC_pD::const_iterator param=constr_params.begin();
+             param != constr_params.end(); ++param) {
+            sys->c2p[*constr].push_back(*param);
+            sys->p2c[*param].push_back(*constr);
+        }
+    }
+    sys->declareUnknowns(params);
+
+    // take over the diagnosis instead of repeating it
+    if (hasDiagnosis) {
+        for (int i=0; i < int(clist.size()); ++i)
+            if (redundant.count(clist[i]))
+                sys->redundant.insert(sys->clist[i]);
+        sys->dofs = dofs;
+        sys->conflictingTags = conflictingTags;
+        sys->redundantTags = redundantTags;
+        sys->hasDiagnosis = true;
+    }
+
+    if (isInit)
+        sys->initSolution();
+    return sys;
+}
+
 void System::setReference()
 {
     reference.clear();
@@ -780,14 +822,33 @@ int System::solve(bool isFine, Algorithm alg)
     return res;
 }
 
+bool System::useSparse(int paramsNum) const
+{
+#ifdef FREEGCS_SPARSE
+    if (jacobianType == SparseJacobian)
+        return true;
+    if (jacobianType == AutoJacobian)
+        return paramsNum >= SparseThreshold;
+#endif
+    return false;
+}
+
 int System::solve(SubSystem *subsys, bool isFine, Algorithm alg)
 {
+#ifdef FREEGCS_SPARSE
+    if (alg != BFGS && useSparse(subsys->pSize())) {
+        if (alg == LevenbergMarquardt)
+            return solve_LM< Eigen::SparseMatrix<double> >(subsys);
+        else if (alg == DogLeg)
+            return solve_DL< Eigen::SparseMatrix<double> >(subsys);
+    }
+#endif
     if (alg == BFGS)
         return solve_BFGS(subsys, isFine);
     else if (alg == LevenbergMarquardt)
-        return solve_LM(subsys);
+        return solve_LM<Eigen::MatrixXd>(subsys);
     else if (alg == DogLeg)
-        return solve_DL(subsys);
+        return solve_DL<Eigen::MatrixXd>(subsys);
 }
 
 int System::solve_BFGS(SubSystem *subsys, bool isFine)
@@ -829,6 +890,8 @@ int System::solve_BFGS(SubSystem *subsys, bool isFine)
             break;
         if (err > divergingLim || err != err) // check for diverging and NaN
             break;
+        if (isInterrupted())
+            break;
 
         y = grad;
         subsys->calcGrad(grad);
@@ -865,6 +928,77 @@ int System::solve_BFGS(SubSystem *subsys, bool isFine)
     return Failed;
 }
 
+// Linear solvers used by solve_LM() and solve_DL() for the dense and the sparse jacobi matrix
+
+// solves the augmented normal equations A*h=g
+static void solveNormalEquations(const Eigen::MatrixXd &A, const Eigen::VectorXd &g, Eigen::VectorXd &h)
+{
+    h = A.fullPivLu().solve(g);
+}
+
+// computes the gauss-newton step h of J*h=-f
+static void solveGaussNewton(const Eigen::MatrixXd &J, const Eigen::VectorXd &f, Eigen::VectorXd &h)
+{
+    h = J.fullPivLu().solve(-f);
+}
+
+#ifdef FREEGCS_SPARSE
+typedef Eigen::SparseQR< Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int> > SparseQR;
+typedef Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> PermutationMatrix;
+
+// Computes the QR decomposition of rowsPerm*A. SparseQR only permutes the columns but the fill-in
+// of Q and R strongly depends on the order of the rows, e.g. the jacobi matrix of a long chain of
+// lines may take seconds instead of milliseconds. As SuiteSparseQR does, the rows are therefore
+// sorted by the position of their leftmost non zero entry in the column ordering.
+static bool sparseQR(const Eigen::SparseMatrix<double> &A, SparseQR &qr, PermutationMatrix &rowsPerm)
+{
+    PermutationMatrix colsPerm;
+    Eigen::COLAMDOrdering<int> ordering;
+    ordering(A, colsPerm);
+
+    std::vector<int> colPos(A.cols());
+    for (int j=0; j < int(A.cols()); j++)
+        colPos[colsPerm.indices()[j]] = j;
+    std::vector< std::pair<int,int> > leftmost(A.rows()); // (leftmost column, row)
+    for (int i=0; i < int(A.rows()); i++)
+        leftmost[i] = std::make_pair(int(A.cols()), i);
+    for (int j=0; j < int(A.outerSize()); j++)
+        for (Eigen::SparseMatrix<double>::InnerIterator it(A,j); it; ++it)
+            leftmost[it.row()].first = std::min(leftmost[it.row()].first, colPos[j]);
+    std::sort(leftmost.begin(), leftmost.end());
+
+    rowsPerm.resize(A.rows());
+    for (int i=0; i < int(A.rows()); i++)
+        rowsPerm.indices()[leftmost[i].second] = i;
+
+    Eigen::SparseMatrix<double> PA = rowsPerm * A;
+    PA.makeCompressed();
+    qr.compute(PA);
+    return qr.info() == Eigen::Success;
+}
+
+static void solveNormalEquations(const Eigen::SparseMatrix<double> &A, const Eigen::VectorXd &g, Eigen::VectorXd &h)
+{
+    // once augmented A is symmetric positive definite
+    Eigen::SimplicialLDLT< Eigen::SparseMatrix<double> > ldlt(A);
+    if (ldlt.info() == Eigen::Success)
+        h = ldlt.solve(g);
+    else
+        h.setZero(); // let the caller reject the step
+}
+
+static void solveGaussNewton(const Eigen::SparseMatrix<double> &J, const Eigen::VectorXd &f, Eigen::VectorXd &h)
+{
+    SparseQR qr;
+    PermutationMatrix rowsPerm;
+    if (sparseQR(J, qr, rowsPerm))
+        h = qr.solve(rowsPerm * (-f));
+    else
+        h.setZero();
+}
+#endif
+
+template <typename Jacobian>
 int System::solve_LM(SubSystem* subsys)
 {
     int xsize = subsys->pSize();
@@ -874,8 +1008,8 @@ int System::solve_LM(SubSystem* subsys)
         return Success;
 
     Eigen::VectorXd e(csize), e_new(csize); // vector of all function errors (every constraint is one function)
-    Eigen::MatrixXd J(csize, xsize);        // Jacobi of the subsystem
-    Eigen::MatrixXd A(xsize, xsize);
+    Jacobian J(csize, xsize);               // Jacobi of the subsystem
+    Jacobian A(xsize, xsize);
     Eigen::VectorXd x(xsize), h(xsize), x_new(xsize), g(xsize), diag_A(xsize);
 
     subsys->redirectParams();
@@ -903,6 +1037,10 @@ int System::solve_LM(SubSystem* subsys)
             stop = 6;
             break;
         }
+        else if (isInterrupted()) {
+            stop = 8;
+            break;
+        }
 
         // J^T J, J^T e
         subsys->calcJacobi(J);;
@@ -929,10 +1067,10 @@ int System::solve_LM(SubSystem* subsys)
         while (k < 50) {
             // augment normal equations A = A+uI
             for (int i=0; i < xsize; ++i)
-                A(i,i) += mu;
+                A.coeffRef(i,i) += mu;
 
             //solve augmented functions A*h=-g
-            h = A.fullPivLu().solve(g);
+            solveNormalEquations(A, g, h);
             double rel_error = (A*h - g).norm() / g.norm();
 
             // check if solving works
@@ -981,7 +1119,7 @@ int System::solve_LM(SubSystem* subsys)
             mu*=nu;
             nu*=2.0;
             for (int i=0; i < xsize; ++i) // restore diagonal J^T J entries
-                A(i,i) = diag_A(i);
+                A.coeffRef(i,i) = diag_A(i);
 
             k++;
         }
@@ -1000,6 +1138,7 @@ int System::solve_LM(SubSystem* subsys)
 }
 
 
+template <typename Jacobian>
 int System::solve_DL(SubSystem* subsys)
 {
     double tolg=1e-80, tolx=1e-80, tolf=1e-10;
@@ -1012,7 +1151,7 @@ int System::solve_DL(SubSystem* subsys)
 
     Eigen::VectorXd x(xsize), x_new(xsize);
     Eigen::VectorXd fx(csize), fx_new(csize);
-    Eigen::MatrixXd Jx(csize, xsize), Jx_new(csize, xsize);
+    Jacobian Jx(csize, xsize), Jx_new(csize, xsize);
     Eigen::VectorXd g(xsize), h_sd(xsize), h_gn(xsize), h_dl(xsize);
 
     subsys->redirectParams();
@@ -1049,13 +1188,15 @@ int System::solve_DL(SubSystem* subsys)
         else if (err > divergingLim || err != err) { // check for diverging and NaN
             stop = 6;
         }
+        else if (isInterrupted())
+            stop = 8;
         else {
             // get the steepest descent direction
             alpha = g.squaredNorm()/(Jx*g).squaredNorm();
             h_sd  = alpha*g;
 
             // get the gauss-newton step
-            h_gn = Jx.fullPivLu().solve(-fx);
+            solveGaussNewton(Jx, fx, h_gn);
             double rel_error = (Jx*h_gn + fx).norm() / fx.norm();
             if (rel_error > 1e15)
                 break;
@@ -1296,6 +1437,8 @@ int System::solve(SubSystem *subsysA, SubSystem *subsysB, bool isFine)
             break;
         if (err > divergingLim || err != err) // check for diverging and NaN
             break;
+        if (isInterrupted())
+            break;
     }
 
     int ret;
@@ -1325,6 +1468,20 @@ void System::applySolution()
     }
 }
 
+void System::applySolution(System &sys)
+{
+    sys.applySolution();
+    if (sys.plist.size() == plist.size()) {
+        for (int i=0; i < int(plist.size()); ++i)
+            *plist[i] = *sys.plist[i];
+    }
+}
+
+bool System::isInterrupted() const
+{
+    return interrupt && *interrupt != 0;
+}
+
 void System::undoSolution()
 {
     resetToReference();
@@ -1351,56 +1508,18 @@ int System::diagnose()
     redundant.clear();
     conflictingTags.clear();
     redundantTags.clear();
-    Eigen::MatrixXd J(clist.size(), plist.size());
-    int count=0;
-    for (std::vector<Constraint *>::iterator constr=clist.begin();
-         constr != clist.end(); ++constr) {
-        (*constr)->revertParams();
-        if ((*constr)->getTag() >= 0) {
-            count++;
-            for (int j=0; j < int(plist.size()); j++)
-                J(count-1,j) = (*constr)->grad(plist[j]);
-        }
-    }
 
-    if (J.rows() > 0) {
-        Eigen::FullPivHouseholderQR<Eigen::MatrixXd> qrJT(J.topRows(count).transpose());
-        Eigen::MatrixXd Q = qrJT.matrixQ ();
-        int paramsNum = qrJT.rows();
-        int constrNum = qrJT.cols();
-        int rank = qrJT.rank();
-
-        Eigen::MatrixXd R;
-        if (constrNum >= paramsNum)
-            R = qrJT.matrixQR().triangularView<Eigen::Upper>();
+    if (clist.size() > 0) {
+        int paramsNum, constrNum, rank;
+        std::vector< std::vector<Constraint *> > conflictGroups;
+#ifdef FREEGCS_SPARSE
+        if (useSparse(plist.size()))
+            rank = decomposeSparse(conflictGroups, paramsNum, constrNum);
         else
-            R = qrJT.matrixQR().topRows(constrNum)
-                               .triangularView<Eigen::Upper>();
+#endif
+            rank = decomposeDense(conflictGroups, paramsNum, constrNum);
 
         if (constrNum > rank) { // conflicting or redundant constraints
-            for (int i=1; i < rank; i++) {
-                // eliminate non zeros above pivot
-                assert(R(i,i) != 0);
-                for (int row=0; row < i; row++) {
-                    if (R(row,i) != 0) {
-                        double coef=R(row,i)/R(i,i);
-                        R.block(row,i+1,1,constrNum-i-1) -= coef * R.block(i,i+1,1,constrNum-i-1);
-                        R(row,i) = 0;
-                    }
-                }
-            }
-            std::vector< std::vector<Constraint *> > conflictGroups(constrNum-rank);
-            for (int j=rank; j < constrNum; j++) {
-                for (int row=0; row < rank; row++) {
-                    if (fabs(R(row,j)) > 1e-10) {
-                        int origCol = qrJT.colsPermutation().indices()[row];
-                        conflictGroups[j-rank].push_back(clist[origCol]);
-                    }
-                }
-                int origCol = qrJT.colsPermutation().indices()[j];
-                conflictGroups[j-rank].push_back(clist[origCol]);
-            }
-
             // try to remove the conflicting constraints and solve the
             // system in order to check if the removed constraints were
             // just redundant but not really conflicting
@@ -1518,6 +1637,122 @@ int System::diagnose()
     return dofs;
 }
 
+int System::decomposeDense(std::vector< std::vector<Constraint *> > &conflictGroups,
+                           int &paramsNum, int &constrNum)
+{
+    Eigen::MatrixXd J(clist.size(), plist.size());
+    int count=0;
+    for (std::vector<Constraint *>::iterator constr=clist.begin();
+         constr != clist.end(); ++constr) {
+        (*constr)->revertParams();
+        if ((*constr)->getTag() >= 0) {
+            count++;
+            for (int j=0; j < int(plist.size()); j++)
+                J(count-1,j) = (*constr)->grad(plist[j]);
+        }
+    }
+
+    Eigen::FullPivHouseholderQR<Eigen::MatrixXd> qrJT(J.topRows(count).transpose());
+    paramsNum = qrJT.rows();
+    constrNum = qrJT.cols();
+    int rank = qrJT.rank();
+
+    Eigen::MatrixXd R;
+    if (constrNum >= paramsNum)
+        R = qrJT.matrixQR().triangularView<Eigen::Upper>();
+    else
+        R = qrJT.matrixQR().topRows(constrNum)
+                           .triangularView<Eigen::Upper>();
+
+    if (constrNum > rank) { // conflicting or redundant constraints
+        for (int i=1; i < rank; i++) {
+            // eliminate non zeros above pivot
+            assert(R(i,i) != 0);
+            for (int row=0; row < i; row++) {
+                if (R(row,i) != 0) {
+                    double coef=R(row,i)/R(i,i);
+                    R.block(row,i+1,1,constrNum-i-1) -= coef * R.block(i,i+1,1,constrNum-i-1);
+                    R(row,i) = 0;
+                }
+            }
+        }
+        conflictGroups.resize(constrNum-rank);
+        for (int j=rank; j < constrNum; j++) {
+            for (int row=0; row < rank; row++) {
+                if (fabs(R(row,j)) > 1e-10) {
+                    int origCol = qrJT.colsPermutation().indices()[row];
+                    conflictGroups[j-rank].push_back(clist[origCol]);
+                }
+            }
+            int origCol = qrJT.colsPermutation().indices()[j];
+            conflictGroups[j-rank].push_back(clist[origCol]);
+        }
+    }
+    return rank;
+}
+
+#ifdef FREEGCS_SPARSE
+int System::decomposeSparse(std::vector< std::vector<Constraint *> > &conflictGroups,
+                            int &paramsNum, int &constrNum)
+{
+    // assemble the transposed jacobi matrix, only the parameters of a constraint give non zeros
+    std::vector< Eigen::Triplet<double> > triplets;
+    int count=0;
+    for (std::vector<Constraint *>::iterator constr=clist.begin();
+         constr != clist.end(); ++constr) {
+        (*constr)->revertParams();
+        if ((*constr)->getTag() >= 0) {
+            VEC_pD constr_params_orig = (*constr)->params();
+            SET_pD constr_params(constr_params_orig.begin(), constr_params_orig.end());
+            for (SET_pD::const_iterator p=constr_params.begin();
+                 p != constr_params.end(); ++p) {
+                MAP_pD_I::const_iterator it = pIndex.find(*p);
+                if (it != pIndex.end())
+                    triplets.push_back(Eigen::Triplet<double>(it->second, count, (*constr)->grad(*p)));
+            }
+            count++;
+        }
+    }
+
+    paramsNum = plist.size();
+    constrNum = count;
+    if (count == 0)
+        return 0;
+
+    Eigen::SparseMatrix<double> JT(paramsNum, constrNum);
+    JT.setFromTriplets(triplets.begin(), triplets.end());
+
+    SparseQR qrJT;
+    PermutationMatrix rowsPerm; // permutes the parameters only, so R is not affected
+    if (!sparseQR(JT, qrJT, rowsPerm))
+        return decomposeDense(conflictGroups, paramsNum, constrNum);
+    int rank = qrJT.rank();
+
+    if (constrNum > rank) { // conflicting or redundant constraints
+        // the linearly dependent columns are moved to the end, i.e. R = [R11 R12] with the
+        // upper triangular R11 of size rank. The elimination done in decomposeDense() results
+        // in diag(R11)*R11^-1*R12 which is computed here column by column.
+        const Eigen::SparseMatrix<double> &R = qrJT.matrixR();
+        Eigen::SparseMatrix<double> R11 = R.topLeftCorner(rank, rank);
+        Eigen::VectorXd pivots = R11.diagonal();
+        conflictGroups.resize(constrNum-rank);
+        for (int j=rank; j < constrNum; j++) {
+            Eigen::VectorXd col = R.col(j);
+            Eigen::VectorXd coef = R11.triangularView<Eigen::Upper>().solve(col.head(rank));
+            for (int row=0; row < rank; row++) {
+                if (fabs(pivots(row)*coef(row)) > 1e-10) {
+                    int origCol = qrJT.colsPermutation().indices()[row];
+                    conflictGroups[j-rank].push_back(clist[origCol]);
+                }
+            }
+            int origCol = qrJT.colsPermutation().indices()[j];
+            conflictGroups[j-rank].push_back(clist[origCol]);
+        }
+    }
+    return rank;
+}
+#endif
+
 void System::clearSubSystems()
 {
     isInit = false;
@@ -25,6 +25,8 @@
 
 #include "SubSystem.h"
 
+class QAtomicInt;
+
 namespace GCS
 {
 
@@ -44,6 +46,12 @@ namespace GCS
         DogLeg = 2
     };
 
+    enum JacobianType {
+        AutoJacobian = 0,  // SparseJacobian from SparseThreshold parameters on, DenseJacobian below
+        DenseJacobian = 1,
+        SparseJacobian = 2 // falls back to DenseJacobian if Eigen is older than 3.2
+    };
+
     class System
     {
     // This is the main class. It holds all constraints and information
@@ -75,9 +83,23 @@ namespace GCS
         bool hasDiagnosis; // if dofs, conflictingTags, redundantTags are up to date
         bool isInit;       // if plists, clists, reductionmaps are up to date
 
+        JacobianType jacobianType;
+        bool useSparse(int paramsNum) const;
+
+        VEC_D ownParams;                // storage of the unknowns of a system created by copy()
+        const QAtomicInt *interrupt; // the solvers give up as soon as this flag is set
+        bool isInterrupted() const;
+
         int solve_BFGS(SubSystem *subsys, bool isFine);
-        int solve_LM(SubSystem *subsys);
-        int solve_DL(SubSystem *subsys);
+        template <typename Jacobian> int solve_LM(SubSystem *subsys);
+        template <typename Jacobian> int solve_DL(SubSystem *subsys);
+        // QR decomposition of the transposed jacobi matrix used by diagnose(), returns the rank
+        int decomposeDense(std::vector< std::vector<Constraint *> > &conflictGroups,
+                           int &paramsNum, int &constrNum);
+#ifdef FREEGCS_SPARSE
+        int decomposeSparse(std::vector< std::vector<Constraint *> > &conflictGroups,
+                            int &paramsNum, int &constrNum);
+#endif
     public:
         System();
         System(std::vector<Constraint *> clist_);
@@ -157,15 +179,29 @@ namespace GCS
         int addConstraintP2PSymmetric(Point &p1, Point &p2, Point &p, int tagId=0);
         void rescaleConstraint(int id, double coeff);
 
+        // selects the matrix type used by the LM and DogLeg solvers and by diagnose()
+        void setJacobianType(JacobianType type) { jacobianType = type; }
+        JacobianType getJacobianType() const { return jacobianType; }
+
         void declareUnknowns(VEC_pD &params);
         void initSolution();
 
+        // Returns a copy of the initialized system with own copies of the constraints and of the
+        // unknowns, which are set to the reference values. The copy can be solved in another
+        // thread at the same time as this system, the parameters that are not unknowns are
+        // shared and must not change meanwhile. The caller takes ownership of the copy.
+        System *copy();
+        // the solvers stop and fail when *flag is set, e.g. from another thread
+        void setInterrupt(const QAtomicInt *flag) { interrupt = flag; }
+
         int solve(bool isFine=true, Algorithm alg=DogLeg);
         int solve(VEC_pD &params, bool isFine=true, Algorithm alg=DogLeg);
         int solve(SubSystem *subsys, bool isFine=true, Algorithm alg=DogLeg);
         int solve(SubSystem *subsysA, SubSystem *subsysB, bool isFine=true);
 
         void applySolution();
+        // applies the solution of a system created by copy() to the unknowns of this system
+        void applySolution(System &sys);
         void undoSolution();
 
         int diagnose();
@@ -184,6 +220,11 @@ namespace GCS
     #define smallF            1e-20
     #define MaxIterations     100 //Note that the total number of iterations allowed is MaxIterations *xLength
 
+    ///////////////////////////////////////
+    // Sparse linear algebra parameters
+    ///////////////////////////////////////
+    #define SparseThreshold   100 // number of parameters from which on AutoJacobian uses sparse matrices
+
     ///////////////////////////////////////
     // Helper elements
     ///////////////////////////////////////
@@ -270,6 +270,24 @@ void SubSystem::calcJacobi(Eigen::MatrixXd &jacobi)
     calcJacobi(plist, jacobi);
 }
 
+#ifdef FREEGCS_SPARSE
+void SubSystem::calcJacobi(Eigen::SparseMatrix<double> &jacobi)
+{
+    // the columns of the jacobi matrix correspond to the entries of pvals
+    std::vector< Eigen::Triplet<double> > triplets;
+    for (int i=0; i < csize; i++) {
+        std::map<Constraint *,VEC_pD >::const_iterator c2pfind = c2p.find(clist[i]);
+        if (c2pfind != c2p.end())
+            for (VEC_pD::const_iterator p=c2pfind->second.begin();
+                 p != c2pfind->second.end(); ++p)
+                triplets.push_back(Eigen::Triplet<double>(i, int(*p - &pvals[0]),
+                                                          clist[i]->grad(*p)));
+    }
+    jacobi.resize(csize, psize);
+    jacobi.setFromTriplets(triplets.begin(), triplets.end());
+}
+#endif
+
 void SubSystem::calcGrad(VEC_pD &params, Eigen::VectorXd &grad)
 {
     assert(grad.size() == int(params.size()));
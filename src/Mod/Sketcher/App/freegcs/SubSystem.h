@@ -27,6 +27,10 @@
 #undef max
 
 #include <Eigen/Core>
+#if EIGEN_VERSION_AT_LEAST(3,2,0)
+# define FREEGCS_SPARSE // sparse QR decomposition is available since Eigen 3.2
+# include <Eigen/SparseCore>
+#endif
 #include "Constraints.h"
 
 namespace GCS
@@ -69,6 +73,10 @@ namespace GCS
         void calcResidual(Eigen::VectorXd &r, double &err);
         void calcJacobi(VEC_pD &params, Eigen::MatrixXd &jacobi);
         void calcJacobi(Eigen::MatrixXd &jacobi);
+#ifdef FREEGCS_SPARSE
+        // only the non zero entries given by the constraint to parameter adjacency are evaluated
+        void calcJacobi(Eigen::SparseMatrix<double> &jacobi);
+#endif
         void calcGrad(VEC_pD &params, Eigen::VectorXd &grad);
         void calcGrad(Eigen::VectorXd &grad);
 
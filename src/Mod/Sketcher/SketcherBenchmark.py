@@ -0,0 +1,166 @@
+#***************************************************************************
+#*   (c) agent (agent[at]local) 2026                                       *
+#*                                                                         *
+#*   This file is part of the FreeCAD CAx development system.              *
+#*                                                                         *
+#*   This program is free software; you can redistribute it and/or modify  *
+#*   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#*   as published by the Free Software Foundation; either version 2 of     *
+#*   the License, or (at your option) any later version.                   *
+#*   for detail see the LICENCE text file.                                 *
+#*                                                                         *
+#*   FreeCAD is distributed in the hope that it will be useful,            *
+#*   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#*   GNU Library General Public License for more details.                  *
+#*                                                                         *
+#*   You should have received a copy of the GNU Library General Public     *
+#*   License along with FreeCAD; if not, write to the Free Software        *
+#*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#*   USA                                                                   *
+#*                                                                         *
+#***************************************************************************
+
+# Measures the time to solve a set of difficult sketches with the solvers
+# running one after another and in portfolio mode, where the solvers run at
+# the same time and the first valid solution wins.
+#
+# Usage:
+#   import SketcherBenchmark
+#   SketcherBenchmark.run()
+
+import FreeCAD, Part, Sketcher, math, time
+App = FreeCAD
+
+ParamPath = "User parameter:BaseApp/Preferences/Mod/Sketcher"
+
+def jitter(i, scale):
+	# deterministic disturbance of the drawn geometry
+	return scale * math.sin(i * 12.9898)
+
+def makeChain(count):
+	# a staircase of lines with lengths and angles, drawn far away from the solution
+	geo = []
+	con = []
+	x, y = 0.0, 0.0
+	for i in range(count):
+		nx, ny = x + 6.0 + jitter(i, 4.0), y + 3.0 + jitter(i + 7, 4.0)
+		geo.append(Part.Line(App.Vector(x,y,0),App.Vector(nx,ny,0)))
+		if i > 0:
+			con.append(Sketcher.Constraint('Coincident',i-1,2,i,1))
+		con.append(Sketcher.Constraint('Distance',i,10.0 + (i % 3)))
+		con.append(Sketcher.Constraint('Angle',i,0.2 * math.sin(0.7 * i)))
+		x, y = nx, ny
+	con.append(Sketcher.Constraint('DistanceX',0,1,0.0))
+	con.append(Sketcher.Constraint('DistanceY',0,1,0.0))
+	return geo, con
+
+def makeNecklace(count):
+	# a row of circles of given radii touching each other and a common base line
+	geo = [Part.Line(App.Vector(-20,0,0),App.Vector(40.0 * count,0,0))]
+	con = [Sketcher.Constraint('Horizontal',0),
+	       Sketcher.Constraint('DistanceX',0,1,-20.0),
+	       Sketcher.Constraint('DistanceY',0,1,0.0)]
+	for i in range(count):
+		c = i + 1
+		geo.append(Part.Circle(App.Vector(30.0 * i + jitter(i, 8.0),25.0 + jitter(i + 3, 10.0),0),App.Vector(0,0,1),
+		                       15.0 + jitter(i + 5, 6.0)))
+		con.append(Sketcher.Constraint('Radius',c,10.0 + 5.0 * (i % 4)))
+		con.append(Sketcher.Constraint('Tangent',0,c))
+		if i > 0:
+			con.append(Sketcher.Constraint('Tangent',c-1,c))
+	con.append(Sketcher.Constraint('DistanceX',1,3,0.0))
+	return geo, con
+
+def makeGrid(count):
+	# a row of squares of equal size side by side
+	geo = []
+	con = []
+	for i in range(count):
+		x = 20.0 * i + jitter(i, 5.0)
+		b, r, t, l = 4 * i, 4 * i + 1, 4 * i + 2, 4 * i + 3
+		geo.append(Part.Line(App.Vector(x,0,0),App.Vector(x+25,jitter(i,3.0),0)))
+		geo.append(Part.Line(App.Vector(x+25,jitter(i,3.0),0),App.Vector(x+22,18,0)))
+		geo.append(Part.Line(App.Vector(x+22,18,0),App.Vector(x+jitter(i+1,4.0),23,0)))
+		geo.append(Part.Line(App.Vector(x+jitter(i+1,4.0),23,0),App.Vector(x,0,0)))
+		con.append(Sketcher.Constraint('Coincident',b,2,r,1))
+		con.append(Sketcher.Constraint('Coincident',r,2,t,1))
+		con.append(Sketcher.Constraint('Coincident',t,2,l,1))
+		con.append(Sketcher.Constraint('Coincident',l,2,b,1))
+		con.append(Sketcher.Constraint('Horizontal',b))
+		con.append(Sketcher.Constraint('Perpendicular',b,r))
+		con.append(Sketcher.Constraint('Parallel',b,t))
+		con.append(Sketcher.Constraint('Parallel',r,l))
+		if i == 0:
+			con.append(Sketcher.Constraint('Distance',b,20.0))
+			con.append(Sketcher.Constraint('Distance',r,20.0))
+			con.append(Sketcher.Constraint('DistanceX',b,1,0.0))
+			con.append(Sketcher.Constraint('DistanceY',b,1,0.0))
+		else:
+			con.append(Sketcher.Constraint('Coincident',b-4,2,b,1))
+			con.append(Sketcher.Constraint('Equal',0,b))
+			con.append(Sketcher.Constraint('Equal',1,r))
+	return geo, con
+
+def makePolygon(count):
+	# a regular polygon inscribed in a circle, drawn as a star
+	geo = [Part.Circle(App.Vector(0,0,0),App.Vector(0,0,1),50.0)]
+	con = [Sketcher.Constraint('Radius',0,40.0),
+	       Sketcher.Constraint('DistanceX',0,3,0.0),
+	       Sketcher.Constraint('DistanceY',0,3,0.0)]
+	pts = []
+	for i in range(count):
+		a = 2.0 * math.pi * i / count
+		r = 50.0 if i % 2 == 0 else 25.0
+		pts.append(App.Vector(r * math.cos(a),r * math.sin(a),0))
+	for i in range(count):
+		g = i + 1
+		geo.append(Part.Line(pts[i],pts[(i+1) % count]))
+		con.append(Sketcher.Constraint('PointOnObject',g,1,0))
+		if i > 0:
+			con.append(Sketcher.Constraint('Coincident',g-1,2,g,1))
+			con.append(Sketcher.Constraint('Equal',1,g))
+	con.append(Sketcher.Constraint('Coincident',count,2,1,1))
+	con.append(Sketcher.Constraint('Horizontal',1))
+	return geo, con
+
+Sketches = [("chain", makeChain, 150),
+            ("necklace", makeNecklace, 40),
+            ("grid", makeGrid, 30),
+            ("polygon", makePolygon, 36)]
+
+def solveSketch(builder, count, portfolio):
+	# returns the time to solve the sketch and the points of its solution
+	FreeCAD.ParamGet(ParamPath).SetBool("PortfolioSolving", portfolio)
+	doc = FreeCAD.newDocument("SketcherBenchmark")
+	try:
+		sketch = doc.addObject('Sketcher::SketchObject','Sketch')
+		geo, con = builder(count)
+		sketch.Geometry = geo
+		sketch.Constraints = con
+		start = time.time()
+		doc.recompute()
+		seconds = time.time() - start
+		points = [(v.Point.x, v.Point.y) for v in sketch.Shape.Vertexes]
+	finally:
+		FreeCAD.closeDocument(doc.Name)
+	return seconds, points
+
+def run(repeat=3):
+	param = FreeCAD.ParamGet(ParamPath)
+	oldValue = param.GetBool("PortfolioSolving", False)
+	try:
+		print "%-10s %12s %12s %8s" % ("sketch", "sequential", "portfolio", "same")
+		for name, builder, count in Sketches:
+			times = {}
+			points = {}
+			for portfolio in (False, True):
+				best = None
+				for i in range(repeat):
+					seconds, points[portfolio] = solveSketch(builder, count, portfolio)
+					if best is None or seconds < best:
+						best = seconds
+				times[portfolio] = best
+			print "%-10s %11.3fs %11.3fs %8s" % (name, times[False], times[True], points[False] == points[True])
+	finally:
+		param.SetBool("PortfolioSolving", oldValue)
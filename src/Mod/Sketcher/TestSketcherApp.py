@@ -113,6 +113,53 @@ class SketcherSolverTestCases(unittest.TestCase):
 		CreateSlotPlateInnerSet(self.Slot)
 		self.Doc.recompute()
 		self.failUnless(len(self.Slot.Shape.Edges) == 9)
+
+	def testLargeChainCase(self):
+		# a staircase of lines whose solver system is big enough to use the sparse jacobi matrix
+		self.Chain = self.Doc.addObject('Sketcher::SketchObject','SketchChain')
+		count = 80
+		x, y = 0.0, 0.0
+		for i in range(count):
+			if i % 2 == 0:
+				nx, ny = x + 9.0, y + 0.5
+			else:
+				nx, ny = x + 0.5, y + 4.0
+			self.Chain.addGeometry(Part.Line(App.Vector(x,y,0),App.Vector(nx,ny,0)))
+			if i > 0:
+				self.Chain.addConstraint(Sketcher.Constraint('Coincident',i-1,2,i,1))
+			if i % 2 == 0:
+				self.Chain.addConstraint(Sketcher.Constraint('Horizontal',i))
+				self.Chain.addConstraint(Sketcher.Constraint('Distance',i,10.0))
+			else:
+				self.Chain.addConstraint(Sketcher.Constraint('Vertical',i))
+				self.Chain.addConstraint(Sketcher.Constraint('Distance',i,5.0))
+			x, y = nx, ny
+		self.Chain.addConstraint(Sketcher.Constraint('DistanceX',0,1,0.0))
+		self.Chain.addConstraint(Sketcher.Constraint('DistanceY',0,1,0.0))
+		self.Doc.recompute()
+		self.failUnless(len(self.Chain.Shape.Edges) == count)
+		box = self.Chain.Shape.BoundBox
+		self.failUnless(abs(box.XLength - 400.0) < 1e-6)
+		self.failUnless(abs(box.YLength - 200.0) < 1e-6)
+
+	def testPortfolioCase(self):
+		# solving with the solvers running at the same time must give the same result
+		param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/Sketcher")
+		oldValue = param.GetBool("PortfolioSolving", False)
+		points = []
+		try:
+			for portfolio in (False, True):
+				param.SetBool("PortfolioSolving", portfolio)
+				slot = self.Doc.addObject('Sketcher::SketchObject','SketchSlot')
+				CreateSlotPlateSet(slot)
+				CreateSlotPlateInnerSet(slot)
+				self.Doc.recompute()
+				points.append([v.Point for v in slot.Shape.Vertexes])
+		finally:
+			param.SetBool("PortfolioSolving", oldValue)
+		self.failUnless(len(points[0]) == len(points[1]))
+		for p, q in zip(points[0], points[1]):
+			self.failUnless(p == q)
 	
 	
 	def tearDown(self):
@@ -165,6 +165,37 @@ class DocumentBasicCases(unittest.TestCase):
       self.failUnless(False)
     del L2
 
+  def testUniqueNames(self):
+    L1 = self.Doc.addObject("App::FeatureTest","Box")
+    L2 = self.Doc.addObject("App::FeatureTest","Box")
+    L3 = self.Doc.addObject("App::FeatureTest","Box")
+    self.failUnless([L1.Name, L2.Name, L3.Name] == ["Box", "Box001", "Box002"])
+    self.Doc.removeObject(L2.Name)
+    self.failUnless(self.Doc.addObject("App::FeatureTest","Box").Name == "Box003")
+    self.failUnless(self.Doc.addObject("App::FeatureTest","Box002").Name == "Box002001")
+
+  def testAddManyObjects(self):
+    # the names and labels of the objects must stay unique
+    objs = [self.Doc.addObject("App::FeatureTest","Part") for i in range(300)]
+    names = ["Part"] + ["Part%03d" % i for i in range(1, 300)]
+    self.failUnless([o.Name for o in objs] == names)
+    self.failUnless([o.Label for o in objs] == names)
+    # the next number follows the highest one, removed numbers aren't reused
+    self.Doc.removeObject("Part150")
+    self.failUnless(self.Doc.addObject("App::FeatureTest","Part").Name == "Part300")
+    self.failUnless(self.Doc.addObject("App::FeatureTest","Part150").Name == "Part150")
+    self.failUnless(self.Doc.addObject("App::FeatureTest","Part150").Name == "Part150001")
+    # Part200 to Part299 count as Part2 with the numbers 00 to 99
+    self.failUnless(self.Doc.addObject("App::FeatureTest","Part2").Name == "Part2")
+    self.failUnless(self.Doc.addObject("App::FeatureTest","Part2").Name == "Part2100")
+    labels = [o.Label for o in self.Doc.Objects]
+    self.failUnless(len(set(labels)) == len(labels))
+    # a changed label is found by its new value
+    objs[10].Label = "Renamed"
+    self.failUnless(self.Doc.getObjectsByLabel("Renamed") == [objs[10]])
+    self.failUnless(self.Doc.getObjectsByLabel("Part010") == [])
+    self.failUnless(self.Doc.addObject("App::FeatureTest","Part010").Label == "Part010")
+
   def tearDown(self):
     #closing doc
     FreeCAD.closeDocument("CreateTest")
@@ -202,6 +233,41 @@ class DocumentSaveRestoreCases(unittest.TestCase):
     self.failUnless(self.Doc.Label_1.TypeTransient == 4711)
     self.failUnless(self.Doc == FreeCAD.getDocument(self.Doc.Name))
 
+  def testSaveAndRestoreLargeFiles(self):
+    # the binary files are deflated and inflated in parallel in chunks of 1 MB,
+    # so use several files larger than that and check they come back in order
+    SaveName = self.TempPath + os.sep + "SaveRestoreTests.FCStd"
+    floats = []
+    vectors = []
+    blobs = []
+    for i in range(6):
+      obj = self.Doc.addObject("App::FeatureTest","Large")
+      floats.append([float((j * (i + 7)) % 10007) * 0.5 for j in range(300000)])
+      vectors.append([(float(j), float(i), float(-j)) for j in range(30000)])
+      obj.FloatList = floats[i]
+      obj.VectorList = vectors[i]
+    for i in range(2):
+      obj = self.Doc.addObject("App::DocumentObjectFileIncluded","LargeFile")
+      blobs.append(os.urandom(1500000))
+      file = open(self.Doc.getTempFileName("large"),"wb")
+      file.write(blobs[i])
+      file.close()
+      obj.File = (file.name,"Large%d.bin" % i)
+    names = [o.Name for o in self.Doc.Objects if o.Name.startswith("Large")]
+    self.Doc.saveAs(SaveName)
+    FreeCAD.closeDocument("SaveRestoreTests")
+    self.Doc = FreeCAD.open(SaveName)
+    for i in range(6):
+      obj = self.Doc.getObject(names[i])
+      self.failUnless(list(obj.FloatList) == floats[i])
+      self.failUnless([(v.x, v.y, v.z) for v in obj.VectorList] == vectors[i])
+    for i in range(2):
+      obj = self.Doc.getObject(names[6 + i])
+      file = open(obj.File,"rb")
+      data = file.read()
+      file.close()
+      self.failUnless(data == blobs[i])
+
   def testRestore(self):
     Doc = FreeCAD.newDocument("RestoreTests")
     Doc.addObject("App::FeatureTest","Label_1")
@@ -244,6 +310,181 @@ class DocumentRecomputeCases(unittest.TestCase):
     self.L1.Link = self.L2
     self.L2.Link = self.L3
 
+  def testDependencyUpdate(self):
+    # the dependency graph must follow the changes of the links
+    self.L1.Link = self.L2
+    self.Doc.recompute()
+    count = self.L1.ExecCount
+    self.L2.touch()
+    self.Doc.recompute()
+    self.failUnless(self.L1.ExecCount == count+1)
+    self.L1.Link = None
+    self.Doc.recompute()
+    count = self.L1.ExecCount
+    self.L2.touch()
+    self.Doc.recompute()
+    self.failUnless(self.L1.ExecCount == count)
+    # removing and re-adding an object by undo must restore its links
+    self.Doc.UndoMode = 1
+    self.L1.LinkList = [self.L3]
+    self.Doc.openTransaction("Remove")
+    self.Doc.removeObject(self.L3.Name)
+    self.Doc.commitTransaction()
+    self.Doc.undo()
+    self.Doc.recompute()
+    count = self.L1.ExecCount
+    self.Doc.getObject("Label_3").touch()
+    self.Doc.recompute()
+    self.failUnless(self.L1.ExecCount == count+1)
+
+  def testInList(self):
+    self.L1.Link = self.L3
+    self.L2.LinkList = [self.L3, self.L1, self.L3]
+    self.failUnless(self.L3.InList == [self.L1, self.L2, self.L2])
+    self.failUnless(self.L1.InList == [self.L2])
+    self.failUnless(self.Doc.checkDependencyGraph())
+    self.L1.Link = None
+    self.failUnless(self.L3.InList == [self.L2, self.L2])
+    # removing and re-adding an object by undo must restore the links to it
+    self.L2.LinkList = [self.L3, self.L1]
+    self.Doc.UndoMode = 1
+    self.Doc.openTransaction("Remove")
+    self.Doc.removeObject(self.L3.Name)
+    self.Doc.commitTransaction()
+    self.failUnless(self.Doc.checkDependencyGraph())
+    self.Doc.undo()
+    self.failUnless(self.Doc.getObject("Label_3").InList == [self.L2])
+    self.failUnless(self.Doc.checkDependencyGraph())
+    self.Doc.removeObject(self.L2.Name)
+    self.failUnless(self.L1.InList == [])
+    self.failUnless(self.Doc.checkDependencyGraph())
+
+  def testInListChain(self):
+    # a chain of objects each linking to its predecessor
+    objs = [self.L1]
+    for i in range(50):
+      obj = self.Doc.addObject("App::FeatureTest","Chain")
+      obj.Link = objs[-1]
+      objs.append(obj)
+    self.failUnless(self.Doc.checkDependencyGraph())
+    for i in range(len(objs) - 1):
+      self.failUnless(objs[i].InList == [objs[i+1]])
+    self.failUnless(objs[-1].InList == [])
+    # relinking moves the object from one InList to the other
+    objs[30].Link = objs[10]
+    self.failUnless(objs[29].InList == [])
+    self.failUnless(objs[10].InList == [objs[11], objs[30]])
+    # a removed object disappears from the InList of the object it linked to
+    self.Doc.removeObject(objs[11].Name)
+    self.failUnless(objs[10].InList == [objs[30]])
+    self.failUnless(self.Doc.checkDependencyGraph())
+
+  def testRemoveLinkProperty(self):
+    # removing a dynamic link property removes the links of the object
+    obj = self.Doc.addObject("App::FeaturePython","Python")
+    obj.addProperty("App::PropertyLink","Ref")
+    obj.addProperty("App::PropertyLinkList","Refs")
+    obj.Ref = self.L1
+    obj.Refs = [self.L2, self.L3]
+    self.failUnless(self.L1.InList == [obj] and self.L2.InList == [obj])
+    self.failUnless(obj.removeProperty("Ref"))
+    self.failUnless(self.L1.InList == [])
+    self.failUnless(self.L2.InList == [obj] and self.L3.InList == [obj])
+    self.failUnless(self.Doc.checkDependencyGraph())
+    self.failUnless(obj.removeProperty("Refs"))
+    self.failUnless(self.L2.InList == [] and self.L3.InList == [])
+    self.failUnless(obj.OutList == [])
+    self.failUnless(self.Doc.checkDependencyGraph())
+
+  def testRecomputeTouchedOnly(self):
+    self.L1.Link = self.L2
+    self.L2.Link = self.L3
+    self.Doc.recompute()
+    count = [i.ExecCount for i in [self.L1, self.L2, self.L3]]
+    self.L2.touch()
+    self.Doc.recompute(True)
+    # only L2 and its dependent L1 are recomputed
+    self.failUnless([i.ExecCount for i in [self.L1, self.L2, self.L3]] == [count[0]+1, count[1]+1, count[2]])
+    self.failUnless(not self.L1.State.count("Touched") and not self.L2.State.count("Touched"))
+    # a purged object is not recomputed any more
+    count = [i.ExecCount for i in [self.L1, self.L2, self.L3]]
+    self.L2.touch()
+    self.L2.purgeTouched()
+    self.Doc.recompute(True)
+    self.failUnless([i.ExecCount for i in [self.L1, self.L2, self.L3]] == count)
+    # changing a property touches the object
+    self.L3.Integer = 5
+    self.Doc.recompute(True)
+    self.failUnless([i.ExecCount for i in [self.L1, self.L2, self.L3]] == [j+1 for j in count])
+    # a touched object which is removed and restored by undo is still touched
+    self.Doc.UndoMode = 1
+    self.L1.Link = None
+    L4 = self.Doc.addObject("App::FeatureTest","Label_4")
+    L4.Link = self.L2
+    self.Doc.recompute()
+    L4.touch()
+    self.Doc.openTransaction("Remove")
+    self.Doc.removeObject(L4.Name)
+    self.Doc.commitTransaction()
+    count = [i.ExecCount for i in [self.L1, self.L2, self.L3]]
+    self.Doc.recompute(True)
+    self.failUnless([i.ExecCount for i in [self.L1, self.L2, self.L3]] == count)
+    self.Doc.undo()
+    L4 = self.Doc.getObject("Label_4")
+    count = L4.ExecCount
+    self.Doc.recompute(True)
+    self.failUnless(L4.ExecCount == count+1)
+
+  def testParallelRecompute(self):
+    param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+    parallel = param.GetBool("ParallelRecompute",False)
+    param.SetBool("ParallelRecompute",True)
+    try:
+      # two independent branches joined by L1
+      L4 = self.Doc.addObject("App::FeatureTest","Label_4")
+      self.L1.LinkList = [self.L2, self.L3]
+      self.L2.Link = L4
+      for i in [self.L1, self.L2, self.L3, L4]:
+        i.touch()
+      count = [i.ExecCount for i in [self.L1, self.L2, self.L3, L4]]
+      self.Doc.recompute()
+      self.failUnless([i.ExecCount for i in [self.L1, self.L2, self.L3, L4]] == [j+1 for j in count])
+      self.failUnless(self.L1.State == ["Up-to-date"] and L4.State == ["Up-to-date"])
+      # an error in one branch must not stop the other one
+      L5 = self.Doc.addObject("App::FeatureTestException","Label_5")
+      self.L3.Link = L5
+      L5.touch()
+      L4.touch()
+      count = L4.ExecCount
+      self.Doc.recompute()
+      self.failUnless(L4.ExecCount == count+1)
+      self.failUnless("Invalid" in L5.State)
+    finally:
+      param.SetBool("ParallelRecompute",parallel)
+
+  def testParallelRecomputeMainThread(self):
+    param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+    parallel = param.GetBool("ParallelRecompute",False)
+    param.SetBool("ParallelRecompute",True)
+    try:
+      # thread-safe and unsafe objects depending on each other
+      L4 = self.Doc.addObject("App::FeatureTest","Label_4")
+      L5 = self.Doc.addObject("App::FeatureTest","Label_5")
+      self.L1.LinkList = [self.L2, self.L3]
+      self.L2.Link = L4
+      self.L3.Link = L5
+      self.L1.ThreadSafe = True
+      L4.ThreadSafe = True
+      objs = [self.L1, self.L2, self.L3, L4, L5]
+      for i in objs:
+        i.touch()
+      count = [i.ExecCount for i in objs]
+      self.Doc.recompute()
+      self.failUnless([i.ExecCount for i in objs] == [j+1 for j in count])
+      # only the thread-safe objects leave the main thread
+      self.failUnless([i.ExecInMainThread for i in objs] == [False, True, True, False, True])
+    finally:
+      param.SetBool("ParallelRecompute",parallel)
 
   def tearDown(self):
     #closing doc
@@ -756,6 +997,36 @@ class DocumentPropertyCases(unittest.TestCase):
     FreeCAD.closeDocument("PropertyTests")
     self.Doc = FreeCAD.open(tempFile)
 
+  def testPropertyLookup(self):
+    obj = self.Doc.addObject("App::FeatureTest","Lookup")
+    # Label is defined in the base class, the other ones in the class itself
+    self.failUnless(obj.getGroupOfProperty("Label") == "Base")
+    self.failUnless(obj.getGroupOfProperty("ExecCount") == "Feature Test")
+    self.failUnless(obj.getGroupOfProperty("NoSuchProperty") == "")
+    self.failUnless(obj.getTypeOfProperty("Integer") == [])
+    self.failUnless(obj.getTypeOfProperty("TypeTransient") == ["Transient"])
+    self.failUnless(obj.getTypeOfProperty("TypeAll") == ["Hidden", "ReadOnly", "Output"])
+    # every listed property is found by its name
+    for name in obj.PropertiesList:
+      self.failUnless(repr(obj.getPropertyByName(name)) == repr(getattr(obj, name)))
+    self.failUnless(obj.getPropertyByName("Label") == "Lookup")
+    self.failUnless(obj.getPropertyByName("Integer") == 4711)
+    try:
+      obj.getPropertyByName("NoSuchProperty")
+    except AttributeError:
+      pass
+    else:
+      self.failUnless(False)
+    # saving finds the type of a property by its address, transient ones aren't saved
+    obj.Integer = 1
+    obj.TypeTransient = 1
+    tempFile = tempfile.gettempdir() + os.sep + "PropertyTests.FCStd"
+    self.Doc.saveAs(tempFile)
+    FreeCAD.closeDocument("PropertyTests")
+    self.Doc = FreeCAD.open(tempFile)
+    self.failUnless(self.Doc.Lookup.Integer == 1)
+    self.failUnless(self.Doc.Lookup.TypeTransient == 4711)
+
   def tearDown(self):
     #closing doc
     FreeCAD.closeDocument("PropertyTests")
@@ -0,0 +1,74 @@
+#***************************************************************************
+#*   (c) agent (agent[at]local) 2026                                       *
+#*                                                                         *
+#*   This file is part of the FreeCAD CAx development system.              *
+#*                                                                         *
+#*   This program is free software; you can redistribute it and/or modify  *
+#*   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#*   as published by the Free Software Foundation; either version 2 of     *
+#*   the License, or (at your option) any later version.                   *
+#*   for detail see the LICENCE text file.                                 *
+#*                                                                         *
+#*   FreeCAD is distributed in the hope that it will be useful,            *
+#*   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#*   GNU Library General Public License for more details.                  *
+#*                                                                         *
+#*   You should have received a copy of the GNU Library General Public     *
+#*   License along with FreeCAD; if not, write to the Free Software        *
+#*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#*   USA                                                                   *
+#*                                                                         *
+#***************************************************************************
+
+# Measures the time of document operations that must not slow down with the
+# number of objects of a document.
+#
+# Usage:
+#   import DocumentBenchmark
+#   DocumentBenchmark.run()
+
+import FreeCAD, time
+
+def addObjects(doc, count):
+	# all objects get the same name, so each one needs a new number
+	for i in range(count):
+		obj = doc.addObject("App::FeatureTest","Part")
+	return obj.Name == "Part%03d" % (count - 1)
+
+def inList(doc, count):
+	# a chain of objects each linking to its predecessor
+	objs = [doc.addObject("App::FeatureTest","Chain")]
+	for i in range(count):
+		obj = doc.addObject("App::FeatureTest","Chain")
+		obj.Link = objs[-1]
+		objs.append(obj)
+	ok = True
+	for obj in objs[:-1]:
+		ok = ok and len(obj.InList) == 1
+	return ok
+
+def propertyLookup(doc, count):
+	# Label is defined in the base class, the other ones in the class itself
+	obj = doc.addObject("App::FeatureTest","Lookup")
+	names = ["Label", "Integer", "Float", "Link", "TypeTransient"]
+	for i in range(count / len(names)):
+		for name in names:
+			obj.getGroupOfProperty(name)
+	return obj.getGroupOfProperty("Label") == "Base"
+
+Benchmarks = [("add objects", addObjects, 100000),
+              ("InList of a chain", inList, 20000),
+              ("property lookups", propertyLookup, 500000)]
+
+def run():
+	print "%-20s %8s %10s %6s" % ("benchmark", "count", "time", "ok")
+	for name, benchmark, count in Benchmarks:
+		doc = FreeCAD.newDocument("DocumentBenchmark")
+		try:
+			start = time.time()
+			ok = benchmark(doc, count)
+			seconds = time.time() - start
+		finally:
+			FreeCAD.closeDocument(doc.Name)
+		print "%-20s %8d %9.3fs %6s" % (name, count, seconds, ok)
@@ -50,6 +50,10 @@ ConstEntryPointer ZipInputStream::getNextEntry() {
   return izf->getNextEntry() ;
 }
 
+bool ZipInputStream::readRawEntryData( std::vector< char > &data ) {
+  return izf->readRawEntryData( data ) ;
+}
+
 ZipInputStream::~ZipInputStream() {
   // It's ok to call delete with a Null pointer.
   delete izf ;
@@ -49,6 +49,11 @@ public:
   */
   ConstEntryPointer getNextEntry() ;
 
+  /** Reads the data of the current entry as it is stored in the zip archive,
+      see ZipInputStreambuf::readRawEntryData().
+  */
+  bool readRawEntryData( std::vector< char > &data ) ;
+
   /** Destructor. */
   virtual ~ZipInputStream() ;
 
@@ -79,6 +79,62 @@ ConstEntryPointer ZipInputStreambuf::getNextEntry() {
 }
 
 
+bool ZipInputStreambuf::readRawEntryData( vector< char > &data ) {
+  if ( ! _open_entry )
+    return false ;
+
+  int size = static_cast< int >( _curr_entry.getCompressedSize() ) ;
+  data.resize( size ) ;
+  if ( size == 0 )
+    return true ;
+
+  // in case some data of the entry has been read already
+  _inbuf->pubseekoff( _data_start, ios::beg, ios::in ) ;
+  return _inbuf->sgetn( &( data[ 0 ] ), size ) == size ;
+}
+
+
+bool ZipInputStreambuf::inflateEntryData( vector< char > &data, StorageMethod method,
+					  uint32 size ) {
+  if ( method == STORED )
+    return true ;
+  else if ( method != DEFLATED )
+    return false ;
+
+  z_stream zs ;
+  zs.zalloc = Z_NULL ;
+  zs.zfree  = Z_NULL ;
+  zs.opaque = Z_NULL ;
+  zs.next_in  = Z_NULL ;
+  zs.avail_in = 0 ;
+  // no zlib header as in InflateInputStreambuf::reset()
+  if ( inflateInit2( &zs, -MAX_WBITS ) != Z_OK )
+    return false ;
+
+  if ( ! data.empty() ) {
+    zs.next_in  = reinterpret_cast< Bytef * >( &( data[ 0 ] ) ) ;
+    zs.avail_in = data.size() ;
+  }
+
+  vector< char > out( size + 1 ) ;
+  vector< char >::size_type pos = 0 ;
+  int err = Z_OK ;
+  while ( err == Z_OK ) {
+    if ( pos == out.size() )
+      out.resize( 2 * out.size() ) ;
+    zs.next_out  = reinterpret_cast< Bytef * >( &( out[ pos ] ) ) ;
+    zs.avail_out = out.size() - pos ;
+    err = inflate( &zs, Z_NO_FLUSH ) ;
+    pos = out.size() - zs.avail_out ;
+  }
+  inflateEnd( &zs ) ;
+
+  out.resize( pos ) ;
+  data.swap( out ) ;
+  return err == Z_STREAM_END ;
+}
+
+
 ZipInputStreambuf::~ZipInputStreambuf() {
 }
 
@@ -39,6 +39,18 @@ public:
   */
   ConstEntryPointer getNextEntry() ;
 
+  /** Reads the data of the current entry as it is stored in the zip archive,
+      i.e. deflated for a DEFLATED entry. The data can be inflated afterwards
+      with inflateEntryData(), e.g. in another thread.
+      @return false if there is no open entry or the data couldn't be read. */
+  bool readRawEntryData( vector< char > &data ) ;
+
+  /** Replaces the raw data of an entry by its uncompressed data.
+      @param method the storage method of the entry.
+      @param size the uncompressed size of the entry.
+      @return false if the data couldn't be inflated. */
+  static bool inflateEntryData( vector< char > &data, StorageMethod method, uint32 size ) ;
+
   /** Destructor. */
   virtual ~ZipInputStreambuf() ;
 protected:
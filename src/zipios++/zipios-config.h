@@ -3,6 +3,11 @@
 
 #include <FCConfig.h>
 
+// FreeCAD extension: entries can be written with data that has been deflated
+// in advance and read as raw data to inflate them elsewhere, see
+// ZipOutputStream::putDeflatedEntry() and ZipInputStream::readRawEntryData()
+#define ZIPIOS_HAVE_RAW_ENTRIES
+
 #ifdef _MSC_VER
 
 // This is fine for VC++ 5.0 sp 3
@@ -55,6 +55,12 @@ void ZipOutputStream::putNextEntry(const std::string& entryName) {
   putNextEntry( ZipCDirEntry(entryName));
 }
 
+void ZipOutputStream::putDeflatedEntry( const std::string &entryName, 
+					const std::vector< std::vector< char > > &chunks,
+					uint32 crc, uint32 size ) {
+  ozf->putDeflatedEntry( ZipCDirEntry( entryName ), chunks, crc, size ) ;
+}
+
 
 void ZipOutputStream::setComment( const std::string &comment ) {
   ozf->setComment( comment ) ;
@@ -66,6 +72,11 @@ void ZipOutputStream::setLevel( int level ) {
 }
 
 
+int ZipOutputStream::getLevel() const {
+  return ozf->getLevel() ;
+}
+
+
 void ZipOutputStream::setMethod( StorageMethod method ) {
   ozf->setMethod( method ) ;
 }
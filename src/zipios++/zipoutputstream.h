@@ -54,12 +54,22 @@ public:
   */
   void putNextEntry(const std::string& entryName);
 
+  /** Writes an entry whose data has already been deflated, see 
+      ZipOutputStreambuf::putDeflatedEntry().
+  */
+  void putDeflatedEntry( const std::string &entryName, 
+			 const std::vector< std::vector< char > > &chunks,
+			 uint32 crc, uint32 size ) ;
+
   /** Sets the global comment for the Zip archive. */
   void setComment( const std::string& comment ) ;
 
   /** Sets the compression level to be used for subsequent entries. */
   void setLevel( int level ) ;
 
+  /** Returns the compression level to be used for subsequent entries. */
+  int getLevel() const ;
+
   /** Sets the compression method to be used. only STORED and DEFLATED are
       supported. */
   void setMethod( StorageMethod method ) ;
@@ -8,6 +8,7 @@
 
 #include <zlib.h>
 
+#include "fcollexceptions.h"
 #include "zipoutputstreambuf.h"
 
 namespace zipios {
@@ -81,6 +82,93 @@ void ZipOutputStreambuf::putNextEntry( const ZipCDirEntry &entry ) {
 }
 
 
+void ZipOutputStreambuf::putDeflatedEntry( const ZipCDirEntry &entry, 
+					   const vector< vector< char > > &chunks,
+					   uint32 crc, uint32 size ) {
+  if ( _open_entry )
+    closeEntry() ;
+
+  _entries.push_back( entry ) ;
+  ZipCDirEntry &ent = _entries.back() ;
+
+  uint32 compressed_size = 0 ;
+  vector< vector< char > >::const_iterator it ;
+  for ( it = chunks.begin() ; it != chunks.end() ; ++it )
+    compressed_size += it->size() ;
+
+  ostream os( _outbuf ) ;
+
+  // The sizes are known in advance so the header needn't be updated afterwards
+  ent.setLocalHeaderOffset( os.tellp() ) ;
+  ent.setMethod( DEFLATED ) ;
+  ent.setSize( size ) ;
+  ent.setCrc( crc ) ;
+  ent.setCompressedSize( compressed_size ) ;
+  ent.setTime( currentDosTime() ) ;
+
+  os << static_cast< ZipLocalEntry >( ent ) ;
+  for ( it = chunks.begin() ; it != chunks.end() ; ++it ) {
+    if ( ! it->empty() )
+      os.write( &( *it )[ 0 ], it->size() ) ;
+  }
+}
+
+
+uint32 ZipOutputStreambuf::deflateChunk( const char *data, uint32 size, uint32 prev_size,
+					 int level, bool last, vector< char > &out ) {
+  static const int default_mem_level = 8 ;
+  static const uint32 max_dict_size = 32768 ;
+
+  z_stream zs ;
+  zs.zalloc = Z_NULL ;
+  zs.zfree  = Z_NULL ;
+  zs.opaque = Z_NULL ;
+  // no zlib header as in DeflateOutputStreambuf::init()
+  if ( deflateInit2( &zs, level, Z_DEFLATED, -MAX_WBITS, 
+		     default_mem_level, Z_DEFAULT_STRATEGY ) != Z_OK )
+    throw IOException( "Deflation failed" ) ;
+
+  // The end of the preceding chunk keeps the compression as good as if the
+  // entry was deflated in one go
+  if ( prev_size > 0 ) {
+    uint32 dict_size = min( prev_size, max_dict_size ) ;
+    deflateSetDictionary( &zs, reinterpret_cast< const Bytef * >( data - dict_size ),
+			  dict_size ) ;
+  }
+
+  // All but the last chunk end at a byte boundary without the final block
+  int flush = last ? Z_FINISH : Z_FULL_FLUSH ;
+  zs.next_in  = reinterpret_cast< Bytef * >( const_cast< char * >( data ) ) ;
+  zs.avail_in = size ;
+
+  vector< char >::size_type pos = out.size() ;
+  out.resize( pos + deflateBound( &zs, size ) + 16 ) ;
+  for ( ;; ) {
+    if ( pos == out.size() )
+      out.resize( 2 * out.size() ) ;
+    zs.next_out  = reinterpret_cast< Bytef * >( &( out[ pos ] ) ) ;
+    zs.avail_out = out.size() - pos ;
+    int err = deflate( &zs, flush ) ;
+    pos = out.size() - zs.avail_out ;
+    if ( err == Z_STREAM_ERROR ) {
+      deflateEnd( &zs ) ;
+      throw IOException( "Deflation failed" ) ;
+    }
+    if ( last ? err == Z_STREAM_END : zs.avail_out > 0 )
+      break ;
+  }
+  out.resize( pos ) ;
+  deflateEnd( &zs ) ;
+
+  return crc32( crc32( 0, Z_NULL, 0 ), reinterpret_cast< const Bytef * >( data ), size ) ;
+}
+
+
+uint32 ZipOutputStreambuf::combineCrc( uint32 crc1, uint32 crc2, uint32 size2 ) {
+  return crc32_combine( crc1, crc2, size2 ) ;
+}
+
+
 void ZipOutputStreambuf::setComment( const string &comment ) {
   _zip_comment = comment ;
 }
@@ -91,6 +179,11 @@ void ZipOutputStreambuf::setLevel( int level ) {
 }
 
 
+int ZipOutputStreambuf::getLevel() const {
+  return _level ;
+}
+
+
 void ZipOutputStreambuf::setMethod( StorageMethod method ) {
   _method = method ;
   if( method == STORED )
@@ -145,7 +238,16 @@ void ZipOutputStreambuf::updateEntryHeaderInfo() {
   entry.setCrc( getCrc32() ) ;
   entry.setCompressedSize( curr_pos - entry.getLocalHeaderOffset() 
 			   - entry.getLocalHeaderSize() ) ;
+  entry.setTime( currentDosTime() ) ;
+
+  // write ZipLocalEntry header to header position
+  os.seekp( entry.getLocalHeaderOffset() ) ;
+  os << static_cast< ZipLocalEntry >( entry ) ;
+  os.seekp( curr_pos ) ;
+}
+
 
+int ZipOutputStreambuf::currentDosTime() {
   // Mark Donszelmann: added current date and time
   time_t ltime;
   time( &ltime );
@@ -153,12 +255,7 @@ void ZipOutputStreambuf::updateEntryHeaderInfo() {
   now = localtime( &ltime );
   int dosTime = (now->tm_year - 80) << 25 | (now->tm_mon + 1) << 21 | now->tm_mday << 16 |
               now->tm_hour << 11 | now->tm_min << 5 | now->tm_sec >> 1;
-  entry.setTime(dosTime);
-
-  // write ZipLocalEntry header to header position
-  os.seekp( entry.getLocalHeaderOffset() ) ;
-  os << static_cast< ZipLocalEntry >( entry ) ;
-  os.seekp( curr_pos ) ;
+  return dosTime;
 }
 
 
@@ -52,9 +52,39 @@ public:
   /** Sets the global comment for the Zip archive. */
   void setComment( const string &comment ) ;
 
+  /** Writes an entry whose data has already been deflated by deflateChunk().
+      The current entry is closed first, the written entry is closed, too.
+      @param chunks the deflated chunks of the data in order.
+      @param crc the crc32 of the (uncompressed) data.
+      @param size the size of the (uncompressed) data. */
+  void putDeflatedEntry( const ZipCDirEntry &entry, 
+			 const vector< vector< char > > &chunks,
+			 uint32 crc, uint32 size ) ;
+
+  /** Deflates a chunk of the data of an entry and appends the output to out.
+      The chunks of an entry are independent of each other and can be
+      deflated in different threads. Their output in order is the deflated
+      data of the entry.
+      @param data the chunk.
+      @param size the size of the chunk.
+      @param prev_size the number of bytes in front of data that belong to the
+      preceding chunks. Up to 32 KB of them are used as dictionary.
+      @param level the compression level.
+      @param last true for the last chunk of the entry.
+      @return the crc32 of the chunk. */
+  static uint32 deflateChunk( const char *data, uint32 size, uint32 prev_size,
+			      int level, bool last, vector< char > &out ) ;
+
+  /** Returns the crc32 of two consecutive chunks.
+      @param size2 the size of the second chunk. */
+  static uint32 combineCrc( uint32 crc1, uint32 crc2, uint32 size2 ) ;
+
   /** Sets the compression level to be used for subsequent entries. */
   void setLevel( int level ) ;
 
+  /** Returns the compression level to be used for subsequent entries. */
+  int getLevel() const ;
+
   /** Sets the compression method to be used. only STORED and DEFLATED are
       supported. */
   void setMethod( StorageMethod method ) ;
@@ -68,6 +98,7 @@ protected:
 
   void setEntryClosedState() ;
   void updateEntryHeaderInfo() ;
+  static int currentDosTime() ;
 
   // Should/could be moved to zipheadio.h ?!
   static void writeCentralDirectory( const vector< ZipCDirEntry > &entries, 